@@ -0,0 +1,70 @@
+"""Time sampling, blending and skinning palette generation for a crowd of skinned characters
+
+Usage: python benchmarks/animation.py [character_count] [bone_count] [frames]
+"""
+import math
+import os
+import sys
+import time
+from array import array
+
+from py3dengine.math import AnimationClip, Skeleton
+
+
+def generate_skeleton(bone_count):
+    # Five limbs hanging off the root, like a spine with arms, legs and a head
+    parents = [-1] + [0 if i % (bone_count // 5 or 1) == 1 else i - 1 for i in range(1, bone_count)]
+    rest = array('f')
+    for i in range(bone_count):
+        rest.extend((0.0, 0.1 if i else 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0))
+
+    return Skeleton(parents, rest_pose=rest)
+
+
+def generate_clip(bone_count, key_count, duration, phase):
+    times = [duration * k / (key_count - 1) for k in range(key_count)]
+    tracks = []
+    for bone in range(bone_count):
+        rotations = []
+        for k in range(key_count):
+            half_angle = 0.25 * math.sin(phase + bone * 0.3 + k * 2.0 * math.pi / (key_count - 1))
+            rotations.extend((math.sin(half_angle), 0.0, 0.0, math.cos(half_angle)))
+        tracks.append((bone, 'rotation', times, rotations))
+
+    translations = []
+    for k in range(key_count):
+        translations.extend((0.0, 0.05 * math.sin(phase + k), 0.0))
+    tracks.append((0, 'translation', times, translations))
+
+    return AnimationClip(duration, tracks)
+
+
+def measure(skeleton, jobs, out, frames, threads):
+    start = time.perf_counter()
+    for frame in range(frames):
+        frame_jobs = [(a, t + frame / 60.0, b, tb + frame / 60.0, w) for a, t, b, tb, w in jobs]
+        skeleton.evaluate(frame_jobs, out, threads=threads)
+
+    return (time.perf_counter() - start) / frames
+
+
+def main():
+    character_count = int(sys.argv[1]) if len(sys.argv) > 1 else 1000
+    bone_count = int(sys.argv[2]) if len(sys.argv) > 2 else 64
+    frames = int(sys.argv[3]) if len(sys.argv) > 3 else 30
+
+    skeleton = generate_skeleton(bone_count)
+    walk = generate_clip(bone_count, 31, 1.0, 0.0)
+    run = generate_clip(bone_count, 21, 0.7, 1.0)
+    jobs = [(walk, i * 0.013, run, i * 0.007, (i % 10) / 10.0) for i in range(character_count)]
+    out = array('f', bytes(character_count * bone_count * 16 * 4))
+
+    print(f'{character_count} characters, {bone_count} bones, two blended clips, {frames} frames')
+    print(f'{"threads":<10} {"frame ms":>10} {"us/char":>10}')
+    for threads in sorted({1, os.cpu_count() or 1}):
+        elapsed = measure(skeleton, jobs, out, frames, threads)
+        print(f'{threads:<10} {elapsed * 1000.0:>10.2f} {elapsed * 1e6 / character_count:>10.2f}')
+
+
+if __name__ == '__main__':
+    main()
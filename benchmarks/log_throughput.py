@@ -0,0 +1,64 @@
+"""Time what a log call costs the calling thread below the level threshold, written synchronously, queued and binary
+
+Usage: python benchmarks/log_throughput.py [message_count]
+"""
+import os
+import sys
+import tempfile
+import time
+from os import path
+
+from py3dengine import logging
+from py3dengine.math import BinaryLog
+
+
+def time_calls(message_count):
+    position = (1.0, 2.0, 3.0)
+    start = time.perf_counter_ns()
+    for i in range(message_count):
+        logging.debug('object {} moved to {} after {:.3f} ms', i, position, 0.125)
+
+    return (time.perf_counter_ns() - start) / message_count
+
+
+def time_binary_calls(message_count):
+    log = BinaryLog()
+    moved = log.register('object {} moved to ({}, {}, {}) after {:.3f} ms', 'iffff')
+    write = log.write
+    start = time.perf_counter_ns()
+    for i in range(message_count):
+        write(moved, i, 1.0, 2.0, 3.0, 0.125)
+
+    return (time.perf_counter_ns() - start) / message_count
+
+
+def main():
+    message_count = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+
+    with tempfile.TemporaryDirectory() as work_dir:
+        logging.set_level('INFO')
+        filtered = time_calls(message_count)
+        logging.set_level('TRACE')
+
+        with open(path.join(work_dir, 'sync.log'), 'w') as sync_file:
+            old_dst = logging.set_debug_dst(sync_file)
+            synchronous = time_calls(message_count)
+            logging.set_debug_dst(old_dst)
+
+        log_path = path.join(work_dir, 'async.log')
+        logging.start_async_logging(log_path, capacity=message_count)
+        queued = time_calls(message_count)
+        start = time.perf_counter()
+        logging.stop_async_logging()
+        drain = time.perf_counter() - start
+
+        print(f'{message_count} debug messages')
+        print(f'below threshold     {filtered:>10.1f} ns/call')
+        print(f'synchronous file    {synchronous:>10.1f} ns/call')
+        print(f'queued              {queued:>10.1f} ns/call ({drain * 1000.0:.1f} ms left to write on stop, '
+              f'{os.path.getsize(log_path)} bytes)')
+        print(f'binary record       {time_binary_calls(message_count):>10.1f} ns/call')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,175 @@
+"""Microbenchmark every Python level operator, method and factory of Vector3, Quaternion and Matrix4x4
+
+Usage: python benchmarks/math_micro.py [--filter text] [--min-time ms] [--repetitions n]
+
+Prints the same JSON report as the py3dmath_bench C executable, so both suites can be compared across commits by one
+script. allocs_per_op counts the memory blocks still held per op while every result is kept alive, so a call returning
+one new Vector3 reports 1.0 and a call that leaks reports more than it returns.
+"""
+import argparse
+import json
+import statistics
+import sys
+import time
+from array import array
+
+from py3dengine.math import Matrix4x4, Quaternion, Vector3
+
+BATCH_COUNT = 1024
+
+
+def make_benchmarks():
+    a = Vector3(1.0, 2.0, 3.0)
+    b = Vector3(-2.0, 0.5, 4.0)
+    axis = Vector3(0.0, 1.0, 0.0)
+    q = Quaternion.FromAxisAndDegrees(axis, 30.0)
+    r = Quaternion.FromAxisAndDegrees(Vector3(1.0, 0.0, 0.0), 60.0)
+    m = Matrix4x4.RotationAxis(Vector3(0.3, 0.9, 0.1).normalize(), 40.0) * Matrix4x4.Translation(a)
+    n = Matrix4x4.Scaling(Vector3(2.0, 2.0, 2.0))
+    eye = Vector3(3.0, 4.0, 5.0)
+    origin = Vector3(0.0, 0.0, 0.0)
+
+    vectors = array('f', [float(i % 7) for i in range(BATCH_COUNT * 3)])
+    quats = array('f', [0.1, 0.2, 0.3, 0.9] * BATCH_COUNT)
+    quat_out = array('f', bytes(len(quats) * 4))
+    vector_out = array('f', bytes(len(vectors) * 4))
+    worlds = array('f', [1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 1.0, 2.0, 3.0, 1.0] * BATCH_COUNT)
+    world_out = array('f', bytes(len(worlds) * 4))
+
+    # Every entry is (name, function returning the result to keep alive)
+    return [
+        ('Vector3()', lambda: Vector3()),
+        ('Vector3(x, y, z)', lambda: Vector3(1.0, 2.0, 3.0)),
+        ('Vector3(Vector3)', lambda: Vector3(a)),
+        ('Vector3 + Vector3', lambda: a + b),
+        ('Vector3 - Vector3', lambda: a - b),
+        ('Vector3 * Vector3', lambda: a * b),
+        ('Vector3 * Quaternion', lambda: a * q),
+        ('Vector3 * Matrix4x4', lambda: a * m),
+        ('Vector3 * float', lambda: a * 2.5),
+        ('Vector3 / float', lambda: a / 2.5),
+        ('Vector3.x', lambda: a.x),
+        ('Vector3.y', lambda: a.y),
+        ('Vector3.z', lambda: a.z),
+        ('Vector3.dot', lambda: a.dot(b)),
+        ('Vector3.length', lambda: a.length()),
+        ('Vector3.normalize', lambda: a.normalize()),
+        ('Vector3.copy', lambda: a.copy()),
+        ('Vector3.Fill', lambda: Vector3.Fill(2.0)),
+        ('repr(Vector3)', lambda: repr(a)),
+
+        ('Quaternion()', lambda: Quaternion()),
+        ('Quaternion(x, y, z, w)', lambda: Quaternion(0.0, 0.0, 0.0, 1.0)),
+        ('Quaternion(Quaternion)', lambda: Quaternion(q)),
+        ('Quaternion * Quaternion', lambda: q * r),
+        ('Quaternion.x', lambda: q.x),
+        ('Quaternion.y', lambda: q.y),
+        ('Quaternion.z', lambda: q.z),
+        ('Quaternion.w', lambda: q.w),
+        ('Quaternion.FromAxisAndDegrees', lambda: Quaternion.FromAxisAndDegrees(axis, 45.0)),
+        ('Quaternion.FromMatrix', lambda: Quaternion.FromMatrix(m)),
+        ('Quaternion.NormalizeBatch', lambda: Quaternion.NormalizeBatch(quats, quat_out)),
+        ('Quaternion.RotateBatch', lambda: Quaternion.RotateBatch(vectors, q, vector_out)),
+        ('Quaternion.RotateBatch each', lambda: Quaternion.RotateBatch(vectors, quats, vector_out)),
+        ('Quaternion.normalize', lambda: q.normalize()),
+        ('Quaternion.slerp', lambda: q.slerp(r, 0.3)),
+        ('Quaternion.nlerp', lambda: q.nlerp(r, 0.3)),
+        ('Quaternion.to_matrix', lambda: q.to_matrix()),
+        ('repr(Quaternion)', lambda: repr(q)),
+
+        ('Matrix4x4()', lambda: Matrix4x4()),
+        ('Matrix4x4 * Matrix4x4', lambda: m * n),
+        ('Matrix4x4.copy', lambda: m.copy()),
+        ('Matrix4x4.transpose', lambda: m.transpose()),
+        ('Matrix4x4.inverse', lambda: m.inverse()),
+        ('Matrix4x4.Fill', lambda: Matrix4x4.Fill(1.0)),
+        ('Matrix4x4.Translation', lambda: Matrix4x4.Translation(a)),
+        ('Matrix4x4.RotationX', lambda: Matrix4x4.RotationX(30.0)),
+        ('Matrix4x4.RotationY', lambda: Matrix4x4.RotationY(30.0)),
+        ('Matrix4x4.RotationZ', lambda: Matrix4x4.RotationZ(30.0)),
+        ('Matrix4x4.RotationAxis', lambda: Matrix4x4.RotationAxis(axis, 30.0)),
+        ('Matrix4x4.RotationQuaternion', lambda: Matrix4x4.RotationQuaternion(q)),
+        ('Matrix4x4.Scaling', lambda: Matrix4x4.Scaling(a)),
+        ('Matrix4x4.LookAtLH', lambda: Matrix4x4.LookAtLH(eye, origin, axis)),
+        ('Matrix4x4.LookAtRH', lambda: Matrix4x4.LookAtRH(eye, origin, axis)),
+        ('Matrix4x4.PerspectiveFovLH', lambda: Matrix4x4.PerspectiveFovLH(60.0, 1.5, 0.1, 100.0)),
+        ('Matrix4x4.PerspectiveFovRH', lambda: Matrix4x4.PerspectiveFovRH(60.0, 1.5, 0.1, 100.0)),
+        ('Matrix4x4.PerspectiveInfiniteReverseZLH', lambda: Matrix4x4.PerspectiveInfiniteReverseZLH(60.0, 1.5, 0.1)),
+        ('Matrix4x4.PerspectiveInfiniteReverseZRH', lambda: Matrix4x4.PerspectiveInfiniteReverseZRH(60.0, 1.5, 0.1)),
+        ('Matrix4x4.OrthographicLH', lambda: Matrix4x4.OrthographicLH(16.0, 9.0, 0.1, 100.0)),
+        ('Matrix4x4.OrthographicRH', lambda: Matrix4x4.OrthographicRH(16.0, 9.0, 0.1, 100.0)),
+        ('Matrix4x4.MultBatch', lambda: Matrix4x4.MultBatch(worlds, m, world_out)),
+        ('repr(Matrix4x4)', lambda: repr(m)),
+    ]
+
+
+def time_run(function, iterations):
+    start = time.perf_counter_ns()
+    for _ in range(iterations):
+        function()
+    return time.perf_counter_ns() - start
+
+
+def allocations_per_op(function, iterations):
+    # Keeping every result alive leaves one block per object each call created and did not free
+    results = [None] * iterations
+    before = sys.getallocatedblocks()
+    for i in range(iterations):
+        results[i] = function()
+    allocations = sys.getallocatedblocks() - before
+    del results
+
+    return max(allocations, 0) / iterations
+
+
+def run_benchmark(function, min_time_ns, repetitions):
+    iterations = 1
+    while True:
+        elapsed = time_run(function, iterations)
+        if elapsed >= min_time_ns:
+            break
+        iterations *= 2
+
+    runs = [elapsed] + [time_run(function, iterations) for _ in range(repetitions - 1)]
+    per_op = [run / iterations for run in runs]
+
+    return iterations, statistics.median(per_op), min(per_op), allocations_per_op(function, min(iterations, 10000))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Microbenchmark the py3dengine.math extension types')
+    parser.add_argument('--filter', default='', help='Only run benchmarks whose name contains this text')
+    parser.add_argument('--min-time', type=float, default=20.0, help='Minimum duration of one run in ms')
+    parser.add_argument('--repetitions', type=int, default=5, help='Number of timed runs per benchmark')
+    args = parser.parse_args()
+
+    if args.repetitions < 1 or args.min_time <= 0.0:
+        parser.error('--repetitions and --min-time must be positive')
+
+    results = []
+    for name, function in make_benchmarks():
+        if args.filter not in name:
+            continue
+
+        iterations, median, fastest, allocations = run_benchmark(
+            function, int(args.min_time * 1000000), args.repetitions
+        )
+        results.append({
+            'name': name,
+            'iterations': iterations,
+            'ns_per_op': round(median, 3),
+            'min_ns_per_op': round(fastest, 3),
+            'allocs_per_op': round(allocations, 3)
+        })
+
+    report = {
+        'suite': 'py3dengine.math',
+        'batch_count': BATCH_COUNT,
+        'repetitions': args.repetitions,
+        'results': results
+    }
+    print(json.dumps(report, indent=2))
+
+
+if __name__ == '__main__':
+    main()
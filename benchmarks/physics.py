@@ -0,0 +1,81 @@
+"""Step a deterministic pile of spheres, boxes and capsules falling onto a static ground box
+
+Runs the scene twice and checks both runs end in exactly the same state.
+
+Usage: python benchmarks/physics.py [body_count] [steps]
+"""
+import hashlib
+import math
+import sys
+import time
+from array import array
+
+from py3dengine.math import PhysicsWorld, Quaternion, Vector3
+from py3dengine.transform import Transform
+
+SHAPES = (
+    ('sphere', Vector3(0.4, 0, 0)),
+    ('box', Vector3(0.4, 0.3, 0.35)),
+    ('capsule', Vector3(0.25, 0.3, 0)),
+)
+
+
+def build_scene(body_count):
+    world = PhysicsWorld()
+    side = math.ceil(math.sqrt(body_count / 10))
+    world.add_body(Transform(Vector3(0, -1, 0)), 'box', Vector3(side + 5, 1, side + 5), 0)
+
+    transforms = []
+    for i in range(body_count):
+        layer, cell = divmod(i, side * side)
+        row, column = divmod(cell, side)
+        axis = Vector3(1, (i % 7) - 3, 1).normalize()
+        transform = Transform(
+            Vector3(column * 2.0 - side + (layer % 2) * 0.3, 1 + layer * 1.5, row * 2.0 - side),
+            Quaternion.FromAxisAndDegrees(axis, (i * 37) % 360)
+        )
+        shape, size = SHAPES[i % len(SHAPES)]
+        world.add_body(transform, shape, size)
+        transforms.append(transform)
+
+    return world, transforms
+
+
+def run(body_count, steps):
+    world, transforms = build_scene(body_count)
+
+    step_times = []
+    write_times = []
+    for _ in range(steps):
+        start = time.perf_counter()
+        world.step(1 / 60)
+        step_times.append(time.perf_counter() - start)
+
+        start = time.perf_counter()
+        world.write_transforms()
+        write_times.append(time.perf_counter() - start)
+
+    state = array('f', bytes((body_count + 1) * 7 * 4))
+    world.copy_state(state)
+
+    return world, step_times, write_times, hashlib.sha1(state.tobytes()).hexdigest()
+
+
+def main():
+    body_count = int(sys.argv[1]) if len(sys.argv) > 1 else 10000
+    steps = int(sys.argv[2]) if len(sys.argv) > 2 else 300
+
+    world, step_times, write_times, digest = run(body_count, steps)
+    _, _, _, second_digest = run(body_count, steps)
+
+    step_times.sort()
+    print(f'{body_count} bodies, {steps} steps of 1/60 s')
+    print(f'{"step ms":<22} mean {sum(step_times) / steps * 1000:.2f}  median {step_times[steps // 2] * 1000:.2f}  '
+          f'max {step_times[-1] * 1000:.2f}')
+    print(f'{"write_transforms ms":<22} mean {sum(write_times) / steps * 1000:.2f}')
+    print(f'{"final pairs/contacts":<22} {world.pair_count} / {world.contact_count}')
+    print(f'{"state sha1":<22} {digest} ({"deterministic" if digest == second_digest else "NOT deterministic"})')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,86 @@
+"""Measure what profiler zones cost, per zone and on a frame that broadcasts an update through a scene
+
+Usage: python benchmarks/profiler.py [node_count] [frames]
+"""
+import sys
+import time
+
+from py3dengine import profiler
+from py3dengine.component import Component
+from py3dengine.gameobject import GameObject
+from py3dengine.message import Message
+from py3dengine.profiler import ProfileZone
+
+
+class PlainComponent(Component):
+    def update(self, delta):
+        self.delta = delta * 2.0
+
+
+class ProfiledComponent(Component):
+    @ProfileZone('ProfiledComponent.update')
+    def update(self, delta):
+        self.delta = delta * 2.0
+
+
+def build_scene(node_count, component_type):
+    scene = GameObject('scene')
+    for i in range(node_count):
+        child = GameObject(f'node_{i}')
+        child.attach_component(component_type('component'))
+        scene.attach_child(child)
+
+    return scene
+
+
+def time_frames(scene, frames):
+    update = Message('update', (1.0 / 60.0,))
+    start = time.perf_counter()
+    for _ in range(frames):
+        with ProfileZone('frame'):
+            scene.receive_message(update)
+        profiler.collect()
+
+    return (time.perf_counter() - start) / frames
+
+
+def time_zone(iterations):
+    zone = ProfileZone('empty')
+    start = time.perf_counter_ns()
+    for _ in range(iterations):
+        with zone:
+            pass
+    elapsed = time.perf_counter_ns() - start
+    profiler.collect()
+
+    return elapsed / iterations
+
+
+def main():
+    node_count = int(sys.argv[1]) if len(sys.argv) > 1 else 10000
+    frames = int(sys.argv[2]) if len(sys.argv) > 2 else 20
+
+    plain = build_scene(node_count, PlainComponent)
+    profiled = build_scene(node_count, ProfiledComponent)
+
+    baseline = time_frames(plain, frames)
+    disabled = time_frames(profiled, frames)
+    profiler.enable()
+    enabled = time_frames(plain, frames)
+    per_component = time_frames(profiled, frames)
+    zone_enabled = time_zone(100000)
+    profiler.disable()
+    zone_disabled = time_zone(100000)
+
+    print(f'{node_count} nodes, {frames} frames')
+    print(f'empty zone disabled        {zone_disabled:>10.1f} ns')
+    print(f'empty zone enabled         {zone_enabled:>10.1f} ns')
+    print(f'frame without zones        {baseline * 1000.0:>10.2f} ms')
+    print(f'frame zone only, enabled   {enabled * 1000.0:>10.2f} ms ({(enabled / baseline - 1.0) * 100.0:+.1f}%)')
+    print(f'zone per update, disabled  {disabled * 1000.0:>10.2f} ms ({(disabled / baseline - 1.0) * 100.0:+.1f}%)')
+    print(f'zone per update, enabled   {per_component * 1000.0:>10.2f} ms '
+          f'({(per_component / baseline - 1.0) * 100.0:+.1f}%)')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,66 @@
+"""Time the software rasterizer drawing a tessellated sphere at several resolutions and thread counts
+
+Usage: python benchmarks/raster.py [sphere_segments] [frames]
+"""
+import math
+import os
+import sys
+import time
+from array import array
+
+from py3dengine.math import Matrix4x4, Rasterizer, Vector3
+
+RESOLUTIONS = ((320, 240), (1280, 720), (1920, 1080))
+
+
+def generate_sphere(segments):
+    rings = segments // 2
+    positions = array('f')
+    for ring in range(rings + 1):
+        theta = math.pi * ring / rings
+        for segment in range(segments + 1):
+            phi = 2.0 * math.pi * segment / segments
+            positions.extend((math.sin(theta) * math.cos(phi), math.cos(theta), math.sin(theta) * math.sin(phi)))
+
+    indices = array('I')
+    for ring in range(rings):
+        for segment in range(segments):
+            a = ring * (segments + 1) + segment
+            b = a + segments + 1
+            indices.extend((a, a + 1, b, a + 1, b + 1, b))
+
+    # Positions on a unit sphere are their own normals
+    return positions, array('f', positions), indices
+
+
+def measure(rasterizer, mvp, positions, normals, indices, frames):
+    start = time.perf_counter()
+    for _ in range(frames):
+        rasterizer.clear()
+        rasterizer.draw(mvp, positions, indices, normals, color=(0.9, 0.6, 0.3), light=Vector3(0.5, 1.0, 1.0))
+
+    return (time.perf_counter() - start) / frames
+
+
+def main():
+    segments = int(sys.argv[1]) if len(sys.argv) > 1 else 256
+    frames = int(sys.argv[2]) if len(sys.argv) > 2 else 20
+
+    positions, normals, indices = generate_sphere(segments)
+    view = Matrix4x4.LookAtRH(Vector3(0.0, 0.0, 2.6), Vector3(0.0, 0.0, 0.0), Vector3(0.0, 1.0, 0.0))
+
+    print(f'Sphere with {len(indices) // 3} triangles, {frames} frames')
+    print(f'{"resolution":<12} {"threads":<8} {"frame ms":>10} {"Mtri/s":>8}')
+    for width, height in RESOLUTIONS:
+        mvp = view * Matrix4x4.PerspectiveFovRH(45.0, width / height, 0.1, 10.0)
+        for threads in sorted({1, os.cpu_count() or 1}):
+            rasterizer = Rasterizer(width, height, threads)
+            elapsed = measure(rasterizer, mvp, positions, normals, indices, frames)
+            print(
+                f'{f"{width}x{height}":<12} {threads:<8} {elapsed * 1000.0:>10.2f} '
+                f'{len(indices) / 3 / elapsed / 1e6:>8.2f}'
+            )
+
+
+if __name__ == '__main__':
+    main()
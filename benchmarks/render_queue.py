@@ -0,0 +1,80 @@
+"""Time submitting, sorting and replaying draw commands, against binding state and drawing every object separately
+
+Usage: python benchmarks/render_queue.py [object_count] [material_count] [mesh_count]
+"""
+import random
+import sys
+import time
+
+from py3dengine.math import Matrix4x4, RenderQueue, Vector3
+from py3dengine.render_queue import RenderBackend
+
+
+class CountingBackend(RenderBackend):
+    def __init__(self):
+        self.calls = 0
+
+    def begin_layer(self, layer, translucent):
+        self.calls += 1
+
+    def bind_material(self, material):
+        self.calls += 1
+
+    def bind_mesh(self, mesh):
+        self.calls += 1
+
+    def draw_instanced(self, instances, count):
+        self.calls += 1
+
+
+def main():
+    object_count = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+    material_count = int(sys.argv[2]) if len(sys.argv) > 2 else 32
+    mesh_count = int(sys.argv[3]) if len(sys.argv) > 3 else 16
+
+    rng = random.Random(5)
+    objects = [
+        (
+            'material{}'.format(rng.randrange(material_count)),
+            'mesh{}'.format(rng.randrange(mesh_count)),
+            Matrix4x4.Translation(Vector3(rng.uniform(-500, 500), rng.uniform(-50, 50), rng.uniform(-500, 500))),
+            rng.random() < 0.1
+        )
+        for _ in range(object_count)
+    ]
+
+    queue = RenderQueue()
+    backend = CountingBackend()
+
+    # The first frame interns the states and grows the buffers
+    for material, mesh, world, translucent in objects:
+        queue.submit(material, mesh, world, translucent=translucent)
+    queue.flush(backend)
+
+    start = time.perf_counter()
+    for material, mesh, world, translucent in objects:
+        queue.submit(material, mesh, world, translucent=translucent)
+    submitted = time.perf_counter()
+    backend.calls = 0
+    queue.flush(backend)
+    flushed = time.perf_counter()
+    commands, batches, state_changes = queue.last_flush
+
+    naive = CountingBackend()
+    naive_start = time.perf_counter()
+    for material, mesh, world, translucent in objects:
+        naive.bind_material(material)
+        naive.bind_mesh(mesh)
+        naive.draw_instanced(world, 1)
+    naive_end = time.perf_counter()
+
+    print(f'{object_count} objects, {material_count} materials, {mesh_count} meshes, 10% translucent')
+    print(f'submit            {(submitted - start) * 1000.0:>10.2f} ms')
+    print(f'sort + replay     {(flushed - submitted) * 1000.0:>10.2f} ms')
+    print(f'batches           {batches:>10} ({commands / max(batches, 1):.1f} instances each)')
+    print(f'backend calls     {backend.calls:>10} ({state_changes} state changes)')
+    print(f'per object calls  {naive.calls:>10} ({(naive_end - naive_start) * 1000.0:.2f} ms without any sorting)')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,99 @@
+"""Compare loading a GameObject hierarchy from JSON against the compiled scene format and binary snapshots
+
+Usage: python benchmarks/scene_load.py [node_count] [fan_out]
+"""
+import json
+import sys
+import tempfile
+import time
+import tracemalloc
+from os import path
+
+from py3dengine.gameobject import compile_scene, _do_import_game_object, _do_import_compiled_game_object
+from py3dengine.snapshot import save_snapshot, restore_snapshot
+
+
+def generate_scene_json(node_count, fan_out):
+    def new_node(index):
+        return {
+            'name': f'node_{index}',
+            'transform': {
+                'position': {'x': float(index), 'y': 0.0, 'z': 0.0},
+                'orientation': {'x': 0.0, 'y': 0.0, 'z': 0.0, 'w': 1.0},
+                'scale': {'x': 1.0, 'y': 1.0, 'z': 1.0},
+            },
+            'components': [],
+            'children': [],
+        }
+
+    root = new_node(0)
+    open_nodes = [root]
+    next_open = 0
+    for i in range(1, node_count):
+        parent = open_nodes[next_open]
+        child = new_node(i)
+        parent['children'].append(child)
+        open_nodes.append(child)
+        if len(parent['children']) == fan_out:
+            next_open += 1
+
+    return root
+
+
+def load_json(file_path):
+    with open(file_path) as f:
+        return _do_import_game_object(json.load(f))
+
+
+def load_compiled(file_path):
+    with open(file_path, 'rb') as f:
+        return _do_import_compiled_game_object(f.read())
+
+
+def measure(loader, file_path):
+    start = time.perf_counter()
+    root = loader(file_path)
+    elapsed = time.perf_counter() - start
+    del root
+
+    tracemalloc.start()
+    root = loader(file_path)
+    _, peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+    del root
+
+    return elapsed, peak
+
+
+def main():
+    node_count = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+    fan_out = int(sys.argv[2]) if len(sys.argv) > 2 else 8
+
+    scene_json = generate_scene_json(node_count, fan_out)
+
+    with tempfile.TemporaryDirectory() as work_dir:
+        json_path = path.join(work_dir, 'scene.json')
+        compiled_path = path.join(work_dir, 'scene.p3dscene')
+
+        with open(json_path, 'w') as f:
+            json.dump(scene_json, f)
+        with open(compiled_path, 'wb') as f:
+            f.write(compile_scene(scene_json))
+        del scene_json
+
+        snapshot_path = path.join(work_dir, 'scene.p3dsnap')
+        save_snapshot(load_compiled(compiled_path), snapshot_path)
+
+        print(f'{node_count} nodes, fan out {fan_out}')
+        print(f'{"format":<10} {"file bytes":>12} {"load ms":>10} {"peak MiB":>10}')
+        for label, loader, file_path in (
+            ('json', load_json, json_path),
+            ('compiled', load_compiled, compiled_path),
+            ('snapshot', restore_snapshot, snapshot_path),
+        ):
+            elapsed, peak = measure(loader, file_path)
+            print(f'{label:<10} {path.getsize(file_path):>12} {elapsed * 1000.0:>10.1f} {peak / (1024 * 1024):>10.1f}')
+
+
+if __name__ == '__main__':
+    main()
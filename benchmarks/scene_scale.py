@@ -0,0 +1,256 @@
+"""Time loading, message broadcast, lookup by name and transform refresh on synthetic scenes of growing size
+
+Usage: python benchmarks/scene_scale.py [--sizes 1000,10000,100000,1000000] [--fan-out n | --depth n]
+                                        [--components n] [--repetitions n] [--output report.json]
+                                        [--compare baseline.json]
+
+Scenes are filled breadth first, every node holding --fan-out children, or as few as give the scene at most --depth
+levels below the root. Every phase is run --repetitions times on each size and reported as its median. The JSON report
+is written to --output, and --compare prints the change of every phase against the report of an earlier commit.
+"""
+import argparse
+import json
+import platform
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+from os import path
+
+from py3dengine import engine
+from py3dengine.component import Component
+from py3dengine.gameobject import compile_scene
+from py3dengine.message import Message
+from py3dengine.resource_import import register_importer
+
+LOOKUP_COUNT = 100
+PHASES = ('load_json', 'load_compiled', 'broadcast', 'lookup_by_name', 'transform_refresh')
+
+
+class BenchComponent(Component):
+    def __init__(self, name):
+        super().__init__(name)
+        self.ticks = 0
+
+    def tick(self, delta):
+        self.ticks += 1
+
+
+def import_bench_component(component_json):
+    return BenchComponent(component_json['name'])
+
+
+register_importer(import_bench_component, 'BenchComponent')
+
+
+def fan_out_for_depth(node_count, depth):
+    """Return the smallest fan out that fits node_count nodes within depth levels below the root"""
+    fan_out = 1
+    while sum(fan_out ** level for level in range(depth + 1)) < node_count:
+        fan_out += 1
+
+    return fan_out
+
+
+def generate_scene_json(node_count, fan_out, components_per_node=0, name='scene'):
+    def new_node(index):
+        return {
+            'name': name if index == 0 else f'node_{index}',
+            'transform': {
+                'position': {'x': float(index % 1000), 'y': float(index // 1000), 'z': 0.0},
+                'orientation': {'x': 0.0, 'y': 0.0, 'z': 0.0, 'w': 1.0},
+                'scale': {'x': 1.0, 'y': 1.0, 'z': 1.0},
+            },
+            'components': [{'type': 'BenchComponent', 'name': f'component_{c}'} for c in range(components_per_node)],
+            'children': [],
+        }
+
+    root = new_node(0)
+    open_nodes = [root]
+    next_open = 0
+    depths = [0]
+    for i in range(1, node_count):
+        parent = open_nodes[next_open]
+        child = new_node(i)
+        parent['children'].append(child)
+        open_nodes.append(child)
+        depths.append(depths[next_open] + 1)
+        if len(parent['children']) == fan_out:
+            next_open += 1
+
+    return root, depths[-1]
+
+
+def collect_nodes(root):
+    nodes = []
+    pending = [root]
+    while pending:
+        node = pending.pop()
+        nodes.append(node)
+        pending.extend(node._children)
+
+    return nodes
+
+
+def time_phase(function, repetitions, before=None):
+    runs = []
+    for _ in range(repetitions):
+        if before is not None:
+            before()
+        start = time.perf_counter()
+        function()
+        runs.append(time.perf_counter() - start)
+
+    return statistics.median(runs), min(runs)
+
+
+def write_scene_files(work_dir, scene_json):
+    json_path = path.join(work_dir, 'scene.json')
+    compiled_path = path.join(work_dir, 'scene.p3dscene')
+    with open(json_path, 'w') as f:
+        json.dump(scene_json, f)
+    with open(compiled_path, 'wb') as f:
+        f.write(compile_scene(scene_json))
+
+    descriptors = {}
+    for scene_format, file_path in (('json', json_path), ('compiled', compiled_path)):
+        descriptor_path = path.join(work_dir, f'{scene_format}.scene')
+        with open(descriptor_path, 'w') as f:
+            json.dump({'file_path': file_path, 'format': scene_format}, f)
+        descriptors[scene_format] = descriptor_path
+
+    return descriptors
+
+
+def run_size(node_count, fan_out, components, repetitions):
+    scene_json, depth = generate_scene_json(node_count, fan_out, components)
+    # Both the importers and the snapshot writer recurse once per level
+    sys.setrecursionlimit(max(sys.getrecursionlimit(), depth * 4 + 1000))
+
+    timings = {}
+    with tempfile.TemporaryDirectory() as work_dir:
+        descriptors = write_scene_files(work_dir, scene_json)
+        del scene_json
+
+        def unload():
+            if 'scene' in engine._scenes:
+                engine.unload_scene('scene')
+
+        for scene_format in ('json', 'compiled'):
+            timings[f'load_{scene_format}'] = time_phase(
+                lambda: engine.load_scene(descriptors[scene_format]), repetitions, unload
+            )
+
+    scene = engine._scenes['scene']
+    nodes = collect_nodes(scene)
+    tick = Message('tick', (1.0 / 60.0,))
+    timings['broadcast'] = time_phase(lambda: scene.receive_message(tick), repetitions)
+
+    # The last nodes are the deepest and the furthest along the depth first search
+    names = [f'node_{node_count - 1 - i * (node_count // LOOKUP_COUNT)}' for i in range(min(LOOKUP_COUNT, node_count))]
+
+    def lookup():
+        for name in names:
+            if scene.get_child_by_name(name) is None:
+                raise RuntimeError(f'"{name}" was not found')
+
+    timings['lookup_by_name'] = time_phase(lookup, repetitions)
+
+    transforms = [node.get_transform for node in nodes]
+
+    def invalidate():
+        for transform in transforms:
+            transform.invalidate_matrices()
+
+    def refresh():
+        for transform in transforms:
+            transform.world_matrix
+
+    timings['transform_refresh'] = time_phase(refresh, repetitions, invalidate)
+    unload()
+
+    results = []
+    for phase in PHASES:
+        median, fastest = timings[phase]
+        per = len(names) if phase == 'lookup_by_name' else node_count
+        results.append({
+            'nodes': node_count,
+            'phase': phase,
+            'ms': round(median * 1000.0, 3),
+            'min_ms': round(fastest * 1000.0, 3),
+            'us_per_item': round(median * 1000000.0 / per, 3),
+        })
+
+    return depth, results
+
+
+def current_commit():
+    try:
+        return subprocess.run(
+            ['git', 'rev-parse', '--short', 'HEAD'], capture_output=True, text=True, check=True,
+            cwd=path.dirname(path.abspath(__file__))
+        ).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def print_comparison(report, baseline):
+    before = {(r['nodes'], r['phase']): r['ms'] for r in baseline['results']}
+    print(f'{"nodes":>9} {"phase":<18} {baseline.get("commit") or "baseline":>12} {report.get("commit") or "current":>12}')
+    for result in report['results']:
+        key = (result['nodes'], result['phase'])
+        if key not in before:
+            continue
+        change = (result['ms'] / before[key] - 1.0) * 100.0 if before[key] else 0.0
+        print(f'{key[0]:>9} {key[1]:<18} {before[key]:>10.2f}ms {result["ms"]:>10.2f}ms {change:>+7.1f}%')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Time scene operations on synthetic scenes of growing size')
+    parser.add_argument('--sizes', default='1000,10000,100000', help='Comma separated node counts')
+    shape = parser.add_mutually_exclusive_group()
+    shape.add_argument('--fan-out', type=int, default=8, help='Children per node')
+    shape.add_argument('--depth', type=int, help='Levels below the root, the fan out is derived from it')
+    parser.add_argument('--components', type=int, default=1, help='Components per node')
+    parser.add_argument('--repetitions', type=int, default=3, help='Number of timed runs per phase')
+    parser.add_argument('--output', help='Write the JSON report to this file')
+    parser.add_argument('--compare', help='Print the change against a JSON report of an earlier run')
+    args = parser.parse_args()
+
+    sizes = [int(size) for size in args.sizes.split(',')]
+    if any(size < 1 for size in sizes) or args.repetitions < 1 or args.components < 0:
+        parser.error('--sizes and --repetitions must be positive and --components must not be negative')
+    if args.depth is not None and args.depth < 1 or args.fan_out < 1:
+        parser.error('--depth and --fan-out must be positive')
+
+    report = {
+        'suite': 'scene_scale',
+        'commit': current_commit(),
+        'python': platform.python_version(),
+        'components': args.components,
+        'repetitions': args.repetitions,
+        'sizes': [],
+        'results': [],
+    }
+
+    print(f'{"nodes":>9} {"phase":<18} {"ms":>10} {"us/item":>10}')
+    for node_count in sizes:
+        fan_out = args.fan_out if args.depth is None else fan_out_for_depth(node_count, args.depth)
+        depth, results = run_size(node_count, fan_out, args.components, args.repetitions)
+        report['sizes'].append({'nodes': node_count, 'fan_out': fan_out, 'depth': depth})
+        report['results'].extend(results)
+        for result in results:
+            print(f'{node_count:>9} {result["phase"]:<18} {result["ms"]:>10.2f} {result["us_per_item"]:>10.3f}')
+
+    if args.output is not None:
+        with open(args.output, 'w') as f:
+            json.dump(report, f, indent=2)
+
+    if args.compare is not None:
+        with open(args.compare) as f:
+            print_comparison(report, json.load(f))
+
+
+if __name__ == '__main__':
+    main()
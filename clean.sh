@@ -1,4 +1,4 @@
-MATH_LIB_CMAKE='py3dengine/math/lib/cmake-build-debug'
+MATH_LIB_CMAKE='py3dengine/math/lib/cmake-build-release'
 MATH_LIB_BUILD='py3dengine/math/extension/build'
 PY3DENGINE_EGG_INFO='py3dengine.egg-info'
 PY3DENGINE_BUILD='build'
@@ -13,16 +13,27 @@ if ! cd $MATH_DIR/lib; then
   exit 1
 fi
 
-mkdir cmake-build-debug
-cmake -S . -B cmake-build-debug
-if ! cd cmake-build-debug; then
-  echo 'Could not cd into cmake folder for math library';
-  exit 1
+# PY3DMATH_ARCH selects a -march tier (x86-64-v2, x86-64-v3, x86-64-v4 or native) for both the library and the
+# extension, PY3DMATH_LTO=OFF builds both without LTO, PY3DMATH_PGO=1 trains the library on its benchmarks and
+# rebuilds it with the recorded profiles
+CMAKE_ARGS="-DCMAKE_BUILD_TYPE=Release -DPY3DMATH_ARCH=$PY3DMATH_ARCH -DPY3DMATH_LTO=${PY3DMATH_LTO-ON}"
+
+mkdir -p cmake-build-release
+if [ "$PY3DMATH_PGO" = '1' ]; then
+  rm -rf cmake-build-release/pgo-profiles
+  cmake -S . -B cmake-build-release $CMAKE_ARGS -DPY3DMATH_PGO=GENERATE || exit 1
+  cmake --build cmake-build-release --target pgo-train || exit 1
+  cmake -S . -B cmake-build-release $CMAKE_ARGS -DPY3DMATH_PGO=USE || exit 1
+else
+  cmake -S . -B cmake-build-release $CMAKE_ARGS -DPY3DMATH_PGO=OFF || exit 1
 fi
 
-make
+if ! cmake --build cmake-build-release; then
+  echo 'Could not build the math library';
+  exit 1
+fi
 
-cd ../../../..
+cd ../../..
 
 $PIP_EXE install py3dengine/math/extension
 $PIP_EXE install .
\ No newline at end of file
@@ -1,3 +1,6 @@
+from time import perf_counter_ns
+
+from py3dengine import message_stats
 from py3dengine.message_handler import MessageHandler
 
 
@@ -14,6 +17,18 @@ class Component(MessageHandler):
     def name(self):
         return self._name
 
+    def get_snapshot_state(self):
+        """Return the state a snapshot stores for this component, plain JSON data without references to other objects"""
+        return None
+
+    @classmethod
+    def from_snapshot_state(cls, name, state):
+        """Create a component from the name and get_snapshot_state result saved in a snapshot
+
+        Components whose constructor takes more than the name, or that return state, override this.
+        """
+        return cls(name)
+
     def bubble_message(self, message):
         """Convenience function for bubbling the message up to the owning GameObject"""
         if self._owner is None:
@@ -39,7 +54,11 @@ class Component(MessageHandler):
         return self._message_type_accept_by_default
 
     def receive_message(self, message):
-        if not self.accept_message(message):
+        accepted = self.accept_message(message)
+        if message_stats.enabled:
+            message_stats.record_delivery(message.name, accepted)
+
+        if not accepted:
             return
 
         if message.data is None:
@@ -50,4 +69,12 @@ class Component(MessageHandler):
             except TypeError:
                 args = (message.data,)
 
-        getattr(self, message.name)(*args)
+        if not message_stats.enabled:
+            getattr(self, message.name)(*args)
+            return
+
+        start = perf_counter_ns()
+        try:
+            getattr(self, message.name)(*args)
+        finally:
+            message_stats.record_handler(message.name, perf_counter_ns() - start)
@@ -1,17 +1,37 @@
 from typing import Dict
 
-from core import get_importer
+from py3dengine.resource_import import (
+    get_importer, set_shared_resource_manager, collect_resource_handles, release_resources, ResourceImportError
+)
+from py3dengine.resource_manager import ResourceManager
 from py3dengine.gameobject import GameObject
 from py3dengine.message import Message
+from py3dengine.snapshot import save_snapshot, restore_snapshot, SnapshotError
+from py3dengine.streaming import import_world_partition, StreamingController
+from py3dengine.transform import Transform
 
 _scenes: Dict[str, GameObject] = {}
 _active_scene: GameObject | None = None
+_resource_manager: ResourceManager | None = None
+_scene_resources: Dict[str, list] = {}
+_scene_controllers: Dict[str, StreamingController] = {}
 
 
 class SceneError(Exception):
     pass
 
 
+def get_resource_manager():
+    """Return the ResourceManager shared by every loaded scene, so identical resources are only loaded once"""
+    global _resource_manager
+
+    if _resource_manager is None:
+        _resource_manager = ResourceManager()
+        set_shared_resource_manager(_resource_manager)
+
+    return _resource_manager
+
+
 def register_event_generator():
     pass
 
@@ -27,8 +47,8 @@ def load_scene(path):
         raise SceneError(err)
 
     try:
-        root_go: GameObject = importer(descriptor_file)
-    except OSError as err:
+        root_go, resource_handles = _load_with_resources(importer, descriptor_file)
+    except (OSError, ResourceImportError) as err:
         raise SceneError(err)
     except ValueError as err:
         raise SceneError(err)
@@ -38,9 +58,69 @@ def load_scene(path):
         raise SceneError(err)
     descriptor_file.close()
 
+    _add_scene(root_go, resource_handles)
+
+
+def save_scene_snapshot(name, path):
+    """Write a loaded scene to a binary snapshot that load_scene_snapshot can restore without running importers"""
+    if name not in _scenes.keys():
+        raise SceneError(f'Cannot save scene "{name}", scene is not loaded')
+
+    try:
+        save_snapshot(_scenes[name], path)
+    except (OSError, SnapshotError) as err:
+        raise SceneError(err)
+
+
+def load_scene_snapshot(path):
+    try:
+        root_go, resource_handles = _load_with_resources(restore_snapshot, path)
+    except (SnapshotError, ResourceImportError) as err:
+        raise SceneError(err)
+
+    _add_scene(root_go, resource_handles)
+
+
+def load_streaming_scene(path, load_radius, unload_radius=None):
+    """Load a world partition descriptor as an empty scene and return the StreamingController that fills it
+
+    The caller drives streaming by calling update on the controller with the current focus point. Unloading the
+    scene shuts the controller down, which unloads its resident chunks and releases their resources.
+    """
+    try:
+        with open(path) as descriptor_file:
+            partition = import_world_partition(descriptor_file)
+    except (OSError, ValueError, TypeError, KeyError) as err:
+        raise SceneError(err)
+
+    root_go = GameObject(partition.name)
+    root_go._transform = Transform()
+    _add_scene(root_go)
+    controller = StreamingController(root_go, partition, load_radius, unload_radius)
+    _scene_controllers[root_go.name] = controller
+
+    return controller
+
+
+def _load_with_resources(loader, *args):
+    # Resources the scene's importers load go through the shared manager and are owned by the scene
+    get_resource_manager()
+    with collect_resource_handles() as resource_handles:
+        try:
+            return loader(*args), resource_handles
+        except BaseException:
+            release_resources(resource_handles)
+            raise
+
+
+def _add_scene(root_go, resource_handles=()):
+    global _scenes
+
     if root_go.name in _scenes.keys():
+        release_resources(resource_handles)
         raise SceneError(f'Cannot load scene "{root_go.name}", scene already loaded')
     _scenes[root_go.name] = root_go
+    _scene_resources[root_go.name] = list(resource_handles)
 
     root_go.receive_message(Message('loading'))
 
@@ -51,8 +131,14 @@ def unload_scene(name):
     if name not in _scenes.keys():
         raise SceneError(f'Cannot unload scene "{name}", scene is not loaded')
 
+    # Chunks are detached first so they only get the "unloading" message once
+    controller = _scene_controllers.pop(name, None)
+    if controller is not None:
+        controller.shutdown()
+
     _scenes[name].receive_message(Message('unloading'))
     del _scenes[name]
+    release_resources(_scene_resources.pop(name))
 
 
 def activate_scene(scene: GameObject):
@@ -1,4 +1,7 @@
 import json
+import struct
+from array import array
+from py3dengine import message_stats
 from py3dengine.resource_import import register_importer, get_importer
 from py3dengine.transform import Transform
 from py3dengine.json_util import fetch_property, fetch_optional_property
@@ -41,7 +44,11 @@ class GameObject(Nameable, MessageHandler):
 
     def receive_message(self, message):
         """Process a message, then propagate based on message settings"""
-        if not self.accept_message(message):
+        accepted = self.accept_message(message)
+        if message_stats.enabled:
+            message_stats.record_delivery(message.name, accepted)
+
+        if not accepted:
             return
 
         for component in self._components:
@@ -51,7 +58,7 @@ class GameObject(Nameable, MessageHandler):
             return
 
         for child in self._children:
-            child.receive_message(child)
+            child.receive_message(message)
 
     def accept_message(self, message):
         if message.name in self._message_type_white_list:
@@ -103,7 +110,7 @@ class GameObject(Nameable, MessageHandler):
             raise ValueError('Child is already attached')
 
         self._components.append(new_component)
-        new_component.owner = new_component
+        new_component._owner = self
         # TODO: emit event?
 
     def detach_component(self, component):
@@ -111,7 +118,7 @@ class GameObject(Nameable, MessageHandler):
             raise ValueError('Component is not attached and cannot be detached')
 
         self._components.remove(component)
-        component.owner = None
+        component._owner = None
 
     def get_component_by_type(self, component_type: type):
         for c in self._components:
@@ -137,9 +144,34 @@ class GameObject(Nameable, MessageHandler):
         return len(self._components)
 
 
+COMPILED_SCENE_MAGIC = b'P3DC'
+COMPILED_SCENE_VERSION = 2
+_TRANSFORM_FLOATS = 10
+# magic, version, byte order mark, node count, then (offset, size) for each block
+_COMPILED_HEADER = struct.Struct('=4sIII' + 'QQ' * 7)
+_BYTE_ORDER_MARK = 0x01020304
+
+
 def import_game_object(descriptor):
     description = json.load(descriptor)
     file_path = description['file_path']
+    scene_format = fetch_optional_property(description, 'format', str, 'json')
+
+    return load_game_object_file(file_path, scene_format)
+
+
+def load_game_object_file(file_path, scene_format='json'):
+    if scene_format == 'compiled':
+        with open(file_path, 'rb') as resource_file:
+            compiled_scene = resource_file.read()
+
+        try:
+            return _do_import_compiled_game_object(compiled_scene)
+        except ValueError as err:
+            raise ValueError(f'"{file_path}" is not a valid compiled scene', err)
+
+    if scene_format != 'json':
+        raise ValueError(f'Unknown scene format "{scene_format}"')
 
     resource_file = open(file_path)
     game_object_json = json.load(resource_file)
@@ -184,4 +216,244 @@ def _do_import_game_object(game_object_json):
     return new_go
 
 
-register_importer(GameObject, import_game_object)
+def compile_scene(game_object_json):
+    """Flatten a GameObject JSON description into the compiled scene format
+
+    All validation happens here so loading a compiled scene is a single pass over flat columns in pre-order. The
+    result is a header (magic, version, byte order mark, node count, then the offset and size of every block) followed
+    by the blocks: name offsets (uint32) into a utf-8 string table, child counts (uint32), transforms (10 float32
+    each), filter table indices (uint32), component counts (uint32), then one JSON document holding the filter table
+    and the (type name, component json) pairs.
+
+    Components deliberately keep their JSON dicts: component importers are registered per type and only understand
+    JSON, so a fixed binary layout would need a schema for every component type. Only the per-node columns are
+    packed, since they make up most of a large scene.
+    """
+    name_offsets = array('I', [0])
+    names = bytearray()
+    child_counts = array('I')
+    transforms = array('f')
+    filters = []
+    filter_ids = array('I')
+    filter_lookup = {}
+    component_counts = array('I')
+    components = []
+
+    pending = [game_object_json]
+    while len(pending) > 0:
+        node = pending.pop()
+
+        names.extend(fetch_property(node, 'name', str).encode('utf-8'))
+        name_offsets.append(len(names))
+
+        transform_json = fetch_property(node, 'transform', dict)
+        transforms.extend(_transform_json_floats(transform_json))
+
+        node_filter = (
+            tuple(fetch_optional_property(node, 'msg_white_list', list, [])),
+            tuple(fetch_optional_property(node, 'msg_black_list', list, [])),
+            fetch_optional_property(node, 'accept_msgs', bool, True),
+        )
+        if node_filter not in filter_lookup.keys():
+            filter_lookup[node_filter] = len(filters)
+            filters.append(node_filter)
+        filter_ids.append(filter_lookup[node_filter])
+
+        node_components = fetch_property(node, 'components', list)
+        for component_json in node_components:
+            components.append((fetch_property(component_json, 'type', str), component_json))
+        component_counts.append(len(node_components))
+
+        children = fetch_property(node, 'children', list)
+        child_counts.append(len(children))
+        pending.extend(reversed(children))
+
+    blocks = (
+        name_offsets.tobytes(),
+        bytes(names),
+        child_counts.tobytes(),
+        transforms.tobytes(),
+        filter_ids.tobytes(),
+        component_counts.tobytes(),
+        json.dumps([filters, components], separators=(',', ':')).encode('utf-8'),
+    )
+
+    # Blocks start 4 byte aligned so the uint32 and float32 columns can be cast in place
+    parts = [b'']
+    layout = []
+    offset = _COMPILED_HEADER.size
+    for block in blocks:
+        padding = -offset % 4
+        parts.append(b'\0' * padding + block)
+        offset += padding
+        layout.extend((offset, len(block)))
+        offset += len(block)
+
+    parts[0] = _COMPILED_HEADER.pack(
+        COMPILED_SCENE_MAGIC, COMPILED_SCENE_VERSION, _BYTE_ORDER_MARK, len(child_counts), *layout
+    )
+
+    return b''.join(parts)
+
+
+def compile_scene_file(json_path, compiled_path):
+    with open(json_path) as json_file:
+        game_object_json = json.load(json_file)
+
+    compiled_scene = compile_scene(game_object_json)
+
+    with open(compiled_path, 'wb') as compiled_file:
+        compiled_file.write(compiled_scene)
+
+
+def _transform_json_floats(transform_json):
+    position = fetch_property(transform_json, 'position', dict)
+    orientation = fetch_property(transform_json, 'orientation', dict)
+    scale = fetch_property(transform_json, 'scale', dict)
+
+    return (
+        float(position['x']), float(position['y']), float(position['z']),
+        float(orientation['x']), float(orientation['y']), float(orientation['z']), float(orientation['w']),
+        float(scale['x']), float(scale['y']), float(scale['z']),
+    )
+
+
+def _do_import_compiled_game_object(compiled_scene):
+    """Rebuild the GameObjects of compile_scene output, raises ValueError when the data is not a valid compiled scene"""
+    names, child_counts, transforms, filters, filter_ids, component_counts, components = _read_compiled_scene(
+        compiled_scene
+    )
+
+    component_importers = {}
+    from_floats = Transform.from_floats
+
+    root = None
+    open_parents = []
+    next_component = 0
+    for i, name in enumerate(names):
+        new_go = GameObject(name)
+
+        white_list, black_list, accept = filters[filter_ids[i]]
+        new_go._message_type_white_list = list(white_list)
+        new_go._message_type_black_list = list(black_list)
+        new_go._message_type_accept_by_default = accept
+
+        offset = i * _TRANSFORM_FLOATS
+        new_go._transform = from_floats(transforms[offset:offset + _TRANSFORM_FLOATS])
+
+        for type_name, component_json in components[next_component:next_component + component_counts[i]]:
+            component_importer = component_importers.get(type_name)
+            if component_importer is None:
+                component_importer = get_importer(type_name)
+                component_importers[type_name] = component_importer
+
+            new_component = component_importer(component_json)
+            new_component._owner = new_go
+            new_go._components.append(new_component)
+        next_component += component_counts[i]
+
+        if len(open_parents) > 0:
+            parent_entry = open_parents[-1]
+            new_go._parent = parent_entry[0]
+            parent_entry[0]._children.append(new_go)
+            parent_entry[1] -= 1
+            if parent_entry[1] == 0:
+                open_parents.pop()
+        elif root is None:
+            root = new_go
+        else:
+            raise ValueError('Compiled scene has more than one root GameObject')
+
+        if child_counts[i] > 0:
+            open_parents.append([new_go, child_counts[i]])
+
+    if root is None or len(open_parents) > 0:
+        raise ValueError('Compiled scene hierarchy is truncated')
+
+    return root
+
+
+def _read_compiled_scene(compiled_scene):
+    view = memoryview(compiled_scene)
+    if len(view) < _COMPILED_HEADER.size:
+        raise ValueError('Compiled scene is truncated')
+
+    magic, version, byte_order_mark, node_count, *layout = _COMPILED_HEADER.unpack_from(view)
+    if magic != COMPILED_SCENE_MAGIC:
+        raise ValueError('Compiled scene has the wrong magic number')
+    if version != COMPILED_SCENE_VERSION:
+        raise ValueError(f'Compiled scene version {version} is not supported, expected {COMPILED_SCENE_VERSION}')
+    if byte_order_mark != _BYTE_ORDER_MARK:
+        raise ValueError('Compiled scene was written on a machine with a different byte order')
+    if node_count == 0:
+        raise ValueError('Compiled scene contains no GameObjects')
+
+    blocks = []
+    for offset, size in zip(layout[0::2], layout[1::2]):
+        if offset + size > len(view):
+            raise ValueError('Compiled scene is truncated')
+        blocks.append(view[offset:offset + size])
+
+    try:
+        name_offsets = blocks[0].cast('I')
+        child_counts = blocks[2].cast('I')
+        transforms = blocks[3].cast('f')
+        filter_ids = blocks[4].cast('I')
+        component_counts = blocks[5].cast('I')
+    except TypeError:
+        raise ValueError('Compiled scene blocks are not whole columns')
+
+    if (
+        len(name_offsets) != node_count + 1 or
+        len(child_counts) != node_count or
+        len(transforms) != node_count * _TRANSFORM_FLOATS or
+        len(filter_ids) != node_count or
+        len(component_counts) != node_count
+    ):
+        raise ValueError('Compiled scene blocks do not match its node count')
+
+    # Every node but the root is somebody's child
+    if sum(child_counts) != node_count - 1:
+        raise ValueError('Compiled scene child counts do not add up to its node count')
+
+    try:
+        filters, components = json.loads(str(blocks[6], 'utf-8'))
+    except (TypeError, ValueError):
+        raise ValueError('Compiled scene has a malformed component block')
+
+    if name_offsets[-1] != len(blocks[1]) or any(a > b for a, b in zip(name_offsets, name_offsets[1:])):
+        raise ValueError('Compiled scene name offsets do not fit its string table')
+
+    if not isinstance(filters, list) or any(
+        not isinstance(f, list) or len(f) != 3 or not isinstance(f[0], list) or not isinstance(f[1], list) or
+        not isinstance(f[2], bool) for f in filters
+    ):
+        raise ValueError('Compiled scene has a malformed filter table')
+    if any(filter_id >= len(filters) for filter_id in filter_ids):
+        raise ValueError('Compiled scene refers to a filter that is not in its filter table')
+
+    if not isinstance(components, list) or sum(component_counts) != len(components):
+        raise ValueError('Compiled scene component counts do not match its components')
+    if any(
+        not isinstance(c, list) or len(c) != 2 or not isinstance(c[0], str) or not isinstance(c[1], dict)
+        for c in components
+    ):
+        raise ValueError('Compiled scene has a malformed component entry')
+
+    # Offsets count utf-8 bytes, so names are cut from the encoded table before decoding
+    encoded_names = bytes(blocks[1])
+    try:
+        names = [str(encoded_names[name_offsets[i]:name_offsets[i + 1]], 'utf-8') for i in range(node_count)]
+    except UnicodeDecodeError:
+        raise ValueError('Compiled scene has a malformed name')
+
+    transform_floats = array('f')
+    transform_floats.frombytes(blocks[3])
+
+    return (
+        names, child_counts.tolist(), transform_floats, filters, filter_ids.tolist(), component_counts.tolist(),
+        components
+    )
+
+
+register_importer(import_game_object, GameObject)
@@ -0,0 +1,114 @@
+import sys
+import time
+
+from py3dengine import profiler
+from py3dengine.math import MemoryTracker
+
+
+def scene_memory(root):
+    """Return {nodes, components, bytes} of the GameObject tree under root
+
+    Bytes are approximate: they add up the shallow sizes of every GameObject, Component and Transform, their attribute
+    dicts and child and component lists, and the math values and cached matrices of the transforms. Objects a
+    component merely references, such as resources held by a ResourceManager, are not included.
+    """
+    nodes = 0
+    components = 0
+    total = 0
+
+    pending = [root]
+    while pending:
+        node = pending.pop()
+        nodes += 1
+        total += _object_size(node) + sys.getsizeof(node._children) + sys.getsizeof(node._components)
+
+        transform = node.get_transform
+        if transform is not None:
+            total += _object_size(transform)
+            total += sys.getsizeof(transform.position) + sys.getsizeof(transform.orientation)
+            total += sys.getsizeof(transform.scale)
+            for matrix in (transform._w_mtx, transform._wit_mtx):
+                if matrix is not None:
+                    total += sys.getsizeof(matrix)
+
+        for component in node._components:
+            components += 1
+            total += _object_size(component)
+
+        pending.extend(node._children)
+
+    return {'nodes': nodes, 'components': components, 'bytes': total}
+
+
+def _object_size(obj):
+    size = sys.getsizeof(obj)
+    attributes = getattr(obj, '__dict__', None)
+    if attributes is not None:
+        size += sys.getsizeof(attributes)
+
+    return size
+
+
+def memory_usage(scene=None, resource_manager=None):
+    """Return one report of the live math objects, and of the scene and resources when they are passed
+
+    The report is {'math': MemoryTracker.Stats(), 'scene': scene_memory(scene), 'resources': the resource manager's
+    get_memory_report()}, without the keys of whatever was not passed.
+    """
+    report = {'math': MemoryTracker.Stats()}
+    if scene is not None:
+        report['scene'] = scene_memory(scene)
+    if resource_manager is not None:
+        report['resources'] = resource_manager.get_memory_report()
+
+    return report
+
+
+def sample_memory(scene=None, resource_manager=None):
+    """Record the memory usage as profiler counter samples, one track per math type plus scene and resources
+
+    Does nothing while the profiler is disabled. Returns the sampled report, or None when nothing was recorded.
+    """
+    if not profiler.is_enabled():
+        return None
+
+    report = memory_usage(scene, resource_manager)
+    for type_name, stats in report['math'].items():
+        profiler.record_counter(f'memory.{type_name}', live=stats['live'], bytes=stats['live_bytes'])
+
+    if 'scene' in report:
+        scene_report = report['scene']
+        profiler.record_counter('memory.scene', nodes=scene_report['nodes'], bytes=scene_report['bytes'])
+
+    if 'resources' in report:
+        resources = report['resources']
+        profiler.record_counter('memory.resources', referenced=resources['referenced_bytes'],
+                                unreferenced=resources['unreferenced_bytes'])
+
+    return report
+
+
+class MemorySampler:
+    """MemorySampler: Samples memory usage into the profiler at most once per interval
+
+    Call tick() once per frame. Walking a large scene is not free, so the interval should be seconds rather than
+    frames.
+    """
+
+    def __init__(self, interval=1.0, scene=None, resource_manager=None):
+        self.interval = float(interval)
+        self.scene = scene
+        self.resource_manager = resource_manager
+        self._next_sample = 0.0
+
+    def tick(self):
+        """Sample when the interval has passed since the last sample, returns the report or None"""
+        now = time.monotonic()
+        if now < self._next_sample:
+            return None
+
+        report = sample_memory(self.scene, self.resource_manager)
+        if report is not None:
+            self._next_sample = now + self.interval
+
+        return report
@@ -0,0 +1,104 @@
+import atexit
+import sys
+
+# Read by GameObject and Component on every delivery, statistics cost one attribute check while disabled
+enabled = False
+
+_stats = {}
+_dump_registered = False
+
+
+class MessageTypeStats:
+    """MessageTypeStats: Dispatch counters of one message name
+
+    deliveries counts every GameObject and Component a message was passed to, filtered the ones whose accept_message
+    turned it away (including Components without a handler method), handlers the handler methods that were called and
+    handler_ns the time spent inside them. A handler that sends another message includes that message's handler time.
+    """
+
+    __slots__ = ('deliveries', 'filtered', 'handlers', 'handler_ns')
+
+    def __init__(self):
+        self.deliveries = 0
+        self.filtered = 0
+        self.handlers = 0
+        self.handler_ns = 0
+
+    def as_dict(self):
+        return {
+            'deliveries': self.deliveries,
+            'filtered': self.filtered,
+            'handlers': self.handlers,
+            'handler_ns': self.handler_ns,
+        }
+
+
+def enable():
+    global enabled
+
+    enabled = True
+
+
+def disable():
+    global enabled
+
+    enabled = False
+
+
+def reset():
+    _stats.clear()
+
+
+def _get(name):
+    stats = _stats.get(name)
+    if stats is None:
+        stats = _stats[name] = MessageTypeStats()
+
+    return stats
+
+
+def record_delivery(name, accepted):
+    stats = _get(name)
+    stats.deliveries += 1
+    if not accepted:
+        stats.filtered += 1
+
+
+def record_handler(name, elapsed_ns):
+    stats = _get(name)
+    stats.handlers += 1
+    stats.handler_ns += elapsed_ns
+
+
+def get_message_stats(name=None):
+    """Return a copy of the counters of one message name as a dict, or of every recorded name as {name: dict}"""
+    if name is not None:
+        stats = _stats.get(name)
+        return MessageTypeStats().as_dict() if stats is None else stats.as_dict()
+
+    return {message_name: stats.as_dict() for message_name, stats in _stats.items()}
+
+
+def dump(destination=None):
+    """Write a table of every recorded message name to destination (stderr by default), most handler time first"""
+    if destination is None:
+        destination = sys.stderr
+
+    lines = [f'{"message":<24} {"deliveries":>12} {"filtered":>12} {"handlers":>12} {"handler ms":>12}']
+    for name, stats in sorted(_stats.items(), key=lambda item: item[1].handler_ns, reverse=True):
+        lines.append(
+            f'{name:<24} {stats.deliveries:>12} {stats.filtered:>12} {stats.handlers:>12} '
+            f'{stats.handler_ns / 1000000.0:>12.3f}'
+        )
+    destination.write('\n'.join(lines) + '\n')
+
+
+def dump_on_exit(destination=None):
+    """Dump the statistics when the interpreter shuts down, calling this more than once registers a single dump"""
+    global _dump_registered
+
+    if _dump_registered:
+        return
+
+    atexit.register(dump, destination)
+    _dump_registered = True
@@ -0,0 +1,108 @@
+from py3dengine.math import SweepAndPrune
+from py3dengine.message import Message
+
+OVERLAP_BEGAN = 'overlap_began'
+OVERLAP_ENDED = 'overlap_ended'
+
+
+class _TrackedBounds:
+    __slots__ = ('proxy', 'min', 'max', 'dynamic')
+
+    def __init__(self, proxy, min_bounds, max_bounds, dynamic):
+        self.proxy = proxy
+        self.min = min_bounds
+        self.max = max_bounds
+        self.dynamic = dynamic
+
+
+class OverlapTracker:
+    """OverlapTracker: Finds which tracked GameObjects' bounds started or stopped overlapping and reports it as Messages
+
+    Every tracked GameObject has a local AABB that its transform's world matrix moves on each update. Pairs are kept by
+    an incremental sweep and prune broadphase, so an update costs as much as the bounds that moved past each other
+    instead of every pair in the scene.
+
+    Events are batched per update: a GameObject whose overlaps changed receives at most one 'overlap_ended' and then one
+    'overlap_began' Message, each carrying a tuple of the other GameObjects, so a Component handles a whole frame of
+    changes in one call of overlap_began(self, others). The Messages do not propagate to children.
+    """
+
+    def __init__(self):
+        self._broadphase = SweepAndPrune()
+        self._tracked = {}
+
+    def track(self, game_object, min_bounds, max_bounds, dynamic=True):
+        """Start tracking a GameObject's local bounds, static objects are only placed once"""
+        if game_object in self._tracked:
+            raise ValueError('GameObject is already tracked')
+
+        world = _world_matrix(game_object)
+        if world is None:
+            proxy = self._broadphase.insert(game_object, min_bounds, max_bounds)
+        else:
+            proxy = self._broadphase.insert(game_object, min_bounds, max_bounds, world)
+
+        self._tracked[game_object] = _TrackedBounds(proxy, min_bounds, max_bounds, bool(dynamic))
+
+    def untrack(self, game_object):
+        """Stop tracking a GameObject, its overlaps end on the next update"""
+        try:
+            tracked = self._tracked.pop(game_object)
+        except KeyError:
+            raise ValueError('GameObject is not tracked')
+
+        self._broadphase.remove(tracked.proxy)
+
+    def set_bounds(self, game_object, min_bounds, max_bounds):
+        tracked = self._tracked.get(game_object)
+        if tracked is None:
+            raise ValueError('GameObject is not tracked')
+
+        tracked.min = min_bounds
+        tracked.max = max_bounds
+        self._move(game_object, tracked)
+
+    def is_tracked(self, game_object):
+        return game_object in self._tracked
+
+    def get_tracked_count(self):
+        return len(self._tracked)
+
+    def get_overlaps(self):
+        """Every overlapping (GameObject, GameObject) pair as of the last update"""
+        return self._broadphase.get_pairs()
+
+    def update(self):
+        """Move dynamic bounds to their GameObjects' current transforms and deliver the overlap Messages"""
+        for game_object, tracked in self._tracked.items():
+            if tracked.dynamic:
+                self._move(game_object, tracked)
+
+        began, ended = self._broadphase.update_pairs()
+
+        _deliver(OVERLAP_ENDED, ended)
+        _deliver(OVERLAP_BEGAN, began)
+
+        return len(began), len(ended)
+
+    def _move(self, game_object, tracked):
+        world = _world_matrix(game_object)
+        if world is None:
+            self._broadphase.update(tracked.proxy, tracked.min, tracked.max)
+        else:
+            self._broadphase.update(tracked.proxy, tracked.min, tracked.max, world)
+
+
+def _world_matrix(game_object):
+    transform = game_object.get_transform
+    return None if transform is None else transform.world_matrix
+
+
+def _deliver(message_name, pairs):
+    others = {}
+    for a, b in pairs:
+        others.setdefault(a, []).append(b)
+        others.setdefault(b, []).append(a)
+
+    for game_object, objects in others.items():
+        game_object.receive_message(Message(message_name, (tuple(objects),), propagate=False))
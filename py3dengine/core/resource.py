@@ -1,3 +1,22 @@
+import sys
+
+
 class Resource:
     def __init__(self, name):
         self._name = name
+
+    @property
+    def name(self):
+        return self._name
+
+    @property
+    def size(self):
+        """Number of bytes this resource holds, used by the ResourceManager to enforce its memory budget
+
+        Resource types that own large buffers (meshes, textures, scripts) should override this.
+        """
+        return sys.getsizeof(self)
+
+    def unload(self):
+        """Called by the ResourceManager when this resource is evicted or removed"""
+        pass
@@ -1,4 +1,11 @@
+import threading
+from contextlib import contextmanager
+from hashlib import blake2b
+
 _importers = {}
+_shared_resource_manager = None
+_shared_resource_lock = threading.Lock()
+_collected_handles = threading.local()
 
 
 class ResourceImportError(Exception):
@@ -20,3 +27,83 @@ def register_importer(_func=None, obj_type=None):
 def get_importer(obj_type):
     if obj_type not in _importers.keys():
         raise ValueError(f'An importer for type \'{obj_type.__name__}\' is not registered')
+
+    return _importers[obj_type]
+
+
+def hash_content(data):
+    """Return the content address used to deduplicate resources loaded from identical bytes"""
+    return blake2b(data, digest_size=16).hexdigest()
+
+
+def import_shared_resource(resource_manager, path, obj_type):
+    """Import the resource file at path, sharing an already stored resource if one was loaded from identical content
+
+    The importer registered for obj_type is called as importer(path, data) with the raw file contents, and only when
+    no stored resource has the same content hash. Returns a handle holding one reference to the resource.
+    """
+    try:
+        with open(path, 'rb') as resource_file:
+            data = resource_file.read()
+    except OSError as err:
+        raise ResourceImportError(err)
+
+    content_hash = hash_content(data)
+
+    handle = resource_manager.get_handle_by_content_hash(content_hash)
+    if handle is not None:
+        return resource_manager.alias_resource(handle, path)
+
+    if resource_manager.get_handle_by_name(path) is not None:
+        raise ResourceImportError(f'Resource "{path}" is already stored with different content')
+
+    importer = get_importer(obj_type)
+    resource = importer(path, data)
+
+    return resource_manager.store_resource(resource, content_hash)
+
+
+def set_shared_resource_manager(resource_manager):
+    """Make import_resource store into resource_manager, the engine installs the manager every scene shares here"""
+    global _shared_resource_manager
+
+    _shared_resource_manager = resource_manager
+
+
+def import_resource(path, obj_type):
+    """Import a resource file through the shared resource manager, for importers of components that use resources
+
+    Scenes importing identical content get handles to one shared resource. While collect_resource_handles is active
+    on the calling thread the reference is owned by the scene being loaded and released when it is unloaded,
+    otherwise the caller releases it with release_resources. Streaming worker threads may call this concurrently.
+    """
+    if _shared_resource_manager is None:
+        raise ResourceImportError('No shared resource manager has been set')
+
+    with _shared_resource_lock:
+        handle = import_shared_resource(_shared_resource_manager, path, obj_type)
+
+    handles = getattr(_collected_handles, 'handles', None)
+    if handles is not None:
+        handles.append(handle)
+
+    return handle
+
+
+def release_resources(handles):
+    """Give back one reference of every handle returned by import_resource"""
+    with _shared_resource_lock:
+        for handle in handles:
+            _shared_resource_manager.release_resource(handle)
+
+
+@contextmanager
+def collect_resource_handles():
+    """Collect the handles import_resource returns on this thread into the yielded list, while loading a scene"""
+    previous = getattr(_collected_handles, 'handles', None)
+    handles = []
+    _collected_handles.handles = handles
+    try:
+        yield handles
+    finally:
+        _collected_handles.handles = previous
@@ -1,14 +1,291 @@
-class ResourceManager:
+from collections import OrderedDict
+
+from py3dengine.config import get_config_value_or_default
+
+MEMORY_BUDGET_CONFIG_KEY = 'resource_memory_budget'
+
+
+class ResourceHandle:
+    """ResourceHandle: A generation checked reference to a slot in a ResourceManager
+
+    When a slot is vacated its generation is incremented, so handles to the old occupant are detected as stale
+    instead of silently resolving to whatever resource was stored there next.
+    """
+
+    __slots__ = ('_index', '_generation')
+
+    def __init__(self, index, generation):
+        self._index = index
+        self._generation = generation
+
+    @property
+    def index(self):
+        return self._index
+
+    @property
+    def generation(self):
+        return self._generation
+
+    def __eq__(self, other):
+        if not isinstance(other, ResourceHandle):
+            return NotImplemented
+
+        return self._index == other._index and self._generation == other._generation
+
+    def __hash__(self):
+        return hash((self._index, self._generation))
+
+    def __repr__(self):
+        return f'ResourceHandle({self._index}, {self._generation})'
+
+
+class _Slot:
+    __slots__ = ('resource', 'generation', 'ref_count', 'size', 'names', 'content_hash')
+
     def __init__(self):
+        self.resource = None
+        self.generation = 0
+        self.ref_count = 0
+        self.size = 0
+        self.names = []
+        self.content_hash = None
+
+
+class ResourceManager:
+    """ResourceManager: Owns resources and evicts unreferenced ones to stay within a memory budget
+
+    Resources are addressed through ResourceHandles. Every handle returned by store_resource or acquire_resource
+    carries one reference that must be given back with release_resource. Resources with no references are kept
+    around in least recently used order and are only evicted when the memory budget is exceeded.
+
+    Resources stored with a content hash are deduplicated: storing or aliasing identical content under another name
+    shares the slot that already holds it instead of keeping a second copy.
+
+    The memory budget is read from the "resource_memory_budget" config value (in bytes) unless one is passed in.
+    A budget of None means resources are never evicted.
+    """
+
+    def __init__(self, memory_budget=None):
+        if memory_budget is None:
+            memory_budget = get_config_value_or_default(MEMORY_BUDGET_CONFIG_KEY)
+
+        self._slots = []
+        self._free_slots = []
         self._store = {}
+        self._content_index = {}
+        self._lru = OrderedDict()
+        self._memory_used = 0
+        self._memory_budget = None if memory_budget is None else int(memory_budget)
+
+    @property
+    def memory_used(self):
+        return self._memory_used
+
+    @property
+    def memory_budget(self):
+        return self._memory_budget
+
+    @memory_budget.setter
+    def memory_budget(self, new_value):
+        self._memory_budget = None if new_value is None else int(new_value)
+        self._enforce_budget()
+
+    def get_resource_count(self):
+        return len(self._slots) - len(self._free_slots)
 
     def get_resource_by_name(self, name):
-        return self._store[name]
+        return self.get_resource(self._store_handle(name))
+
+    def get_handle_by_name(self, name):
+        try:
+            return self._store_handle(name)
+        except KeyError:
+            return None
+
+    def get_handle_by_content_hash(self, content_hash):
+        try:
+            index = self._content_index[content_hash]
+        except KeyError:
+            return None
+
+        return ResourceHandle(index, self._slots[index].generation)
+
+    def get_resource(self, handle):
+        slot = self._resolve(handle)
+        if slot.ref_count == 0:
+            self._lru.move_to_end(handle.index)
+
+        return slot.resource
+
+    def is_valid(self, handle):
+        try:
+            self._resolve(handle)
+        except ValueError:
+            return False
+
+        return True
 
-    def store_resource(self, resource):
+    def get_ref_count(self, handle):
+        return self._resolve(handle).ref_count
+
+    def get_memory_report(self, largest_count=10):
+        """Return how the stored resources' sizes add up against the budget, with the largest resources listed
+
+        Referenced bytes are held by resources with outstanding references, unreferenced bytes could be evicted.
+        Every entry of "largest" is {names, size, ref_count}, largest first.
+        """
+        referenced_bytes = 0
+        occupied = []
+        for slot in self._slots:
+            if slot.resource is None:
+                continue
+
+            occupied.append(slot)
+            if slot.ref_count > 0:
+                referenced_bytes += slot.size
+
+        occupied.sort(key=lambda s: s.size, reverse=True)
+
+        return {
+            'resource_count': len(occupied),
+            'memory_used': self._memory_used,
+            'memory_budget': self._memory_budget,
+            'referenced_bytes': referenced_bytes,
+            'unreferenced_bytes': self._memory_used - referenced_bytes,
+            'largest': [
+                {'names': list(slot.names), 'size': slot.size, 'ref_count': slot.ref_count}
+                for slot in occupied[:largest_count]
+            ],
+        }
+
+    def store_resource(self, resource, content_hash=None):
+        """Store a new resource and return a handle holding one reference to it
+
+        If content_hash matches a resource that is already stored, the resource's name becomes an alias of the stored
+        one and a handle to the stored resource is returned instead. The duplicate is unloaded, it is never stored.
+        """
         name = resource.name
 
+        if content_hash is not None and content_hash in self._content_index.keys():
+            handle = self.alias_resource(self.get_handle_by_content_hash(content_hash), name)
+            if self._slots[handle.index].resource is not resource:
+                resource.unload()
+
+            return handle
+
         if name in self._store.keys():
             raise ValueError(f'Resource with name "{name}" is already stored')
 
-        self._store[name] = resource
+        if len(self._free_slots) > 0:
+            index = self._free_slots.pop()
+        else:
+            index = len(self._slots)
+            self._slots.append(_Slot())
+
+        slot = self._slots[index]
+        slot.resource = resource
+        slot.ref_count = 1
+        slot.size = int(resource.size)
+        slot.names = [name]
+        slot.content_hash = content_hash
+
+        self._store[name] = index
+        if content_hash is not None:
+            self._content_index[content_hash] = index
+        self._memory_used += slot.size
+
+        handle = ResourceHandle(index, slot.generation)
+        self._enforce_budget()
+
+        return handle
+
+    def alias_resource(self, handle, name):
+        """Make a stored resource reachable under an additional name and return a handle holding a new reference"""
+        slot = self._resolve(handle)
+
+        if name in self._store.keys() and self._store[name] != handle.index:
+            raise ValueError(f'Resource with name "{name}" is already stored')
+
+        if name not in slot.names:
+            slot.names.append(name)
+            self._store[name] = handle.index
+
+        return self.acquire_resource(handle)
+
+    def acquire_resource(self, handle):
+        """Add a reference to a stored resource, protecting it from eviction"""
+        slot = self._resolve(handle)
+        if slot.ref_count == 0:
+            del self._lru[handle.index]
+        slot.ref_count += 1
+
+        return handle
+
+    def release_resource(self, handle):
+        """Give back a reference, once no references remain the resource becomes eligible for eviction"""
+        slot = self._resolve(handle)
+        if slot.ref_count == 0:
+            raise ValueError(f'Resource "{slot.resource.name}" has no references to release')
+
+        slot.ref_count -= 1
+        if slot.ref_count == 0:
+            self._lru[handle.index] = None
+            self._enforce_budget()
+
+    def remove_resource(self, handle):
+        """Unconditionally remove a resource, invalidating every outstanding handle to it"""
+        slot = self._resolve(handle)
+        if slot.ref_count == 0:
+            del self._lru[handle.index]
+
+        self._vacate(handle.index)
+
+    def evict_unreferenced(self):
+        """Evict every resource that has no references, regardless of the memory budget"""
+        while len(self._lru) > 0:
+            index, _ = self._lru.popitem(last=False)
+            self._vacate(index)
+
+    def _store_handle(self, name):
+        index = self._store[name]
+
+        return ResourceHandle(index, self._slots[index].generation)
+
+    def _resolve(self, handle):
+        index = handle.index
+        if index < 0 or index >= len(self._slots):
+            raise ValueError(f'{handle} does not refer to a resource slot')
+
+        slot = self._slots[index]
+        if slot.resource is None or slot.generation != handle.generation:
+            raise ValueError(f'{handle} is stale, the resource it referred to has been removed')
+
+        return slot
+
+    def _enforce_budget(self):
+        if self._memory_budget is None:
+            return
+
+        while self._memory_used > self._memory_budget and len(self._lru) > 0:
+            index, _ = self._lru.popitem(last=False)
+            self._vacate(index)
+
+    def _vacate(self, index):
+        slot = self._slots[index]
+        resource = slot.resource
+
+        for name in slot.names:
+            del self._store[name]
+        if slot.content_hash is not None:
+            del self._content_index[slot.content_hash]
+        self._memory_used -= slot.size
+
+        slot.resource = None
+        slot.ref_count = 0
+        slot.size = 0
+        slot.names = []
+        slot.content_hash = None
+        slot.generation += 1
+        self._free_slots.append(index)
+
+        resource.unload()
@@ -0,0 +1,224 @@
+import json
+import mmap
+import struct
+from array import array
+
+from py3dengine.gameobject import GameObject
+from py3dengine.transform import Transform
+
+SNAPSHOT_MAGIC = b'P3DS'
+SNAPSHOT_VERSION = 2
+
+# magic, version, byte order mark, node count, then (offset, size) for each block
+_HEADER = struct.Struct('=4sIIIQQQQQQQQQQQQ')
+_BYTE_ORDER_MARK = 0x01020304
+_BLOCK_ALIGNMENT = 8
+_TRANSFORM_FLOATS = 10
+
+_snapshot_types = {}
+_snapshot_type_names = {}
+
+
+class SnapshotError(Exception):
+    pass
+
+
+def register_snapshot_component(type_name):
+    """Class decorator that allows snapshots to store components of the class under type_name
+
+    Only registered classes are saved and restored. A snapshot stores the component's name, its message filters and
+    whatever get_snapshot_state returns, and restores it with the class's from_snapshot_state.
+    """
+    def register(component_type):
+        if type_name in _snapshot_types.keys():
+            raise ValueError(f'A snapshot component named \'{type_name}\' has already been registered')
+
+        _snapshot_types[type_name] = component_type
+        _snapshot_type_names[component_type] = type_name
+
+        return component_type
+
+    return register
+
+
+def save_snapshot(root, file_path):
+    """Write the GameObject hierarchy under root to file_path as a binary snapshot
+
+    The snapshot is a header followed by contiguous, 8 byte aligned blocks, every per-node block in pre-order:
+    parent indices (int32), accept-by-default flags (uint8), transforms (10 float32 each), name offsets (uint32)
+    into a utf-8 string table, then one JSON document holding the message filters and component state.
+
+    Components must be of a class registered with register_snapshot_component, their state must be plain JSON data.
+    """
+    parents = array('i')
+    accept_flags = array('B')
+    transforms = array('f')
+    name_offsets = array('I', [0])
+    names = bytearray()
+    filters = []
+    components = []
+
+    pending = [(root, -1)]
+    while len(pending) > 0:
+        go, parent_index = pending.pop()
+        index = len(parents)
+
+        parents.append(parent_index)
+        accept_flags.append(1 if go._message_type_accept_by_default else 0)
+
+        transform = go._transform if go._transform is not None else Transform()
+        transforms.extend(transform.to_floats())
+
+        names.extend(go.name.encode('utf-8'))
+        name_offsets.append(len(names))
+
+        filters.append((tuple(go._message_type_white_list), tuple(go._message_type_black_list)))
+        components.append([_component_entry(component) for component in go._components])
+
+        pending.extend((child, index) for child in reversed(go._children))
+
+    try:
+        state_block = json.dumps([filters, components], separators=(',', ':')).encode('utf-8')
+    except (TypeError, ValueError) as err:
+        raise SnapshotError('Component snapshot state is not plain JSON data', err)
+
+    blocks = (
+        parents.tobytes(),
+        accept_flags.tobytes(),
+        transforms.tobytes(),
+        name_offsets.tobytes(),
+        bytes(names),
+        state_block,
+    )
+
+    layout = []
+    offset = _align(_HEADER.size)
+    for block in blocks:
+        layout.extend((offset, len(block)))
+        offset = _align(offset + len(block))
+
+    with open(file_path, 'wb') as snapshot_file:
+        snapshot_file.write(_HEADER.pack(SNAPSHOT_MAGIC, SNAPSHOT_VERSION, _BYTE_ORDER_MARK, len(parents), *layout))
+        for block, block_offset in zip(blocks, layout[0::2]):
+            snapshot_file.write(b'\0' * (block_offset - snapshot_file.tell()))
+            snapshot_file.write(block)
+
+
+def restore_snapshot(file_path):
+    """Rebuild the GameObject hierarchy saved by save_snapshot, reading the blocks straight out of a memory map"""
+    try:
+        snapshot_file = open(file_path, 'rb')
+    except OSError as err:
+        raise SnapshotError(err)
+
+    try:
+        with mmap.mmap(snapshot_file.fileno(), 0, access=mmap.ACCESS_READ) as mapped:
+            with memoryview(mapped) as view:
+                return _restore_from_buffer(view)
+    except (ValueError, TypeError, KeyError, IndexError) as err:
+        raise SnapshotError(f'"{file_path}" is not a valid snapshot', err)
+    finally:
+        snapshot_file.close()
+
+
+def _restore_from_buffer(view):
+    if len(view) < _HEADER.size:
+        raise SnapshotError('Snapshot is truncated')
+
+    magic, version, byte_order_mark, node_count, *layout = _HEADER.unpack_from(view)
+    if magic != SNAPSHOT_MAGIC:
+        raise SnapshotError('Snapshot has the wrong magic number')
+    if version != SNAPSHOT_VERSION:
+        raise SnapshotError(f'Snapshot version {version} is not supported, expected {SNAPSHOT_VERSION}')
+    if byte_order_mark != _BYTE_ORDER_MARK:
+        raise SnapshotError('Snapshot was written on a machine with a different byte order')
+    if node_count == 0:
+        raise SnapshotError('Snapshot contains no GameObjects')
+
+    for offset, size in zip(layout[0::2], layout[1::2]):
+        if offset + size > len(view):
+            raise SnapshotError('Snapshot is truncated')
+
+    views = [view[offset:offset + size] for offset, size in zip(layout[0::2], layout[1::2])]
+    try:
+        views.extend((views[0].cast('i'), views[2].cast('f'), views[3].cast('I')))
+        accept_flags, names, parents, transforms, name_offsets = views[1], views[4], *views[6:]
+        filters, components = json.loads(str(views[5], 'utf-8'))
+
+        if (
+            len(filters) != node_count or
+            len(components) != node_count or
+            len(parents) != node_count or
+            len(accept_flags) != node_count or
+            len(transforms) != node_count * _TRANSFORM_FLOATS or
+            len(name_offsets) != node_count + 1
+        ):
+            raise SnapshotError('Snapshot blocks do not match its node count')
+
+        game_objects = []
+        from_floats = Transform.from_floats
+        for i in range(node_count):
+            new_go = GameObject(str(names[name_offsets[i]:name_offsets[i + 1]], 'utf-8'))
+
+            white_list, black_list = filters[i]
+            new_go._message_type_white_list = list(white_list)
+            new_go._message_type_black_list = list(black_list)
+            new_go._message_type_accept_by_default = accept_flags[i] != 0
+
+            offset = i * _TRANSFORM_FLOATS
+            new_go._transform = from_floats(transforms[offset:offset + _TRANSFORM_FLOATS])
+
+            for entry in components[i]:
+                component = _restore_component(entry)
+                component._owner = new_go
+                new_go._components.append(component)
+
+            parent_index = parents[i]
+            if parent_index >= i:
+                raise SnapshotError('Snapshot hierarchy is not in pre-order')
+            elif parent_index >= 0:
+                parent = game_objects[parent_index]
+                new_go._parent = parent
+                parent._children.append(new_go)
+            elif i != 0:
+                raise SnapshotError('Snapshot has more than one root GameObject')
+
+            game_objects.append(new_go)
+    finally:
+        for block_view in reversed(views):
+            block_view.release()
+
+    return game_objects[0]
+
+
+def _component_entry(component):
+    type_name = _snapshot_type_names.get(type(component))
+    if type_name is None:
+        raise SnapshotError(f'Component type \'{type(component).__name__}\' is not registered for snapshots')
+
+    return [
+        type_name,
+        component.name,
+        component._message_type_white_list,
+        component._message_type_black_list,
+        component._message_type_accept_by_default,
+        component.get_snapshot_state(),
+    ]
+
+
+def _restore_component(entry):
+    type_name, name, white_list, black_list, accept_by_default, state = entry
+    component_type = _snapshot_types.get(type_name)
+    if component_type is None:
+        raise SnapshotError(f'Snapshot component type \'{type_name}\' is not registered')
+
+    component = component_type.from_snapshot_state(name, state)
+    component._message_type_white_list = list(white_list)
+    component._message_type_black_list = list(black_list)
+    component._message_type_accept_by_default = bool(accept_by_default)
+
+    return component
+
+
+def _align(offset):
+    return (offset + _BLOCK_ALIGNMENT - 1) & ~(_BLOCK_ALIGNMENT - 1)
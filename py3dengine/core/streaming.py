@@ -0,0 +1,256 @@
+import json
+import math
+from concurrent.futures import ThreadPoolExecutor, wait
+from os import path
+
+from py3dengine.gameobject import GameObject, load_game_object_file
+from py3dengine.json_util import fetch_property, fetch_optional_property
+from py3dengine.message import Message
+from py3dengine.resource_import import collect_resource_handles, release_resources
+from py3dengine.snapshot import save_snapshot, restore_snapshot
+from py3dengine.transform import Transform
+
+
+class ChunkDescriptor:
+    """ChunkDescriptor: Where to find the GameObjects of one cell of a WorldPartition"""
+
+    def __init__(self, coords, file_path, scene_format='snapshot'):
+        self._coords = tuple(int(c) for c in coords)
+        self._file_path = str(file_path)
+        self._format = str(scene_format)
+
+    @property
+    def coords(self):
+        return self._coords
+
+    @property
+    def file_path(self):
+        return self._file_path
+
+    @property
+    def format(self):
+        return self._format
+
+
+class WorldPartition:
+    """WorldPartition: A world split into cubic chunks of chunk_size units, keyed by integer chunk coordinates"""
+
+    def __init__(self, name, chunk_size, chunks=()):
+        if chunk_size <= 0:
+            raise ValueError('Chunk size must be positive')
+
+        self._name = str(name)
+        self._chunk_size = float(chunk_size)
+        self._chunks = {c.coords: c for c in chunks}
+
+    @property
+    def name(self):
+        return self._name
+
+    @property
+    def chunk_size(self):
+        return self._chunk_size
+
+    def get_chunk(self, coords):
+        return self._chunks.get(coords)
+
+    def get_chunk_count(self):
+        return len(self._chunks)
+
+    def chunk_coords_of(self, x, y, z):
+        size = self._chunk_size
+
+        return math.floor(x / size), math.floor(y / size), math.floor(z / size)
+
+    def chunks_in_range(self, x, y, z, radius):
+        """Return the coordinates of every chunk whose bounds come within radius of the point"""
+        size = self._chunk_size
+        low = self.chunk_coords_of(x - radius, y - radius, z - radius)
+        high = self.chunk_coords_of(x + radius, y + radius, z + radius)
+        radius_sq = radius * radius
+
+        in_range = set()
+        for cx in range(low[0], high[0] + 1):
+            dx = _axis_distance(x, cx * size, size)
+            for cy in range(low[1], high[1] + 1):
+                dy = _axis_distance(y, cy * size, size)
+                for cz in range(low[2], high[2] + 1):
+                    if (cx, cy, cz) not in self._chunks:
+                        continue
+
+                    dz = _axis_distance(z, cz * size, size)
+                    if dx * dx + dy * dy + dz * dz <= radius_sq:
+                        in_range.add((cx, cy, cz))
+
+        return in_range
+
+
+def import_world_partition(descriptor):
+    """Read a world partition descriptor, chunk file paths are relative to the descriptor's directory"""
+    description = json.load(descriptor)
+    base_dir = path.dirname(getattr(descriptor, 'name', ''))
+
+    chunks = []
+    for chunk_json in fetch_property(description, 'chunks', list):
+        chunks.append(ChunkDescriptor(
+            fetch_property(chunk_json, 'coords', list),
+            path.join(base_dir, fetch_property(chunk_json, 'file_path', str)),
+            fetch_optional_property(chunk_json, 'format', str, 'snapshot')
+        ))
+
+    return WorldPartition(
+        fetch_property(description, 'name', str),
+        fetch_property(description, 'chunk_size', float),
+        chunks
+    )
+
+
+def partition_game_object(root, chunk_size, out_dir):
+    """Split the children of root into chunk snapshots by position and write a world partition descriptor
+
+    Every direct child of root is placed in the chunk containing its position; each chunk is saved as a snapshot
+    whose root GameObject is named after the chunk. Returns the path of the written descriptor.
+    """
+    partition = WorldPartition(root.name, chunk_size)
+
+    chunk_roots = {}
+    for i in range(root.get_child_count()):
+        child = root.get_child_by_index(i)
+        position = child.get_transform.position if child.get_transform is not None else None
+        coords = (0, 0, 0) if position is None else partition.chunk_coords_of(position.x, position.y, position.z)
+
+        if coords not in chunk_roots.keys():
+            chunk_root = GameObject(_chunk_name(root.name, coords))
+            chunk_root._transform = Transform()
+            chunk_roots[coords] = chunk_root
+        chunk_roots[coords]._children.append(child)
+
+    chunks_json = []
+    for coords, chunk_root in chunk_roots.items():
+        file_name = _chunk_name(root.name, coords) + '.p3dsnap'
+        save_snapshot(chunk_root, path.join(out_dir, file_name))
+        chunks_json.append({'coords': list(coords), 'file_path': file_name, 'format': 'snapshot'})
+
+    descriptor_path = path.join(out_dir, root.name + '.world.json')
+    with open(descriptor_path, 'w') as descriptor_file:
+        json.dump({'name': root.name, 'chunk_size': float(chunk_size), 'chunks': chunks_json}, descriptor_file)
+
+    return descriptor_path
+
+
+class StreamingController:
+    """StreamingController: Keeps the chunks around a focus point resident under a world root GameObject
+
+    Chunk files are read and turned into GameObjects on background threads. Finished chunks are only attached to
+    the world (and sent a "loading" message) from update, so the scene graph is never mutated off the calling thread.
+    Chunks are sent an "unloading" message and detached once the focus moves further than unload_radius away; a
+    larger unload radius than load radius keeps chunks on a boundary from thrashing. Resources a chunk's importers
+    load with import_resource are shared with every scene and released when the chunk is detached.
+    """
+
+    def __init__(self, world_root, partition, load_radius, unload_radius=None, max_workers=2):
+        if unload_radius is None:
+            unload_radius = load_radius
+        if unload_radius < load_radius:
+            raise ValueError('Unload radius must not be smaller than load radius')
+
+        self._world_root = world_root
+        self._partition = partition
+        self._load_radius = float(load_radius)
+        self._unload_radius = float(unload_radius)
+        self._executor = ThreadPoolExecutor(max_workers=max_workers, thread_name_prefix='py3dengine-streaming')
+        self._resident = {}
+        self._pending = {}
+
+    @property
+    def partition(self):
+        return self._partition
+
+    def get_resident_chunks(self):
+        return set(self._resident.keys())
+
+    def get_pending_chunks(self):
+        return set(self._pending.keys())
+
+    def update(self, focus):
+        """Queue loads for chunks that came into range, attach finished ones and drop ones that left range"""
+        x, y, z = focus.x, focus.y, focus.z
+
+        for coords in self._partition.chunks_in_range(x, y, z, self._load_radius):
+            if coords not in self._resident.keys() and coords not in self._pending.keys():
+                descriptor = self._partition.get_chunk(coords)
+                self._pending[coords] = self._executor.submit(_load_chunk, descriptor)
+
+        keep = self._partition.chunks_in_range(x, y, z, self._unload_radius)
+
+        for coords, future in list(self._pending.items()):
+            if coords not in keep:
+                del self._pending[coords]
+                if not future.cancel():
+                    future.add_done_callback(_release_loaded_chunk)
+            elif future.done():
+                del self._pending[coords]
+                self._attach(coords, *future.result())
+
+        for coords in list(self._resident.keys()):
+            if coords not in keep:
+                self._detach(coords)
+
+    def finish_pending(self, focus):
+        """Queue loads around focus and block until all of them are attached"""
+        self.update(focus)
+        wait(list(self._pending.values()))
+        self.update(focus)
+
+    def shutdown(self):
+        """Stop the worker threads and unload every resident chunk"""
+        for future in self._pending.values():
+            if not future.cancel():
+                future.add_done_callback(_release_loaded_chunk)
+        self._pending.clear()
+        self._executor.shutdown(wait=True)
+
+        for coords in list(self._resident.keys()):
+            self._detach(coords)
+
+    def _attach(self, coords, chunk_root, resource_handles):
+        self._resident[coords] = (chunk_root, resource_handles)
+        self._world_root.attach_child(chunk_root)
+        chunk_root.receive_message(Message('loading'))
+
+    def _detach(self, coords):
+        chunk_root, resource_handles = self._resident.pop(coords)
+        chunk_root.receive_message(Message('unloading'))
+        self._world_root.detach_child(chunk_root)
+        release_resources(resource_handles)
+
+
+def _load_chunk(descriptor):
+    with collect_resource_handles() as resource_handles:
+        try:
+            if descriptor.format == 'snapshot':
+                return restore_snapshot(descriptor.file_path), resource_handles
+
+            return load_game_object_file(descriptor.file_path, descriptor.format), resource_handles
+        except BaseException:
+            release_resources(resource_handles)
+            raise
+
+
+def _release_loaded_chunk(future):
+    # A chunk that finished loading after it went out of range is never attached
+    if future.exception() is None:
+        release_resources(future.result()[1])
+
+
+def _axis_distance(value, cell_min, size):
+    if value < cell_min:
+        return cell_min - value
+    if value > cell_min + size:
+        return value - (cell_min + size)
+
+    return 0.0
+
+
+def _chunk_name(world_name, coords):
+    return f'{world_name}_chunk_{coords[0]}_{coords[1]}_{coords[2]}'
@@ -1,4 +1,4 @@
-from resource_import import register_importer
+from py3dengine.resource_import import register_importer
 from py3dengine.math import Vector3, Quaternion, Matrix4x4
 from py3dengine.json_util import fetch_property
 
@@ -11,44 +11,83 @@ class Transform:
 
         self._w_mtx = None
         self._wit_mtx = None
-        self._refresh_matrix_cache()
+
+    @classmethod
+    def from_floats(cls, values):
+        """Build a Transform from 10 packed floats: position xyz, orientation xyzw, scale xyz"""
+        t = cls.__new__(cls)
+        t._position = Vector3(values[0], values[1], values[2])
+        t._orientation = Quaternion(values[3], values[4], values[5], values[6])
+        t._scale = Vector3(values[7], values[8], values[9])
+        t._w_mtx = None
+        t._wit_mtx = None
+
+        return t
+
+    def to_floats(self):
+        """Return the inverse of from_floats"""
+        p, o, s = self._position, self._orientation, self._scale
+
+        return p.x, p.y, p.z, o.x, o.y, o.z, o.w, s.x, s.y, s.z
 
     @property
     def position(self):
         return self._position
 
+    @position.setter
+    def position(self, value):
+        self._position = Vector3(value)
+        self.invalidate_matrices()
+
     @property
     def orientation(self):
         return self._orientation
 
+    @orientation.setter
+    def orientation(self, value):
+        self._orientation = Quaternion(value)
+        self.invalidate_matrices()
+
     @property
     def scale(self):
         return self._scale
 
     @property
     def world_matrix(self):
+        if self._w_mtx is None:
+            self._refresh_matrix_cache()
+
         return self._w_mtx
 
     @property
     def wit_matrix(self):
+        if self._wit_mtx is None:
+            self._refresh_matrix_cache()
+
         return self._wit_mtx
 
+    def invalidate_matrices(self):
+        """Drop the cached matrices, call after changing position, orientation or scale in place"""
+        self._w_mtx = None
+        self._wit_mtx = None
+
     def _refresh_matrix_cache(self):
+        """Matrices are built on first use, scenes are often loaded with far more objects than are ever drawn"""
         s = Matrix4x4.Scaling(self._scale)
         r = Matrix4x4.RotationQuaternion(self._orientation)
         t = Matrix4x4.Translation(self._position)
 
         # TODO: this is horribly inefficient and should be re-written in c math lib
         self._w_mtx = (s * r) * t
-        self._wit_matrix = self._w_mtx.inverse()
+        self._wit_mtx = self._w_mtx.inverse()
 
 
-@register_importer(Transform)
-def import_transform(descriptor, transform_json):
-    t = Transform()
+def import_transform(transform_json):
+    return Transform(
+        Vector3(fetch_property(transform_json, 'position', dict)),
+        Quaternion(fetch_property(transform_json, 'orientation', dict)),
+        Vector3(fetch_property(transform_json, 'scale', dict))
+    )
 
-    t._position = Vector3(fetch_property(transform_json, 'position', dict))
-    t._orientation = Quaternion(fetch_property(transform_json, 'orientation', dict))
-    t._scale = Vector3(fetch_property(transform_json, 'scale', dict))
 
-    return t
+register_importer(import_transform, Transform)
@@ -0,0 +1,141 @@
+"""Save py3dmath.BinaryLog rings to files and render them back to text offline
+
+Usage: python -m py3dengine.binary_log log_file.p3dlog
+"""
+import struct
+import sys
+
+from py3dengine.math import BinaryLog
+
+BINARY_LOG_MAGIC = b'P3DBLOG\0'
+BINARY_LOG_VERSION = 1
+_RECORD_HEADER_SIZE = 16
+
+
+class BinaryLogError(Exception):
+    pass
+
+
+def save_binary_log(log: BinaryLog, file_path):
+    """Write the formats and the held records of a BinaryLog, the records stay in the ring"""
+    byte_order = '<' if sys.byteorder == 'little' else '>'
+    formats = log.formats
+    records = log.snapshot()
+
+    chunks = [BINARY_LOG_MAGIC, struct.pack(f'{byte_order}IcI', BINARY_LOG_VERSION, byte_order.encode(), len(formats))]
+    for format_string, types in formats:
+        encoded_format = format_string.encode('utf-8')
+        encoded_types = types.encode('ascii')
+        chunks.append(struct.pack(f'{byte_order}II', len(encoded_format), len(encoded_types)))
+        chunks.append(encoded_format)
+        chunks.append(encoded_types)
+    chunks.append(struct.pack(f'{byte_order}QQ', log.overwritten_count, len(records)))
+    chunks.append(records)
+
+    with open(file_path, 'wb') as log_file:
+        log_file.write(b''.join(chunks))
+
+
+def read_binary_log(file_path):
+    """Return (formats, records, overwritten count) of a saved log, records are (timestamp ns, format id, args)"""
+    with open(file_path, 'rb') as log_file:
+        data = log_file.read()
+
+    if not data.startswith(BINARY_LOG_MAGIC):
+        raise BinaryLogError(f'"{file_path}" is not a binary log')
+
+    try:
+        offset = len(BINARY_LOG_MAGIC)
+        byte_order = chr(data[offset + 4])
+        if byte_order not in '<>':
+            raise BinaryLogError(f'"{file_path}" has an unknown byte order')
+
+        version, _, format_count = struct.unpack_from(f'{byte_order}IcI', data, offset)
+        if version != BINARY_LOG_VERSION:
+            raise BinaryLogError(f'"{file_path}" is version {version}, expected {BINARY_LOG_VERSION}')
+        offset += struct.calcsize(f'{byte_order}IcI')
+
+        formats = []
+        for _ in range(format_count):
+            format_size, types_size = struct.unpack_from(f'{byte_order}II', data, offset)
+            offset += 8
+            format_string = data[offset:offset + format_size].decode('utf-8')
+            offset += format_size
+            types = data[offset:offset + types_size].decode('ascii')
+            offset += types_size
+            formats.append((format_string, types))
+
+        overwritten, records_size = struct.unpack_from(f'{byte_order}QQ', data, offset)
+        offset += 16
+        records = decode_records(data[offset:offset + records_size], formats, byte_order)
+    except (struct.error, IndexError, UnicodeDecodeError) as err:
+        raise BinaryLogError(f'"{file_path}" is truncated or corrupt', err)
+
+    return formats, records, overwritten
+
+
+def decode_records(records, formats, byte_order='<'):
+    """Split a BinaryLog snapshot into (timestamp ns, format id, args) tuples"""
+    fixed = {'i': (f'{byte_order}q', 8), 'f': (f'{byte_order}d', 8), 'b': ('?', 1)}
+    length_format = f'{byte_order}H'
+    header_format = f'{byte_order}IIQ'
+
+    decoded = []
+    offset = 0
+    while offset < len(records):
+        size, format_id, timestamp = struct.unpack_from(header_format, records, offset)
+        if size < _RECORD_HEADER_SIZE or format_id >= len(formats):
+            raise BinaryLogError(f'Corrupt record at byte {offset}')
+
+        args = []
+        position = offset + _RECORD_HEADER_SIZE
+        for argument_type in formats[format_id][1]:
+            if argument_type == 's':
+                (length,) = struct.unpack_from(length_format, records, position)
+                position += 2
+                args.append(records[position:position + length].decode('utf-8', 'replace'))
+                position += length
+            else:
+                value_format, value_size = fixed[argument_type]
+                args.append(struct.unpack_from(value_format, records, position)[0])
+                position += value_size
+
+        decoded.append((timestamp, format_id, tuple(args)))
+        offset += size
+
+    return decoded
+
+
+def render_records(formats, records):
+    """Yield one text line per record, with its timestamp in seconds"""
+    for timestamp, format_id, args in records:
+        format_string = formats[format_id][0]
+        try:
+            text = format_string.format(*args)
+        except (IndexError, KeyError, ValueError):
+            text = f'{format_string} {args!r}'
+
+        yield f'[{timestamp / 1e9:.9f}] {text}'
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__.strip().splitlines()[-1], file=sys.stderr)
+        return 1
+
+    try:
+        formats, records, overwritten = read_binary_log(sys.argv[1])
+    except (OSError, BinaryLogError) as err:
+        print(err, file=sys.stderr)
+        return 1
+
+    if overwritten:
+        print(f'[{overwritten} older records were overwritten]')
+    for line in render_records(formats, records):
+        print(line)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
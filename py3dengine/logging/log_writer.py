@@ -0,0 +1,153 @@
+import os
+import sys
+import threading
+from collections import deque
+
+
+class AsyncLogWriter:
+    """AsyncLogWriter: Writes log records to a rotating file from a background thread
+
+    write only appends the unformatted record to a bounded deque, whose append and popleft are atomic without a lock,
+    so logging threads never wait on formatting or file IO. The writer thread wakes every flush_interval seconds, or
+    as soon as batch_size records are waiting, formats every waiting record with format_record and writes them in one
+    call. Records arriving while capacity records are waiting are dropped and reported in the file once room is back.
+
+    When the file grows past max_bytes it is renamed to file_path.1, older files move up to file_path.backup_count and
+    the oldest is deleted. File errors are reported on stderr and the records of that batch are lost, the writer keeps
+    running and opens the file again for the next batch.
+    """
+
+    def __init__(
+        self, file_path, format_record, max_bytes=16 * 1024 * 1024, backup_count=3, capacity=65536, batch_size=256,
+        flush_interval=0.1
+    ):
+        if max_bytes <= 0 or backup_count < 0 or capacity <= 0 or batch_size <= 0 or flush_interval <= 0.0:
+            raise ValueError('Log writer sizes and intervals must be positive')
+
+        self._file_path = file_path
+        self._format_record = format_record
+        self._max_bytes = max_bytes
+        self._backup_count = backup_count
+        self._capacity = capacity
+        self._batch_size = batch_size
+        self._flush_interval = flush_interval
+
+        self._records = deque()
+        self._dropped = 0
+        self._reported_dropped = 0
+        self._wake = threading.Event()
+        self._stopping = False
+
+        self._file = open(file_path, 'a', encoding='utf-8')
+        self._file_size = self._file.tell()
+
+        self._thread = threading.Thread(target=self._run, name='py3dengine log writer', daemon=True)
+        self._thread.start()
+
+    @property
+    def dropped(self):
+        return self._dropped
+
+    def write(self, *record):
+        records = self._records
+        if len(records) >= self._capacity:
+            self._dropped += 1
+            return
+
+        records.append(record)
+        if len(records) >= self._batch_size and not self._wake.is_set():
+            self._wake.set()
+
+    def flush(self):
+        """Wait until every record written so far is in the file"""
+        if self._stopping:
+            return
+
+        # The marker skips the capacity check, a full queue must not leave the caller waiting forever
+        done = threading.Event()
+        self._records.append((None, done))
+        self._wake.set()
+        while not done.wait(self._flush_interval):
+            if not self._thread.is_alive():
+                return
+
+    def close(self):
+        if self._stopping:
+            return
+
+        self._stopping = True
+        self._wake.set()
+        self._thread.join()
+        self._file.close()
+
+    def _run(self):
+        while not self._stopping:
+            self._wake.wait(self._flush_interval)
+            self._wake.clear()
+            self._drain()
+
+        self._drain()
+
+    def _drain(self):
+        records = self._records
+        lines = []
+        flushed = []
+        while records:
+            record = records.popleft()
+            if record[0] is None:
+                flushed.append(record[1])
+            else:
+                lines.append(self._format_record_safely(*record))
+
+        dropped = self._dropped - self._reported_dropped
+        if dropped:
+            lines.append(self._format_record('WARNING', '{} log records were dropped, the queue was full', (dropped,)))
+            self._reported_dropped += dropped
+
+        try:
+            if lines:
+                self._write_lines(lines)
+        except OSError as err:
+            sys.stderr.write(f'Could not write {len(lines)} log records to "{self._file_path}": {err}\n')
+        finally:
+            for done in flushed:
+                done.set()
+
+    def _format_record_safely(self, level, msg, args):
+        # Even the fallback text calls repr on the arguments, one record that still fails must not end _run
+        try:
+            return self._format_record(level, msg, args)
+        except Exception as err:
+            return f'[{level}]: {msg!s:.200} (could not be formatted: {type(err).__name__})\n'
+
+    def _write_lines(self, lines):
+        if self._file.closed:
+            self._file = open(self._file_path, 'a', encoding='utf-8')
+            self._file_size = self._file.tell()
+
+        text = ''.join(lines)
+        self._file.write(text)
+        self._file.flush()
+        self._file_size += len(text.encode('utf-8'))
+
+        if self._file_size >= self._max_bytes:
+            self._rotate()
+
+    def _rotate(self):
+        self._file.close()
+
+        # Any of the files may have been deleted by something else, a missing one is simply skipped
+        try:
+            if self._backup_count > 0:
+                for index in range(self._backup_count - 1, 0, -1):
+                    source = f'{self._file_path}.{index}'
+                    if os.path.exists(source):
+                        os.replace(source, f'{self._file_path}.{index + 1}')
+                os.replace(self._file_path, f'{self._file_path}.1')
+            else:
+                os.remove(self._file_path)
+        except FileNotFoundError:
+            pass
+
+        self._file = open(self._file_path, 'a', encoding='utf-8')
+        self._file_size = 0
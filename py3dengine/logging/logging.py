@@ -1,12 +1,26 @@
+import atexit
 import sys
 
-_DEBUG_LEVEL = 'DEBUG'
+from py3dengine.log_writer import AsyncLogWriter
+
 _TRACE_LEVEL = 'TRACE'
+_DEBUG_LEVEL = 'DEBUG'
 _INFO_LEVEL = 'INFO'
 _WARNING_LEVEL = 'WARNING'
 _ERROR_LEVEL = 'ERROR'
 _CRITICAL_LEVEL = 'CRITICAL'
 
+# Messages below the threshold return before anything is formatted
+_level_values = {
+    _TRACE_LEVEL: 0,
+    _DEBUG_LEVEL: 1,
+    _INFO_LEVEL: 2,
+    _WARNING_LEVEL: 3,
+    _ERROR_LEVEL: 4,
+    _CRITICAL_LEVEL: 5
+}
+_threshold = 0
+
 _dst_mapping = {
     _DEBUG_LEVEL: sys.stdout,
     _TRACE_LEVEL: sys.stdout,
@@ -16,31 +30,92 @@ _dst_mapping = {
     _CRITICAL_LEVEL: sys.stderr
 }
 
-def debug(msg):
-    _level_log(_DEBUG_LEVEL, msg)
+_async_writer = None
+
+def debug(msg, *args):
+    if _threshold <= 1:
+        _level_log(_DEBUG_LEVEL, msg, args)
+
+def trace(msg, *args):
+    if _threshold <= 0:
+        _level_log(_TRACE_LEVEL, msg, args)
+
+def info(msg, *args):
+    if _threshold <= 2:
+        _level_log(_INFO_LEVEL, msg, args)
+
+def warning(msg, *args):
+    if _threshold <= 3:
+        _level_log(_WARNING_LEVEL, msg, args)
+
+def error(msg, *args):
+    if _threshold <= 4:
+        _level_log(_ERROR_LEVEL, msg, args)
 
-def trace(msg):
-    _level_log(_TRACE_LEVEL, msg)
+def critical(msg, *args):
+    _level_log(_CRITICAL_LEVEL, msg, args)
 
-def info(msg):
-    _level_log(_INFO_LEVEL, msg)
+def set_level(level):
+    """Drop every message below level, one of 'TRACE', 'DEBUG', 'INFO', 'WARNING', 'ERROR' or 'CRITICAL'"""
+    global _threshold
+    if level not in _level_values.keys():
+        raise ValueError(f'Unknown log level "{level}"')
 
-def warning(msg):
-    _level_log(_WARNING_LEVEL, msg)
+    _threshold = _level_values[level]
 
-def error(msg):
-    _level_log(_ERROR_LEVEL, msg)
+def is_enabled_for(level):
+    """Check a level before building expensive log arguments"""
+    return _level_values.get(level, 0) >= _threshold
 
-def critical(msg):
-    _level_log(_CRITICAL_LEVEL, msg)
+def _format_record(level, msg, args):
+    """Messages with arguments are formatted with str.format only once they are written"""
+    if args:
+        try:
+            msg = str(msg).format(*args)
+        except Exception as err:
+            # A bad argument must not raise into game code or end the async writer
+            msg = f'{msg} {args!r} (could not be formatted: {err!r})'
 
-def _level_log(level, msg):
+    return "[{}]: {}\n".format(level, msg)
+
+def _level_log(level, msg, args=()):
     global _dst_mapping
+    if _async_writer is not None:
+        _async_writer.write(level, msg, args)
+        return
+
     if level not in _dst_mapping.keys() or _dst_mapping[level] is None:
         return
 
-    log_msg = "[{}]: {}\n".format(level, msg)
-    _dst_mapping[level].write(log_msg)
+    _dst_mapping[level].write(_format_record(level, msg, args))
+
+def start_async_logging(file_path, max_bytes=16 * 1024 * 1024, backup_count=3, capacity=65536):
+    """Send every message to a rotating file written by a background thread instead of the level destinations
+
+    Arguments are formatted on the writer thread, so they should not be changed after they are logged. Messages logged
+    while capacity messages are waiting are dropped and counted. The writer is stopped and drained on exit.
+    """
+    global _async_writer
+    if _async_writer is not None:
+        raise RuntimeError('Asynchronous logging is already started')
+
+    _async_writer = AsyncLogWriter(file_path, _format_record, max_bytes, backup_count, capacity)
+    atexit.register(stop_async_logging)
+
+def flush_async_logging():
+    """Wait until every message logged so far is written"""
+    if _async_writer is not None:
+        _async_writer.flush()
+
+def stop_async_logging():
+    global _async_writer
+    if _async_writer is None:
+        return
+
+    writer = _async_writer
+    _async_writer = None
+    writer.close()
+    atexit.unregister(stop_async_logging)
 
 def set_debug_dst(new_dst):
     _set_dst(_DEBUG_LEVEL, new_dst)
@@ -0,0 +1,172 @@
+import functools
+import json
+import os
+import threading
+from collections import deque
+
+from py3dengine.math import Profiler
+
+_enabled = False
+_named_threads = threading.local()
+_counters = deque(maxlen=65536)
+
+
+def enable():
+    """Start recording zones from Python and from the math library on every thread"""
+    global _enabled
+
+    _enabled = True
+    Profiler.SetEnabled(True)
+
+
+def disable():
+    global _enabled
+
+    _enabled = False
+    Profiler.SetEnabled(False)
+
+
+def is_enabled():
+    return _enabled
+
+
+class ProfileZone:
+    """ProfileZone: A profiled scope, used as a context manager or as a function decorator
+
+        with ProfileZone('physics'):
+            world.step(delta)
+
+        @ProfileZone()
+        def update(self, delta):
+            ...
+
+    A decorator without a name uses the function's qualified name. While the profiler is disabled a zone only checks
+    a flag, so zones can stay in production code. That check still costs a Python call, so zones belong around
+    systems and frames rather than around the update of every component in a large scene.
+    """
+
+    __slots__ = ('name',)
+
+    def __init__(self, name=None):
+        self.name = name
+
+    def __enter__(self):
+        if _enabled:
+            _name_thread()
+            Profiler.Begin(self.name)
+
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        if _enabled:
+            Profiler.End(self.name)
+
+        return False
+
+    def __call__(self, function):
+        name = self.name if self.name is not None else function.__qualname__
+
+        @functools.wraps(function)
+        def profiled(*args, **kwargs):
+            if not _enabled:
+                return function(*args, **kwargs)
+
+            _name_thread()
+            Profiler.Begin(name)
+            try:
+                return function(*args, **kwargs)
+            finally:
+                Profiler.End(name)
+
+        return profiled
+
+
+def _name_thread():
+    if getattr(_named_threads, 'named', False):
+        return
+
+    Profiler.SetThreadName(threading.current_thread().name)
+    _named_threads.named = True
+
+
+def collect():
+    """Remove and return every recorded event as (thread, timestamp ns, 'B' or 'E', name) tuples"""
+    return Profiler.Collect()
+
+
+def record_counter(name, **values):
+    """Record a sample of named values, shown as a counter track in Chrome traces, while the profiler is enabled
+
+    Samples share the timeline of the zone events. Only the newest 65536 samples are kept until they are collected.
+    """
+    if _enabled:
+        _counters.append((Profiler.Now(), name, values))
+
+
+def collect_counters():
+    """Remove and return every recorded counter sample as (timestamp ns, name, {value name: value}) tuples"""
+    samples = list(_counters)
+    _counters.clear()
+
+    return samples
+
+
+def summarize(events):
+    """Return {name: (count, total ns)} of the zones in events, nested zones are included in their parent's total
+
+    Zones whose begin or end is missing from events, because they were dropped or are still open, are not counted.
+    """
+    summary = {}
+    open_zones = {}
+    for thread, timestamp, phase, name in events:
+        stack = open_zones.setdefault(thread, [])
+        if phase == 'B':
+            stack.append((name, timestamp))
+            continue
+
+        if not stack or stack[-1][0] != name:
+            continue
+
+        _, begin = stack.pop()
+        count, total = summary.get(name, (0, 0))
+        summary[name] = (count + 1, total + timestamp - begin)
+
+    return summary
+
+
+def export_chrome_trace(file_path, events=None, counters=None):
+    """Write events and counter samples as Chrome trace event JSON, which chrome://tracing and the Perfetto UI open
+
+    When events or counters is None every recorded event or sample is collected first. Returns the number of events
+    written, not counting the samples.
+    """
+    if events is None:
+        events = collect()
+    if counters is None:
+        counters = collect_counters()
+
+    pid = os.getpid()
+    trace_events = []
+    threads = set()
+    for thread, timestamp, phase, name in events:
+        threads.add(thread)
+        trace_events.append({'name': name, 'ph': phase, 'ts': timestamp / 1000.0, 'pid': pid, 'tid': thread})
+
+    for timestamp, name, values in counters:
+        trace_events.append({'name': name, 'ph': 'C', 'ts': timestamp / 1000.0, 'pid': pid, 'args': values})
+
+    for thread in sorted(threads):
+        thread_name = Profiler.ThreadName(thread)
+        if thread_name is not None:
+            trace_events.append({'name': 'thread_name', 'ph': 'M', 'pid': pid, 'tid': thread,
+                                 'args': {'name': thread_name}})
+
+    trace = {
+        'traceEvents': trace_events,
+        'displayTimeUnit': 'ns',
+        'otherData': {'dropped_events': Profiler.DroppedEvents()},
+    }
+    with open(file_path, 'w') as trace_file:
+        json.dump(trace, trace_file)
+
+    return len(events)
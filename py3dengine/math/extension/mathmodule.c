@@ -4,6 +4,17 @@
 #include "py3dvector3.h"
 #include "py3dquaternion.h"
 #include "py3dmatrix4x4.h"
+#include "py3dbvh.h"
+#include "py3dfrustum.h"
+#include "py3danimation.h"
+#include "py3dphysics.h"
+#include "py3dbroadphase.h"
+#include "py3drasterizer.h"
+#include "py3drenderqueue.h"
+#include "py3dprofiler.h"
+#include "py3dbinarylog.h"
+#include "py3dmemory.h"
+#include "py3ddispatch.h"
 
 static struct PyModuleDef py3dmathModuleDef = {
     PyModuleDef_HEAD_INIT,
@@ -36,5 +47,60 @@ extern PyMODINIT_FUNC PyInit_math(void) {
         return NULL;
     }
 
+    if (!PyInit_Py3dBoundingVolumeHierarchy(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
+    if (!PyInit_Py3dFrustum(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
+    if (!PyInit_Py3dAnimation(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
+    if (!PyInit_Py3dPhysicsWorld(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
+    if (!PyInit_Py3dSweepAndPrune(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
+    if (!PyInit_Py3dRasterizer(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
+    if (!PyInit_Py3dRenderQueue(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
+    if (!PyInit_Py3dProfiler(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
+    if (!PyInit_Py3dBinaryLog(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
+    if (!PyInit_Py3dMemoryTracker(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
+    if (!PyInit_Py3dDispatch(newModule)) {
+        Py_CLEAR(newModule);
+        return NULL;
+    }
+
     return newModule;
 }
@@ -1,5 +1,23 @@
+import os
+
 from setuptools import Extension, setup
 
+# install.sh builds the math library into cmake-build-release, PY3DMATH_LIB_DIR points at another build of it
+MATH_LIB_DIR = os.environ.get('PY3DMATH_LIB_DIR', '../lib/cmake-build-release')
+
+
+def cmake_bool(value):
+    """Interpret an option the way CMake's if() does, so the library and the extension agree on it"""
+    value = value.strip().upper()
+    return not (value in ('', '0', 'OFF', 'NO', 'FALSE', 'N', 'IGNORE', 'NOTFOUND') or value.endswith('-NOTFOUND'))
+
+
+# The library is built with LTO by default, compiling the extension with it lets calls into the library be inlined
+LTO_ARGS = ['-flto=auto'] if cmake_bool(os.environ.get('PY3DMATH_LTO', 'ON')) else []
+# Has to match the PY3DMATH_ARCH the library was configured with
+ARCH = os.environ.get('PY3DMATH_ARCH', '')
+ARCH_ARGS = [f'-march={ARCH}'] if ARCH else []
+
 setup(
     ext_modules=[
         Extension(
@@ -8,11 +26,25 @@ setup(
                 "mathmodule.c",
                 "src/source/py3dvector3.c",
                 "src/source/py3dquaternion.c",
-                "src/source/py3dmatrix4x4.c"
+                "src/source/py3dmatrix4x4.c",
+                "src/source/py3dbvh.c",
+                "src/source/py3dfrustum.c",
+                "src/source/py3dbuffer.c",
+                "src/source/py3danimation.c",
+                "src/source/py3dphysics.c",
+                "src/source/py3dbroadphase.c",
+                "src/source/py3drasterizer.c",
+                "src/source/py3drenderqueue.c",
+                "src/source/py3dprofiler.c",
+                "src/source/py3dbinarylog.c",
+                "src/source/py3dmemory.c",
+                "src/source/py3ddispatch.c"
             ],
             include_dirs=['src/headers', '../lib/src/headers'],
-            library_dirs=['../lib/cmake-build-debug'],
-            libraries=['py3dmath']
+            library_dirs=[MATH_LIB_DIR],
+            libraries=['py3dmath'],
+            extra_compile_args=['-O3', '-DNDEBUG'] + LTO_ARGS + ARCH_ARGS,
+            extra_link_args=['-pthread', '-O3'] + LTO_ARGS + ARCH_ARGS
         )
     ]
 )
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef PY3DANIMATION_H
+#define PY3DANIMATION_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <animation.h>
+#include <skinning.h>
+
+struct Py3dAnimationClip {
+    PyObject_HEAD
+    struct AnimClip clip;
+    // Number of evaluations reading the clip without the GIL, __init__ must not free its tracks meanwhile
+    int busy;
+};
+extern PyTypeObject Py3dAnimationClip_Type;
+
+struct Py3dSkeleton {
+    PyObject_HEAD
+    struct AnimSkeleton skeleton;
+    // Number of evaluations reading the skeleton without the GIL, __init__ must not free its bones meanwhile
+    int busy;
+};
+extern PyTypeObject Py3dSkeleton_Type;
+
+extern int PyInit_Py3dAnimation(PyObject *module);
+
+extern PyObject *Py3dAnimationClip_GetDuration(struct Py3dAnimationClip *self, void *closure);
+extern PyObject *Py3dAnimationClip_GetTrackCount(struct Py3dAnimationClip *self, void *closure);
+
+extern PyObject *Py3dSkeleton_GetBoneCount(struct Py3dSkeleton *self, void *closure);
+extern PyObject *Py3dSkeleton_Evaluate(struct Py3dSkeleton *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dSkeleton_SkinVertices(struct Py3dSkeleton *self, PyObject *args, PyObject *kwds);
+
+#endif
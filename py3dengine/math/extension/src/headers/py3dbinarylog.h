@@ -0,0 +1,29 @@
+#ifndef PY3DBINARYLOG_H
+#define PY3DBINARYLOG_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <binarylog.h>
+
+struct Py3dBinaryLog {
+    PyObject_HEAD
+    struct BinaryLog log;
+    // (format, argument types) tuples, indexed by format id
+    PyObject *formats;
+};
+extern PyTypeObject Py3dBinaryLog_Type;
+
+extern int PyInit_Py3dBinaryLog(PyObject *module);
+
+extern PyObject *Py3dBinaryLog_GetFormats(struct Py3dBinaryLog *self, void *closure);
+extern PyObject *Py3dBinaryLog_GetRecordCount(struct Py3dBinaryLog *self, void *closure);
+extern PyObject *Py3dBinaryLog_GetOverwrittenCount(struct Py3dBinaryLog *self, void *closure);
+extern PyObject *Py3dBinaryLog_GetCapacity(struct Py3dBinaryLog *self, void *closure);
+
+extern PyObject *Py3dBinaryLog_Register(struct Py3dBinaryLog *self, PyObject *args);
+extern PyObject *Py3dBinaryLog_Write(struct Py3dBinaryLog *self, PyObject *const *args, Py_ssize_t nargs);
+extern PyObject *Py3dBinaryLog_Snapshot(struct Py3dBinaryLog *self, PyObject *args);
+extern PyObject *Py3dBinaryLog_Reset(struct Py3dBinaryLog *self, PyObject *args);
+
+#endif
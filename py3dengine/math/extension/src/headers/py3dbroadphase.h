@@ -0,0 +1,31 @@
+#ifndef PY3DBROADPHASE_H
+#define PY3DBROADPHASE_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <broadphase.h>
+
+struct Py3dSweepAndPrune {
+    PyObject_HEAD
+    struct SweepAndPrune sap;
+    PyObject *objects;
+    // Keys of proxies removed since the last update_pairs, their objects are still needed for the end events
+    PyObject *removed;
+    // Set while update_pairs runs without the GIL, the proxies must not be changed by other threads until it is cleared
+    int updating;
+};
+extern PyTypeObject Py3dSweepAndPrune_Type;
+
+extern int PyInit_Py3dSweepAndPrune(PyObject *module);
+
+extern PyObject *Py3dSweepAndPrune_Insert(struct Py3dSweepAndPrune *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dSweepAndPrune_Update(struct Py3dSweepAndPrune *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dSweepAndPrune_UpdateBatch(struct Py3dSweepAndPrune *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dSweepAndPrune_Remove(struct Py3dSweepAndPrune *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dSweepAndPrune_UpdatePairs(struct Py3dSweepAndPrune *self, PyObject *args);
+extern PyObject *Py3dSweepAndPrune_GetPairs(struct Py3dSweepAndPrune *self, PyObject *args);
+extern PyObject *Py3dSweepAndPrune_GetPairCount(struct Py3dSweepAndPrune *self, void *closure);
+extern PyObject *Py3dSweepAndPrune_GetUpdating(struct Py3dSweepAndPrune *self, void *closure);
+
+#endif
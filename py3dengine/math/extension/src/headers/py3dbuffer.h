@@ -0,0 +1,16 @@
+#ifndef PY3DBUFFER_H
+#define PY3DBUFFER_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+/**
+ * Helpers for batch APIs that take packed data through the buffer protocol (array.array, memoryview, numpy...).
+ * Both return 1 with a C contiguous view of 32 bit items, or 0 with an exception set and nothing to release.
+ */
+extern int Py3dBuffer_GetFloats(PyObject *obj, Py_buffer *view, int writable);
+extern int Py3dBuffer_GetInts(PyObject *obj, Py_buffer *view, int writable);
+// Index buffers may be signed or unsigned, array('I') is what WfoProcessor builds
+extern int Py3dBuffer_GetIndices(PyObject *obj, Py_buffer *view, int writable);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef PY3DBVH_H
+#define PY3DBVH_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <bvh.h>
+
+struct Py3dBoundingVolumeHierarchy {
+    PyObject_HEAD
+    struct Bvh bvh;
+    PyObject *objects;
+};
+extern PyTypeObject Py3dBoundingVolumeHierarchy_Type;
+
+extern int PyInit_Py3dBoundingVolumeHierarchy(PyObject *module);
+
+extern PyObject *Py3dBoundingVolumeHierarchy_Insert(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dBoundingVolumeHierarchy_Update(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dBoundingVolumeHierarchy_SetBounds(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dBoundingVolumeHierarchy_Remove(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dBoundingVolumeHierarchy_Refit(struct Py3dBoundingVolumeHierarchy *self, PyObject *args);
+extern PyObject *Py3dBoundingVolumeHierarchy_Rebuild(struct Py3dBoundingVolumeHierarchy *self, PyObject *args);
+extern PyObject *Py3dBoundingVolumeHierarchy_RayCast(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dBoundingVolumeHierarchy_QueryAabb(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dBoundingVolumeHierarchy_QuerySphere(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dBoundingVolumeHierarchy_Nearest(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dBoundingVolumeHierarchy_GetHeight(struct Py3dBoundingVolumeHierarchy *self, void *closure);
+
+#endif
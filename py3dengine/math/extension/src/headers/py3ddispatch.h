@@ -0,0 +1,22 @@
+#ifndef PY3DDISPATCH_H
+#define PY3DDISPATCH_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <dispatch.h>
+
+#define PY3DMATH_FORCE_TIER_ENV "PY3DMATH_FORCE_TIER"
+
+// Dispatch only has static methods, the bound kernels live in the library
+extern PyTypeObject Py3dDispatch_Type;
+
+// Binds the best tier the CPU supports, or the one named by PY3DMATH_FORCE_TIER
+extern int PyInit_Py3dDispatch(PyObject *module);
+
+extern PyObject *Py3dDispatch_Tier(PyObject *cls, PyObject *args);
+extern PyObject *Py3dDispatch_DetectedTier(PyObject *cls, PyObject *args);
+extern PyObject *Py3dDispatch_SupportedTiers(PyObject *cls, PyObject *args);
+extern PyObject *Py3dDispatch_SetTier(PyObject *cls, PyObject *args);
+
+#endif
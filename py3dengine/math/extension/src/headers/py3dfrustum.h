@@ -0,0 +1,25 @@
+#ifndef PY3DFRUSTUM_H
+#define PY3DFRUSTUM_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <frustum.h>
+
+struct Py3dFrustum {
+    PyObject_HEAD
+    float planes[FRUSTUM_SIZE];
+};
+extern PyTypeObject Py3dFrustum_Type;
+
+extern int PyInit_Py3dFrustum(PyObject *module);
+
+extern PyObject *Py3dFrustum_Update(struct Py3dFrustum *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dFrustum_TestPoint(struct Py3dFrustum *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dFrustum_TestSphere(struct Py3dFrustum *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dFrustum_TestAabb(struct Py3dFrustum *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dFrustum_CullSpheres(struct Py3dFrustum *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dFrustum_CullAabbs(struct Py3dFrustum *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dFrustum_GetPlanes(struct Py3dFrustum *self, void *closure);
+
+#endif
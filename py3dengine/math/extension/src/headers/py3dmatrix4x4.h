@@ -28,6 +28,14 @@ extern PyObject *Py3dMatrix4x4_RotationAxis(struct Py3dMatrix4x4 *self, PyObject
 extern PyObject *Py3dMatrix4x4_RotationQuaternion(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
 extern PyObject *Py3dMatrix4x4_Scaling(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
 extern PyObject *Py3dMatrix4x4_LookAtLH(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dMatrix4x4_LookAtRH(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dMatrix4x4_PerspectiveFovLH(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dMatrix4x4_PerspectiveFovRH(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dMatrix4x4_PerspectiveInfiniteReverseZLH(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dMatrix4x4_PerspectiveInfiniteReverseZRH(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dMatrix4x4_OrthographicLH(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dMatrix4x4_OrthographicRH(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dMatrix4x4_MultBatch(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
 extern PyObject *Py3dMatrix4x4_Mult(struct Py3dMatrix4x4 *self, PyObject *other);
 
 #endif
@@ -0,0 +1,47 @@
+#ifndef PY3DMEMORY_H
+#define PY3DMEMORY_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+/**
+ * Live, peak and total instance counts of the math value types, with the bytes their objects take.
+ *
+ * Types count an instance in their tp_alloc and uncount it in their tp_dealloc. Counters are only touched with the
+ * GIL held, so they need no atomics.
+ */
+struct Py3dMemoryCounter {
+    const char *name;
+    Py_ssize_t live;
+    Py_ssize_t peak;
+    Py_ssize_t liveBytes;
+    Py_ssize_t peakBytes;
+    unsigned long long allocations;
+};
+
+extern struct Py3dMemoryCounter Py3dVector3_Memory;
+extern struct Py3dMemoryCounter Py3dQuaternion_Memory;
+extern struct Py3dMemoryCounter Py3dMatrix4x4_Memory;
+
+static inline void Py3dMemory_Track(struct Py3dMemoryCounter *counter, Py_ssize_t bytes) {
+    ++counter->allocations;
+    ++counter->live;
+    counter->liveBytes += bytes;
+    if (counter->live > counter->peak) counter->peak = counter->live;
+    if (counter->liveBytes > counter->peakBytes) counter->peakBytes = counter->liveBytes;
+}
+
+static inline void Py3dMemory_Untrack(struct Py3dMemoryCounter *counter, Py_ssize_t bytes) {
+    --counter->live;
+    counter->liveBytes -= bytes;
+}
+
+// MemoryTracker only has static methods reading the counters
+extern PyTypeObject Py3dMemoryTracker_Type;
+
+extern int PyInit_Py3dMemoryTracker(PyObject *module);
+
+extern PyObject *Py3dMemoryTracker_Stats(PyObject *cls, PyObject *args);
+extern PyObject *Py3dMemoryTracker_ResetPeaks(PyObject *cls, PyObject *args);
+
+#endif
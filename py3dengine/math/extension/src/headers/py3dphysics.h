@@ -0,0 +1,43 @@
+#ifndef PY3DPHYSICS_H
+#define PY3DPHYSICS_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <physics.h>
+
+// Every body slot links the Transform it syncs with and that Transform's position Vector3 and orientation Quaternion
+#define PHYSICS_LINKS_PER_BODY 3
+
+struct Py3dPhysicsWorld {
+    PyObject_HEAD
+    struct PhysicsWorld world;
+    PyObject **links;
+    int linkCapacity;
+    // Set while step runs without the GIL, the world must not be changed by other threads until it is cleared
+    int stepping;
+};
+extern PyTypeObject Py3dPhysicsWorld_Type;
+
+extern int PyInit_Py3dPhysicsWorld(PyObject *module);
+
+extern PyObject *Py3dPhysicsWorld_GetBodyCount(struct Py3dPhysicsWorld *self, void *closure);
+extern PyObject *Py3dPhysicsWorld_GetPairCount(struct Py3dPhysicsWorld *self, void *closure);
+extern PyObject *Py3dPhysicsWorld_GetContactCount(struct Py3dPhysicsWorld *self, void *closure);
+extern PyObject *Py3dPhysicsWorld_GetGravity(struct Py3dPhysicsWorld *self, void *closure);
+extern int Py3dPhysicsWorld_SetGravity(struct Py3dPhysicsWorld *self, PyObject *value, void *closure);
+extern PyObject *Py3dPhysicsWorld_GetStepping(struct Py3dPhysicsWorld *self, void *closure);
+extern PyObject *Py3dPhysicsWorld_GetIterations(struct Py3dPhysicsWorld *self, void *closure);
+extern int Py3dPhysicsWorld_SetIterations(struct Py3dPhysicsWorld *self, PyObject *value, void *closure);
+
+extern PyObject *Py3dPhysicsWorld_AddBody(struct Py3dPhysicsWorld *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dPhysicsWorld_RemoveBody(struct Py3dPhysicsWorld *self, PyObject *args);
+extern PyObject *Py3dPhysicsWorld_GetVelocity(struct Py3dPhysicsWorld *self, PyObject *args);
+extern PyObject *Py3dPhysicsWorld_SetVelocity(struct Py3dPhysicsWorld *self, PyObject *args);
+extern PyObject *Py3dPhysicsWorld_ApplyImpulse(struct Py3dPhysicsWorld *self, PyObject *args);
+extern PyObject *Py3dPhysicsWorld_Step(struct Py3dPhysicsWorld *self, PyObject *args);
+extern PyObject *Py3dPhysicsWorld_ReadTransforms(struct Py3dPhysicsWorld *self, PyObject *args);
+extern PyObject *Py3dPhysicsWorld_WriteTransforms(struct Py3dPhysicsWorld *self, PyObject *args);
+extern PyObject *Py3dPhysicsWorld_CopyState(struct Py3dPhysicsWorld *self, PyObject *args);
+
+#endif
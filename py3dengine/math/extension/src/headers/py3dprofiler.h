@@ -0,0 +1,24 @@
+#ifndef PY3DPROFILER_H
+#define PY3DPROFILER_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <profiler.h>
+
+// Profiler only has static methods, the zones of every thread live in the library
+extern PyTypeObject Py3dProfiler_Type;
+
+extern int PyInit_Py3dProfiler(PyObject *module);
+
+extern PyObject *Py3dProfiler_SetEnabled(PyObject *cls, PyObject *args);
+extern PyObject *Py3dProfiler_IsEnabled(PyObject *cls, PyObject *args);
+extern PyObject *Py3dProfiler_Now(PyObject *cls, PyObject *args);
+extern PyObject *Py3dProfiler_Begin(PyObject *cls, PyObject *name);
+extern PyObject *Py3dProfiler_End(PyObject *cls, PyObject *name);
+extern PyObject *Py3dProfiler_SetThreadName(PyObject *cls, PyObject *args);
+extern PyObject *Py3dProfiler_ThreadName(PyObject *cls, PyObject *args);
+extern PyObject *Py3dProfiler_Collect(PyObject *cls, PyObject *args);
+extern PyObject *Py3dProfiler_DroppedEvents(PyObject *cls, PyObject *args);
+
+#endif
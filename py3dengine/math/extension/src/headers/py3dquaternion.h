@@ -22,6 +22,12 @@ extern PyObject *Py3dQuaternion_GetW(struct Py3dQuaternion *self, void *closure)
 extern PyObject *Py3dQuaternion_FromAxisAndDegrees(struct Py3dQuaternion *self, PyObject *args, PyObject *kwds);
 extern PyObject *Py3dQuaternion_Normalize(struct Py3dQuaternion *self, PyObject *args);
 extern PyObject *Py3dQuaternion_Mult(struct Py3dQuaternion *self, PyObject *other);
+extern PyObject *Py3dQuaternion_Slerp(struct Py3dQuaternion *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dQuaternion_Nlerp(struct Py3dQuaternion *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dQuaternion_ToMatrix(struct Py3dQuaternion *self, PyObject *args);
+extern PyObject *Py3dQuaternion_FromMatrix(struct Py3dQuaternion *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dQuaternion_NormalizeBatch(struct Py3dQuaternion *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dQuaternion_RotateBatch(struct Py3dQuaternion *self, PyObject *args, PyObject *kwds);
 
 
 #endif
@@ -0,0 +1,27 @@
+#ifndef PY3DRASTERIZER_H
+#define PY3DRASTERIZER_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <raster.h>
+
+struct Py3dRasterizer {
+    PyObject_HEAD
+    struct RasterTarget target;
+    // Set while a draw runs without the GIL so another thread can't use the same buffers
+    int busy;
+};
+extern PyTypeObject Py3dRasterizer_Type;
+
+extern int PyInit_Py3dRasterizer(PyObject *module);
+
+extern PyObject *Py3dRasterizer_GetWidth(struct Py3dRasterizer *self, void *closure);
+extern PyObject *Py3dRasterizer_GetHeight(struct Py3dRasterizer *self, void *closure);
+
+extern PyObject *Py3dRasterizer_Clear(struct Py3dRasterizer *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dRasterizer_Draw(struct Py3dRasterizer *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dRasterizer_ColorBytes(struct Py3dRasterizer *self, PyObject *args);
+extern PyObject *Py3dRasterizer_ReadDepth(struct Py3dRasterizer *self, PyObject *args);
+
+#endif
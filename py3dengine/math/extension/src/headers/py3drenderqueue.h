@@ -0,0 +1,37 @@
+#ifndef PY3DRENDERQUEUE_H
+#define PY3DRENDERQUEUE_H
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <renderqueue.h>
+
+struct Py3dRenderQueue {
+    PyObject_HEAD
+    struct RenderQueue queue;
+    // Materials and meshes are interned to the 16 bit ids of the sort keys, dicts map objects to ids, lists ids to objects
+    PyObject *materialIds;
+    PyObject *materials;
+    PyObject *meshIds;
+    PyObject *meshes;
+    float cameraPosition[VEC_3_SIZE];
+    int flushing;
+    int lastCommandCount;
+    int lastBatchCount;
+    int lastStateChangeCount;
+};
+extern PyTypeObject Py3dRenderQueue_Type;
+
+extern int PyInit_Py3dRenderQueue(PyObject *module);
+
+extern PyObject *Py3dRenderQueue_GetCameraPosition(struct Py3dRenderQueue *self, void *closure);
+extern int Py3dRenderQueue_SetCameraPosition(struct Py3dRenderQueue *self, PyObject *value, void *closure);
+extern PyObject *Py3dRenderQueue_GetStateCount(struct Py3dRenderQueue *self, void *closure);
+extern PyObject *Py3dRenderQueue_GetLastFlush(struct Py3dRenderQueue *self, void *closure);
+
+extern PyObject *Py3dRenderQueue_Submit(struct Py3dRenderQueue *self, PyObject *args, PyObject *kwds);
+extern PyObject *Py3dRenderQueue_Flush(struct Py3dRenderQueue *self, PyObject *args);
+extern PyObject *Py3dRenderQueue_Reset(struct Py3dRenderQueue *self, PyObject *args);
+extern PyObject *Py3dRenderQueue_ReleaseStates(struct Py3dRenderQueue *self, PyObject *args);
+
+#endif
@@ -0,0 +1,546 @@
+#include "py3danimation.h"
+
+#include "py3dbuffer.h"
+
+static int Py3dAnimationClip_Init(struct Py3dAnimationClip *self, PyObject *args, PyObject *kwds);
+static void Py3dAnimationClip_Dealloc(struct Py3dAnimationClip *self);
+static int Py3dSkeleton_Init(struct Py3dSkeleton *self, PyObject *args, PyObject *kwds);
+static void Py3dSkeleton_Dealloc(struct Py3dSkeleton *self);
+
+static const char *channelNames[ANIM_CHANNEL_COUNT] = {"translation", "rotation", "scale"};
+static const int channelStrides[ANIM_CHANNEL_COUNT] = {VEC_3_SIZE, QUATERNION_SIZE, VEC_3_SIZE};
+
+static PyGetSetDef Py3dAnimationClip_GettersSetters[] = {
+    {"duration", (getter) Py3dAnimationClip_GetDuration, (setter) NULL, "Length of the clip in seconds", NULL},
+    {"track_count", (getter) Py3dAnimationClip_GetTrackCount, (setter) NULL, "Number of animated bone channels", NULL},
+    {NULL}
+};
+
+PyTypeObject Py3dAnimationClip_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.AnimationClip",
+    .tp_doc = "Keyframe tracks for the bones of a Skeleton, built from a duration and (bone, channel, times, values) tracks",
+    .tp_basicsize = sizeof(struct Py3dAnimationClip),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_init = (initproc) Py3dAnimationClip_Init,
+    .tp_dealloc = (destructor) Py3dAnimationClip_Dealloc,
+    .tp_new = PyType_GenericNew,
+    .tp_getset = Py3dAnimationClip_GettersSetters
+};
+
+static PyGetSetDef Py3dSkeleton_GettersSetters[] = {
+    {"bone_count", (getter) Py3dSkeleton_GetBoneCount, (setter) NULL, "Number of bones", NULL},
+    {NULL}
+};
+
+static PyMethodDef Py3dSkeleton_Methods[] = {
+    {"evaluate", (PyCFunction) Py3dSkeleton_Evaluate, METH_VARARGS | METH_KEYWORDS, "Sample (clip, time) or (clip, time, clip_b, time_b, weight) jobs into consecutive skinning palettes of a float32 buffer"},
+    {"SkinVertices", (PyCFunction) Py3dSkeleton_SkinVertices, METH_VARARGS | METH_KEYWORDS | METH_STATIC, "Linear blend skin packed positions (and optionally normals) with 4 int32 bone indices and weights per vertex, returns the vertex count"},
+    {NULL}
+};
+
+PyTypeObject Py3dSkeleton_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.Skeleton",
+    .tp_doc = "A bone hierarchy built from parent indices, optional inverse bind matrices and an optional rest pose",
+    .tp_basicsize = sizeof(struct Py3dSkeleton),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_init = (initproc) Py3dSkeleton_Init,
+    .tp_methods = Py3dSkeleton_Methods,
+    .tp_dealloc = (destructor) Py3dSkeleton_Dealloc,
+    .tp_new = PyType_GenericNew,
+    .tp_getset = Py3dSkeleton_GettersSetters
+};
+
+int PyInit_Py3dAnimation(PyObject *module) {
+    if (PyType_Ready(&Py3dAnimationClip_Type) < 0) return 0;
+    if (PyType_Ready(&Py3dSkeleton_Type) < 0) return 0;
+
+    if (PyModule_AddObjectRef(module, "AnimationClip", (PyObject *) &Py3dAnimationClip_Type) < 0) return 0;
+    if (PyModule_AddObjectRef(module, "Skeleton", (PyObject *) &Py3dSkeleton_Type) < 0) return 0;
+
+    return 1;
+}
+
+/** AnimationClip */
+static int parseChannel(PyObject *name) {
+    for (int c = 0; c < ANIM_CHANNEL_COUNT; ++c) {
+        if (PyUnicode_Check(name) && PyUnicode_CompareWithASCIIString(name, channelNames[c]) == 0) return c;
+    }
+
+    PyErr_SetString(PyExc_ValueError, "Track channel must be \"translation\", \"rotation\" or \"scale\"");
+    return -1;
+}
+
+// Appends every number of a sequence to dest, which must have room for them
+static int copyFloats(float *dest, PyObject *fast) {
+    Py_ssize_t size = PySequence_Fast_GET_SIZE(fast);
+    PyObject **items = PySequence_Fast_ITEMS(fast);
+
+    for (Py_ssize_t i = 0; i < size; ++i) {
+        double value = PyFloat_AsDouble(items[i]);
+        if (value == -1.0 && PyErr_Occurred()) return 0;
+
+        dest[i] = (float) value;
+    }
+
+    return 1;
+}
+
+struct ClipTracks {
+    Py_ssize_t trackCount;
+    int *bones;
+    int *channels;
+    int *keyCounts;
+    float *times;
+    float *values;
+};
+
+static void releaseTracks(struct ClipTracks *tracks) {
+    PyMem_Free(tracks->bones);
+    PyMem_Free(tracks->channels);
+    PyMem_Free(tracks->keyCounts);
+    PyMem_Free(tracks->times);
+    PyMem_Free(tracks->values);
+}
+
+// Gathers the (bone, channel, times, values) tuples into the flat arrays AnimClipInit expects
+static int parseTracks(struct ClipTracks *tracks, PyObject *tracksFast) {
+    Py_ssize_t trackCount = PySequence_Fast_GET_SIZE(tracksFast);
+    PyObject **trackItems = PySequence_Fast_ITEMS(tracksFast);
+    size_t trackSlots = (size_t) (trackCount > 0 ? trackCount : 1);
+    Py_ssize_t keyTotal = 0, valueTotal = 0;
+
+    memset(tracks, 0, sizeof(struct ClipTracks));
+    if (trackCount > INT_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "Too many animation tracks");
+        return 0;
+    }
+
+    tracks->trackCount = trackCount;
+    tracks->bones = PyMem_Malloc(sizeof(int) * trackSlots);
+    tracks->channels = PyMem_Malloc(sizeof(int) * trackSlots);
+    tracks->keyCounts = PyMem_Malloc(sizeof(int) * trackSlots);
+    if (tracks->bones == NULL || tracks->channels == NULL || tracks->keyCounts == NULL) {
+        PyErr_NoMemory();
+        return 0;
+    }
+
+    // First pass validates and sizes, second pass copies the keys
+    for (int pass = 0; pass < 2; ++pass) {
+        Py_ssize_t keyOffset = 0, valueOffset = 0;
+
+        for (Py_ssize_t t = 0; t < trackCount; ++t) {
+            int bone = 0;
+            PyObject *channelObj = NULL, *timesObj = NULL, *valuesObj = NULL;
+            if (!PyTuple_Check(trackItems[t])) {
+                PyErr_Format(PyExc_TypeError, "Track %zd must be a (bone, channel, times, values) tuple", t);
+                return 0;
+            }
+            if (!PyArg_ParseTuple(trackItems[t], "iOOO", &bone, &channelObj, &timesObj, &valuesObj)) return 0;
+
+            int channel = parseChannel(channelObj);
+            if (channel < 0) return 0;
+
+            PyObject *times = PySequence_Fast(timesObj, "Track times must be a sequence");
+            PyObject *values = times == NULL ? NULL : PySequence_Fast(valuesObj, "Track values must be a sequence");
+            if (values == NULL) {
+                Py_XDECREF(times);
+                return 0;
+            }
+
+            Py_ssize_t keyCount = PySequence_Fast_GET_SIZE(times);
+            int valid = bone >= 0 && keyCount > 0 && keyCount <= INT_MAX &&
+                        PySequence_Fast_GET_SIZE(values) == keyCount * channelStrides[channel];
+
+            if (pass == 0) {
+                tracks->bones[t] = bone;
+                tracks->channels[t] = channel;
+                tracks->keyCounts[t] = (int) keyCount;
+                if (!valid) {
+                    PyErr_Format(
+                        PyExc_ValueError,
+                        "Track %zd needs a bone index of at least 0, at least one key and %d values per key",
+                        t, channelStrides[channel]
+                    );
+                }
+            } else if (copyFloats(&tracks->times[keyOffset], times)) {
+                copyFloats(&tracks->values[valueOffset], values);
+
+                for (Py_ssize_t k = keyOffset + 1; k < keyOffset + keyCount; ++k) {
+                    if (!(tracks->times[k] > tracks->times[k - 1])) {
+                        PyErr_Format(PyExc_ValueError, "Track %zd key times must be strictly increasing", t);
+                        break;
+                    }
+                }
+            }
+
+            Py_DECREF(times);
+            Py_DECREF(values);
+            if (PyErr_Occurred()) return 0;
+
+            keyOffset += keyCount;
+            valueOffset += keyCount * channelStrides[channel];
+        }
+
+        keyTotal = keyOffset;
+        valueTotal = valueOffset;
+
+        if (pass == 0) {
+            tracks->times = PyMem_Malloc(sizeof(float) * (keyTotal > 0 ? keyTotal : 1));
+            tracks->values = PyMem_Malloc(sizeof(float) * (valueTotal > 0 ? valueTotal : 1));
+            if (tracks->times == NULL || tracks->values == NULL) {
+                PyErr_NoMemory();
+                return 0;
+            }
+        }
+    }
+
+    if (keyTotal > INT_MAX || valueTotal > INT_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "Too many animation keys");
+        return 0;
+    }
+
+    return 1;
+}
+
+static int Py3dAnimationClip_Init(struct Py3dAnimationClip *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    float duration = 0.0f;
+    PyObject *tracksObj = NULL;
+    if (PyArg_ParseTuple(args, "fO", &duration, &tracksObj) != 1) return -1;
+
+    if (!(duration > 0.0f)) {
+        PyErr_SetString(PyExc_ValueError, "Clip duration must be positive");
+        return -1;
+    }
+
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "AnimationClip is being evaluated");
+        return -1;
+    }
+
+    PyObject *tracksFast = PySequence_Fast(tracksObj, "Clip tracks must be a sequence");
+    if (tracksFast == NULL) return -1;
+
+    struct ClipTracks tracks;
+    int parsed = parseTracks(&tracks, tracksFast);
+    Py_CLEAR(tracksFast);
+
+    if (parsed) {
+        AnimClipRelease(&self->clip);
+        if (
+            !AnimClipInit(
+                &self->clip, duration, (int) tracks.trackCount,
+                tracks.bones, tracks.channels, tracks.keyCounts, tracks.times, tracks.values
+            )
+        ) {
+            PyErr_NoMemory();
+            parsed = 0;
+        }
+    }
+
+    releaseTracks(&tracks);
+
+    return parsed ? 0 : -1;
+}
+
+static void Py3dAnimationClip_Dealloc(struct Py3dAnimationClip *self) {
+    AnimClipRelease(&self->clip);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+PyObject *Py3dAnimationClip_GetDuration(struct Py3dAnimationClip *self, void *Py_UNUSED(closure)) {
+    return PyFloat_FromDouble(self->clip.duration);
+}
+
+PyObject *Py3dAnimationClip_GetTrackCount(struct Py3dAnimationClip *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromLong(self->clip.trackCount);
+}
+
+/** Skeleton */
+static int Py3dSkeleton_Init(struct Py3dSkeleton *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"parents", "inverse_bind", "rest_pose", NULL};
+    PyObject *parentsObj = NULL, *inverseBindObj = Py_None, *restObj = Py_None;
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "O|OO", kwlist, &parentsObj, &inverseBindObj, &restObj) != 1) return -1;
+
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "Skeleton is being evaluated");
+        return -1;
+    }
+
+    PyObject *parentsFast = PySequence_Fast(parentsObj, "Skeleton parents must be a sequence");
+    if (parentsFast == NULL) return -1;
+
+    Py_ssize_t boneCount = PySequence_Fast_GET_SIZE(parentsFast);
+    int *parents = PyMem_Malloc(sizeof(int) * (boneCount > 0 ? boneCount : 1));
+    Py_buffer inverseBind = {0}, rest = {0};
+    int haveInverseBind = 0, haveRest = 0, result = -1;
+
+    if (parents == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    for (Py_ssize_t i = 0; i < boneCount; ++i) {
+        long parent = PyLong_AsLong(PySequence_Fast_GET_ITEM(parentsFast, i));
+        if (parent == -1 && PyErr_Occurred()) goto done;
+
+        if (parent < -1 || parent >= i) {
+            PyErr_Format(PyExc_ValueError, "Bone %zd must have a parent of -1 or an earlier bone", i);
+            goto done;
+        }
+        parents[i] = (int) parent;
+    }
+
+    if (inverseBindObj != Py_None) {
+        if (!(haveInverseBind = Py3dBuffer_GetFloats(inverseBindObj, &inverseBind, 0))) goto done;
+        if (inverseBind.len != boneCount * MAT_4_SIZE * (Py_ssize_t) sizeof(float)) {
+            PyErr_SetString(PyExc_ValueError, "Skeleton inverse bind matrices must be 16 floats per bone");
+            goto done;
+        }
+    }
+
+    if (restObj != Py_None) {
+        if (!(haveRest = Py3dBuffer_GetFloats(restObj, &rest, 0))) goto done;
+        if (rest.len != boneCount * ANIM_TRANSFORM_SIZE * (Py_ssize_t) sizeof(float)) {
+            PyErr_SetString(PyExc_ValueError, "Skeleton rest pose must be 10 floats per bone");
+            goto done;
+        }
+    }
+
+    AnimSkeletonRelease(&self->skeleton);
+    if (
+        boneCount > INT_MAX ||
+        !AnimSkeletonInit(
+            &self->skeleton, (int) boneCount, parents,
+            haveInverseBind ? inverseBind.buf : NULL,
+            haveRest ? rest.buf : NULL
+        )
+    ) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    result = 0;
+
+done:
+    if (haveRest) PyBuffer_Release(&rest);
+    if (haveInverseBind) PyBuffer_Release(&inverseBind);
+    PyMem_Free(parents);
+    Py_CLEAR(parentsFast);
+
+    return result;
+}
+
+static void Py3dSkeleton_Dealloc(struct Py3dSkeleton *self) {
+    AnimSkeletonRelease(&self->skeleton);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+PyObject *Py3dSkeleton_GetBoneCount(struct Py3dSkeleton *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromLong(self->skeleton.boneCount);
+}
+
+static int checkClip(struct Py3dSkeleton *self, struct Py3dAnimationClip *clip) {
+    if (clip->clip.maxBone >= self->skeleton.boneCount) {
+        PyErr_Format(
+            PyExc_ValueError, "Clip animates bone %d but the skeleton has %d bones",
+            clip->clip.maxBone, self->skeleton.boneCount
+        );
+        return 0;
+    }
+
+    return 1;
+}
+
+// Every job is a validated (clip, time[, clip, time, weight]) tuple
+static void markClipsBusy(PyObject *jobsTuple, int delta) {
+    for (Py_ssize_t j = 0; j < PyTuple_GET_SIZE(jobsTuple); ++j) {
+        PyObject *job = PyTuple_GET_ITEM(jobsTuple, j);
+        ((struct Py3dAnimationClip *) PyTuple_GET_ITEM(job, 0))->busy += delta;
+        if (PyTuple_GET_SIZE(job) > 2) ((struct Py3dAnimationClip *) PyTuple_GET_ITEM(job, 2))->busy += delta;
+    }
+}
+
+PyObject *Py3dSkeleton_Evaluate(struct Py3dSkeleton *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"jobs", "out", "loop", "threads", NULL};
+    PyObject *jobsObj = NULL, *outObj = NULL;
+    int loop = 1, threads = 0;
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "OO|pi", kwlist, &jobsObj, &outObj, &loop, &threads) != 1) return NULL;
+
+    // The tuple keeps every clip alive while the GIL is released, the busy counts keep the clips and the skeleton from
+    // being re-initialized by another thread
+    PyObject *jobsTuple = PySequence_Tuple(jobsObj);
+    if (jobsTuple == NULL) return NULL;
+
+    Py_ssize_t jobCount = PyTuple_GET_SIZE(jobsTuple);
+    struct AnimJob *jobs = PyMem_Malloc(sizeof(struct AnimJob) * (jobCount > 0 ? jobCount : 1));
+    Py_buffer out;
+    int haveOut = 0;
+    PyObject *result = NULL;
+
+    if (jobs == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    if (!(haveOut = Py3dBuffer_GetFloats(outObj, &out, 1))) goto done;
+
+    Py_ssize_t paletteFloats = (Py_ssize_t) self->skeleton.boneCount * MAT_4_SIZE;
+    if (jobCount > INT_MAX || out.len < jobCount * paletteFloats * (Py_ssize_t) sizeof(float)) {
+        PyErr_SetString(PyExc_ValueError, "Output buffer must hold 16 floats per bone for every job");
+        goto done;
+    }
+
+    for (Py_ssize_t j = 0; j < jobCount; ++j) {
+        struct Py3dAnimationClip *clipA = NULL, *clipB = NULL;
+        struct AnimJob *job = &jobs[j];
+        memset(job, 0, sizeof(struct AnimJob));
+
+        PyObject *jobItem = PyTuple_GET_ITEM(jobsTuple, j);
+        if (!PyTuple_Check(jobItem)) {
+            PyErr_Format(PyExc_TypeError, "Job %zd must be a (clip, time[, clip, time, weight]) tuple", j);
+            goto done;
+        }
+
+        if (
+            !PyArg_ParseTuple(
+                jobItem, "O!f|O!ff",
+                &Py3dAnimationClip_Type, &clipA, &job->timeA,
+                &Py3dAnimationClip_Type, &clipB, &job->timeB, &job->weight
+            )
+        ) goto done;
+
+        if (!checkClip(self, clipA) || (clipB != NULL && !checkClip(self, clipB))) goto done;
+
+        job->clipA = &clipA->clip;
+        job->clipB = clipB != NULL ? &clipB->clip : NULL;
+        job->outPalette = (float *) out.buf + j * paletteFloats;
+    }
+
+    int success;
+    self->busy += 1;
+    markClipsBusy(jobsTuple, 1);
+    Py_BEGIN_ALLOW_THREADS
+    success = AnimEvaluate(&self->skeleton, jobs, (int) jobCount, loop, threads);
+    Py_END_ALLOW_THREADS
+    markClipsBusy(jobsTuple, -1);
+    self->busy -= 1;
+
+    if (!success) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    result = Py_NewRef(Py_None);
+
+done:
+    if (haveOut) PyBuffer_Release(&out);
+    PyMem_Free(jobs);
+    Py_CLEAR(jobsTuple);
+
+    return result;
+}
+
+enum SkinBuffer {
+    SKIN_PALETTE, SKIN_POSITIONS, SKIN_INDICES, SKIN_WEIGHTS, SKIN_OUT_POSITIONS, SKIN_NORMALS, SKIN_OUT_NORMALS,
+    SKIN_BUFFER_COUNT
+};
+
+static int checkSkinBuffers(Py_buffer *views, int haveNormals, Py_ssize_t *outVertexCount) {
+    Py_ssize_t vec3Size = (Py_ssize_t) sizeof(float[VEC_3_SIZE]);
+    Py_ssize_t influenceSize = (Py_ssize_t) sizeof(float[SKIN_INFLUENCES]);
+    Py_ssize_t vertexCount = views[SKIN_POSITIONS].len / vec3Size;
+    Py_ssize_t boneCount = views[SKIN_PALETTE].len / (Py_ssize_t) sizeof(float[MAT_4_SIZE]);
+
+    if (
+        views[SKIN_POSITIONS].len % vec3Size != 0 ||
+        vertexCount > INT_MAX ||
+        views[SKIN_INDICES].len != vertexCount * influenceSize ||
+        views[SKIN_WEIGHTS].len != vertexCount * influenceSize ||
+        views[SKIN_OUT_POSITIONS].len < views[SKIN_POSITIONS].len ||
+        (haveNormals && views[SKIN_NORMALS].len != views[SKIN_POSITIONS].len) ||
+        (haveNormals && views[SKIN_OUT_NORMALS].len < views[SKIN_POSITIONS].len)
+    ) {
+        PyErr_SetString(
+            PyExc_ValueError,
+            "Skinning needs 3 floats per position and normal, 4 bone indices and weights per vertex and room in the outputs"
+        );
+        return 0;
+    }
+
+    const int *bones = views[SKIN_INDICES].buf;
+    for (Py_ssize_t i = 0; i < vertexCount * SKIN_INFLUENCES; ++i) {
+        if (bones[i] < 0 || bones[i] >= boneCount) {
+            PyErr_Format(PyExc_ValueError, "Bone index %d is outside of the %zd matrix palette", bones[i], boneCount);
+            return 0;
+        }
+    }
+
+    *outVertexCount = vertexCount;
+    return 1;
+}
+
+PyObject *Py3dSkeleton_SkinVertices(struct Py3dSkeleton *Py_UNUSED(self), PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {
+        "palette", "positions", "bone_indices", "bone_weights", "out_positions", "normals", "out_normals", "threads", NULL
+    };
+    PyObject *objs[SKIN_BUFFER_COUNT] = {NULL};
+    objs[SKIN_NORMALS] = Py_None;
+    objs[SKIN_OUT_NORMALS] = Py_None;
+    int threads = 0;
+    if (
+        PyArg_ParseTupleAndKeywords(
+            args, kwds, "OOOOO|OOi", kwlist,
+            &objs[SKIN_PALETTE], &objs[SKIN_POSITIONS], &objs[SKIN_INDICES], &objs[SKIN_WEIGHTS],
+            &objs[SKIN_OUT_POSITIONS], &objs[SKIN_NORMALS], &objs[SKIN_OUT_NORMALS], &threads
+        ) != 1
+    ) return NULL;
+
+    int haveNormals = objs[SKIN_NORMALS] != Py_None;
+    if (haveNormals != (objs[SKIN_OUT_NORMALS] != Py_None)) {
+        PyErr_SetString(PyExc_ValueError, "Normals and out_normals must be given together");
+        return NULL;
+    }
+
+    Py_buffer views[SKIN_BUFFER_COUNT];
+    int viewCount = haveNormals ? SKIN_BUFFER_COUNT : SKIN_NORMALS;
+    int acquired = 0;
+    PyObject *result = NULL;
+
+    for (; acquired < viewCount; ++acquired) {
+        int writable = acquired == SKIN_OUT_POSITIONS || acquired == SKIN_OUT_NORMALS;
+        int success = acquired == SKIN_INDICES ?
+            Py3dBuffer_GetInts(objs[acquired], &views[acquired], writable) :
+            Py3dBuffer_GetFloats(objs[acquired], &views[acquired], writable);
+        if (!success) goto done;
+    }
+
+    Py_ssize_t vertexCount = 0;
+    if (!checkSkinBuffers(views, haveNormals, &vertexCount)) goto done;
+
+    Py_BEGIN_ALLOW_THREADS
+    SkinVertices(
+        views[SKIN_OUT_POSITIONS].buf,
+        haveNormals ? views[SKIN_OUT_NORMALS].buf : NULL,
+        views[SKIN_POSITIONS].buf,
+        haveNormals ? views[SKIN_NORMALS].buf : NULL,
+        views[SKIN_INDICES].buf,
+        views[SKIN_WEIGHTS].buf,
+        views[SKIN_PALETTE].buf,
+        (int) vertexCount,
+        threads
+    );
+    Py_END_ALLOW_THREADS
+
+    result = PyLong_FromSsize_t(vertexCount);
+
+done:
+    while (acquired > 0) {
+        PyBuffer_Release(&views[--acquired]);
+    }
+
+    return result;
+}
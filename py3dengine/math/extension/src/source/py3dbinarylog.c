@@ -0,0 +1,227 @@
+#include "py3dbinarylog.h"
+
+#include <profiler.h>
+
+#define MAX_PAYLOAD 1024
+#define MAX_ARGUMENTS 32
+#define ARGUMENT_TYPES "ifbs"
+
+static int Py3dBinaryLog_Init(struct Py3dBinaryLog *self, PyObject *args, PyObject *kwds);
+static void Py3dBinaryLog_Dealloc(struct Py3dBinaryLog *self);
+
+static PyGetSetDef Py3dBinaryLog_GettersSetters[] = {
+    {"formats", (getter) Py3dBinaryLog_GetFormats, (setter) NULL, "Tuple of the registered (format, argument types), indexed by format id", NULL},
+    {"record_count", (getter) Py3dBinaryLog_GetRecordCount, (setter) NULL, "Number of records held by the ring", NULL},
+    {"overwritten_count", (getter) Py3dBinaryLog_GetOverwrittenCount, (setter) NULL, "Number of oldest records overwritten since the last reset", NULL},
+    {"capacity", (getter) Py3dBinaryLog_GetCapacity, (setter) NULL, "Size of the ring in bytes", NULL},
+    {NULL}
+};
+
+static PyMethodDef Py3dBinaryLog_Methods[] = {
+    {"register", (PyCFunction) Py3dBinaryLog_Register, METH_VARARGS, "Register a str.format format with argument types from 'i' int, 'f' float, 'b' bool and 's' str, returns its id"},
+    {"write", (PyCFunction) Py3dBinaryLog_Write, METH_FASTCALL, "Record a format id with the current time and its raw arguments"},
+    {"snapshot", (PyCFunction) Py3dBinaryLog_Snapshot, METH_NOARGS, "Return the held records oldest first as bytes"},
+    {"reset", (PyCFunction) Py3dBinaryLog_Reset, METH_NOARGS, "Drop every record, registered formats are kept"},
+    {NULL}
+};
+
+PyTypeObject Py3dBinaryLog_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.BinaryLog",
+    .tp_doc = "A ring of binary log records holding a format id, a timestamp and raw arguments",
+    .tp_basicsize = sizeof(struct Py3dBinaryLog),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_init = (initproc) Py3dBinaryLog_Init,
+    .tp_methods = Py3dBinaryLog_Methods,
+    .tp_dealloc = (destructor) Py3dBinaryLog_Dealloc,
+    .tp_new = PyType_GenericNew,
+    .tp_getset = Py3dBinaryLog_GettersSetters
+};
+
+int PyInit_Py3dBinaryLog(PyObject *module) {
+    if (PyType_Ready(&Py3dBinaryLog_Type) < 0) return 0;
+
+    if (PyModule_AddObjectRef(module, "BinaryLog", (PyObject *) &Py3dBinaryLog_Type) < 0) return 0;
+
+    return 1;
+}
+
+static int Py3dBinaryLog_Init(struct Py3dBinaryLog *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"capacity", NULL};
+    Py_ssize_t capacity = 1 << 20;
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "|n", kwlist, &capacity) != 1) return -1;
+
+    if (capacity < BINARY_LOG_MIN_CAPACITY) {
+        PyErr_Format(PyExc_ValueError, "BinaryLog capacity must be at least %d bytes", BINARY_LOG_MIN_CAPACITY);
+        return -1;
+    }
+
+    // __init__ may be called again on an existing instance
+    BinaryLogRelease(&self->log);
+    Py_CLEAR(self->formats);
+
+    self->formats = PyList_New(0);
+    if (self->formats == NULL) return -1;
+
+    if (!BinaryLogInit(&self->log, (size_t) capacity)) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    return 0;
+}
+
+static void Py3dBinaryLog_Dealloc(struct Py3dBinaryLog *self) {
+    BinaryLogRelease(&self->log);
+    Py_CLEAR(self->formats);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static int checkInitialized(struct Py3dBinaryLog *self) {
+    if (self->formats != NULL && self->log.data != NULL) return 1;
+
+    PyErr_SetString(PyExc_RuntimeError, "BinaryLog is not initialized");
+    return 0;
+}
+
+PyObject *Py3dBinaryLog_GetFormats(struct Py3dBinaryLog *self, void *Py_UNUSED(closure)) {
+    if (!checkInitialized(self)) return NULL;
+
+    return PyList_AsTuple(self->formats);
+}
+
+PyObject *Py3dBinaryLog_GetRecordCount(struct Py3dBinaryLog *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromUnsignedLongLong(self->log.recordCount);
+}
+
+PyObject *Py3dBinaryLog_GetOverwrittenCount(struct Py3dBinaryLog *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromUnsignedLongLong(self->log.overwrittenCount);
+}
+
+PyObject *Py3dBinaryLog_GetCapacity(struct Py3dBinaryLog *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromSize_t(self->log.capacity);
+}
+
+PyObject *Py3dBinaryLog_Register(struct Py3dBinaryLog *self, PyObject *args) {
+    if (!checkInitialized(self)) return NULL;
+
+    PyObject *format = NULL;
+    const char *types = "";
+    if (PyArg_ParseTuple(args, "U|s", &format, &types) != 1) return NULL;
+
+    size_t typeCount = strlen(types);
+    if (typeCount > MAX_ARGUMENTS || strspn(types, ARGUMENT_TYPES) != typeCount) {
+        PyErr_Format(
+            PyExc_ValueError, "Argument types must be at most %d of '%s'", MAX_ARGUMENTS, ARGUMENT_TYPES
+        );
+        return NULL;
+    }
+
+    PyObject *entry = Py_BuildValue("(Os)", format, types);
+    if (entry == NULL) return NULL;
+
+    int appended = PyList_Append(self->formats, entry);
+    Py_DECREF(entry);
+    if (appended < 0) return NULL;
+
+    return PyLong_FromSsize_t(PyList_GET_SIZE(self->formats) - 1);
+}
+
+static int packArgument(unsigned char *payload, size_t *size, char type, PyObject *arg) {
+    switch (type) {
+        case 'i': {
+            long long value = PyLong_AsLongLong(arg);
+            if (value == -1 && PyErr_Occurred()) return 0;
+            memcpy(&payload[*size], &value, sizeof(long long));
+            *size += sizeof(long long);
+            return 1;
+        }
+        case 'f': {
+            double value = PyFloat_AsDouble(arg);
+            if (value == -1.0 && PyErr_Occurred()) return 0;
+            memcpy(&payload[*size], &value, sizeof(double));
+            *size += sizeof(double);
+            return 1;
+        }
+        case 'b': {
+            int value = PyObject_IsTrue(arg);
+            if (value < 0) return 0;
+            payload[(*size)++] = (unsigned char) value;
+            return 1;
+        }
+        default: {
+            Py_ssize_t length = 0;
+            const char *utf8 = PyUnicode_AsUTF8AndSize(arg, &length);
+            if (utf8 == NULL) return 0;
+
+            // Strings are cut to what fits in the payload, the decoder replaces a split character
+            size_t room = *size + sizeof(uint16_t) < MAX_PAYLOAD ? MAX_PAYLOAD - *size - sizeof(uint16_t) : 0;
+            uint16_t stored = (uint16_t) ((size_t) length < room ? (size_t) length : room);
+            memcpy(&payload[*size], &stored, sizeof(uint16_t));
+            memcpy(&payload[*size + sizeof(uint16_t)], utf8, stored);
+            *size += sizeof(uint16_t) + stored;
+            return 1;
+        }
+    }
+}
+
+PyObject *Py3dBinaryLog_Write(struct Py3dBinaryLog *self, PyObject *const *args, Py_ssize_t nargs) {
+    if (!checkInitialized(self)) return NULL;
+
+    if (nargs < 1) {
+        PyErr_SetString(PyExc_TypeError, "write takes a format id and its arguments");
+        return NULL;
+    }
+
+    Py_ssize_t formatId = PyLong_AsSsize_t(args[0]);
+    if (formatId == -1 && PyErr_Occurred()) return NULL;
+    if (formatId < 0 || formatId >= PyList_GET_SIZE(self->formats)) {
+        PyErr_Format(PyExc_KeyError, "No format is registered with id %zd", formatId);
+        return NULL;
+    }
+
+    PyObject *entry = PyList_GET_ITEM(self->formats, formatId);
+    const char *types = PyUnicode_AsUTF8(PyTuple_GET_ITEM(entry, 1));
+    if (types == NULL) return NULL;
+
+    Py_ssize_t typeCount = (Py_ssize_t) strlen(types);
+    if (nargs - 1 != typeCount) {
+        PyErr_Format(PyExc_TypeError, "Format %zd takes %zd arguments, %zd given", formatId, typeCount, nargs - 1);
+        return NULL;
+    }
+
+    // Fixed size arguments take at most 8 bytes each, strings are cut to fit what is left
+    unsigned char payload[MAX_PAYLOAD + MAX_ARGUMENTS * sizeof(double)];
+    size_t size = 0;
+    for (Py_ssize_t i = 0; i < typeCount; ++i) {
+        if (!packArgument(payload, &size, types[i], args[i + 1])) return NULL;
+    }
+
+    if (!BinaryLogWrite(&self->log, (uint32_t) formatId, ProfilerNow(), payload, size)) {
+        PyErr_SetString(PyExc_ValueError, "Record is larger than the BinaryLog");
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dBinaryLog_Snapshot(struct Py3dBinaryLog *self, PyObject *Py_UNUSED(args)) {
+    if (!checkInitialized(self)) return NULL;
+
+    size_t size = BinaryLogSize(&self->log);
+    PyObject *snapshot = PyBytes_FromStringAndSize(NULL, (Py_ssize_t) size);
+    if (snapshot == NULL) return NULL;
+
+    BinaryLogSnapshot(&self->log, (unsigned char *) PyBytes_AS_STRING(snapshot), size);
+
+    return snapshot;
+}
+
+PyObject *Py3dBinaryLog_Reset(struct Py3dBinaryLog *self, PyObject *Py_UNUSED(args)) {
+    if (!checkInitialized(self)) return NULL;
+
+    BinaryLogReset(&self->log);
+
+    Py_RETURN_NONE;
+}
@@ -0,0 +1,354 @@
+#include "py3dbroadphase.h"
+
+#include <math.h>
+
+#include "py3dvector3.h"
+#include "py3dmatrix4x4.h"
+#include "py3dbuffer.h"
+
+static int Py3dSweepAndPrune_Init(struct Py3dSweepAndPrune *self, PyObject *args, PyObject *kwds);
+static void Py3dSweepAndPrune_Dealloc(struct Py3dSweepAndPrune *self);
+static int Py3dSweepAndPrune_Traverse(struct Py3dSweepAndPrune *self, visitproc visit, void *arg);
+static int Py3dSweepAndPrune_Clear(struct Py3dSweepAndPrune *self);
+static Py_ssize_t Py3dSweepAndPrune_Length(struct Py3dSweepAndPrune *self);
+static int checkNotUpdating(struct Py3dSweepAndPrune *self);
+
+static PyGetSetDef Py3dSweepAndPrune_GettersSetters[] = {
+    {"pair_count", (getter) Py3dSweepAndPrune_GetPairCount, (setter) NULL, "Number of overlapping pairs after the last update_pairs", NULL},
+    {"updating", (getter) Py3dSweepAndPrune_GetUpdating, (setter) NULL, "Whether update_pairs is running on another thread", NULL},
+    {NULL}
+};
+
+static PyMethodDef Py3dSweepAndPrune_Methods[] = {
+    {"insert", (PyCFunction) Py3dSweepAndPrune_Insert, METH_VARARGS, "Insert an object with a Vector3 min and max AABB, optionally transformed by a world Matrix4x4, returns its proxy id"},
+    {"update", (PyCFunction) Py3dSweepAndPrune_Update, METH_VARARGS, "Move a proxy to a new AABB, applied by the next update_pairs"},
+    {"update_batch", (PyCFunction) Py3dSweepAndPrune_UpdateBatch, METH_VARARGS, "Move many proxies from an int32 buffer of proxy ids and a float32 buffer of 6 floats (min, max) per proxy"},
+    {"remove", (PyCFunction) Py3dSweepAndPrune_Remove, METH_VARARGS, "Remove a proxy, its pairs end on the next update_pairs"},
+    {"update_pairs", (PyCFunction) Py3dSweepAndPrune_UpdatePairs, METH_NOARGS, "Apply every change, returns (began, ended) lists of (object, object) pairs"},
+    {"get_pairs", (PyCFunction) Py3dSweepAndPrune_GetPairs, METH_NOARGS, "Return every overlapping (object, object) pair as of the last update_pairs"},
+    {NULL}
+};
+
+static PySequenceMethods Py3dSweepAndPrune_SequenceMethods = {
+    .sq_length = (lenfunc) Py3dSweepAndPrune_Length,
+};
+
+PyTypeObject Py3dSweepAndPrune_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.SweepAndPrune",
+    .tp_doc = "An incremental sweep and prune broadphase with a persistent overlapping pair cache",
+    .tp_basicsize = sizeof(struct Py3dSweepAndPrune),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_init = (initproc) Py3dSweepAndPrune_Init,
+    .tp_methods = Py3dSweepAndPrune_Methods,
+    .tp_dealloc = (destructor) Py3dSweepAndPrune_Dealloc,
+    .tp_traverse = (traverseproc) Py3dSweepAndPrune_Traverse,
+    .tp_clear = (inquiry) Py3dSweepAndPrune_Clear,
+    .tp_new = PyType_GenericNew,
+    .tp_getset = Py3dSweepAndPrune_GettersSetters
+};
+
+int PyInit_Py3dSweepAndPrune(PyObject *module) {
+    Py3dSweepAndPrune_Type.tp_as_sequence = &Py3dSweepAndPrune_SequenceMethods;
+    if (PyType_Ready(&Py3dSweepAndPrune_Type) < 0) return 0;
+
+    if (PyModule_AddObjectRef(module, "SweepAndPrune", (PyObject *) &Py3dSweepAndPrune_Type) < 0) return 0;
+
+    return 1;
+}
+
+static int Py3dSweepAndPrune_Init(struct Py3dSweepAndPrune *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    if (PyArg_ParseTuple(args, "") != 1) return -1;
+    if (!checkNotUpdating(self)) return -1;
+
+    // __init__ may be called again on an existing instance
+    SapRelease(&self->sap);
+    SapInit(&self->sap);
+
+    Py_CLEAR(self->objects);
+    Py_CLEAR(self->removed);
+    self->objects = PyDict_New();
+    self->removed = PyList_New(0);
+    if (self->objects == NULL || self->removed == NULL) return -1;
+
+    return 0;
+}
+
+static void Py3dSweepAndPrune_Dealloc(struct Py3dSweepAndPrune *self) {
+    PyObject_GC_UnTrack(self);
+    Py3dSweepAndPrune_Clear(self);
+    SapRelease(&self->sap);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static int Py3dSweepAndPrune_Traverse(struct Py3dSweepAndPrune *self, visitproc visit, void *arg) {
+    Py_VISIT(self->objects);
+    Py_VISIT(self->removed);
+
+    return 0;
+}
+
+static int Py3dSweepAndPrune_Clear(struct Py3dSweepAndPrune *self) {
+    Py_CLEAR(self->objects);
+    Py_CLEAR(self->removed);
+
+    return 0;
+}
+
+static Py_ssize_t Py3dSweepAndPrune_Length(struct Py3dSweepAndPrune *self) {
+    return self->sap.activeCount;
+}
+
+static int checkInitialized(struct Py3dSweepAndPrune *self) {
+    if (self->objects == NULL || self->removed == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "SweepAndPrune was not initialized");
+        return 0;
+    }
+
+    return 1;
+}
+
+// The sweep reads and reallocates the endpoint and pair arrays with the GIL released
+static int checkNotUpdating(struct Py3dSweepAndPrune *self) {
+    if (self->updating) {
+        PyErr_SetString(PyExc_RuntimeError, "SweepAndPrune cannot be changed while it is updating pairs");
+        return 0;
+    }
+
+    return 1;
+}
+
+static int checkProxy(struct Py3dSweepAndPrune *self, int proxy) {
+    if (!SapIsValidProxy(&self->sap, proxy)) {
+        PyErr_Format(PyExc_KeyError, "%d is not a valid proxy", proxy);
+        return 0;
+    }
+
+    return 1;
+}
+
+static void buildAabb(float out[AABB_SIZE], struct Py3dVector3 *min, struct Py3dVector3 *max, PyObject *world) {
+    for (int i = 0; i < 3; ++i) {
+        out[i] = fminf(min->elements[i], max->elements[i]);
+        out[i + 3] = fmaxf(min->elements[i], max->elements[i]);
+    }
+
+    if (world != NULL && world != Py_None) {
+        AabbTransform(out, out, ((struct Py3dMatrix4x4 *) world)->elements);
+    }
+}
+
+PyObject *Py3dSweepAndPrune_Insert(struct Py3dSweepAndPrune *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    PyObject *obj = NULL;
+    struct Py3dVector3 *min = NULL, *max = NULL;
+    struct Py3dMatrix4x4 *world = NULL;
+    if (
+        PyArg_ParseTuple(
+            args, "OO!O!|O!",
+            &obj,
+            &Py3dVector3_Type, &min,
+            &Py3dVector3_Type, &max,
+            &Py3dMatrix4x4_Type, &world
+        ) != 1
+    ) return NULL;
+    if (!checkInitialized(self) || !checkNotUpdating(self)) return NULL;
+
+    float aabb[AABB_SIZE];
+    buildAabb(aabb, min, max, (PyObject *) world);
+
+    int proxy = SapAddProxy(&self->sap, aabb, 0);
+    if (proxy == SAP_NULL_PROXY) return PyErr_NoMemory();
+
+    PyObject *key = PyLong_FromLong(proxy);
+    if (key == NULL || PyDict_SetItem(self->objects, key, obj) < 0) {
+        Py_XDECREF(key);
+        SapRemoveProxy(&self->sap, proxy);
+        return NULL;
+    }
+
+    return key;
+}
+
+PyObject *Py3dSweepAndPrune_Update(struct Py3dSweepAndPrune *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    int proxy = SAP_NULL_PROXY;
+    struct Py3dVector3 *min = NULL, *max = NULL;
+    struct Py3dMatrix4x4 *world = NULL;
+    if (
+        PyArg_ParseTuple(
+            args, "iO!O!|O!",
+            &proxy,
+            &Py3dVector3_Type, &min,
+            &Py3dVector3_Type, &max,
+            &Py3dMatrix4x4_Type, &world
+        ) != 1
+    ) return NULL;
+    if (!checkNotUpdating(self) || !checkProxy(self, proxy)) return NULL;
+
+    float aabb[AABB_SIZE];
+    buildAabb(aabb, min, max, (PyObject *) world);
+    SapSetProxyAabb(&self->sap, proxy, aabb);
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dSweepAndPrune_UpdateBatch(struct Py3dSweepAndPrune *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    PyObject *proxiesObject = NULL, *boundsObject = NULL;
+    if (PyArg_ParseTuple(args, "OO", &proxiesObject, &boundsObject) != 1) return NULL;
+    if (!checkNotUpdating(self)) return NULL;
+
+    Py_buffer proxiesView, boundsView;
+    if (!Py3dBuffer_GetInts(proxiesObject, &proxiesView, 0)) return NULL;
+    if (!Py3dBuffer_GetFloats(boundsObject, &boundsView, 0)) {
+        PyBuffer_Release(&proxiesView);
+        return NULL;
+    }
+
+    Py_ssize_t count = proxiesView.len / (Py_ssize_t) sizeof(int);
+    const int *proxies = proxiesView.buf;
+    const float *bounds = boundsView.buf;
+    PyObject *result = NULL;
+
+    if (boundsView.len / (Py_ssize_t) sizeof(float) != count * AABB_SIZE) {
+        PyErr_SetString(PyExc_ValueError, "Bounds must hold 6 floats (min, max) for every proxy");
+        goto done;
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        if (!checkProxy(self, proxies[i])) goto done;
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        SapSetProxyAabb(&self->sap, proxies[i], bounds + i * AABB_SIZE);
+    }
+    result = PyLong_FromSsize_t(count);
+
+done:
+    PyBuffer_Release(&proxiesView);
+    PyBuffer_Release(&boundsView);
+
+    return result;
+}
+
+PyObject *Py3dSweepAndPrune_Remove(struct Py3dSweepAndPrune *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    int proxy = SAP_NULL_PROXY;
+    if (PyArg_ParseTuple(args, "i", &proxy) != 1) return NULL;
+    if (!checkInitialized(self) || !checkNotUpdating(self) || !checkProxy(self, proxy)) return NULL;
+
+    PyObject *key = PyLong_FromLong(proxy);
+    if (key == NULL) return NULL;
+
+    int result = PyList_Append(self->removed, key);
+    Py_CLEAR(key);
+    if (result < 0) return NULL;
+
+    SapRemoveProxy(&self->sap, proxy);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *lookupObject(struct Py3dSweepAndPrune *self, int proxy) {
+    PyObject *key = PyLong_FromLong(proxy);
+    if (key == NULL) return NULL;
+
+    PyObject *obj = PyDict_GetItemWithError(self->objects, key);
+    Py_CLEAR(key);
+    if (obj == NULL && !PyErr_Occurred()) {
+        PyErr_SetString(PyExc_AssertionError, "SweepAndPrune proxy has no object");
+    }
+
+    return obj;
+}
+
+static PyObject *buildPair(struct Py3dSweepAndPrune *self, int proxyA, int proxyB) {
+    PyObject *a = lookupObject(self, proxyA);
+    PyObject *b = a == NULL ? NULL : lookupObject(self, proxyB);
+    if (b == NULL) return NULL;
+
+    return PyTuple_Pack(2, a, b);
+}
+
+static PyObject *buildEventList(struct Py3dSweepAndPrune *self, const int *events, int count) {
+    PyObject *result = PyList_New(count);
+    if (result == NULL) return NULL;
+
+    for (int i = 0; i < count; ++i) {
+        PyObject *pair = buildPair(self, events[i * 2], events[i * 2 + 1]);
+        if (pair == NULL) {
+            Py_CLEAR(result);
+            return NULL;
+        }
+
+        PyList_SET_ITEM(result, i, pair);
+    }
+
+    return result;
+}
+
+PyObject *Py3dSweepAndPrune_UpdatePairs(struct Py3dSweepAndPrune *self, PyObject *Py_UNUSED(args)) {
+    if (!checkInitialized(self) || !checkNotUpdating(self)) return NULL;
+
+    // Set and cleared while the GIL is held, so no other thread sees a half finished sweep
+    int ok;
+    self->updating = 1;
+    Py_BEGIN_ALLOW_THREADS
+    ok = SapUpdate(&self->sap);
+    Py_END_ALLOW_THREADS
+    self->updating = 0;
+    if (!ok) return PyErr_NoMemory();
+
+    PyObject *began = buildEventList(self, self->sap.beginEvents, self->sap.beginCount);
+    PyObject *ended = began == NULL ? NULL : buildEventList(self, self->sap.endEvents, self->sap.endCount);
+    if (ended == NULL) {
+        Py_XDECREF(began);
+        return NULL;
+    }
+
+    // Removed proxies reported their end events, their ids may be handed out again from here on
+    Py_ssize_t removedCount = PyList_GET_SIZE(self->removed);
+    for (Py_ssize_t i = 0; i < removedCount; ++i) {
+        if (PyDict_DelItem(self->objects, PyList_GET_ITEM(self->removed, i)) < 0) {
+            Py_DECREF(began);
+            Py_DECREF(ended);
+            return NULL;
+        }
+    }
+    if (PyList_SetSlice(self->removed, 0, removedCount, NULL) < 0) {
+        Py_DECREF(began);
+        Py_DECREF(ended);
+        return NULL;
+    }
+
+    PyObject *result = PyTuple_Pack(2, began, ended);
+    Py_DECREF(began);
+    Py_DECREF(ended);
+
+    return result;
+}
+
+PyObject *Py3dSweepAndPrune_GetPairs(struct Py3dSweepAndPrune *self, PyObject *Py_UNUSED(args)) {
+    if (!checkInitialized(self) || !checkNotUpdating(self)) return NULL;
+
+    PyObject *result = PyList_New(self->sap.pairCount);
+    if (result == NULL) return NULL;
+
+    for (int i = 0; i < self->sap.pairCount; ++i) {
+        PyObject *pair = buildPair(self, self->sap.pairs[i].a, self->sap.pairs[i].b);
+        if (pair == NULL) {
+            Py_CLEAR(result);
+            return NULL;
+        }
+
+        PyList_SET_ITEM(result, i, pair);
+    }
+
+    return result;
+}
+
+PyObject *Py3dSweepAndPrune_GetPairCount(struct Py3dSweepAndPrune *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromLong(self->sap.pairCount);
+}
+
+PyObject *Py3dSweepAndPrune_GetUpdating(struct Py3dSweepAndPrune *self, void *Py_UNUSED(closure)) {
+    return PyBool_FromLong(self->updating);
+}
@@ -0,0 +1,36 @@
+#include "py3dbuffer.h"
+
+#include <string.h>
+
+static int isFormat(const Py_buffer *view, const char *formats) {
+    const char *f = view->format;
+    if (f == NULL) return 0;
+    if (*f == '@' || *f == '=' || *f == '<') ++f;
+
+    return f[0] != '\0' && f[1] == '\0' && strchr(formats, f[0]) != NULL;
+}
+
+static int getBuffer(PyObject *obj, Py_buffer *view, int writable, const char *formats, const char *error) {
+    int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+    if (PyObject_GetBuffer(obj, view, flags) < 0) return 0;
+
+    if (view->itemsize != 4 || !isFormat(view, formats)) {
+        PyBuffer_Release(view);
+        PyErr_SetString(PyExc_ValueError, error);
+        return 0;
+    }
+
+    return 1;
+}
+
+int Py3dBuffer_GetFloats(PyObject *obj, Py_buffer *view, int writable) {
+    return getBuffer(obj, view, writable, "f", "Expected a buffer of float32");
+}
+
+int Py3dBuffer_GetInts(PyObject *obj, Py_buffer *view, int writable) {
+    return getBuffer(obj, view, writable, "il", "Expected a buffer of int32");
+}
+
+int Py3dBuffer_GetIndices(PyObject *obj, Py_buffer *view, int writable) {
+    return getBuffer(obj, view, writable, "iIlL", "Expected a buffer of int32 or uint32");
+}
@@ -0,0 +1,375 @@
+#include "py3dbvh.h"
+
+#include <math.h>
+
+#include "py3dvector3.h"
+#include "py3dmatrix4x4.h"
+
+#define QUERY_BUFFER_SIZE 64
+
+static int Py3dBoundingVolumeHierarchy_Init(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *kwds);
+static void Py3dBoundingVolumeHierarchy_Dealloc(struct Py3dBoundingVolumeHierarchy *self);
+static int Py3dBoundingVolumeHierarchy_Traverse(struct Py3dBoundingVolumeHierarchy *self, visitproc visit, void *arg);
+static int Py3dBoundingVolumeHierarchy_Clear(struct Py3dBoundingVolumeHierarchy *self);
+static Py_ssize_t Py3dBoundingVolumeHierarchy_Length(struct Py3dBoundingVolumeHierarchy *self);
+
+static PyGetSetDef Py3dBoundingVolumeHierarchy_GettersSetters[] = {
+    {"height", (getter) Py3dBoundingVolumeHierarchy_GetHeight, (setter) NULL, "Height of the tree", NULL},
+    {NULL}
+};
+
+static PyMethodDef Py3dBoundingVolumeHierarchy_Methods[] = {
+    {"insert", (PyCFunction) Py3dBoundingVolumeHierarchy_Insert, METH_VARARGS, "Insert an object with a Vector3 min and max AABB, optionally transformed by a world Matrix4x4, returns its proxy id"},
+    {"update", (PyCFunction) Py3dBoundingVolumeHierarchy_Update, METH_VARARGS, "Move a proxy to a new AABB, returns True if the tree had to be restructured"},
+    {"set_bounds", (PyCFunction) Py3dBoundingVolumeHierarchy_SetBounds, METH_VARARGS, "Move a proxy without restructuring the tree, refit must be called before the next query"},
+    {"remove", (PyCFunction) Py3dBoundingVolumeHierarchy_Remove, METH_VARARGS, "Remove a proxy from the tree"},
+    {"refit", (PyCFunction) Py3dBoundingVolumeHierarchy_Refit, METH_NOARGS, "Recompute every internal AABB after set_bounds calls"},
+    {"rebuild", (PyCFunction) Py3dBoundingVolumeHierarchy_Rebuild, METH_NOARGS, "Rebuild the tree top down with the surface area heuristic"},
+    {"ray_cast", (PyCFunction) Py3dBoundingVolumeHierarchy_RayCast, METH_VARARGS, "Return (object, t) for the closest hit along origin + t * direction, or None"},
+    {"query_aabb", (PyCFunction) Py3dBoundingVolumeHierarchy_QueryAabb, METH_VARARGS, "Return every object whose AABB overlaps the Vector3 min and max"},
+    {"query_sphere", (PyCFunction) Py3dBoundingVolumeHierarchy_QuerySphere, METH_VARARGS, "Return every object whose AABB comes within radius of a Vector3 center"},
+    {"nearest", (PyCFunction) Py3dBoundingVolumeHierarchy_Nearest, METH_VARARGS, "Return up to k (object, distance) pairs closest to a Vector3, nearest first"},
+    {NULL}
+};
+
+static PySequenceMethods Py3dBoundingVolumeHierarchy_SequenceMethods = {
+    .sq_length = (lenfunc) Py3dBoundingVolumeHierarchy_Length,
+};
+
+PyTypeObject Py3dBoundingVolumeHierarchy_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.BoundingVolumeHierarchy",
+    .tp_doc = "A dynamic AABB tree for spatial queries",
+    .tp_basicsize = sizeof(struct Py3dBoundingVolumeHierarchy),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_init = (initproc) Py3dBoundingVolumeHierarchy_Init,
+    .tp_methods = Py3dBoundingVolumeHierarchy_Methods,
+    .tp_dealloc = (destructor) Py3dBoundingVolumeHierarchy_Dealloc,
+    .tp_traverse = (traverseproc) Py3dBoundingVolumeHierarchy_Traverse,
+    .tp_clear = (inquiry) Py3dBoundingVolumeHierarchy_Clear,
+    .tp_new = PyType_GenericNew,
+    .tp_getset = Py3dBoundingVolumeHierarchy_GettersSetters
+};
+
+int PyInit_Py3dBoundingVolumeHierarchy(PyObject *module) {
+    Py3dBoundingVolumeHierarchy_Type.tp_as_sequence = &Py3dBoundingVolumeHierarchy_SequenceMethods;
+    if (PyType_Ready(&Py3dBoundingVolumeHierarchy_Type) < 0) return 0;
+
+    if (PyModule_AddObjectRef(module, "BoundingVolumeHierarchy", (PyObject *) &Py3dBoundingVolumeHierarchy_Type) < 0) return 0;
+
+    return 1;
+}
+
+static int Py3dBoundingVolumeHierarchy_Init(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    float margin = 0.1f;
+    if (PyArg_ParseTuple(args, "|f", &margin) != 1) return -1;
+
+    // __init__ may be called again on an existing instance
+    BvhRelease(&self->bvh);
+    BvhInit(&self->bvh, margin);
+
+    Py_CLEAR(self->objects);
+    self->objects = PyDict_New();
+    if (self->objects == NULL) return -1;
+
+    return 0;
+}
+
+static void Py3dBoundingVolumeHierarchy_Dealloc(struct Py3dBoundingVolumeHierarchy *self) {
+    PyObject_GC_UnTrack(self);
+    Py3dBoundingVolumeHierarchy_Clear(self);
+    BvhRelease(&self->bvh);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static int Py3dBoundingVolumeHierarchy_Traverse(struct Py3dBoundingVolumeHierarchy *self, visitproc visit, void *arg) {
+    Py_VISIT(self->objects);
+
+    return 0;
+}
+
+static int Py3dBoundingVolumeHierarchy_Clear(struct Py3dBoundingVolumeHierarchy *self) {
+    Py_CLEAR(self->objects);
+
+    return 0;
+}
+
+static Py_ssize_t Py3dBoundingVolumeHierarchy_Length(struct Py3dBoundingVolumeHierarchy *self) {
+    return self->bvh.leafCount;
+}
+
+static int checkInitialized(struct Py3dBoundingVolumeHierarchy *self) {
+    if (self->objects == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "BoundingVolumeHierarchy was not initialized");
+        return 0;
+    }
+
+    return 1;
+}
+
+static int checkProxy(struct Py3dBoundingVolumeHierarchy *self, int proxy) {
+    if (!BvhIsValidProxy(&self->bvh, proxy)) {
+        PyErr_Format(PyExc_KeyError, "%d is not a valid proxy", proxy);
+        return 0;
+    }
+
+    return 1;
+}
+
+static void buildAabb(float out[AABB_SIZE], struct Py3dVector3 *min, struct Py3dVector3 *max, PyObject *world) {
+    for (int i = 0; i < 3; ++i) {
+        out[i] = fminf(min->elements[i], max->elements[i]);
+        out[i + 3] = fmaxf(min->elements[i], max->elements[i]);
+    }
+
+    if (world != NULL && world != Py_None) {
+        AabbTransform(out, out, ((struct Py3dMatrix4x4 *) world)->elements);
+    }
+}
+
+static PyObject *lookupObject(struct Py3dBoundingVolumeHierarchy *self, int proxy) {
+    PyObject *key = PyLong_FromLong(proxy);
+    if (key == NULL) return NULL;
+
+    PyObject *obj = PyDict_GetItemWithError(self->objects, key);
+    Py_CLEAR(key);
+    if (obj == NULL && !PyErr_Occurred()) {
+        PyErr_SetString(PyExc_AssertionError, "BoundingVolumeHierarchy proxy has no object");
+    }
+
+    return obj;
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_Insert(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    PyObject *obj = NULL;
+    struct Py3dVector3 *min = NULL, *max = NULL;
+    struct Py3dMatrix4x4 *world = NULL;
+    if (
+        PyArg_ParseTuple(
+            args, "OO!O!|O!",
+            &obj,
+            &Py3dVector3_Type, &min,
+            &Py3dVector3_Type, &max,
+            &Py3dMatrix4x4_Type, &world
+        ) != 1
+    ) return NULL;
+    if (!checkInitialized(self)) return NULL;
+
+    float aabb[AABB_SIZE];
+    buildAabb(aabb, min, max, (PyObject *) world);
+
+    int proxy = BvhInsert(&self->bvh, aabb, 0);
+    if (proxy == BVH_NULL_NODE) return PyErr_NoMemory();
+
+    PyObject *key = PyLong_FromLong(proxy);
+    if (key == NULL || PyDict_SetItem(self->objects, key, obj) < 0) {
+        Py_XDECREF(key);
+        BvhRemove(&self->bvh, proxy);
+        return NULL;
+    }
+
+    return key;
+}
+
+static PyObject *do_Move(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, int restructure) {
+    int proxy = BVH_NULL_NODE;
+    struct Py3dVector3 *min = NULL, *max = NULL;
+    struct Py3dMatrix4x4 *world = NULL;
+    if (
+        PyArg_ParseTuple(
+            args, "iO!O!|O!",
+            &proxy,
+            &Py3dVector3_Type, &min,
+            &Py3dVector3_Type, &max,
+            &Py3dMatrix4x4_Type, &world
+        ) != 1
+    ) return NULL;
+    if (!checkProxy(self, proxy)) return NULL;
+
+    float aabb[AABB_SIZE];
+    buildAabb(aabb, min, max, (PyObject *) world);
+
+    if (!restructure) {
+        BvhSetLeafAabb(&self->bvh, proxy, aabb);
+        Py_RETURN_NONE;
+    }
+
+    return PyBool_FromLong(BvhUpdate(&self->bvh, proxy, aabb));
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_Update(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Move(self, args, 1);
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_SetBounds(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Move(self, args, 0);
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_Remove(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    int proxy = BVH_NULL_NODE;
+    if (PyArg_ParseTuple(args, "i", &proxy) != 1) return NULL;
+    if (!checkProxy(self, proxy)) return NULL;
+
+    PyObject *key = PyLong_FromLong(proxy);
+    if (key == NULL) return NULL;
+
+    int result = PyDict_DelItem(self->objects, key);
+    Py_CLEAR(key);
+    if (result < 0) return NULL;
+
+    BvhRemove(&self->bvh, proxy);
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_Refit(struct Py3dBoundingVolumeHierarchy *self, PyObject *Py_UNUSED(args)) {
+    if (!checkInitialized(self)) return NULL;
+
+    BvhRefit(&self->bvh);
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_Rebuild(struct Py3dBoundingVolumeHierarchy *self, PyObject *Py_UNUSED(args)) {
+    if (!checkInitialized(self)) return NULL;
+
+    if (!BvhRebuild(&self->bvh)) return PyErr_NoMemory();
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_RayCast(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dVector3 *origin = NULL, *direction = NULL;
+    float maxT = INFINITY;
+    if (
+        PyArg_ParseTuple(
+            args, "O!O!|f",
+            &Py3dVector3_Type, &origin,
+            &Py3dVector3_Type, &direction,
+            &maxT
+        ) != 1
+    ) return NULL;
+    if (!checkInitialized(self)) return NULL;
+
+    int proxy = BVH_NULL_NODE;
+    float t = 0.0f;
+    int hit = BvhRayCast(&self->bvh, origin->elements, direction->elements, maxT, &proxy, &t);
+    if (hit < 0) return PyErr_NoMemory();
+    if (hit == 0) Py_RETURN_NONE;
+
+    PyObject *obj = lookupObject(self, proxy);
+    if (obj == NULL) return NULL;
+
+    return Py_BuildValue("(Of)", obj, t);
+}
+
+static PyObject *buildObjectList(struct Py3dBoundingVolumeHierarchy *self, const int *proxies, int count) {
+    PyObject *result = PyList_New(count);
+    if (result == NULL) return NULL;
+
+    for (int i = 0; i < count; ++i) {
+        PyObject *obj = lookupObject(self, proxies[i]);
+        if (obj == NULL) {
+            Py_CLEAR(result);
+            return NULL;
+        }
+
+        PyList_SET_ITEM(result, i, Py_NewRef(obj));
+    }
+
+    return result;
+}
+
+// Runs a query into a stack buffer and retries into a heap buffer when there were more results than fit
+static PyObject *do_Query(struct Py3dBoundingVolumeHierarchy *self, const float *a, const float *b, float radius) {
+    int buffer[QUERY_BUFFER_SIZE];
+    int *proxies = buffer;
+    int capacity = QUERY_BUFFER_SIZE;
+
+    while (1) {
+        int found = a != NULL
+            ? BvhQueryAabb(&self->bvh, a, proxies, capacity)
+            : BvhQuerySphere(&self->bvh, b, radius, proxies, capacity);
+
+        if (found < 0) {
+            if (proxies != buffer) PyMem_Free(proxies);
+            return PyErr_NoMemory();
+        }
+
+        if (found <= capacity) {
+            PyObject *result = buildObjectList(self, proxies, found);
+            if (proxies != buffer) PyMem_Free(proxies);
+            return result;
+        }
+
+        if (proxies != buffer) PyMem_Free(proxies);
+        capacity = found;
+        proxies = PyMem_Malloc(sizeof(int) * capacity);
+        if (proxies == NULL) return PyErr_NoMemory();
+    }
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_QueryAabb(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dVector3 *min = NULL, *max = NULL;
+    if (PyArg_ParseTuple(args, "O!O!", &Py3dVector3_Type, &min, &Py3dVector3_Type, &max) != 1) return NULL;
+    if (!checkInitialized(self)) return NULL;
+
+    float aabb[AABB_SIZE];
+    buildAabb(aabb, min, max, NULL);
+
+    return do_Query(self, aabb, NULL, 0.0f);
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_QuerySphere(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dVector3 *center = NULL;
+    float radius = 0.0f;
+    if (PyArg_ParseTuple(args, "O!f", &Py3dVector3_Type, &center, &radius) != 1) return NULL;
+    if (!checkInitialized(self)) return NULL;
+
+    return do_Query(self, NULL, center->elements, radius);
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_Nearest(struct Py3dBoundingVolumeHierarchy *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dVector3 *point = NULL;
+    int k = 1;
+    if (PyArg_ParseTuple(args, "O!|i", &Py3dVector3_Type, &point, &k) != 1) return NULL;
+    if (!checkInitialized(self)) return NULL;
+
+    if (k <= 0) return PyList_New(0);
+    if (k > self->bvh.leafCount) k = self->bvh.leafCount;
+    if (k == 0) return PyList_New(0);
+
+    int *proxies = PyMem_Malloc(sizeof(int) * k);
+    float *distSq = PyMem_Malloc(sizeof(float) * k);
+    if (proxies == NULL || distSq == NULL) {
+        PyMem_Free(proxies);
+        PyMem_Free(distSq);
+        return PyErr_NoMemory();
+    }
+
+    int found = BvhQueryNearest(&self->bvh, point->elements, k, proxies, distSq);
+    PyObject *result = found < 0 ? PyErr_NoMemory() : PyList_New(found);
+
+    for (int i = 0; result != NULL && i < found; ++i) {
+        PyObject *obj = lookupObject(self, proxies[i]);
+        PyObject *pair = obj == NULL ? NULL : Py_BuildValue("(Of)", obj, sqrtf(distSq[i]));
+        if (pair == NULL) {
+            Py_CLEAR(result);
+            break;
+        }
+
+        PyList_SET_ITEM(result, i, pair);
+    }
+
+    PyMem_Free(proxies);
+    PyMem_Free(distSq);
+
+    return result;
+}
+
+PyObject *Py3dBoundingVolumeHierarchy_GetHeight(struct Py3dBoundingVolumeHierarchy *self, void *Py_UNUSED(closure)) {
+    if (!checkInitialized(self)) return NULL;
+
+    return PyLong_FromLong(BvhGetHeight(&self->bvh));
+}
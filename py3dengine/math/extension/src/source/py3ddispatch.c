@@ -0,0 +1,100 @@
+#include <stdlib.h>
+
+#include "py3ddispatch.h"
+
+static PyMethodDef Py3dDispatch_Methods[] = {
+    {"Tier", (PyCFunction) Py3dDispatch_Tier, METH_NOARGS | METH_STATIC, "Return the name of the tier the math kernels are bound to"},
+    {"DetectedTier", (PyCFunction) Py3dDispatch_DetectedTier, METH_NOARGS | METH_STATIC, "Return the name of the best tier this CPU supports"},
+    {"SupportedTiers", (PyCFunction) Py3dDispatch_SupportedTiers, METH_NOARGS | METH_STATIC, "Return the names of every tier this CPU supports, slowest first"},
+    {"SetTier", (PyCFunction) Py3dDispatch_SetTier, METH_VARARGS | METH_STATIC, "Bind the math kernels to a tier by name, for tests and benchmarks"},
+    {NULL}
+};
+
+PyTypeObject Py3dDispatch_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.Dispatch",
+    .tp_doc = "Selects the scalar, SSE, AVX2 or AVX-512 kernels of the hot math functions for the running CPU",
+    .tp_basicsize = sizeof(PyObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_methods = Py3dDispatch_Methods,
+};
+
+// A forced tier that is unknown or unsupported falls back to the detected one with a warning rather than failing the
+// import, a wrong environment on a production host must not take the engine down
+static int initTier(void) {
+    enum DispatchTier tier = DispatchDetectTier();
+
+    const char *forced = getenv(PY3DMATH_FORCE_TIER_ENV);
+    if (forced != NULL && forced[0] != '\0') {
+        int forcedTier = DispatchTierFromName(forced);
+        if (forcedTier < 0) {
+            if (PyErr_WarnFormat(PyExc_RuntimeWarning, 1, "%s=%s is not a tier, using %s",
+                                 PY3DMATH_FORCE_TIER_ENV, forced, DispatchTierName(tier)) < 0) return 0;
+        } else if (!DispatchTierSupported(forcedTier)) {
+            if (PyErr_WarnFormat(PyExc_RuntimeWarning, 1, "%s=%s is not supported by this CPU, using %s",
+                                 PY3DMATH_FORCE_TIER_ENV, forced, DispatchTierName(tier)) < 0) return 0;
+        } else {
+            tier = forcedTier;
+        }
+    }
+
+    DispatchInit(tier);
+
+    return 1;
+}
+
+int PyInit_Py3dDispatch(PyObject *module) {
+    if (PyType_Ready(&Py3dDispatch_Type) < 0) return 0;
+
+    if (!initTier()) return 0;
+
+    if (PyModule_AddObjectRef(module, "Dispatch", (PyObject *) &Py3dDispatch_Type) < 0) return 0;
+
+    return 1;
+}
+
+PyObject *Py3dDispatch_Tier(PyObject *Py_UNUSED(cls), PyObject *Py_UNUSED(args)) {
+    return PyUnicode_FromString(DispatchTierName(DispatchCurrentTier()));
+}
+
+PyObject *Py3dDispatch_DetectedTier(PyObject *Py_UNUSED(cls), PyObject *Py_UNUSED(args)) {
+    return PyUnicode_FromString(DispatchTierName(DispatchDetectTier()));
+}
+
+PyObject *Py3dDispatch_SupportedTiers(PyObject *Py_UNUSED(cls), PyObject *Py_UNUSED(args)) {
+    PyObject *tiers = PyList_New(0);
+    if (tiers == NULL) return NULL;
+
+    for (int tier = 0; tier < DISPATCH_TIER_COUNT; ++tier) {
+        if (!DispatchTierSupported(tier)) continue;
+
+        PyObject *name = PyUnicode_FromString(DispatchTierName(tier));
+        if (name == NULL || PyList_Append(tiers, name) < 0) {
+            Py_XDECREF(name);
+            Py_DECREF(tiers);
+            return NULL;
+        }
+        Py_DECREF(name);
+    }
+
+    return tiers;
+}
+
+PyObject *Py3dDispatch_SetTier(PyObject *Py_UNUSED(cls), PyObject *args) {
+    const char *name = NULL;
+    if (PyArg_ParseTuple(args, "s", &name) != 1) return NULL;
+
+    int tier = DispatchTierFromName(name);
+    if (tier < 0) {
+        PyErr_Format(PyExc_ValueError, "\"%s\" is not a tier", name);
+        return NULL;
+    }
+
+    if (!DispatchInit(tier)) {
+        PyErr_Format(PyExc_ValueError, "Tier \"%s\" is not supported by this CPU", name);
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
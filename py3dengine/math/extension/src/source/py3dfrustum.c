@@ -0,0 +1,244 @@
+#include "py3dfrustum.h"
+
+#include "py3dbuffer.h"
+#include "py3dvector3.h"
+#include "py3dmatrix4x4.h"
+
+#define MAX_CULL_INPUTS 6
+
+static int Py3dFrustum_Init(struct Py3dFrustum *self, PyObject *args, PyObject *kwds);
+static void Py3dFrustum_Dealloc(struct Py3dFrustum *self);
+
+static PyGetSetDef Py3dFrustum_GettersSetters[] = {
+    {"planes", (getter) Py3dFrustum_GetPlanes, (setter) NULL, "Tuple of the 6 (a, b, c, d) planes: left, right, bottom, top, near, far", NULL},
+    {NULL}
+};
+
+static PyMethodDef Py3dFrustum_Methods[] = {
+    {"update", (PyCFunction) Py3dFrustum_Update, METH_VARARGS, "Extract the planes from a view projection Matrix4x4"},
+    {"test_point", (PyCFunction) Py3dFrustum_TestPoint, METH_VARARGS, "Return True if a Vector3 is inside the frustum"},
+    {"test_sphere", (PyCFunction) Py3dFrustum_TestSphere, METH_VARARGS, "Return True if a sphere with a Vector3 center and a radius is at least partially inside the frustum"},
+    {"test_aabb", (PyCFunction) Py3dFrustum_TestAabb, METH_VARARGS, "Return True if an AABB with Vector3 min and max is at least partially inside the frustum"},
+    {"cull_spheres", (PyCFunction) Py3dFrustum_CullSpheres, METH_VARARGS, "Cull spheres given as float buffers x, y, z and radius, returns the visible indices or writes them to an int32 buffer and returns how many"},
+    {"cull_aabbs", (PyCFunction) Py3dFrustum_CullAabbs, METH_VARARGS, "Cull AABBs given as float buffers min x, y, z and max x, y, z, returns the visible indices or writes them to an int32 buffer and returns how many"},
+    {NULL}
+};
+
+PyTypeObject Py3dFrustum_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.Frustum",
+    .tp_doc = "A view frustum extracted from a view projection matrix",
+    .tp_basicsize = sizeof(struct Py3dFrustum),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_init = (initproc) Py3dFrustum_Init,
+    .tp_methods = Py3dFrustum_Methods,
+    .tp_dealloc = (destructor) Py3dFrustum_Dealloc,
+    .tp_new = PyType_GenericNew,
+    .tp_getset = Py3dFrustum_GettersSetters
+};
+
+int PyInit_Py3dFrustum(PyObject *module) {
+    if (PyType_Ready(&Py3dFrustum_Type) < 0) return 0;
+
+    if (PyModule_AddObjectRef(module, "Frustum", (PyObject *) &Py3dFrustum_Type) < 0) return 0;
+
+    return 1;
+}
+
+static int Py3dFrustum_Init(struct Py3dFrustum *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dMatrix4x4 *viewProj = NULL;
+    if (PyArg_ParseTuple(args, "|O!", &Py3dMatrix4x4_Type, &viewProj) != 1) return -1;
+
+    float identity[MAT_4_SIZE];
+    Mat4Identity(identity);
+    FrustumFromMatrix(self->planes, viewProj != NULL ? viewProj->elements : identity);
+
+    return 0;
+}
+
+static void Py3dFrustum_Dealloc(struct Py3dFrustum *self) {
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+PyObject *Py3dFrustum_Update(struct Py3dFrustum *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dMatrix4x4 *viewProj = NULL;
+    if (PyArg_ParseTuple(args, "O!", &Py3dMatrix4x4_Type, &viewProj) != 1) return NULL;
+
+    FrustumFromMatrix(self->planes, viewProj->elements);
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dFrustum_TestPoint(struct Py3dFrustum *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dVector3 *point = NULL;
+    if (PyArg_ParseTuple(args, "O!", &Py3dVector3_Type, &point) != 1) return NULL;
+
+    return PyBool_FromLong(FrustumTestPoint(self->planes, point->elements));
+}
+
+PyObject *Py3dFrustum_TestSphere(struct Py3dFrustum *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dVector3 *center = NULL;
+    float radius = 0.0f;
+    if (PyArg_ParseTuple(args, "O!f", &Py3dVector3_Type, &center, &radius) != 1) return NULL;
+
+    return PyBool_FromLong(FrustumTestSphere(self->planes, center->elements, radius));
+}
+
+PyObject *Py3dFrustum_TestAabb(struct Py3dFrustum *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dVector3 *min = NULL, *max = NULL;
+    if (PyArg_ParseTuple(args, "O!O!", &Py3dVector3_Type, &min, &Py3dVector3_Type, &max) != 1) return NULL;
+
+    return PyBool_FromLong(FrustumTestAabb(self->planes, min->elements, max->elements));
+}
+
+static void releaseBuffers(Py_buffer *views, int count) {
+    for (int i = 0; i < count; ++i) {
+        PyBuffer_Release(&views[i]);
+    }
+}
+
+/**
+ * Acquire inputCount contiguous float32 buffers of equal length from args, followed by an optional writable int32
+ * output buffer which must be able to hold every index. Returns the volume count or -1 with an exception set.
+ */
+static Py_ssize_t acquireCullBuffers(PyObject *args, int inputCount, Py_buffer *views, Py_buffer *outView, int *hasOut) {
+    PyObject *objects[MAX_CULL_INPUTS + 1] = {NULL};
+    if (
+        PyArg_UnpackTuple(
+            args, "cull", inputCount, inputCount + 1,
+            &objects[0], &objects[1], &objects[2], &objects[3], &objects[4], &objects[5], &objects[6]
+        ) != 1
+    ) return -1;
+
+    // PyArg_UnpackTuple only fills as many pointers as were passed, the optional out buffer follows the inputs
+    PyObject *outObject = objects[inputCount];
+    Py_ssize_t count = -1;
+
+    for (int i = 0; i < inputCount; ++i) {
+        if (!Py3dBuffer_GetFloats(objects[i], &views[i], 0)) {
+            releaseBuffers(views, i);
+            return -1;
+        }
+
+        Py_ssize_t length = views[i].len / (Py_ssize_t) sizeof(float);
+        if (count >= 0 && length != count) {
+            PyErr_SetString(PyExc_ValueError, "Cull inputs must be of equal length");
+            releaseBuffers(views, i + 1);
+            return -1;
+        }
+
+        count = length;
+    }
+
+    if (count > INT_MAX) {
+        PyErr_SetString(PyExc_OverflowError, "Too many volumes to cull in one call");
+        releaseBuffers(views, inputCount);
+        return -1;
+    }
+
+    *hasOut = outObject != NULL && outObject != Py_None;
+    if (*hasOut) {
+        if (!Py3dBuffer_GetInts(outObject, outView, 1)) {
+            releaseBuffers(views, inputCount);
+            return -1;
+        }
+
+        if (outView->len / (Py_ssize_t) sizeof(int) < count) {
+            PyErr_SetString(PyExc_ValueError, "Cull output buffer is too small for every index");
+            PyBuffer_Release(outView);
+            releaseBuffers(views, inputCount);
+            return -1;
+        }
+    }
+
+    return count;
+}
+
+static PyObject *buildIndexResult(int *indices, int written, int hasOut) {
+    if (hasOut) return PyLong_FromLong(written);
+
+    PyObject *result = PyList_New(written);
+    if (result == NULL) return NULL;
+
+    for (int i = 0; i < written; ++i) {
+        PyObject *index = PyLong_FromLong(indices[i]);
+        if (index == NULL) {
+            Py_CLEAR(result);
+            return NULL;
+        }
+
+        PyList_SET_ITEM(result, i, index);
+    }
+
+    return result;
+}
+
+static PyObject *do_Cull(struct Py3dFrustum *self, PyObject *args, int inputCount) {
+    Py_buffer views[MAX_CULL_INPUTS];
+    Py_buffer outView;
+    int hasOut = 0;
+
+    Py_ssize_t count = acquireCullBuffers(args, inputCount, views, &outView, &hasOut);
+    if (count < 0) return NULL;
+
+    int *indices = hasOut ? outView.buf : PyMem_Malloc(sizeof(int) * (count > 0 ? count : 1));
+    if (indices == NULL) {
+        releaseBuffers(views, inputCount);
+        return PyErr_NoMemory();
+    }
+
+    int written;
+    Py_BEGIN_ALLOW_THREADS
+    if (inputCount == 4) {
+        written = FrustumCullSpheres(
+            indices, self->planes,
+            views[0].buf, views[1].buf, views[2].buf, views[3].buf,
+            (int) count
+        );
+    } else {
+        written = FrustumCullAabbs(
+            indices, self->planes,
+            views[0].buf, views[1].buf, views[2].buf, views[3].buf, views[4].buf, views[5].buf,
+            (int) count
+        );
+    }
+    Py_END_ALLOW_THREADS
+
+    PyObject *result = buildIndexResult(indices, written, hasOut);
+
+    if (hasOut) {
+        PyBuffer_Release(&outView);
+    } else {
+        PyMem_Free(indices);
+    }
+    releaseBuffers(views, inputCount);
+
+    return result;
+}
+
+PyObject *Py3dFrustum_CullSpheres(struct Py3dFrustum *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Cull(self, args, 4);
+}
+
+PyObject *Py3dFrustum_CullAabbs(struct Py3dFrustum *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Cull(self, args, 6);
+}
+
+PyObject *Py3dFrustum_GetPlanes(struct Py3dFrustum *self, void *Py_UNUSED(closure)) {
+    PyObject *planes = PyTuple_New(FRUSTUM_PLANE_COUNT);
+    if (planes == NULL) return NULL;
+
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        const float *plane = &self->planes[p * 4];
+        PyObject *value = Py_BuildValue("(ffff)", plane[0], plane[1], plane[2], plane[3]);
+        if (value == NULL) {
+            Py_CLEAR(planes);
+            return NULL;
+        }
+
+        PyTuple_SET_ITEM(planes, p, value);
+    }
+
+    return planes;
+}
@@ -1,6 +1,8 @@
 #include "py3dvector3.h"
 #include "py3dquaternion.h"
 #include "py3dmatrix4x4.h"
+#include "py3dbuffer.h"
+#include "py3dmemory.h"
 
 #include <structmember.h>
 
@@ -10,6 +12,7 @@
 
 static int Py3dMatrix4x4_Init(struct Py3dMatrix4x4 *self, PyObject *args, PyObject *kwds);
 static void Py3dMatrix4x4_Dealloc(struct Py3dMatrix4x4 *self);
+static PyObject *Py3dMatrix4x4_Alloc(PyTypeObject *type, Py_ssize_t itemCount);
 
 static PyMethodDef Py3dMatrix4x4_Methods[] = {
     {"copy", (PyCFunction) Py3dMatrix4x4_Copy, METH_NOARGS, "Copy an existing Matrix4x4"},
@@ -25,6 +28,14 @@ static PyMethodDef Py3dMatrix4x4_Methods[] = {
     {"RotationQuaternion", (PyCFunction) Py3dMatrix4x4_RotationQuaternion, METH_VARARGS | METH_STATIC, "Create a new rotation Matrix4x4 with the provided quaternion"},
     {"Scaling", (PyCFunction) Py3dMatrix4x4_Scaling, METH_VARARGS | METH_STATIC, "Create a new scaling Matrix4x4"},
     {"LookAtLH", (PyCFunction) Py3dMatrix4x4_LookAtLH, METH_VARARGS | METH_STATIC, "Create a new left handed look at Matrix4x4 using the supplied target and up vectors in world space"},
+    {"LookAtRH", (PyCFunction) Py3dMatrix4x4_LookAtRH, METH_VARARGS | METH_STATIC, "Create a new right handed look at Matrix4x4 using the supplied target and up vectors in world space"},
+    {"PerspectiveFovLH", (PyCFunction) Py3dMatrix4x4_PerspectiveFovLH, METH_VARARGS | METH_STATIC, "Create a new left handed perspective Matrix4x4 from a vertical field of view in degrees, aspect ratio, near and far"},
+    {"PerspectiveFovRH", (PyCFunction) Py3dMatrix4x4_PerspectiveFovRH, METH_VARARGS | METH_STATIC, "Create a new right handed perspective Matrix4x4 from a vertical field of view in degrees, aspect ratio, near and far"},
+    {"PerspectiveInfiniteReverseZLH", (PyCFunction) Py3dMatrix4x4_PerspectiveInfiniteReverseZLH, METH_VARARGS | METH_STATIC, "Create a new left handed reverse z perspective Matrix4x4 with no far plane from a vertical field of view in degrees, aspect ratio and near"},
+    {"PerspectiveInfiniteReverseZRH", (PyCFunction) Py3dMatrix4x4_PerspectiveInfiniteReverseZRH, METH_VARARGS | METH_STATIC, "Create a new right handed reverse z perspective Matrix4x4 with no far plane from a vertical field of view in degrees, aspect ratio and near"},
+    {"OrthographicLH", (PyCFunction) Py3dMatrix4x4_OrthographicLH, METH_VARARGS | METH_STATIC, "Create a new left handed orthographic Matrix4x4 from a view width, height, near and far"},
+    {"OrthographicRH", (PyCFunction) Py3dMatrix4x4_OrthographicRH, METH_VARARGS | METH_STATIC, "Create a new right handed orthographic Matrix4x4 from a view width, height, near and far"},
+    {"MultBatch", (PyCFunction) Py3dMatrix4x4_MultBatch, METH_VARARGS | METH_STATIC, "Multiply packed float32 world matrices by a view projection Matrix4x4 into an output buffer, returns the matrix count"},
     {NULL}
 };
 
@@ -32,6 +43,12 @@ static PyNumberMethods Py3dMatrix4x4_NumberMethods = {
     .nb_multiply = (binaryfunc) Py3dMatrix4x4_Mult,
 };
 
+static int Py3dMatrix4x4_GetBuffer(struct Py3dMatrix4x4 *self, Py_buffer *view, int flags);
+
+static PyBufferProcs Py3dMatrix4x4_BufferProcs = {
+    .bf_getbuffer = (getbufferproc) Py3dMatrix4x4_GetBuffer,
+};
+
 PyTypeObject Py3dMatrix4x4_Type = {
     PyVarObject_HEAD_INIT(NULL, 0)
     .tp_name = "py3dmath.Matrix4x4",
@@ -41,6 +58,7 @@ PyTypeObject Py3dMatrix4x4_Type = {
     .tp_flags = Py_TPFLAGS_DEFAULT,
     .tp_init = (initproc) Py3dMatrix4x4_Init,
     .tp_methods = Py3dMatrix4x4_Methods,
+    .tp_alloc = (allocfunc) Py3dMatrix4x4_Alloc,
     .tp_dealloc = (destructor) Py3dMatrix4x4_Dealloc,
     .tp_new = PyType_GenericNew,
     .tp_repr = (reprfunc) Py3dMatrix4x4_Repr,
@@ -49,6 +67,7 @@ PyTypeObject Py3dMatrix4x4_Type = {
 
 int PyInit_Py3dMatrix4x4(PyObject *module) {
     Py3dMatrix4x4_Type.tp_as_number = &Py3dMatrix4x4_NumberMethods;
+    Py3dMatrix4x4_Type.tp_as_buffer = &Py3dMatrix4x4_BufferProcs;
     if (PyType_Ready(&Py3dMatrix4x4_Type) < 0) return 0;
 
     if (PyModule_AddObjectRef(module, "Matrix4x4", (PyObject *) &Py3dMatrix4x4_Type) < 0) return 0;
@@ -62,10 +81,45 @@ static int Py3dMatrix4x4_Init(struct Py3dMatrix4x4 *self, PyObject *Py_UNUSED(ar
     return 0;
 }
 
+static PyObject *Py3dMatrix4x4_Alloc(PyTypeObject *type, Py_ssize_t itemCount) {
+    PyObject *obj = PyType_GenericAlloc(type, itemCount);
+    if (obj != NULL) Py3dMemory_Track(&Py3dMatrix4x4_Memory, type->tp_basicsize);
+
+    return obj;
+}
+
 static void Py3dMatrix4x4_Dealloc(struct Py3dMatrix4x4 *self) {
+    Py3dMemory_Untrack(&Py3dMatrix4x4_Memory, Py_TYPE(self)->tp_basicsize);
     Py_TYPE(self)->tp_free((PyObject *) self);
 }
 
+// Exposes the 16 elements as read-only float32 so matrices can be packed into batch buffers without copying. Matrices
+// behave as values everywhere else, so writes through the buffer are refused rather than changing one in place.
+static int Py3dMatrix4x4_GetBuffer(struct Py3dMatrix4x4 *self, Py_buffer *view, int flags) {
+    static Py_ssize_t shape[1] = {MAT_4_SIZE};
+    static Py_ssize_t strides[1] = {sizeof(float)};
+
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "Matrix4x4 buffers are read-only");
+        view->obj = NULL;
+        return -1;
+    }
+
+    view->obj = Py_NewRef(self);
+    view->buf = self->elements;
+    view->len = sizeof(self->elements);
+    view->readonly = 1;
+    view->itemsize = sizeof(float);
+    view->format = (flags & PyBUF_FORMAT) ? "f" : NULL;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? shape : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+
+    return 0;
+}
+
 struct Py3dMatrix4x4 *Py3dMatrix4x4_New() {
     PyObject *mathModule = PyImport_ImportModule("py3dengine.math");
     if (mathModule == NULL) return NULL;
@@ -240,7 +294,7 @@ PyObject *Py3dMatrix4x4_RotationAxis(struct Py3dMatrix4x4 *Py_UNUSED(self), PyOb
 
 PyObject *Py3dMatrix4x4_RotationQuaternion(struct Py3dMatrix4x4 *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
     struct Py3dQuaternion *quat = NULL;
-    if (PyArg_ParseTuple(args, "O!O", &Py3dQuaternion_Type, &quat) != 1) return NULL;
+    if (PyArg_ParseTuple(args, "O!", &Py3dQuaternion_Type, &quat) != 1) return NULL;
 
     struct Py3dMatrix4x4 *result = Py3dMatrix4x4_New();
     if (result == NULL) return NULL;
@@ -281,6 +335,132 @@ PyObject *Py3dMatrix4x4_LookAtLH(struct Py3dMatrix4x4 *Py_UNUSED(self), PyObject
     return (PyObject *) result;
 }
 
+PyObject *Py3dMatrix4x4_LookAtRH(struct Py3dMatrix4x4 *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dVector3 *camPosW = NULL, *camTargetW = NULL, *camUpW = NULL;
+    if (
+        PyArg_ParseTuple(
+            args, "O!O!O!",
+            &Py3dVector3_Type, &camPosW,
+            &Py3dVector3_Type, &camTargetW,
+            &Py3dVector3_Type, &camUpW
+        ) != 1
+    ) return NULL;
+
+    struct Py3dMatrix4x4 *result = Py3dMatrix4x4_New();
+    if (result == NULL) return NULL;
+
+    Mat4LookAtRH(result->elements, camPosW->elements, camTargetW->elements, camUpW->elements);
+
+    return (PyObject *) result;
+}
+
+static PyObject *do_Projection_Matrix(char kind, PyObject *args) {
+    float a = 0.0f, b = 0.0f, nearZ = 0.0f, farZ = 0.0f;
+    int infinite = kind == 'i' || kind == 'j';
+    if (infinite) {
+        if (PyArg_ParseTuple(args, "fff", &a, &b, &nearZ) != 1) return NULL;
+    } else {
+        if (PyArg_ParseTuple(args, "ffff", &a, &b, &nearZ, &farZ) != 1) return NULL;
+    }
+
+    if (a <= 0.0f || b <= 0.0f) {
+        PyErr_SetString(PyExc_ValueError, "Projection extents must be positive");
+        return NULL;
+    }
+
+    if (infinite ? nearZ <= 0.0f : nearZ == farZ) {
+        PyErr_SetString(PyExc_ValueError, "Projection depth range is empty");
+        return NULL;
+    }
+
+    struct Py3dMatrix4x4 *result = Py3dMatrix4x4_New();
+    if (result == NULL) return NULL;
+
+    switch (kind) {
+        case 'p':
+            Mat4PerspectiveFovLH(result->elements, a, b, nearZ, farZ);
+            break;
+        case 'q':
+            Mat4PerspectiveFovRH(result->elements, a, b, nearZ, farZ);
+            break;
+        case 'i':
+            Mat4PerspectiveInfiniteReverseZLH(result->elements, a, b, nearZ);
+            break;
+        case 'j':
+            Mat4PerspectiveInfiniteReverseZRH(result->elements, a, b, nearZ);
+            break;
+        case 'o':
+            Mat4OrthographicLH(result->elements, a, b, nearZ, farZ);
+            break;
+        case 'r':
+            Mat4OrthographicRH(result->elements, a, b, nearZ, farZ);
+            break;
+        default:
+            Py_CLEAR(result);
+            PyErr_SetString(PyExc_AssertionError, "Bad projection specification in do_Projection_Matrix");
+    }
+
+    return (PyObject *) result;
+}
+
+PyObject *Py3dMatrix4x4_PerspectiveFovLH(struct Py3dMatrix4x4 *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Projection_Matrix('p', args);
+}
+
+PyObject *Py3dMatrix4x4_PerspectiveFovRH(struct Py3dMatrix4x4 *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Projection_Matrix('q', args);
+}
+
+PyObject *Py3dMatrix4x4_PerspectiveInfiniteReverseZLH(struct Py3dMatrix4x4 *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Projection_Matrix('i', args);
+}
+
+PyObject *Py3dMatrix4x4_PerspectiveInfiniteReverseZRH(struct Py3dMatrix4x4 *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Projection_Matrix('j', args);
+}
+
+PyObject *Py3dMatrix4x4_OrthographicLH(struct Py3dMatrix4x4 *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Projection_Matrix('o', args);
+}
+
+PyObject *Py3dMatrix4x4_OrthographicRH(struct Py3dMatrix4x4 *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Projection_Matrix('r', args);
+}
+
+PyObject *Py3dMatrix4x4_MultBatch(struct Py3dMatrix4x4 *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    PyObject *worldsObj = NULL, *outObj = NULL;
+    struct Py3dMatrix4x4 *viewProj = NULL;
+    if (PyArg_ParseTuple(args, "OO!O", &worldsObj, &Py3dMatrix4x4_Type, &viewProj, &outObj) != 1) return NULL;
+
+    Py_buffer worlds, out;
+    if (!Py3dBuffer_GetFloats(worldsObj, &worlds, 0)) return NULL;
+    if (!Py3dBuffer_GetFloats(outObj, &out, 1)) {
+        PyBuffer_Release(&worlds);
+        return NULL;
+    }
+
+    Py_ssize_t count = worlds.len / (Py_ssize_t) sizeof(float[MAT_4_SIZE]);
+    if (worlds.len % (Py_ssize_t) sizeof(float[MAT_4_SIZE]) != 0 || out.len < worlds.len || count > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "World matrices must be 16 floats each and fit in the output buffer");
+        PyBuffer_Release(&out);
+        PyBuffer_Release(&worlds);
+        return NULL;
+    }
+
+    // Copy the view projection so the batch does not read a Matrix4x4 another thread could change
+    float vp[MAT_4_SIZE];
+    Mat4Copy(vp, viewProj->elements);
+
+    Py_BEGIN_ALLOW_THREADS
+    Mat4MultBatch(out.buf, worlds.buf, vp, (int) count);
+    Py_END_ALLOW_THREADS
+
+    PyBuffer_Release(&out);
+    PyBuffer_Release(&worlds);
+
+    return PyLong_FromSsize_t(count);
+}
+
 PyObject *Py3dMatrix4x4_Mult(struct Py3dMatrix4x4 *self, PyObject *other) {
     if (!Py3dMatrix4x4_Check(other)) {
         PyErr_SetString(PyExc_TypeError, "Second operand must be of type Matrix4x4");
@@ -0,0 +1,66 @@
+#include "py3dmemory.h"
+
+struct Py3dMemoryCounter Py3dVector3_Memory = {.name = "Vector3"};
+struct Py3dMemoryCounter Py3dQuaternion_Memory = {.name = "Quaternion"};
+struct Py3dMemoryCounter Py3dMatrix4x4_Memory = {.name = "Matrix4x4"};
+
+static struct Py3dMemoryCounter *counters[] = {&Py3dVector3_Memory, &Py3dQuaternion_Memory, &Py3dMatrix4x4_Memory};
+#define COUNTER_COUNT ((int) (sizeof(counters) / sizeof(counters[0])))
+
+static PyMethodDef Py3dMemoryTracker_Methods[] = {
+    {"Stats", (PyCFunction) Py3dMemoryTracker_Stats, METH_NOARGS | METH_STATIC, "Return {type name: {live, peak, live_bytes, peak_bytes, allocations}} for the math value types"},
+    {"ResetPeaks", (PyCFunction) Py3dMemoryTracker_ResetPeaks, METH_NOARGS | METH_STATIC, "Lower every peak to the current live count and bytes"},
+    {NULL}
+};
+
+PyTypeObject Py3dMemoryTracker_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.MemoryTracker",
+    .tp_doc = "Instance and byte counters of the math value types",
+    .tp_basicsize = sizeof(PyObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_methods = Py3dMemoryTracker_Methods,
+};
+
+int PyInit_Py3dMemoryTracker(PyObject *module) {
+    if (PyType_Ready(&Py3dMemoryTracker_Type) < 0) return 0;
+
+    if (PyModule_AddObjectRef(module, "MemoryTracker", (PyObject *) &Py3dMemoryTracker_Type) < 0) return 0;
+
+    return 1;
+}
+
+PyObject *Py3dMemoryTracker_Stats(PyObject *Py_UNUSED(cls), PyObject *Py_UNUSED(args)) {
+    PyObject *stats = PyDict_New();
+    if (stats == NULL) return NULL;
+
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        const struct Py3dMemoryCounter *counter = counters[i];
+        PyObject *entry = Py_BuildValue(
+            "{s:n,s:n,s:n,s:n,s:K}",
+            "live", counter->live,
+            "peak", counter->peak,
+            "live_bytes", counter->liveBytes,
+            "peak_bytes", counter->peakBytes,
+            "allocations", counter->allocations
+        );
+        if (entry == NULL || PyDict_SetItemString(stats, counter->name, entry) < 0) {
+            Py_XDECREF(entry);
+            Py_DECREF(stats);
+            return NULL;
+        }
+        Py_DECREF(entry);
+    }
+
+    return stats;
+}
+
+PyObject *Py3dMemoryTracker_ResetPeaks(PyObject *Py_UNUSED(cls), PyObject *Py_UNUSED(args)) {
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        counters[i]->peak = counters[i]->live;
+        counters[i]->peakBytes = counters[i]->liveBytes;
+    }
+
+    Py_RETURN_NONE;
+}
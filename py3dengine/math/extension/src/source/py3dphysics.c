@@ -0,0 +1,474 @@
+#include "py3dphysics.h"
+
+#include "py3dvector3.h"
+#include "py3dquaternion.h"
+#include "py3dbuffer.h"
+
+#define STATE_FLOATS_PER_BODY (VEC_3_SIZE + QUATERNION_SIZE)
+
+static int Py3dPhysicsWorld_Init(struct Py3dPhysicsWorld *self, PyObject *args, PyObject *kwds);
+static void Py3dPhysicsWorld_Dealloc(struct Py3dPhysicsWorld *self);
+static int Py3dPhysicsWorld_Traverse(struct Py3dPhysicsWorld *self, visitproc visit, void *arg);
+static int Py3dPhysicsWorld_Clear(struct Py3dPhysicsWorld *self);
+static int checkNotStepping(struct Py3dPhysicsWorld *self);
+
+static const char *shapeNames[] = {"sphere", "box", "capsule"};
+
+static PyObject *positionName = NULL;
+static PyObject *orientationName = NULL;
+// Transform caches its matrices, writing a body back has to tell it they are stale
+static PyObject *invalidateMatricesName = NULL;
+
+static PyGetSetDef Py3dPhysicsWorld_GettersSetters[] = {
+    {"body_count", (getter) Py3dPhysicsWorld_GetBodyCount, (setter) NULL, "Number of bodies in the world", NULL},
+    {"pair_count", (getter) Py3dPhysicsWorld_GetPairCount, (setter) NULL, "Number of overlapping AABB pairs found by the last step", NULL},
+    {"contact_count", (getter) Py3dPhysicsWorld_GetContactCount, (setter) NULL, "Number of contact points solved by the last step", NULL},
+    {"gravity", (getter) Py3dPhysicsWorld_GetGravity, (setter) Py3dPhysicsWorld_SetGravity, "Gravity as a Vector3", NULL},
+    {"iterations", (getter) Py3dPhysicsWorld_GetIterations, (setter) Py3dPhysicsWorld_SetIterations, "Solver iterations per step", NULL},
+    {"stepping", (getter) Py3dPhysicsWorld_GetStepping, (setter) NULL, "Whether step is running on another thread", NULL},
+    {NULL}
+};
+
+static PyMethodDef Py3dPhysicsWorld_Methods[] = {
+    {"add_body", (PyCFunction) Py3dPhysicsWorld_AddBody, METH_VARARGS | METH_KEYWORDS, "Add a 'sphere', 'box' or 'capsule' body synced with a Transform, a mass of 0 makes it static, returns its id"},
+    {"remove_body", (PyCFunction) Py3dPhysicsWorld_RemoveBody, METH_VARARGS, "Remove a body, its id may be reused by a later add_body"},
+    {"get_velocity", (PyCFunction) Py3dPhysicsWorld_GetVelocity, METH_VARARGS, "Return the (linear, angular) velocity Vector3s of a body"},
+    {"set_velocity", (PyCFunction) Py3dPhysicsWorld_SetVelocity, METH_VARARGS, "Set the linear and optionally angular velocity of a body"},
+    {"apply_impulse", (PyCFunction) Py3dPhysicsWorld_ApplyImpulse, METH_VARARGS, "Apply a Vector3 impulse to a body, at its center of mass or at a world point"},
+    {"step", (PyCFunction) Py3dPhysicsWorld_Step, METH_VARARGS, "Advance the simulation by dt seconds, split into optional substeps, without holding the GIL"},
+    {"read_transforms", (PyCFunction) Py3dPhysicsWorld_ReadTransforms, METH_NOARGS, "Copy the position and orientation of every Transform into its body, for teleports and kinematic moves, returns the count"},
+    {"write_transforms", (PyCFunction) Py3dPhysicsWorld_WriteTransforms, METH_NOARGS, "Copy the position and orientation of every dynamic body into its Transform, returns the count"},
+    {"copy_state", (PyCFunction) Py3dPhysicsWorld_CopyState, METH_VARARGS, "Write position xyz and orientation xyzw of every body id into a float32 buffer, returns the id count"},
+    {NULL}
+};
+
+PyTypeObject Py3dPhysicsWorld_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.PhysicsWorld",
+    .tp_doc = "A rigid body simulation whose bodies read and write Transform positions and orientations in bulk",
+    .tp_basicsize = sizeof(struct Py3dPhysicsWorld),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_init = (initproc) Py3dPhysicsWorld_Init,
+    .tp_methods = Py3dPhysicsWorld_Methods,
+    .tp_dealloc = (destructor) Py3dPhysicsWorld_Dealloc,
+    .tp_traverse = (traverseproc) Py3dPhysicsWorld_Traverse,
+    .tp_clear = (inquiry) Py3dPhysicsWorld_Clear,
+    .tp_new = PyType_GenericNew,
+    .tp_getset = Py3dPhysicsWorld_GettersSetters
+};
+
+int PyInit_Py3dPhysicsWorld(PyObject *module) {
+    if (PyType_Ready(&Py3dPhysicsWorld_Type) < 0) return 0;
+
+    positionName = PyUnicode_InternFromString("position");
+    orientationName = PyUnicode_InternFromString("orientation");
+    invalidateMatricesName = PyUnicode_InternFromString("invalidate_matrices");
+    if (positionName == NULL || orientationName == NULL || invalidateMatricesName == NULL) return 0;
+
+    if (PyModule_AddObjectRef(module, "PhysicsWorld", (PyObject *) &Py3dPhysicsWorld_Type) < 0) return 0;
+
+    return 1;
+}
+
+static int Py3dPhysicsWorld_Init(struct Py3dPhysicsWorld *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dVector3 *gravity = NULL;
+    if (PyArg_ParseTuple(args, "|O!", &Py3dVector3_Type, &gravity) != 1) return -1;
+
+    if (!checkNotStepping(self)) return -1;
+
+    float defaultGravity[VEC_3_SIZE] = {0.0f, -9.81f, 0.0f};
+
+    // __init__ may be called again on an existing instance
+    Py3dPhysicsWorld_Clear(self);
+    PhysicsWorldRelease(&self->world);
+    PhysicsWorldInit(&self->world, gravity != NULL ? gravity->elements : defaultGravity);
+
+    return 0;
+}
+
+static void Py3dPhysicsWorld_Dealloc(struct Py3dPhysicsWorld *self) {
+    PyObject_GC_UnTrack(self);
+    Py3dPhysicsWorld_Clear(self);
+    PhysicsWorldRelease(&self->world);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static int Py3dPhysicsWorld_Traverse(struct Py3dPhysicsWorld *self, visitproc visit, void *arg) {
+    for (int i = 0; i < self->linkCapacity * PHYSICS_LINKS_PER_BODY; ++i) {
+        Py_VISIT(self->links[i]);
+    }
+
+    return 0;
+}
+
+static int Py3dPhysicsWorld_Clear(struct Py3dPhysicsWorld *self) {
+    for (int i = 0; i < self->linkCapacity * PHYSICS_LINKS_PER_BODY; ++i) {
+        Py_CLEAR(self->links[i]);
+    }
+    PyMem_Free(self->links);
+    self->links = NULL;
+    self->linkCapacity = 0;
+
+    return 0;
+}
+
+// Step reads and writes every body with the GIL released, nothing else may touch them until it returns
+static int checkNotStepping(struct Py3dPhysicsWorld *self) {
+    if (self->stepping) {
+        PyErr_SetString(PyExc_RuntimeError, "PhysicsWorld cannot be changed while it is stepping");
+        return 0;
+    }
+
+    return 1;
+}
+
+static int checkBody(struct Py3dPhysicsWorld *self, int body) {
+    if (!PhysicsIsValidBody(&self->world, body)) {
+        PyErr_Format(PyExc_KeyError, "%d is not a valid body", body);
+        return 0;
+    }
+
+    return 1;
+}
+
+// Links are only missing after the garbage collector cleared a world that is about to be freed
+static int hasLinks(struct Py3dPhysicsWorld *self, int body) {
+    return body < self->linkCapacity && self->links[body * PHYSICS_LINKS_PER_BODY] != NULL;
+}
+
+static int parseShape(PyObject *name) {
+    for (int s = PHYSICS_SHAPE_SPHERE; s <= PHYSICS_SHAPE_CAPSULE; ++s) {
+        if (PyUnicode_Check(name) && PyUnicode_CompareWithASCIIString(name, shapeNames[s]) == 0) return s;
+    }
+
+    PyErr_SetString(PyExc_ValueError, "Body shape must be \"sphere\", \"box\" or \"capsule\"");
+    return -1;
+}
+
+static int checkSize(int shape, const float size[VEC_3_SIZE]) {
+    int valid;
+    switch (shape) {
+        case PHYSICS_SHAPE_BOX:
+            valid = size[0] > 0.0f && size[1] > 0.0f && size[2] > 0.0f;
+            break;
+        case PHYSICS_SHAPE_CAPSULE:
+            valid = size[0] > 0.0f && size[1] >= 0.0f;
+            break;
+        default:
+            valid = size[0] > 0.0f;
+            break;
+    }
+
+    if (!valid) {
+        PyErr_SetString(
+            PyExc_ValueError,
+            "Body size must hold a positive radius, positive box half extents or a capsule radius and half height"
+        );
+    }
+
+    return valid;
+}
+
+// Returns new references to a Transform's position Vector3 and orientation Quaternion
+static int fetchPose(PyObject *transform, PyObject **position, PyObject **orientation) {
+    *position = PyObject_GetAttr(transform, positionName);
+    *orientation = *position == NULL ? NULL : PyObject_GetAttr(transform, orientationName);
+    if (*orientation == NULL || !Py3dVector3_Check(*position) || !Py3dQuaternion_Check(*orientation)) {
+        if (!PyErr_Occurred() || PyErr_ExceptionMatches(PyExc_AttributeError)) {
+            PyErr_SetString(PyExc_TypeError, "Body transform must have a Vector3 position and a Quaternion orientation");
+        }
+        Py_CLEAR(*position);
+        Py_CLEAR(*orientation);
+        return 0;
+    }
+
+    return 1;
+}
+
+static int growLinks(struct Py3dPhysicsWorld *self, int body) {
+    if (body < self->linkCapacity) return 1;
+
+    int capacity = self->world.capacity;
+    PyObject **links = PyMem_Realloc(self->links, sizeof(PyObject *) * PHYSICS_LINKS_PER_BODY * capacity);
+    if (links == NULL) {
+        PyErr_NoMemory();
+        return 0;
+    }
+
+    for (int i = self->linkCapacity * PHYSICS_LINKS_PER_BODY; i < capacity * PHYSICS_LINKS_PER_BODY; ++i) {
+        links[i] = NULL;
+    }
+    self->links = links;
+    self->linkCapacity = capacity;
+
+    return 1;
+}
+
+PyObject *Py3dPhysicsWorld_AddBody(struct Py3dPhysicsWorld *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"transform", "shape", "size", "mass", "restitution", "friction", NULL};
+    PyObject *transform = NULL, *shapeObj = NULL;
+    struct Py3dVector3 *size = NULL;
+    float mass = 1.0f, restitution = 0.0f, friction = 0.5f;
+    if (
+        PyArg_ParseTupleAndKeywords(
+            args, kwds, "OOO!|fff", kwlist,
+            &transform, &shapeObj, &Py3dVector3_Type, &size, &mass, &restitution, &friction
+        ) != 1
+    ) return NULL;
+
+    if (!checkNotStepping(self)) return NULL;
+
+    int shape = parseShape(shapeObj);
+    if (shape < 0 || !checkSize(shape, size->elements)) return NULL;
+
+    if (!(mass >= 0.0f) || !(restitution >= 0.0f) || !(friction >= 0.0f)) {
+        PyErr_SetString(PyExc_ValueError, "Body mass, restitution and friction must not be negative");
+        return NULL;
+    }
+
+    // The Transform's own Vector3 and Quaternion are kept so syncing never has to look them up again
+    PyObject *position = NULL, *orientation = NULL;
+    if (!fetchPose(transform, &position, &orientation)) return NULL;
+
+    int body = PhysicsAddBody(
+        &self->world, shape, size->elements, mass,
+        ((struct Py3dVector3 *) position)->elements,
+        ((struct Py3dQuaternion *) orientation)->elements
+    );
+    if (body < 0 || !growLinks(self, body)) {
+        if (body < 0) {
+            PyErr_NoMemory();
+        } else {
+            PhysicsRemoveBody(&self->world, body);
+        }
+        Py_DECREF(position);
+        Py_DECREF(orientation);
+        return NULL;
+    }
+
+    self->world.bodies[body].restitution = restitution;
+    self->world.bodies[body].friction = friction;
+
+    PyObject **links = &self->links[body * PHYSICS_LINKS_PER_BODY];
+    Py_XSETREF(links[0], Py_NewRef(transform));
+    Py_XSETREF(links[1], position);
+    Py_XSETREF(links[2], orientation);
+
+    return PyLong_FromLong(body);
+}
+
+PyObject *Py3dPhysicsWorld_RemoveBody(struct Py3dPhysicsWorld *self, PyObject *args) {
+    int body = 0;
+    if (PyArg_ParseTuple(args, "i", &body) != 1) return NULL;
+    if (!checkNotStepping(self) || !checkBody(self, body)) return NULL;
+
+    PhysicsRemoveBody(&self->world, body);
+    for (int i = 0; i < PHYSICS_LINKS_PER_BODY; ++i) {
+        Py_CLEAR(self->links[body * PHYSICS_LINKS_PER_BODY + i]);
+    }
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dPhysicsWorld_GetVelocity(struct Py3dPhysicsWorld *self, PyObject *args) {
+    int body = 0;
+    if (PyArg_ParseTuple(args, "i", &body) != 1) return NULL;
+    if (!checkBody(self, body)) return NULL;
+
+    struct Py3dVector3 *linear = Py3dVector3_New(0.0f, 0.0f, 0.0f);
+    struct Py3dVector3 *angular = linear == NULL ? NULL : Py3dVector3_New(0.0f, 0.0f, 0.0f);
+    if (angular == NULL) {
+        Py_XDECREF(linear);
+        return NULL;
+    }
+
+    Vec3Copy(linear->elements, self->world.bodies[body].linearVelocity);
+    Vec3Copy(angular->elements, self->world.bodies[body].angularVelocity);
+
+    PyObject *result = PyTuple_Pack(2, (PyObject *) linear, (PyObject *) angular);
+    Py_DECREF(linear);
+    Py_DECREF(angular);
+
+    return result;
+}
+
+PyObject *Py3dPhysicsWorld_SetVelocity(struct Py3dPhysicsWorld *self, PyObject *args) {
+    int body = 0;
+    struct Py3dVector3 *linear = NULL, *angular = NULL;
+    if (PyArg_ParseTuple(args, "iO!|O!", &body, &Py3dVector3_Type, &linear, &Py3dVector3_Type, &angular) != 1) return NULL;
+    if (!checkNotStepping(self) || !checkBody(self, body)) return NULL;
+
+    Vec3Copy(self->world.bodies[body].linearVelocity, linear->elements);
+    if (angular != NULL) Vec3Copy(self->world.bodies[body].angularVelocity, angular->elements);
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dPhysicsWorld_ApplyImpulse(struct Py3dPhysicsWorld *self, PyObject *args) {
+    int body = 0;
+    struct Py3dVector3 *impulse = NULL, *point = NULL;
+    if (PyArg_ParseTuple(args, "iO!|O!", &body, &Py3dVector3_Type, &impulse, &Py3dVector3_Type, &point) != 1) return NULL;
+    if (!checkNotStepping(self) || !checkBody(self, body)) return NULL;
+
+    PhysicsApplyImpulse(&self->world, body, impulse->elements, point != NULL ? point->elements : NULL);
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dPhysicsWorld_Step(struct Py3dPhysicsWorld *self, PyObject *args) {
+    float dt = 0.0f;
+    int substeps = 1;
+    if (PyArg_ParseTuple(args, "f|i", &dt, &substeps) != 1) return NULL;
+
+    if (!(dt > 0.0f) || substeps < 1) {
+        PyErr_SetString(PyExc_ValueError, "Step needs a positive time step and at least one substep");
+        return NULL;
+    }
+    if (!checkNotStepping(self)) return NULL;
+
+    // The flag is set and cleared while the GIL is held, so no other thread sees a half finished step
+    int success = 1;
+    self->stepping = 1;
+    Py_BEGIN_ALLOW_THREADS
+    for (int i = 0; i < substeps && success; ++i) {
+        success = PhysicsStep(&self->world, dt / (float) substeps);
+    }
+    Py_END_ALLOW_THREADS
+    self->stepping = 0;
+
+    if (!success) return PyErr_NoMemory();
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dPhysicsWorld_ReadTransforms(struct Py3dPhysicsWorld *self, PyObject *Py_UNUSED(args)) {
+    if (!checkNotStepping(self)) return NULL;
+
+    long read = 0;
+
+    for (int i = 0; i < self->world.bodyCount; ++i) {
+        if (!self->world.bodies[i].active || !hasLinks(self, i)) continue;
+
+        // Setting a Transform's position or orientation replaces the object, so they are looked up again
+        PyObject **links = &self->links[i * PHYSICS_LINKS_PER_BODY];
+        PyObject *position = NULL, *orientation = NULL;
+        if (!fetchPose(links[0], &position, &orientation)) return NULL;
+        Py_XSETREF(links[1], position);
+        Py_XSETREF(links[2], orientation);
+
+        PhysicsSetBodyPose(
+            &self->world,
+            i,
+            ((struct Py3dVector3 *) links[1])->elements,
+            ((struct Py3dQuaternion *) links[2])->elements
+        );
+        ++read;
+    }
+
+    return PyLong_FromLong(read);
+}
+
+PyObject *Py3dPhysicsWorld_WriteTransforms(struct Py3dPhysicsWorld *self, PyObject *Py_UNUSED(args)) {
+    if (!checkNotStepping(self)) return NULL;
+
+    long written = 0;
+
+    for (int i = 0; i < self->world.bodyCount; ++i) {
+        const struct PhysicsBody *body = &self->world.bodies[i];
+        if (!body->active || body->invMass == 0.0f || !hasLinks(self, i)) continue;
+
+        PyObject **links = &self->links[i * PHYSICS_LINKS_PER_BODY];
+        Vec3Copy(((struct Py3dVector3 *) links[1])->elements, body->position);
+        QuaternionCopy(((struct Py3dQuaternion *) links[2])->elements, body->orientation);
+
+        PyObject *result = PyObject_CallMethodNoArgs(links[0], invalidateMatricesName);
+        if (result == NULL) return NULL;
+        Py_DECREF(result);
+        ++written;
+    }
+
+    return PyLong_FromLong(written);
+}
+
+PyObject *Py3dPhysicsWorld_CopyState(struct Py3dPhysicsWorld *self, PyObject *args) {
+    PyObject *outObj = NULL;
+    if (PyArg_ParseTuple(args, "O", &outObj) != 1) return NULL;
+
+    if (!checkNotStepping(self)) return NULL;
+
+    Py_buffer out;
+    if (!Py3dBuffer_GetFloats(outObj, &out, 1)) return NULL;
+
+    int count = self->world.bodyCount;
+    if (out.len < (Py_ssize_t) count * STATE_FLOATS_PER_BODY * (Py_ssize_t) sizeof(float)) {
+        PyErr_SetString(PyExc_ValueError, "Output buffer must hold 7 floats for every body id");
+        PyBuffer_Release(&out);
+        return NULL;
+    }
+
+    // Removed ids are written as zeros so every body keeps its offset
+    float *state = out.buf;
+    for (int i = 0; i < count; ++i) {
+        const struct PhysicsBody *body = &self->world.bodies[i];
+        Vec3Copy(&state[i * STATE_FLOATS_PER_BODY], body->position);
+        QuaternionCopy(&state[i * STATE_FLOATS_PER_BODY + VEC_3_SIZE], body->orientation);
+    }
+
+    PyBuffer_Release(&out);
+
+    return PyLong_FromLong(count);
+}
+
+PyObject *Py3dPhysicsWorld_GetBodyCount(struct Py3dPhysicsWorld *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromLong(self->world.activeCount);
+}
+
+PyObject *Py3dPhysicsWorld_GetPairCount(struct Py3dPhysicsWorld *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromLong(self->world.broadphase.pairCount);
+}
+
+PyObject *Py3dPhysicsWorld_GetContactCount(struct Py3dPhysicsWorld *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromLong(self->world.contactCount);
+}
+
+PyObject *Py3dPhysicsWorld_GetGravity(struct Py3dPhysicsWorld *self, void *Py_UNUSED(closure)) {
+    struct Py3dVector3 *gravity = Py3dVector3_New(0.0f, 0.0f, 0.0f);
+    if (gravity == NULL) return NULL;
+
+    Vec3Copy(gravity->elements, self->world.gravity);
+
+    return (PyObject *) gravity;
+}
+
+int Py3dPhysicsWorld_SetGravity(struct Py3dPhysicsWorld *self, PyObject *value, void *Py_UNUSED(closure)) {
+    if (value == NULL || !Py3dVector3_Check(value)) {
+        PyErr_SetString(PyExc_TypeError, "Gravity must be a Vector3");
+        return -1;
+    }
+
+    Vec3Copy(self->world.gravity, ((struct Py3dVector3 *) value)->elements);
+
+    return 0;
+}
+
+PyObject *Py3dPhysicsWorld_GetStepping(struct Py3dPhysicsWorld *self, void *Py_UNUSED(closure)) {
+    return PyBool_FromLong(self->stepping);
+}
+
+PyObject *Py3dPhysicsWorld_GetIterations(struct Py3dPhysicsWorld *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromLong(self->world.iterations);
+}
+
+int Py3dPhysicsWorld_SetIterations(struct Py3dPhysicsWorld *self, PyObject *value, void *Py_UNUSED(closure)) {
+    long iterations = value == NULL ? -1 : PyLong_AsLong(value);
+    if (iterations == -1 && PyErr_Occurred()) return -1;
+
+    if (iterations < 1 || iterations > 1000) {
+        PyErr_SetString(PyExc_ValueError, "Solver iterations must be between 1 and 1000");
+        return -1;
+    }
+    self->world.iterations = (int) iterations;
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include "py3dprofiler.h"
+
+#define COLLECT_CHUNK 4096
+
+// Zone names recorded from Python are kept alive here, the rings only store pointers to their UTF-8 data
+static PyObject *zoneNames = NULL;
+
+static PyMethodDef Py3dProfiler_Methods[] = {
+    {"SetEnabled", (PyCFunction) Py3dProfiler_SetEnabled, METH_VARARGS | METH_STATIC, "Start or stop recording zones on every thread"},
+    {"IsEnabled", (PyCFunction) Py3dProfiler_IsEnabled, METH_NOARGS | METH_STATIC, "Return True while zones are recorded"},
+    {"Now", (PyCFunction) Py3dProfiler_Now, METH_NOARGS | METH_STATIC, "Return the profiler clock in nanoseconds"},
+    {"Begin", (PyCFunction) Py3dProfiler_Begin, METH_O | METH_STATIC, "Open a zone with a str name on the calling thread"},
+    {"End", (PyCFunction) Py3dProfiler_End, METH_O | METH_STATIC, "Close the zone with a str name on the calling thread"},
+    {"SetThreadName", (PyCFunction) Py3dProfiler_SetThreadName, METH_VARARGS | METH_STATIC, "Name the calling thread in collected traces, returns False if it already has a name"},
+    {"ThreadName", (PyCFunction) Py3dProfiler_ThreadName, METH_VARARGS | METH_STATIC, "Return the name of a profiler thread id or None"},
+    {"Collect", (PyCFunction) Py3dProfiler_Collect, METH_NOARGS | METH_STATIC, "Remove and return every recorded event as (thread, timestamp ns, 'B' or 'E', name) tuples, in order on each thread"},
+    {"DroppedEvents", (PyCFunction) Py3dProfiler_DroppedEvents, METH_NOARGS | METH_STATIC, "Return how many events were dropped because a thread's ring was full"},
+    {NULL}
+};
+
+PyTypeObject Py3dProfiler_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.Profiler",
+    .tp_doc = "A frame profiler recording nested zones from C and Python on every thread into lock free rings",
+    .tp_basicsize = sizeof(PyObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_methods = Py3dProfiler_Methods,
+};
+
+int PyInit_Py3dProfiler(PyObject *module) {
+    if (PyType_Ready(&Py3dProfiler_Type) < 0) return 0;
+
+    if (zoneNames == NULL) {
+        zoneNames = PyDict_New();
+        if (zoneNames == NULL) return 0;
+    }
+
+    if (PyModule_AddObjectRef(module, "Profiler", (PyObject *) &Py3dProfiler_Type) < 0) return 0;
+
+    return 1;
+}
+
+PyObject *Py3dProfiler_SetEnabled(PyObject *Py_UNUSED(cls), PyObject *args) {
+    int enabled = 0;
+    if (PyArg_ParseTuple(args, "p", &enabled) != 1) return NULL;
+
+    ProfilerSetEnabled(enabled);
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dProfiler_IsEnabled(PyObject *Py_UNUSED(cls), PyObject *Py_UNUSED(args)) {
+    return PyBool_FromLong(atomic_load(&profilerEnabled));
+}
+
+PyObject *Py3dProfiler_Now(PyObject *Py_UNUSED(cls), PyObject *Py_UNUSED(args)) {
+    return PyLong_FromUnsignedLongLong(ProfilerNow());
+}
+
+static PyObject *recordZone(PyObject *name, int type) {
+    if (!atomic_load_explicit(&profilerEnabled, memory_order_relaxed)) Py_RETURN_NONE;
+
+    if (!PyUnicode_Check(name)) {
+        PyErr_SetString(PyExc_TypeError, "Zone name must be a str");
+        return NULL;
+    }
+
+    PyObject *interned = PyDict_SetDefault(zoneNames, name, name);
+    if (interned == NULL) return NULL;
+
+    const char *utf8 = PyUnicode_AsUTF8(interned);
+    if (utf8 == NULL) return NULL;
+
+    ProfilerRecord(utf8, type);
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dProfiler_Begin(PyObject *Py_UNUSED(cls), PyObject *name) {
+    return recordZone(name, PROFILER_ZONE_BEGIN);
+}
+
+PyObject *Py3dProfiler_End(PyObject *Py_UNUSED(cls), PyObject *name) {
+    return recordZone(name, PROFILER_ZONE_END);
+}
+
+PyObject *Py3dProfiler_SetThreadName(PyObject *Py_UNUSED(cls), PyObject *args) {
+    const char *name = NULL;
+    if (PyArg_ParseTuple(args, "s", &name) != 1) return NULL;
+
+    return PyBool_FromLong(ProfilerSetThreadName(name));
+}
+
+PyObject *Py3dProfiler_ThreadName(PyObject *Py_UNUSED(cls), PyObject *args) {
+    unsigned int thread = 0;
+    if (PyArg_ParseTuple(args, "I", &thread) != 1) return NULL;
+
+    const char *name = ProfilerThreadName(thread);
+    if (name == NULL) Py_RETURN_NONE;
+
+    return PyUnicode_FromString(name);
+}
+
+static PyObject *nameFor(PyObject *cache, const char *name) {
+    PyObject *key = PyLong_FromVoidPtr((void *) name);
+    if (key == NULL) return NULL;
+
+    PyObject *cached = PyDict_GetItemWithError(cache, key);
+    if (cached != NULL) {
+        Py_DECREF(key);
+        return Py_NewRef(cached);
+    }
+    if (PyErr_Occurred()) {
+        Py_DECREF(key);
+        return NULL;
+    }
+
+    PyObject *decoded = PyUnicode_DecodeUTF8(name, (Py_ssize_t) strlen(name), "replace");
+    if (decoded == NULL || PyDict_SetItem(cache, key, decoded) < 0) {
+        Py_XDECREF(decoded);
+        Py_DECREF(key);
+        return NULL;
+    }
+    Py_DECREF(key);
+
+    return decoded;
+}
+
+PyObject *Py3dProfiler_Collect(PyObject *Py_UNUSED(cls), PyObject *Py_UNUSED(args)) {
+    struct ProfilerEvent *events = PyMem_Malloc(sizeof(struct ProfilerEvent) * COLLECT_CHUNK);
+    if (events == NULL) return PyErr_NoMemory();
+
+    PyObject *result = PyList_New(0);
+    PyObject *names = PyDict_New();
+    if (result == NULL || names == NULL) goto error;
+
+    int count;
+    do {
+        Py_BEGIN_ALLOW_THREADS
+        count = ProfilerCollect(events, COLLECT_CHUNK);
+        Py_END_ALLOW_THREADS
+
+        for (int i = 0; i < count; ++i) {
+            PyObject *name = nameFor(names, events[i].name);
+            if (name == NULL) goto error;
+
+            PyObject *event = Py_BuildValue(
+                "(IKsN)",
+                events[i].thread,
+                (unsigned long long) events[i].timestamp,
+                events[i].type == PROFILER_ZONE_BEGIN ? "B" : "E",
+                name
+            );
+            if (event == NULL) goto error;
+
+            int appended = PyList_Append(result, event);
+            Py_DECREF(event);
+            if (appended < 0) goto error;
+        }
+    } while (count == COLLECT_CHUNK);
+
+    PyMem_Free(events);
+    Py_DECREF(names);
+
+    return result;
+
+error:
+    PyMem_Free(events);
+    Py_XDECREF(names);
+    Py_XDECREF(result);
+
+    return NULL;
+}
+
+PyObject *Py3dProfiler_DroppedEvents(PyObject *Py_UNUSED(cls), PyObject *Py_UNUSED(args)) {
+    return PyLong_FromUnsignedLongLong(ProfilerDroppedEvents());
+}
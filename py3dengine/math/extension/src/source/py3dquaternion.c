@@ -1,14 +1,20 @@
 #include "py3dquaternion.h"
+#include "py3dmemory.h"
 
 #include <structmember.h>
 
 #include "py3dvector3.h"
+#include "py3dmatrix4x4.h"
+#include "py3dbuffer.h"
 #include "quaternion.h"
+#include "matrix.h"
+#include "mathinline.h"
 
 #define MAX_STRING_SIZE 64
 
 static int Py3dQuaternion_Init(struct Py3dQuaternion *self, PyObject *args, PyObject *kwds);
 static void Py3dQuaternion_Dealloc(struct Py3dQuaternion *self);
+static PyObject *Py3dQuaternion_Alloc(PyTypeObject *type, Py_ssize_t itemCount);
 
 static PyGetSetDef Py3dQuaternion_GettersSetters[] = {
     {"x", (getter) Py3dQuaternion_GetX, (setter) NULL, "X Component of Quaternion", NULL},
@@ -20,7 +26,13 @@ static PyGetSetDef Py3dQuaternion_GettersSetters[] = {
 
 static PyMethodDef Py3dQuaternion_Methods[] = {
     {"FromAxisAndDegrees", (PyCFunction) Py3dQuaternion_FromAxisAndDegrees, METH_VARARGS | METH_STATIC, "Create a Quaternion from an axis and a angle in degrees"},
+    {"FromMatrix", (PyCFunction) Py3dQuaternion_FromMatrix, METH_VARARGS | METH_STATIC, "Create a Quaternion from the rotation part of a Matrix4x4"},
+    {"NormalizeBatch", (PyCFunction) Py3dQuaternion_NormalizeBatch, METH_VARARGS | METH_STATIC, "Normalize packed float32 xyzw quaternions into an output buffer, returns the quaternion count"},
+    {"RotateBatch", (PyCFunction) Py3dQuaternion_RotateBatch, METH_VARARGS | METH_STATIC, "Rotate packed float32 xyz vectors by one Quaternion or by a float32 buffer of one quaternion per vector into an output buffer, returns the vector count"},
     {"normalize", (PyCFunction) Py3dQuaternion_Normalize, METH_NOARGS, "Return a normalized version of the quaterion"},
+    {"slerp", (PyCFunction) Py3dQuaternion_Slerp, METH_VARARGS, "Spherically interpolate towards another Quaternion by t along the shortest path"},
+    {"nlerp", (PyCFunction) Py3dQuaternion_Nlerp, METH_VARARGS, "Linearly interpolate towards another Quaternion by t along the shortest path and normalize"},
+    {"to_matrix", (PyCFunction) Py3dQuaternion_ToMatrix, METH_NOARGS, "Return the rotation Matrix4x4 of the quaternion"},
     {NULL}
 };
 
@@ -37,6 +49,7 @@ PyTypeObject Py3dQuaternion_Type = {
     .tp_flags = Py_TPFLAGS_DEFAULT,
     .tp_init = (initproc) Py3dQuaternion_Init,
     .tp_methods = Py3dQuaternion_Methods,
+    .tp_alloc = (allocfunc) Py3dQuaternion_Alloc,
     .tp_dealloc = (destructor) Py3dQuaternion_Dealloc,
     .tp_new = PyType_GenericNew,
     .tp_repr = (reprfunc) Py3dQuaternion_Repr,
@@ -114,7 +127,7 @@ static int Py3dQuaternion_Init(struct Py3dQuaternion *self, PyObject *args, PyOb
     }
 
     PyObject *singleObjArg = NULL;
-    if (PyArg_ParseTuple(args, "O", &singleObjArg) == 1) {
+    if (PyTuple_Size(args) == 1 && PyArg_ParseTuple(args, "O", &singleObjArg) == 1) {
         if (PyList_Check(singleObjArg)) {
             return init_from_list(self, singleObjArg);
         } else if (PyDict_Check(singleObjArg)) {
@@ -139,7 +152,15 @@ static int Py3dQuaternion_Init(struct Py3dQuaternion *self, PyObject *args, PyOb
     return 0;
 }
 
+static PyObject *Py3dQuaternion_Alloc(PyTypeObject *type, Py_ssize_t itemCount) {
+    PyObject *obj = PyType_GenericAlloc(type, itemCount);
+    if (obj != NULL) Py3dMemory_Track(&Py3dQuaternion_Memory, type->tp_basicsize);
+
+    return obj;
+}
+
 static void Py3dQuaternion_Dealloc(struct Py3dQuaternion *self) {
+    Py3dMemory_Untrack(&Py3dQuaternion_Memory, Py_TYPE(self)->tp_basicsize);
     Py_TYPE(self)->tp_free((PyObject *) self);
 }
 
@@ -219,7 +240,7 @@ PyObject *Py3dQuaternion_Mult(struct Py3dQuaternion *self, PyObject *other) {
     struct Py3dQuaternion *result = Py3dQuaternion_New(0.0f,0.0f,0.0f,1.0f);
     if (result == NULL) return NULL;
 
-    QuaternionMult(result->elements, self->elements, otherQuaternion->elements);
+    QuaternionMultInline(result->elements, self->elements, otherQuaternion->elements);
 
     return (PyObject *) result;
 }
@@ -228,7 +249,7 @@ PyObject *Py3dQuaternion_Normalize(struct Py3dQuaternion *self, PyObject *Py_UNU
     struct Py3dQuaternion *result = Py3dQuaternion_New(0.0f,0.0f,0.0f,1.0f);
     if (result == NULL) return NULL;
 
-    QuaternionNormalize(result->elements, self->elements);
+    QuaternionNormalizeInline(result->elements, self->elements);
 
     return (PyObject *) result;
 }
@@ -251,3 +272,134 @@ PyObject *Py3dQuaternion_FromAxisAndDegrees(struct Py3dQuaternion *Py_UNUSED(sel
 
     return (PyObject *) result;
 }
+
+static PyObject *do_Interpolation(struct Py3dQuaternion *self, PyObject *args, int spherical) {
+    struct Py3dQuaternion *other = NULL;
+    float t = 0.0f;
+    if (PyArg_ParseTuple(args, "O!f", &Py3dQuaternion_Type, &other, &t) != 1) return NULL;
+
+    struct Py3dQuaternion *result = Py3dQuaternion_New(0.0f, 0.0f, 0.0f, 1.0f);
+    if (result == NULL) return NULL;
+
+    if (spherical) {
+        QuaternionSlerp(result->elements, self->elements, other->elements, t);
+    } else {
+        QuaternionNlerp(result->elements, self->elements, other->elements, t);
+    }
+
+    return (PyObject *) result;
+}
+
+PyObject *Py3dQuaternion_Slerp(struct Py3dQuaternion *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Interpolation(self, args, 1);
+}
+
+PyObject *Py3dQuaternion_Nlerp(struct Py3dQuaternion *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    return do_Interpolation(self, args, 0);
+}
+
+PyObject *Py3dQuaternion_ToMatrix(struct Py3dQuaternion *self, PyObject *Py_UNUSED(args)) {
+    struct Py3dMatrix4x4 *result = Py3dMatrix4x4_New();
+    if (result == NULL) return NULL;
+
+    Mat4RotationQuaternionFA(result->elements, self->elements);
+
+    return (PyObject *) result;
+}
+
+PyObject *Py3dQuaternion_FromMatrix(struct Py3dQuaternion *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    struct Py3dMatrix4x4 *matrix = NULL;
+    if (PyArg_ParseTuple(args, "O!", &Py3dMatrix4x4_Type, &matrix) != 1) return NULL;
+
+    struct Py3dQuaternion *result = Py3dQuaternion_New(0.0f, 0.0f, 0.0f, 1.0f);
+    if (result == NULL) return NULL;
+
+    Mat4ToQuaternion(result->elements, matrix->elements);
+
+    return (PyObject *) result;
+}
+
+/**
+ * Acquire an input float32 buffer of whole stride sized elements and a writable output buffer able to hold them.
+ * Returns the element count or -1 with an exception set and nothing to release.
+ */
+static Py_ssize_t acquireBatchBuffers(PyObject *inObj, PyObject *outObj, Py_ssize_t stride, Py_buffer *in, Py_buffer *out) {
+    if (!Py3dBuffer_GetFloats(inObj, in, 0)) return -1;
+    if (!Py3dBuffer_GetFloats(outObj, out, 1)) {
+        PyBuffer_Release(in);
+        return -1;
+    }
+
+    Py_ssize_t elementSize = stride * (Py_ssize_t) sizeof(float);
+    Py_ssize_t count = in->len / elementSize;
+    if (in->len % elementSize != 0 || out->len < in->len || count > INT_MAX) {
+        PyErr_Format(PyExc_ValueError, "Batch input must be %zd floats per element and fit in the output buffer", stride);
+        PyBuffer_Release(out);
+        PyBuffer_Release(in);
+        return -1;
+    }
+
+    return count;
+}
+
+PyObject *Py3dQuaternion_NormalizeBatch(struct Py3dQuaternion *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    PyObject *quatsObj = NULL, *outObj = NULL;
+    if (PyArg_ParseTuple(args, "OO", &quatsObj, &outObj) != 1) return NULL;
+
+    Py_buffer quats, out;
+    Py_ssize_t count = acquireBatchBuffers(quatsObj, outObj, QUATERNION_SIZE, &quats, &out);
+    if (count < 0) return NULL;
+
+    Py_BEGIN_ALLOW_THREADS
+    QuaternionNormalizeBatch(out.buf, quats.buf, (int) count);
+    Py_END_ALLOW_THREADS
+
+    PyBuffer_Release(&out);
+    PyBuffer_Release(&quats);
+
+    return PyLong_FromSsize_t(count);
+}
+
+PyObject *Py3dQuaternion_RotateBatch(struct Py3dQuaternion *Py_UNUSED(self), PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    PyObject *vectorsObj = NULL, *rotationObj = NULL, *outObj = NULL;
+    if (PyArg_ParseTuple(args, "OOO", &vectorsObj, &rotationObj, &outObj) != 1) return NULL;
+
+    Py_buffer vectors, out;
+    Py_ssize_t count = acquireBatchBuffers(vectorsObj, outObj, VEC_3_SIZE, &vectors, &out);
+    if (count < 0) return NULL;
+
+    if (Py3dQuaternion_Check(rotationObj)) {
+        float q[QUATERNION_SIZE];
+        QuaternionCopyInline(q, ((struct Py3dQuaternion *) rotationObj)->elements);
+
+        Py_BEGIN_ALLOW_THREADS
+        QuaternionVec3RotationBatch(out.buf, vectors.buf, q, (int) count);
+        Py_END_ALLOW_THREADS
+    } else {
+        Py_buffer quats;
+        if (!Py3dBuffer_GetFloats(rotationObj, &quats, 0)) {
+            PyBuffer_Release(&out);
+            PyBuffer_Release(&vectors);
+            return NULL;
+        }
+
+        if (quats.len != count * QUATERNION_SIZE * (Py_ssize_t) sizeof(float)) {
+            PyErr_SetString(PyExc_ValueError, "Batch rotation needs exactly one quaternion per vector");
+            PyBuffer_Release(&quats);
+            PyBuffer_Release(&out);
+            PyBuffer_Release(&vectors);
+            return NULL;
+        }
+
+        Py_BEGIN_ALLOW_THREADS
+        QuaternionVec3RotationBatchEach(out.buf, vectors.buf, quats.buf, (int) count);
+        Py_END_ALLOW_THREADS
+
+        PyBuffer_Release(&quats);
+    }
+
+    PyBuffer_Release(&out);
+    PyBuffer_Release(&vectors);
+
+    return PyLong_FromSsize_t(count);
+}
@@ -0,0 +1,250 @@
+#include "py3drasterizer.h"
+
+#include <limits.h>
+#include <string.h>
+
+#include "py3dvector3.h"
+#include "py3dmatrix4x4.h"
+#include "py3dbuffer.h"
+
+static int Py3dRasterizer_Init(struct Py3dRasterizer *self, PyObject *args, PyObject *kwds);
+static void Py3dRasterizer_Dealloc(struct Py3dRasterizer *self);
+
+static PyGetSetDef Py3dRasterizer_GettersSetters[] = {
+    {"width", (getter) Py3dRasterizer_GetWidth, (setter) NULL, "Width of the target in pixels", NULL},
+    {"height", (getter) Py3dRasterizer_GetHeight, (setter) NULL, "Height of the target in pixels", NULL},
+    {NULL}
+};
+
+static PyMethodDef Py3dRasterizer_Methods[] = {
+    {"clear", (PyCFunction) Py3dRasterizer_Clear, METH_VARARGS | METH_KEYWORDS, "Fill the color buffer with an RGBA color and the depth buffer with a depth"},
+    {"draw", (PyCFunction) Py3dRasterizer_Draw, METH_VARARGS | METH_KEYWORDS, "Draw indexed triangles from float32 positions (and optionally normals) transformed by an MVP Matrix4x4, returns how many triangles were not culled or clipped away"},
+    {"color_bytes", (PyCFunction) Py3dRasterizer_ColorBytes, METH_NOARGS, "Return the color buffer as RGBA bytes, rows from top to bottom"},
+    {"read_depth", (PyCFunction) Py3dRasterizer_ReadDepth, METH_VARARGS, "Copy the depth buffer into a float32 buffer of width * height items"},
+    {NULL}
+};
+
+PyTypeObject Py3dRasterizer_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.Rasterizer",
+    .tp_doc = "A tile based software rasterizer that renders shaded triangle meshes without a GPU or a window",
+    .tp_basicsize = sizeof(struct Py3dRasterizer),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_init = (initproc) Py3dRasterizer_Init,
+    .tp_methods = Py3dRasterizer_Methods,
+    .tp_dealloc = (destructor) Py3dRasterizer_Dealloc,
+    .tp_new = PyType_GenericNew,
+    .tp_getset = Py3dRasterizer_GettersSetters
+};
+
+int PyInit_Py3dRasterizer(PyObject *module) {
+    if (PyType_Ready(&Py3dRasterizer_Type) < 0) return 0;
+
+    if (PyModule_AddObjectRef(module, "Rasterizer", (PyObject *) &Py3dRasterizer_Type) < 0) return 0;
+
+    return 1;
+}
+
+static int Py3dRasterizer_Init(struct Py3dRasterizer *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"width", "height", "threads", NULL};
+    int width = 0, height = 0, threads = 0;
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "ii|i", kwlist, &width, &height, &threads) != 1) return -1;
+
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "Rasterizer is drawing");
+        return -1;
+    }
+
+    if (width <= 0 || height <= 0 || width > RASTER_MAX_SIZE || height > RASTER_MAX_SIZE) {
+        PyErr_Format(PyExc_ValueError, "Rasterizer size must be between 1 and %d pixels", RASTER_MAX_SIZE);
+        return -1;
+    }
+
+    if (threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "Thread count must not be negative");
+        return -1;
+    }
+
+    // __init__ may be called again on an existing instance
+    RasterRelease(&self->target);
+    if (!RasterInit(&self->target, width, height, threads)) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    return 0;
+}
+
+static void Py3dRasterizer_Dealloc(struct Py3dRasterizer *self) {
+    RasterRelease(&self->target);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static int checkReady(struct Py3dRasterizer *self) {
+    if (self->target.color == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "Rasterizer was not initialized");
+        return 0;
+    }
+
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "Rasterizer is drawing");
+        return 0;
+    }
+
+    return 1;
+}
+
+PyObject *Py3dRasterizer_GetWidth(struct Py3dRasterizer *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromLong(self->target.width);
+}
+
+PyObject *Py3dRasterizer_GetHeight(struct Py3dRasterizer *self, void *Py_UNUSED(closure)) {
+    return PyLong_FromLong(self->target.height);
+}
+
+PyObject *Py3dRasterizer_Clear(struct Py3dRasterizer *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"color", "depth", NULL};
+    float color[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    float depth = 1.0f;
+    if (
+        PyArg_ParseTupleAndKeywords(
+            args, kwds, "|(ffff)f", kwlist,
+            &color[0], &color[1], &color[2], &color[3], &depth
+        ) != 1
+    ) return NULL;
+    if (!checkReady(self)) return NULL;
+
+    RasterClear(&self->target, color, depth);
+
+    Py_RETURN_NONE;
+}
+
+static int hasNonZero(const float *values, Py_ssize_t count) {
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        if (values[i] != 0.0f) return 1;
+    }
+
+    return 0;
+}
+
+PyObject *Py3dRasterizer_Draw(struct Py3dRasterizer *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"mvp", "positions", "indices", "normals", "color", "light", "ambient", "cull", "reverse_z", NULL};
+    struct Py3dMatrix4x4 *mvp = NULL;
+    PyObject *positionsObj = NULL, *indicesObj = NULL, *normalsObj = Py_None;
+    struct Py3dVector3 *light = NULL;
+    struct RasterShading shading = {
+        .color = {1.0f, 1.0f, 1.0f},
+        .lightDir = {0.3f, 1.0f, -0.6f},
+        .ambient = 0.2f,
+        .cullBackFaces = 1,
+        .reverseZ = 0
+    };
+    if (
+        PyArg_ParseTupleAndKeywords(
+            args, kwds, "O!OO|O(fff)O!fpp", kwlist,
+            &Py3dMatrix4x4_Type, &mvp, &positionsObj, &indicesObj, &normalsObj,
+            &shading.color[0], &shading.color[1], &shading.color[2],
+            &Py3dVector3_Type, &light, &shading.ambient, &shading.cullBackFaces, &shading.reverseZ
+        ) != 1
+    ) return NULL;
+    if (!checkReady(self)) return NULL;
+
+    if (light != NULL) {
+        for (int i = 0; i < VEC_3_SIZE; ++i) shading.lightDir[i] = light->elements[i];
+    }
+
+    Py_buffer positionsView, indicesView, normalsView;
+    int hasNormals = normalsObj != Py_None;
+    if (!Py3dBuffer_GetFloats(positionsObj, &positionsView, 0)) return NULL;
+    if (!Py3dBuffer_GetIndices(indicesObj, &indicesView, 0)) {
+        PyBuffer_Release(&positionsView);
+        return NULL;
+    }
+    if (hasNormals && !Py3dBuffer_GetFloats(normalsObj, &normalsView, 0)) {
+        PyBuffer_Release(&positionsView);
+        PyBuffer_Release(&indicesView);
+        return NULL;
+    }
+
+    Py_ssize_t floatCount = positionsView.len / (Py_ssize_t) sizeof(float);
+    Py_ssize_t vertexCount = floatCount / VEC_3_SIZE;
+    Py_ssize_t indexCount = indicesView.len / (Py_ssize_t) sizeof(unsigned int);
+    const unsigned int *indices = indicesView.buf;
+    const float *normals = NULL;
+    PyObject *result = NULL;
+
+    if (floatCount % VEC_3_SIZE != 0 || vertexCount > INT_MAX || indexCount % 3 != 0 || indexCount > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Positions must hold 3 floats per vertex and indices 3 items per triangle");
+        goto done;
+    }
+
+    if (hasNormals) {
+        if (normalsView.len != positionsView.len) {
+            PyErr_SetString(PyExc_ValueError, "Normals must hold 3 floats for every vertex");
+            goto done;
+        }
+
+        // Meshes loaded without normals have them all zero, face normals light those properly
+        if (hasNonZero(normalsView.buf, floatCount)) normals = normalsView.buf;
+    }
+
+    for (Py_ssize_t i = 0; i < indexCount; ++i) {
+        if (indices[i] >= (unsigned int) vertexCount) {
+            PyErr_Format(PyExc_ValueError, "Index %zd refers to vertex %u of %zd", i, indices[i], vertexCount);
+            goto done;
+        }
+    }
+
+    int drawn = 0;
+    self->busy = 1;
+    Py_BEGIN_ALLOW_THREADS
+    drawn = RasterDrawIndexed(
+        &self->target, mvp->elements, positionsView.buf, normals, (int) vertexCount, indices, (int) indexCount, &shading
+    );
+    Py_END_ALLOW_THREADS
+    self->busy = 0;
+
+    if (drawn < 0) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    result = PyLong_FromLong(drawn);
+
+done:
+    PyBuffer_Release(&positionsView);
+    PyBuffer_Release(&indicesView);
+    if (hasNormals) PyBuffer_Release(&normalsView);
+
+    return result;
+}
+
+PyObject *Py3dRasterizer_ColorBytes(struct Py3dRasterizer *self, PyObject *Py_UNUSED(args)) {
+    if (!checkReady(self)) return NULL;
+
+    Py_ssize_t size = (Py_ssize_t) self->target.width * self->target.height * RASTER_COLOR_CHANNELS;
+
+    return PyBytes_FromStringAndSize((const char *) self->target.color, size);
+}
+
+PyObject *Py3dRasterizer_ReadDepth(struct Py3dRasterizer *self, PyObject *args) {
+    PyObject *outObj = NULL;
+    if (PyArg_ParseTuple(args, "O", &outObj) != 1) return NULL;
+    if (!checkReady(self)) return NULL;
+
+    Py_buffer outView;
+    if (!Py3dBuffer_GetFloats(outObj, &outView, 1)) return NULL;
+
+    Py_ssize_t count = (Py_ssize_t) self->target.width * self->target.height;
+    if (outView.len / (Py_ssize_t) sizeof(float) != count) {
+        PyBuffer_Release(&outView);
+        PyErr_Format(PyExc_ValueError, "Depth buffer must hold %zd floats", count);
+        return NULL;
+    }
+
+    memcpy(outView.buf, self->target.depth, (size_t) count * sizeof(float));
+    PyBuffer_Release(&outView);
+
+    Py_RETURN_NONE;
+}
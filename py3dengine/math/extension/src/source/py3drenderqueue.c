@@ -0,0 +1,370 @@
+#include "py3drenderqueue.h"
+
+#include <stdarg.h>
+
+#include "py3dvector3.h"
+#include "py3dmatrix4x4.h"
+
+static int Py3dRenderQueue_Init(struct Py3dRenderQueue *self, PyObject *args, PyObject *kwds);
+static void Py3dRenderQueue_Dealloc(struct Py3dRenderQueue *self);
+static int Py3dRenderQueue_Traverse(struct Py3dRenderQueue *self, visitproc visit, void *arg);
+static int Py3dRenderQueue_Clear(struct Py3dRenderQueue *self);
+static Py_ssize_t Py3dRenderQueue_Length(struct Py3dRenderQueue *self);
+
+static PyGetSetDef Py3dRenderQueue_GettersSetters[] = {
+    {"camera_position", (getter) Py3dRenderQueue_GetCameraPosition, (setter) Py3dRenderQueue_SetCameraPosition, "Vector3 that submit measures the depth of commands from when none is given", NULL},
+    {"state_count", (getter) Py3dRenderQueue_GetStateCount, (setter) NULL, "Number of (materials, meshes) interned since the last release_states", NULL},
+    {"last_flush", (getter) Py3dRenderQueue_GetLastFlush, (setter) NULL, "(commands, batches, state changes) of the last flush", NULL},
+    {NULL}
+};
+
+static PyMethodDef Py3dRenderQueue_Methods[] = {
+    {"submit", (PyCFunction) Py3dRenderQueue_Submit, METH_VARARGS | METH_KEYWORDS, "Queue a draw of a mesh with a material at a world Matrix4x4, on a layer, optionally translucent and at a given depth"},
+    {"flush", (PyCFunction) Py3dRenderQueue_Flush, METH_O, "Sort and batch the queued commands, replay them on a backend and empty the queue, returns the batch count"},
+    {"reset", (PyCFunction) Py3dRenderQueue_Reset, METH_NOARGS, "Drop every queued command"},
+    {"release_states", (PyCFunction) Py3dRenderQueue_ReleaseStates, METH_NOARGS, "Drop every queued command and forget the interned materials and meshes"},
+    {NULL}
+};
+
+static PySequenceMethods Py3dRenderQueue_SequenceMethods = {
+    .sq_length = (lenfunc) Py3dRenderQueue_Length,
+};
+
+PyTypeObject Py3dRenderQueue_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "py3dmath.RenderQueue",
+    .tp_doc = "A render command queue that sorts draws by 64 bit keys and replays them as instanced batches on a backend",
+    .tp_basicsize = sizeof(struct Py3dRenderQueue),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_init = (initproc) Py3dRenderQueue_Init,
+    .tp_methods = Py3dRenderQueue_Methods,
+    .tp_dealloc = (destructor) Py3dRenderQueue_Dealloc,
+    .tp_traverse = (traverseproc) Py3dRenderQueue_Traverse,
+    .tp_clear = (inquiry) Py3dRenderQueue_Clear,
+    .tp_new = PyType_GenericNew,
+    .tp_getset = Py3dRenderQueue_GettersSetters
+};
+
+int PyInit_Py3dRenderQueue(PyObject *module) {
+    Py3dRenderQueue_Type.tp_as_sequence = &Py3dRenderQueue_SequenceMethods;
+    if (PyType_Ready(&Py3dRenderQueue_Type) < 0) return 0;
+
+    if (PyModule_AddObjectRef(module, "RenderQueue", (PyObject *) &Py3dRenderQueue_Type) < 0) return 0;
+
+    return 1;
+}
+
+static int Py3dRenderQueue_Init(struct Py3dRenderQueue *self, PyObject *args, PyObject *Py_UNUSED(kwds)) {
+    if (PyArg_ParseTuple(args, "") != 1) return -1;
+
+    if (self->flushing) {
+        PyErr_SetString(PyExc_RuntimeError, "RenderQueue is flushing");
+        return -1;
+    }
+
+    // __init__ may be called again on an existing instance
+    RenderQueueRelease(&self->queue);
+    RenderQueueInit(&self->queue);
+    Py3dRenderQueue_Clear(self);
+
+    self->materialIds = PyDict_New();
+    self->materials = PyList_New(0);
+    self->meshIds = PyDict_New();
+    self->meshes = PyList_New(0);
+    if (self->materialIds == NULL || self->materials == NULL || self->meshIds == NULL || self->meshes == NULL) return -1;
+
+    Vec3Fill(self->cameraPosition, 0.0f);
+    self->lastCommandCount = 0;
+    self->lastBatchCount = 0;
+    self->lastStateChangeCount = 0;
+
+    return 0;
+}
+
+static void Py3dRenderQueue_Dealloc(struct Py3dRenderQueue *self) {
+    PyObject_GC_UnTrack(self);
+    Py3dRenderQueue_Clear(self);
+    RenderQueueRelease(&self->queue);
+    Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static int Py3dRenderQueue_Traverse(struct Py3dRenderQueue *self, visitproc visit, void *arg) {
+    Py_VISIT(self->materialIds);
+    Py_VISIT(self->materials);
+    Py_VISIT(self->meshIds);
+    Py_VISIT(self->meshes);
+
+    return 0;
+}
+
+static int Py3dRenderQueue_Clear(struct Py3dRenderQueue *self) {
+    Py_CLEAR(self->materialIds);
+    Py_CLEAR(self->materials);
+    Py_CLEAR(self->meshIds);
+    Py_CLEAR(self->meshes);
+
+    return 0;
+}
+
+static Py_ssize_t Py3dRenderQueue_Length(struct Py3dRenderQueue *self) {
+    return self->queue.commandCount;
+}
+
+static int checkReady(struct Py3dRenderQueue *self) {
+    if (self->materialIds == NULL || self->materials == NULL || self->meshIds == NULL || self->meshes == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "RenderQueue was not initialized");
+        return 0;
+    }
+
+    // Backends must not queue or drop commands while the queue replays them
+    if (self->flushing) {
+        PyErr_SetString(PyExc_RuntimeError, "RenderQueue is flushing");
+        return 0;
+    }
+
+    return 1;
+}
+
+PyObject *Py3dRenderQueue_GetCameraPosition(struct Py3dRenderQueue *self, void *Py_UNUSED(closure)) {
+    struct Py3dVector3 *result = Py3dVector3_New(0.0f, 0.0f, 0.0f);
+    if (result == NULL) return NULL;
+
+    Vec3Copy(result->elements, self->cameraPosition);
+
+    return (PyObject *) result;
+}
+
+int Py3dRenderQueue_SetCameraPosition(struct Py3dRenderQueue *self, PyObject *value, void *Py_UNUSED(closure)) {
+    if (value == NULL || !Py3dVector3_Check(value)) {
+        PyErr_SetString(PyExc_TypeError, "Camera position must be a Vector3");
+        return -1;
+    }
+
+    Vec3Copy(self->cameraPosition, ((struct Py3dVector3 *) value)->elements);
+
+    return 0;
+}
+
+PyObject *Py3dRenderQueue_GetStateCount(struct Py3dRenderQueue *self, void *Py_UNUSED(closure)) {
+    if (self->materials == NULL || self->meshes == NULL) return Py_BuildValue("(ii)", 0, 0);
+
+    return Py_BuildValue("(nn)", PyList_GET_SIZE(self->materials), PyList_GET_SIZE(self->meshes));
+}
+
+PyObject *Py3dRenderQueue_GetLastFlush(struct Py3dRenderQueue *self, void *Py_UNUSED(closure)) {
+    return Py_BuildValue("(iii)", self->lastCommandCount, self->lastBatchCount, self->lastStateChangeCount);
+}
+
+static int internState(PyObject *ids, PyObject *objects, PyObject *obj) {
+    PyObject *id = PyDict_GetItemWithError(ids, obj);
+    if (id != NULL) return (int) PyLong_AsLong(id);
+    if (PyErr_Occurred()) return -1;
+
+    Py_ssize_t count = PyList_GET_SIZE(objects);
+    if (count > RENDER_MAX_STATE) {
+        PyErr_Format(
+            PyExc_ValueError,
+            "RenderQueue can tell at most %d materials or meshes apart, call release_states",
+            RENDER_MAX_STATE + 1
+        );
+        return -1;
+    }
+
+    if (PyList_Append(objects, obj) < 0) return -1;
+
+    id = PyLong_FromSsize_t(count);
+    int stored = id != NULL && PyDict_SetItem(ids, obj, id) == 0;
+    Py_XDECREF(id);
+    if (!stored) {
+        PyList_SetSlice(objects, count, count + 1, NULL);
+        return -1;
+    }
+
+    return (int) count;
+}
+
+PyObject *Py3dRenderQueue_Submit(struct Py3dRenderQueue *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"material", "mesh", "world", "layer", "translucent", "depth", NULL};
+    PyObject *material = NULL, *mesh = NULL, *depthObj = Py_None;
+    struct Py3dMatrix4x4 *world = NULL;
+    int layer = 0, translucent = 0;
+    if (
+        PyArg_ParseTupleAndKeywords(
+            args, kwds, "OOO!|ipO", kwlist,
+            &material, &mesh, &Py3dMatrix4x4_Type, &world, &layer, &translucent, &depthObj
+        ) != 1
+    ) return NULL;
+    if (!checkReady(self)) return NULL;
+
+    if (layer < 0 || layer > RENDER_MAX_LAYER) {
+        PyErr_Format(PyExc_ValueError, "Layer must be between 0 and %d", RENDER_MAX_LAYER);
+        return NULL;
+    }
+
+    float depth;
+    if (depthObj == Py_None) {
+        // The translation row of the world matrix is the object's position
+        float offset[VEC_3_SIZE];
+        Vec3Subtract(offset, &world->elements[12], self->cameraPosition);
+        Vec3Length(&depth, offset);
+    } else {
+        double value = PyFloat_AsDouble(depthObj);
+        if (value == -1.0 && PyErr_Occurred()) return NULL;
+        depth = (float) value;
+    }
+
+    int materialId = internState(self->materialIds, self->materials, material);
+    if (materialId < 0) return NULL;
+    int meshId = internState(self->meshIds, self->meshes, mesh);
+    if (meshId < 0) return NULL;
+
+    if (!RenderQueueSubmit(&self->queue, RenderKeyMake(layer, translucent, materialId, meshId, depth), world->elements)) {
+        return PyErr_NoMemory();
+    }
+
+    Py_RETURN_NONE;
+}
+
+static int callBackend(PyObject *method, const char *format, ...) {
+    va_list values;
+    va_start(values, format);
+    PyObject *callArgs = Py_VaBuildValue(format, values);
+    va_end(values);
+    if (callArgs == NULL) return 0;
+
+    PyObject *result = PyObject_CallObject(method, callArgs);
+    Py_DECREF(callArgs);
+    if (result == NULL) return 0;
+
+    Py_DECREF(result);
+    return 1;
+}
+
+static PyObject *instanceView(const struct RenderQueue *queue) {
+    PyObject *data = PyBytes_FromStringAndSize(
+        (const char *) queue->instances, (Py_ssize_t) queue->commandCount * MAT_4_SIZE * (Py_ssize_t) sizeof(float)
+    );
+    if (data == NULL) return NULL;
+
+    PyObject *bytesView = PyMemoryView_FromObject(data);
+    Py_DECREF(data);
+    if (bytesView == NULL) return NULL;
+
+    PyObject *floatView = PyObject_CallMethod(bytesView, "cast", "s", "f");
+    Py_DECREF(bytesView);
+
+    return floatView;
+}
+
+static int replayBatches(struct Py3dRenderQueue *self, PyObject *backend, PyObject *instances) {
+    static const char *methodNames[] = {"begin_layer", "bind_material", "bind_mesh", "draw_instanced"};
+    PyObject *methods[4] = {NULL, NULL, NULL, NULL};
+    int ok = 0;
+
+    for (int i = 0; i < 4; ++i) {
+        methods[i] = PyObject_GetAttrString(backend, methodNames[i]);
+        if (methods[i] == NULL) goto done;
+    }
+
+    int layer = -1, translucent = -1, material = -1, mesh = -1;
+    for (int i = 0; i < self->queue.batchCount; ++i) {
+        const struct RenderBatch *batch = &self->queue.batches[i];
+
+        if (batch->layer != layer || batch->translucent != translucent) {
+            layer = batch->layer;
+            translucent = batch->translucent;
+            ++self->lastStateChangeCount;
+            if (!callBackend(methods[0], "(iO)", layer, translucent ? Py_True : Py_False)) goto done;
+        }
+
+        if (batch->material != material) {
+            material = batch->material;
+            ++self->lastStateChangeCount;
+            if (!callBackend(methods[1], "(O)", PyList_GET_ITEM(self->materials, material))) goto done;
+        }
+
+        if (batch->mesh != mesh) {
+            mesh = batch->mesh;
+            ++self->lastStateChangeCount;
+            if (!callBackend(methods[2], "(O)", PyList_GET_ITEM(self->meshes, mesh))) goto done;
+        }
+
+        PyObject *batchInstances = PySequence_GetSlice(
+            instances,
+            (Py_ssize_t) batch->firstInstance * MAT_4_SIZE,
+            (Py_ssize_t) (batch->firstInstance + batch->instanceCount) * MAT_4_SIZE
+        );
+        if (batchInstances == NULL) goto done;
+
+        int called = callBackend(methods[3], "(Oi)", batchInstances, batch->instanceCount);
+        Py_DECREF(batchInstances);
+        if (!called) goto done;
+    }
+    ok = 1;
+
+done:
+    for (int i = 0; i < 4; ++i) {
+        Py_XDECREF(methods[i]);
+    }
+
+    return ok;
+}
+
+PyObject *Py3dRenderQueue_Flush(struct Py3dRenderQueue *self, PyObject *backend) {
+    if (!checkReady(self)) return NULL;
+
+    // Set before the GIL is released, other threads must not free or grow the arrays the sort works on either
+    self->flushing = 1;
+
+    int batchCount;
+    Py_BEGIN_ALLOW_THREADS
+    batchCount = RenderQueueBuild(&self->queue);
+    Py_END_ALLOW_THREADS
+
+    self->lastCommandCount = self->queue.commandCount;
+    self->lastBatchCount = batchCount < 0 ? 0 : batchCount;
+    self->lastStateChangeCount = 0;
+
+    if (batchCount < 0) {
+        RenderQueueReset(&self->queue);
+        self->flushing = 0;
+        return PyErr_NoMemory();
+    }
+
+    // One copy of the sorted world matrices is shared by the views handed to every draw
+    PyObject *instances = instanceView(&self->queue);
+    int ok = 0;
+    if (instances != NULL) {
+        ok = replayBatches(self, backend, instances);
+        Py_DECREF(instances);
+    }
+
+    RenderQueueReset(&self->queue);
+    self->flushing = 0;
+    if (!ok) return NULL;
+
+    return PyLong_FromLong(batchCount);
+}
+
+PyObject *Py3dRenderQueue_Reset(struct Py3dRenderQueue *self, PyObject *Py_UNUSED(args)) {
+    if (!checkReady(self)) return NULL;
+
+    RenderQueueReset(&self->queue);
+
+    Py_RETURN_NONE;
+}
+
+PyObject *Py3dRenderQueue_ReleaseStates(struct Py3dRenderQueue *self, PyObject *Py_UNUSED(args)) {
+    if (!checkReady(self)) return NULL;
+
+    // Queued commands refer to the ids being forgotten
+    RenderQueueReset(&self->queue);
+
+    PyDict_Clear(self->materialIds);
+    PyDict_Clear(self->meshIds);
+    if (PyList_SetSlice(self->materials, 0, PyList_GET_SIZE(self->materials), NULL) < 0) return NULL;
+    if (PyList_SetSlice(self->meshes, 0, PyList_GET_SIZE(self->meshes), NULL) < 0) return NULL;
+
+    Py_RETURN_NONE;
+}
@@ -5,14 +5,17 @@
 #include <vector.h>
 #include <quaternion.h>
 #include <matrix.h>
+#include <mathinline.h>
 
 #include "py3dvector3.h"
 #include "py3dquaternion.h"
 #include "py3dmatrix4x4.h"
+#include "py3dmemory.h"
 
 #define MAX_STRING_SIZE 64
 
 static void Py3dVector3_Dealloc(struct Py3dVector3 *self);
+static PyObject *Py3dVector3_Alloc(PyTypeObject *type, Py_ssize_t itemCount);
 static int Py3dVector3_Init(struct Py3dVector3 *self, PyObject *args, PyObject *kwds);
 
 PyGetSetDef Py3dVector3_GettersSetters[] = {
@@ -47,6 +50,7 @@ PyTypeObject Py3dVector3_Type = {
     .tp_flags = Py_TPFLAGS_DEFAULT,
     .tp_init = (initproc) Py3dVector3_Init,
     .tp_methods = Py3dVector3_Methods,
+    .tp_alloc = (allocfunc) Py3dVector3_Alloc,
     .tp_dealloc = (destructor) Py3dVector3_Dealloc,
     .tp_new = PyType_GenericNew,
     .tp_repr = (reprfunc) Py3dVector3_Repr,
@@ -115,7 +119,7 @@ static int Py3dVector3_Init(struct Py3dVector3 *self, PyObject *args, PyObject *
     }
 
     PyObject *singleObjArg = NULL;
-    if (PyArg_ParseTuple(args, "O", &singleObjArg) == 1) {
+    if (PyTuple_Size(args) == 1 && PyArg_ParseTuple(args, "O", &singleObjArg) == 1) {
         if (PyList_Check(singleObjArg)) {
             return init_from_list(self, singleObjArg);
         } else if (PyDict_Check(singleObjArg)) {
@@ -140,7 +144,15 @@ static int Py3dVector3_Init(struct Py3dVector3 *self, PyObject *args, PyObject *
     return 0;
 }
 
+static PyObject *Py3dVector3_Alloc(PyTypeObject *type, Py_ssize_t itemCount) {
+    PyObject *obj = PyType_GenericAlloc(type, itemCount);
+    if (obj != NULL) Py3dMemory_Track(&Py3dVector3_Memory, type->tp_basicsize);
+
+    return obj;
+}
+
 static void Py3dVector3_Dealloc(struct Py3dVector3 *self) {
+    Py3dMemory_Untrack(&Py3dVector3_Memory, Py_TYPE(self)->tp_basicsize);
     Py_TYPE(self)->tp_free((PyObject *) self);
 }
 
@@ -182,7 +194,7 @@ PyObject *Py3dVector3_Add(struct Py3dVector3 *self, PyObject *other) {
     struct Py3dVector3 *result = Py3dVector3_New(0.0f, 0.0f, 0.0f);
     if (result == NULL) return NULL;
 
-    Vec3Add(result->elements, self->elements, otherAsVec3->elements);
+    Vec3AddInline(result->elements, self->elements, otherAsVec3->elements);
 
     return (PyObject *) result;
 }
@@ -194,7 +206,7 @@ PyObject *Py3dVector3_Sub(struct Py3dVector3 *self, PyObject *other) {
     struct Py3dVector3 *result = Py3dVector3_New(0.0f, 0.0f, 0.0f);
     if (result == NULL) return NULL;
 
-    Vec3Subtract(result->elements, self->elements, otherAsVec3->elements);
+    Vec3SubtractInline(result->elements, self->elements, otherAsVec3->elements);
 
     return (PyObject *) result;
 }
@@ -203,7 +215,7 @@ static PyObject *do_Vector3_Cross_Mult(struct Py3dVector3 *self, struct Py3dVect
     struct Py3dVector3 *result = Py3dVector3_New(0.0f, 0.0f, 0.0f);
     if (result == NULL) return NULL;
 
-    Vec3Cross(result->elements, self->elements, other->elements);
+    Vec3CrossInline(result->elements, self->elements, other->elements);
 
     return (PyObject *) result;
 }
@@ -212,7 +224,7 @@ static PyObject *do_Vector3_Quaternion_Mult(struct Py3dVector3 *self, struct Py3
     struct Py3dVector3 *result = Py3dVector3_New(0.0f, 0.0f, 0.0f);
     if (result == NULL) return NULL;
 
-    QuaternionVec3Rotation(result->elements, self->elements, other->elements);
+    QuaternionVec3RotationInline(result->elements, self->elements, other->elements);
 
     return (PyObject *) result;
 }
@@ -223,11 +235,11 @@ static PyObject *do_Vector3_Matrix4x4_Mult(struct Py3dVector3 *self, struct Py3d
 
     float vec4[] = {0.0f, 0.0f, 0.0f, 1.0f};
     float temp[] = {0.0f, 0.0f, 0.0f, 1.0f};
-    Vec3Copy(vec4, self->elements);
+    Vec3CopyInline(vec4, self->elements);
 
-    Mat4Vec4Mult(temp, other->elements, vec4);
+    Mat4Vec4MultInline(temp, other->elements, vec4);
 
-    Vec3Copy(result->elements, temp);
+    Vec3CopyInline(result->elements, temp);
 
     return (PyObject *) result;
 }
@@ -236,7 +248,7 @@ static PyObject *do_Vector3_Scalar_Mult(struct Py3dVector3 *self, float scalar)
     struct Py3dVector3 *result = Py3dVector3_New(0.0f, 0.0f, 0.0f);
     if (result == NULL) return NULL;
 
-    Vec3Scalar(result->elements, self->elements, scalar);
+    Vec3ScalarInline(result->elements, self->elements, scalar);
 
     return (PyObject *) result;
 }
@@ -284,7 +296,7 @@ PyObject *Py3dVector3_Div(struct Py3dVector3 *self, PyObject *other) {
     struct Py3dVector3 *result = Py3dVector3_New(0.0f, 0.0f, 0.0f);
     if (result == NULL) return NULL;
 
-    Vec3Divide(result->elements, self->elements, scalar);
+    Vec3DivideInline(result->elements, self->elements, scalar);
 
     return (PyObject *) result;
 }
@@ -293,24 +305,18 @@ PyObject *Py3dVector3_Dot(struct Py3dVector3 *self, PyObject *args, PyObject *Py
     struct Py3dVector3 *other = NULL;
     if (PyArg_ParseTuple(args, "O!", &Py3dVector3_Type, &other) == 0) return NULL;
 
-    float ret = 0.0f;
-    Vec3Dot(&ret, self->elements, other->elements);
-
-    return PyFloat_FromDouble(ret);
+    return PyFloat_FromDouble(Vec3DotInline(self->elements, other->elements));
 }
 
 PyObject *Py3dVector3_Length(struct Py3dVector3 *self, PyObject *Py_UNUSED(args)) {
-    float ret = 0.0f;
-    Vec3Length(&ret, self->elements);
-
-    return PyFloat_FromDouble(ret);
+    return PyFloat_FromDouble(Vec3LengthInline(self->elements));
 }
 
 PyObject *Py3dVector3_Normalize(struct Py3dVector3 *self, PyObject *Py_UNUSED(args)) {
     struct Py3dVector3 *result = Py3dVector3_New(0.0f, 0.0f, 0.0f);
     if (result == NULL) return NULL;
 
-    Vec3Normalize(result->elements, self->elements);
+    Vec3NormalizeInline(result->elements, self->elements);
 
     return (PyObject *) result;
 }
@@ -332,7 +338,7 @@ PyObject *Py3dVector3_Copy(struct Py3dVector3 *self, PyObject *Py_UNUSED(args))
     struct Py3dVector3 *result = Py3dVector3_New(0.0f, 0.0f, 0.0f);
     if (result == NULL) return NULL;
 
-    Vec3Copy(result->elements, self->elements);
+    Vec3CopyInline(result->elements, self->elements);
 
     return (PyObject *) result;
 }
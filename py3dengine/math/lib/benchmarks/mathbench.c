@@ -0,0 +1,341 @@
+/**
+ * Microbenchmarks for every Vec3, Quaternion and Mat4 function of the py3dmath library.
+ *
+ * Usage: py3dmath_bench [--filter text] [--min-time ms] [--repetitions n] [--tier scalar|sse|avx2|avx512]
+ *
+ * Each benchmark is calibrated until one run takes at least min-time, then run repetitions times. The JSON report on
+ * stdout lists benchmarks in a fixed order with the median and minimum ns/op of the runs, and allocs/op when the
+ * allocator is wrapped at link time (null otherwise), so reports of two builds can be diffed or compared by a script.
+ * Functions with an Inline suffix are the mathinline.h variants, next to their out of line counterparts for comparison,
+ * and the Chain benchmarks combine several calls the way transform code does. Batch functions process BATCH_COUNT
+ * items per op. Kernels are bound to the best tier the CPU supports unless --tier
+ * names another, the report records the tier.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vector.h"
+#include "quaternion.h"
+#include "matrix.h"
+#include "dispatch.h"
+#include "mathinline.h"
+
+#define INPUT_COUNT 64
+#define BATCH_COUNT 1024
+#define MAX_REPETITIONS 64
+#define CSTR_SIZE 256
+
+#ifdef MATHBENCH_COUNT_ALLOCATIONS
+static unsigned long allocationCount = 0;
+
+extern void *__real_malloc(size_t size);
+extern void *__real_calloc(size_t count, size_t size);
+extern void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    ++allocationCount;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    ++allocationCount;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    ++allocationCount;
+    return __real_realloc(ptr, size);
+}
+#endif
+
+// Inputs vary between calls so no value is the same every iteration, outputs are global so no call can be dropped
+static float vec3s[INPUT_COUNT][VEC_3_SIZE];
+static float vec4s[INPUT_COUNT][VEC_4_SIZE];
+static float quats[INPUT_COUNT][QUATERNION_SIZE];
+static float mats[INPUT_COUNT][MAT_4_SIZE];
+static float scalars[INPUT_COUNT];
+
+float outVec3[VEC_3_SIZE];
+float outVec4[VEC_4_SIZE];
+float outQuat[QUATERNION_SIZE];
+float outMat[MAT_4_SIZE];
+float outScalar;
+int outInt;
+char outCStr[CSTR_SIZE];
+
+static float *batchIn;
+static float *batchQuats;
+static float *batchOut;
+
+typedef void (*BenchFunction)(long iterations);
+
+struct Benchmark {
+    const char *name;
+    BenchFunction run;
+};
+
+// Inlined bodies would otherwise only store the outputs of the last iteration, the clobber makes every one count
+#if defined(__GNUC__)
+#define BENCH_CLOBBER() __asm__ volatile("" ::: "memory")
+#else
+#define BENCH_CLOBBER()
+#endif
+
+#define BENCH(benchName, body) \
+    static void bench_##benchName(long iterations) { \
+        for (long iteration = 0; iteration < iterations; ++iteration) { \
+            const int k = (int) (iteration & (INPUT_COUNT - 1)); \
+            const int j = (k + 1) & (INPUT_COUNT - 1); \
+            (void) j; \
+            body; \
+            BENCH_CLOBBER(); \
+        } \
+    }
+
+BENCH(Vec3Identity, Vec3Identity(outVec3))
+BENCH(Vec3Copy, Vec3Copy(outVec3, vec3s[k]))
+BENCH(Vec3Fill, Vec3Fill(outVec3, scalars[k]))
+BENCH(Vec3ToCStr, Vec3ToCStr(outCStr, vec3s[k], CSTR_SIZE))
+BENCH(Vec3Add, Vec3Add(outVec3, vec3s[k], vec3s[j]))
+BENCH(Vec3Subtract, Vec3Subtract(outVec3, vec3s[k], vec3s[j]))
+BENCH(Vec3Scalar, Vec3Scalar(outVec3, vec3s[k], scalars[j]))
+BENCH(Vec3Dot, Vec3Dot(&outScalar, vec3s[k], vec3s[j]))
+BENCH(Vec3Cross, Vec3Cross(outVec3, vec3s[k], vec3s[j]))
+BENCH(Vec3Divide, Vec3Divide(outVec3, vec3s[k], scalars[j]))
+BENCH(Vec3Length, Vec3Length(&outScalar, vec3s[k]))
+BENCH(Vec3Normalize, Vec3Normalize(outVec3, vec3s[k]))
+
+BENCH(QuaternionIdentity, QuaternionIdentity(outQuat))
+BENCH(QuaternionCopy, QuaternionCopy(outQuat, quats[k]))
+BENCH(QuaternionToCStr, QuaternionToCStr(outCStr, quats[k], CSTR_SIZE))
+BENCH(QuaternionVec3Rotation, QuaternionVec3Rotation(outVec3, vec3s[k], quats[j]))
+BENCH(QuaternionFromAxisAngle, QuaternionFromAxisAngle(outQuat, vec3s[k][0], vec3s[k][1], vec3s[k][2], scalars[j]))
+BENCH(QuaternionNormalize, QuaternionNormalize(outQuat, quats[k]))
+BENCH(QuaternionMult, QuaternionMult(outQuat, quats[k], quats[j]))
+BENCH(QuaternionDot, QuaternionDot(&outScalar, quats[k], quats[j]))
+BENCH(QuaternionNlerp, QuaternionNlerp(outQuat, quats[k], quats[j], scalars[k] * 0.01f))
+BENCH(QuaternionSlerp, QuaternionSlerp(outQuat, quats[k], quats[j], scalars[k] * 0.01f))
+BENCH(QuaternionNormalizeBatch, QuaternionNormalizeBatch(batchOut, batchQuats, BATCH_COUNT))
+BENCH(QuaternionVec3RotationBatch, QuaternionVec3RotationBatch(batchOut, batchIn, quats[k], BATCH_COUNT))
+BENCH(QuaternionVec3RotationBatchEach, QuaternionVec3RotationBatchEach(batchOut, batchIn, batchQuats, BATCH_COUNT))
+
+BENCH(Mat4Identity, Mat4Identity(outMat))
+BENCH(Mat4Copy, Mat4Copy(outMat, mats[k]))
+BENCH(Mat4Fill, Mat4Fill(outMat, scalars[k]))
+BENCH(Mat4Transpose, Mat4Transpose(outMat, mats[k]))
+BENCH(Mat4ToCStr, Mat4ToCStr(outCStr, mats[k], CSTR_SIZE))
+BENCH(Mat4TranslationF, Mat4TranslationF(outMat, vec3s[k][0], vec3s[k][1], vec3s[k][2]))
+BENCH(Mat4TranslationFA, Mat4TranslationFA(outMat, vec3s[k]))
+BENCH(Mat4RotationX, Mat4RotationX(outMat, scalars[k]))
+BENCH(Mat4RotationY, Mat4RotationY(outMat, scalars[k]))
+BENCH(Mat4RotationZ, Mat4RotationZ(outMat, scalars[k]))
+BENCH(Mat4RotationAxisF, Mat4RotationAxisF(outMat, vec3s[k][0], vec3s[k][1], vec3s[k][2], scalars[j]))
+BENCH(Mat4RotationAxisFA, Mat4RotationAxisFA(outMat, vec3s[k], scalars[j]))
+BENCH(Mat4RotationQuaternionF, Mat4RotationQuaternionF(outMat, quats[k][0], quats[k][1], quats[k][2], quats[k][3]))
+BENCH(Mat4RotationQuaternionFA, Mat4RotationQuaternionFA(outMat, quats[k]))
+BENCH(Mat4ToQuaternion, Mat4ToQuaternion(outQuat, mats[k]))
+BENCH(Mat4ScalingF, Mat4ScalingF(outMat, vec3s[k][0], vec3s[k][1], vec3s[k][2]))
+BENCH(Mat4ScalingFA, Mat4ScalingFA(outMat, vec3s[k]))
+BENCH(Mat4Mult, Mat4Mult(outMat, mats[k], mats[j]))
+BENCH(Mat4Inverse, outInt = Mat4Inverse(outMat, mats[k]))
+BENCH(Mat4Vec4Mult, Mat4Vec4Mult(outVec4, mats[k], vec4s[j]))
+BENCH(Mat4MultBatch, Mat4MultBatch(batchOut, batchIn, mats[k], BATCH_COUNT / 4))
+BENCH(Mat4LookAtLH, Mat4LookAtLH(outMat, vec3s[k], vec3s[j], vec3s[0]))
+BENCH(Mat4LookAtRH, Mat4LookAtRH(outMat, vec3s[k], vec3s[j], vec3s[0]))
+BENCH(Mat4PerspectiveFovLH, Mat4PerspectiveFovLH(outMat, 30.0f + scalars[k], 1.7f, 0.1f, 100.0f))
+BENCH(Mat4PerspectiveFovRH, Mat4PerspectiveFovRH(outMat, 30.0f + scalars[k], 1.7f, 0.1f, 100.0f))
+BENCH(Mat4PerspectiveInfiniteReverseZLH, Mat4PerspectiveInfiniteReverseZLH(outMat, 30.0f + scalars[k], 1.7f, 0.1f))
+BENCH(Mat4PerspectiveInfiniteReverseZRH, Mat4PerspectiveInfiniteReverseZRH(outMat, 30.0f + scalars[k], 1.7f, 0.1f))
+BENCH(Mat4OrthographicLH, Mat4OrthographicLH(outMat, 10.0f + scalars[k], 10.0f, 0.1f, 100.0f))
+BENCH(Mat4OrthographicRH, Mat4OrthographicRH(outMat, 10.0f + scalars[k], 10.0f, 0.1f, 100.0f))
+
+// Rotate, translate, then measure and normalize: the sequence transform code runs per vector
+static inline void chainOutOfLine(float out[VEC_3_SIZE], const float v[VEC_3_SIZE], const float q[QUATERNION_SIZE],
+                                  const float t[VEC_3_SIZE]) {
+    float rotated[VEC_3_SIZE];
+    float moved[VEC_3_SIZE];
+    QuaternionVec3Rotation(rotated, v, q);
+    Vec3Add(moved, rotated, t);
+    Vec3Dot(&outScalar, moved, v);
+    Vec3Normalize(out, moved);
+}
+
+static inline void chainInline(float out[VEC_3_SIZE], const float v[VEC_3_SIZE], const float q[QUATERNION_SIZE],
+                               const float t[VEC_3_SIZE]) {
+    float rotated[VEC_3_SIZE];
+    float moved[VEC_3_SIZE];
+    QuaternionVec3RotationInline(rotated, v, q);
+    Vec3AddInline(moved, rotated, t);
+    outScalar = Vec3DotInline(moved, v);
+    Vec3NormalizeInline(out, moved);
+}
+
+BENCH(Vec3AddInline, Vec3AddInline(outVec3, vec3s[k], vec3s[j]))
+BENCH(Vec3DotInline, outScalar = Vec3DotInline(vec3s[k], vec3s[j]))
+BENCH(Vec3CrossInline, Vec3CrossInline(outVec3, vec3s[k], vec3s[j]))
+BENCH(Vec3NormalizeInline, Vec3NormalizeInline(outVec3, vec3s[k]))
+BENCH(QuaternionVec3RotationInline, QuaternionVec3RotationInline(outVec3, vec3s[k], quats[j]))
+BENCH(QuaternionNormalizeInline, QuaternionNormalizeInline(outQuat, quats[k]))
+BENCH(QuaternionMultInline, QuaternionMultInline(outQuat, quats[k], quats[j]))
+BENCH(Mat4CopyInline, Mat4CopyInline(outMat, mats[k]))
+BENCH(Mat4Vec4MultInline, Mat4Vec4MultInline(outVec4, mats[k], vec4s[j]))
+BENCH(TransformChain, chainOutOfLine(outVec3, vec3s[k], quats[j], vec3s[j]))
+BENCH(TransformChainInline, chainInline(outVec3, vec3s[k], quats[j], vec3s[j]))
+
+#define ENTRY(benchName) {#benchName, bench_##benchName}
+
+static const struct Benchmark benchmarks[] = {
+    ENTRY(Vec3Identity), ENTRY(Vec3Copy), ENTRY(Vec3Fill), ENTRY(Vec3ToCStr), ENTRY(Vec3Add), ENTRY(Vec3Subtract),
+    ENTRY(Vec3Scalar), ENTRY(Vec3Dot), ENTRY(Vec3Cross), ENTRY(Vec3Divide), ENTRY(Vec3Length), ENTRY(Vec3Normalize),
+
+    ENTRY(QuaternionIdentity), ENTRY(QuaternionCopy), ENTRY(QuaternionToCStr), ENTRY(QuaternionVec3Rotation),
+    ENTRY(QuaternionFromAxisAngle), ENTRY(QuaternionNormalize), ENTRY(QuaternionMult), ENTRY(QuaternionDot),
+    ENTRY(QuaternionNlerp), ENTRY(QuaternionSlerp), ENTRY(QuaternionNormalizeBatch), ENTRY(QuaternionVec3RotationBatch),
+    ENTRY(QuaternionVec3RotationBatchEach),
+
+    ENTRY(Mat4Identity), ENTRY(Mat4Copy), ENTRY(Mat4Fill), ENTRY(Mat4Transpose), ENTRY(Mat4ToCStr),
+    ENTRY(Mat4TranslationF), ENTRY(Mat4TranslationFA), ENTRY(Mat4RotationX), ENTRY(Mat4RotationY), ENTRY(Mat4RotationZ),
+    ENTRY(Mat4RotationAxisF), ENTRY(Mat4RotationAxisFA), ENTRY(Mat4RotationQuaternionF),
+    ENTRY(Mat4RotationQuaternionFA), ENTRY(Mat4ToQuaternion), ENTRY(Mat4ScalingF), ENTRY(Mat4ScalingFA),
+    ENTRY(Mat4Mult), ENTRY(Mat4Inverse),
+    ENTRY(Mat4Vec4Mult), ENTRY(Mat4MultBatch), ENTRY(Mat4LookAtLH), ENTRY(Mat4LookAtRH), ENTRY(Mat4PerspectiveFovLH),
+    ENTRY(Mat4PerspectiveFovRH), ENTRY(Mat4PerspectiveInfiniteReverseZLH), ENTRY(Mat4PerspectiveInfiniteReverseZRH),
+    ENTRY(Mat4OrthographicLH), ENTRY(Mat4OrthographicRH),
+
+    ENTRY(Vec3AddInline), ENTRY(Vec3DotInline), ENTRY(Vec3CrossInline), ENTRY(Vec3NormalizeInline),
+    ENTRY(QuaternionVec3RotationInline), ENTRY(QuaternionNormalizeInline), ENTRY(QuaternionMultInline),
+    ENTRY(Mat4CopyInline), ENTRY(Mat4Vec4MultInline), ENTRY(TransformChain), ENTRY(TransformChainInline),
+};
+
+static double nowNs(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double) time.tv_sec * 1e9 + (double) time.tv_nsec;
+}
+
+static double timeRun(BenchFunction run, long iterations) {
+    double start = nowNs();
+    run(iterations);
+
+    return nowNs() - start;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double difference = *(const double *) a - *(const double *) b;
+
+    return (difference > 0.0) - (difference < 0.0);
+}
+
+static void fillInputs(void) {
+    // A fixed linear congruential sequence keeps inputs identical between runs and builds
+    unsigned int state = 12345u;
+    for (int i = 0; i < INPUT_COUNT; ++i) {
+        float values[MAT_4_SIZE];
+        for (int v = 0; v < MAT_4_SIZE; ++v) {
+            state = state * 1664525u + 1013904223u;
+            values[v] = (float) (state >> 8) / (float) (1u << 24) * 2.0f - 1.0f;
+        }
+
+        Vec3Copy(vec3s[i], values);
+        vec3s[i][0] += 1.5f;
+        Vec4Copy(vec4s[i], values);
+        vec4s[i][3] = 1.0f;
+        QuaternionNormalize(quats[i], &values[4]);
+        Mat4RotationAxisFA(mats[i], vec3s[i], values[8] * 180.0f);
+        mats[i][12] = values[9];
+        mats[i][13] = values[10];
+        mats[i][14] = values[11];
+        scalars[i] = 1.0f + (values[12] + 1.0f) * 45.0f;
+    }
+
+    for (int i = 0; i < BATCH_COUNT * 4; ++i) {
+        batchIn[i] = vec4s[i % INPUT_COUNT][i % 4];
+        batchQuats[i] = quats[(i / 4) % INPUT_COUNT][i % 4];
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *filter = NULL;
+    double minTimeNs = 20e6;
+    int repetitions = 5;
+    int tier = DispatchDetectTier();
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minTimeNs = atof(argv[++i]) * 1e6;
+        } else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            repetitions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--tier") == 0 && i + 1 < argc) {
+            tier = DispatchTierFromName(argv[++i]);
+        } else {
+            fprintf(
+                stderr, "Usage: %s [--filter text] [--min-time ms] [--repetitions n] [--tier scalar|sse|avx2|avx512]\n",
+                argv[0]
+            );
+            return 2;
+        }
+    }
+    if (repetitions < 1) repetitions = 1;
+    if (repetitions > MAX_REPETITIONS) repetitions = MAX_REPETITIONS;
+    if (tier < 0 || !DispatchInit(tier)) {
+        fprintf(stderr, "Unknown tier or one this CPU does not support\n");
+        return 2;
+    }
+
+    // Batch outputs hold 4 floats per item, Mat4MultBatch uses the same floats as BATCH_COUNT / 4 matrices
+    batchIn = malloc(sizeof(float) * BATCH_COUNT * 4);
+    batchQuats = malloc(sizeof(float) * BATCH_COUNT * 4);
+    batchOut = malloc(sizeof(float) * BATCH_COUNT * 4);
+    if (batchIn == NULL || batchQuats == NULL || batchOut == NULL) return 1;
+    fillInputs();
+
+    printf("{\n  \"suite\": \"py3dmath\",\n  \"batch_count\": %d,\n", BATCH_COUNT);
+    printf("  \"tier\": \"%s\",\n", DispatchTierName(tier));
+    printf("  \"repetitions\": %d,\n  \"results\": [", repetitions);
+
+    int printed = 0;
+    for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); ++b) {
+        const struct Benchmark *benchmark = &benchmarks[b];
+        if (filter != NULL && strstr(benchmark->name, filter) == NULL) continue;
+
+        // Warm up, then double the iterations until a run is long enough to time reliably
+        long iterations = 16;
+        timeRun(benchmark->run, iterations);
+        while (timeRun(benchmark->run, iterations) < minTimeNs && iterations < (1L << 40)) iterations *= 2;
+
+        double nsPerOp[MAX_REPETITIONS];
+#ifdef MATHBENCH_COUNT_ALLOCATIONS
+        unsigned long allocationsBefore = allocationCount;
+#endif
+        for (int r = 0; r < repetitions; ++r) {
+            nsPerOp[r] = timeRun(benchmark->run, iterations) / (double) iterations;
+        }
+        qsort(nsPerOp, repetitions, sizeof(double), compareDoubles);
+
+        printf("%s\n    {\"name\": \"%s\", \"iterations\": %ld, ", printed ? "," : "", benchmark->name, iterations);
+        printf("\"ns_per_op\": %.3f, \"min_ns_per_op\": %.3f, ", nsPerOp[repetitions / 2], nsPerOp[0]);
+#ifdef MATHBENCH_COUNT_ALLOCATIONS
+        printf(
+            "\"allocs_per_op\": %.3f}",
+            (double) (allocationCount - allocationsBefore) / ((double) iterations * repetitions)
+        );
+#else
+        printf("\"allocs_per_op\": null}");
+#endif
+        fflush(stdout);
+        printed = 1;
+    }
+
+    printf("\n  ]\n}\n");
+
+    free(batchIn);
+    free(batchQuats);
+    free(batchOut);
+
+    return 0;
+}
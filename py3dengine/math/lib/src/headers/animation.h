@@ -0,0 +1,97 @@
+#ifndef ANIMATION_H_
+#define ANIMATION_H_
+
+#include "vector.h"
+#include "quaternion.h"
+#include "matrix.h"
+
+#define ANIM_CHANNEL_TRANSLATION 0
+#define ANIM_CHANNEL_ROTATION 1
+#define ANIM_CHANNEL_SCALE 2
+#define ANIM_CHANNEL_COUNT 3
+
+// A bone transform packed the same way as Transform.to_floats: translation xyz, rotation xyzw, scale xyz
+#define ANIM_TRANSFORM_SIZE 10
+
+/**
+ * Skeletal animation.
+ *
+ * A pose stores local bone transforms as structure of arrays: packed translations (3 floats per bone), rotations
+ * (4 floats) and scales (3 floats). Bones are ordered so every parent comes before its children, which lets model
+ * space matrices be composed in one forward pass. Matrices are row vector like the rest of the library, a bone's
+ * local matrix is S * R * T and its model matrix is local * parent model.
+ *
+ * A clip is a set of tracks, each animating one channel of one bone. All key times of a clip live in one array and
+ * all key values in another, each track addresses its run of keys by offset. Rotations are interpolated with nlerp.
+ */
+
+struct AnimPose {
+    int boneCount;
+    float *translations;
+    float *rotations;
+    float *scales;
+};
+
+struct AnimSkeleton {
+    int boneCount;
+    int *parents;
+    float *inverseBind;
+    struct AnimPose rest;
+};
+
+struct AnimClip {
+    float duration;
+    int trackCount;
+    int maxBone;
+    int *trackBones;
+    int *trackChannels;
+    int *trackKeyCounts;
+    int *trackKeyOffsets;
+    int *trackValueOffsets;
+    float *times;
+    float *values;
+};
+
+/** Evaluate clipA at timeA, optionally blended towards clipB at timeB by weight, into a skinning palette */
+struct AnimJob {
+    const struct AnimClip *clipA;
+    float timeA;
+    const struct AnimClip *clipB;
+    float timeB;
+    float weight;
+    float *outPalette;
+};
+
+extern int AnimPoseInit(struct AnimPose *pose, int boneCount);
+extern void AnimPoseRelease(struct AnimPose *pose);
+extern void AnimPoseCopy(struct AnimPose *out, const struct AnimPose *pose);
+extern void AnimPoseBlend(struct AnimPose *out, const struct AnimPose *a, const struct AnimPose *b, float weight);
+
+extern int AnimSkeletonInit(
+    struct AnimSkeleton *skeleton,
+    int boneCount,
+    const int *parents,
+    const float *inverseBind,
+    const float *restTransforms
+);
+extern void AnimSkeletonRelease(struct AnimSkeleton *skeleton);
+
+extern int AnimClipInit(
+    struct AnimClip *clip,
+    float duration,
+    int trackCount,
+    const int *trackBones,
+    const int *trackChannels,
+    const int *trackKeyCounts,
+    const float *times,
+    const float *values
+);
+extern void AnimClipRelease(struct AnimClip *clip);
+extern void AnimClipSample(struct AnimPose *out, const struct AnimClip *clip, float time, int loop);
+
+extern void AnimPoseToModel(float *outModel, const struct AnimPose *pose, const struct AnimSkeleton *skeleton);
+extern void AnimSkinningPalette(float *outPalette, const float *model, const struct AnimSkeleton *skeleton);
+
+extern int AnimEvaluate(const struct AnimSkeleton *skeleton, const struct AnimJob *jobs, int jobCount, int loop, int threadCount);
+
+#endif
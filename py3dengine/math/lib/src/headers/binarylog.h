@@ -0,0 +1,44 @@
+#ifndef BINARYLOG_H_
+#define BINARYLOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BINARY_LOG_HEADER_SIZE 16
+#define BINARY_LOG_ALIGNMENT 8
+#define BINARY_LOG_MIN_CAPACITY 64
+
+/**
+ * Flight recorder ring of binary log records.
+ *
+ * A record is a 16 byte header, its size in bytes (header included, a multiple of BINARY_LOG_ALIGNMENT), the id of a
+ * format registered elsewhere and a timestamp, followed by the raw argument bytes. A full ring overwrites its oldest
+ * records, so it always holds the most recent history. A record that doesn't fit before the end of the buffer starts
+ * again at offset 0 and the space it skipped is not used until the ring wraps around again.
+ *
+ * Writing is a memcpy and never allocates, but a ring has a single writer: give every thread its own ring or
+ * serialize writes. BinaryLogSnapshot copies the records oldest first into one linear stream of records.
+ */
+
+struct BinaryLog {
+    unsigned char *data;
+    size_t capacity;
+    size_t head;
+    size_t tail;
+    // Records end here instead of at capacity while the ring is wrapped
+    size_t wrapEnd;
+    int wrapped;
+    uint64_t recordCount;
+    uint64_t overwrittenCount;
+};
+
+extern int BinaryLogInit(struct BinaryLog *log, size_t capacity);
+extern void BinaryLogRelease(struct BinaryLog *log);
+extern void BinaryLogReset(struct BinaryLog *log);
+extern int BinaryLogWrite(
+    struct BinaryLog *log, uint32_t formatId, uint64_t timestamp, const void *payload, size_t payloadSize
+);
+extern size_t BinaryLogSize(const struct BinaryLog *log);
+extern size_t BinaryLogSnapshot(const struct BinaryLog *log, unsigned char *out, size_t outCapacity);
+
+#endif
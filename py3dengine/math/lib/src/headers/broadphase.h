@@ -0,0 +1,93 @@
+#ifndef BROADPHASE_H_
+#define BROADPHASE_H_
+
+#include "bvh.h"
+
+#define SAP_NULL_PROXY (-1)
+#define SAP_MAX_COORD 1e30f
+
+#define SAP_PAIR_OVERLAPPING 1
+#define SAP_PAIR_WAS_OVERLAPPING 2
+#define SAP_PAIR_TOUCHED 4
+
+/**
+ * Incremental sweep and prune broadphase.
+ *
+ * Every axis keeps an array of AABB endpoints that stays sorted across updates. Between updates objects move a
+ * little, so re-sorting with an insertion sort is close to linear, and every swap of a min endpoint past a max
+ * endpoint (or the reverse) is exactly the moment two intervals start or stop overlapping on that axis. Those swaps
+ * add and remove pairs in a persistent pair cache, so the cost of an update follows the number of endpoints that
+ * moved past each other rather than the number of objects.
+ *
+ * SapSetProxyAabb, SapAddProxy and SapRemoveProxy only record changes, SapUpdate applies them and fills
+ * beginEvents and endEvents with the pairs that started and stopped overlapping since the previous update. A pair
+ * that starts and stops within one update produces no event. Removed proxies report end events for all of their
+ * pairs and their ids are only reused after that update.
+ *
+ * Pairs store a < b and live in a dense array (with an open addressing hash index), so iterating pairs is cheap
+ * and happens in the same order for the same sequence of calls.
+ */
+
+struct SapEndpoint {
+    float value;
+    // proxy << 1 | 1 for max endpoints
+    int data;
+};
+
+struct SapProxy {
+    float aabb[AABB_SIZE];
+    int userData;
+    int state;
+    int nextFree;
+};
+
+struct SapPair {
+    int a;
+    int b;
+    int flags;
+};
+
+struct SweepAndPrune {
+    struct SapProxy *proxies;
+    int proxyCount;
+    int proxyCapacity;
+    int freeList;
+    int activeCount;
+
+    struct SapEndpoint *endpoints[3];
+    int endpointCount;
+    int endpointCapacity;
+    // Endpoints from sortedCount on belong to proxies added since the last update
+    int sortedCount;
+    int pendingRemovals;
+
+    struct SapPair *pairs;
+    int pairCount;
+    int pairCapacity;
+    int *table;
+    int tableCapacity;
+
+    int *touched;
+    int touchedCount;
+    int touchedCapacity;
+
+    int *beginEvents;
+    int beginCount;
+    int beginCapacity;
+    int *endEvents;
+    int endCount;
+    int endCapacity;
+};
+
+extern void SapInit(struct SweepAndPrune *sap);
+extern void SapRelease(struct SweepAndPrune *sap);
+
+extern int SapAddProxy(struct SweepAndPrune *sap, const float aabb[AABB_SIZE], int userData);
+extern void SapRemoveProxy(struct SweepAndPrune *sap, int proxy);
+extern void SapSetProxyAabb(struct SweepAndPrune *sap, int proxy, const float aabb[AABB_SIZE]);
+extern int SapIsValidProxy(const struct SweepAndPrune *sap, int proxy);
+extern int SapGetUserData(const struct SweepAndPrune *sap, int proxy);
+
+extern int SapUpdate(struct SweepAndPrune *sap);
+
+#endif
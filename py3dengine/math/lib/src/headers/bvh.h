@@ -0,0 +1,67 @@
+#ifndef BVH_H_
+#define BVH_H_
+
+#include "vector.h"
+#include "matrix.h"
+
+#define AABB_SIZE 6
+#define BVH_NULL_NODE (-1)
+
+/**
+ * Dynamic bounding volume hierarchy (AABB tree).
+ *
+ * AABBs are stored as 6 floats: min x, y, z followed by max x, y, z.
+ * Leaves are addressed through proxy ids which stay valid until BvhRemove, including across BvhRebuild.
+ * Leaves store a "fat" AABB grown by the tree's margin so small movements do not need a tree update,
+ * queries test leaves against their exact AABB.
+ */
+
+struct BvhNode {
+    float aabb[AABB_SIZE];
+    float tight[AABB_SIZE];
+    int parent;
+    int left;
+    int right;
+    int height;
+    int userData;
+};
+
+struct Bvh {
+    struct BvhNode *nodes;
+    int capacity;
+    int count;
+    int root;
+    int freeList;
+    int leafCount;
+    float margin;
+};
+
+extern void AabbCopy(float out[AABB_SIZE], const float a[AABB_SIZE]);
+extern void AabbUnion(float out[AABB_SIZE], const float a1[AABB_SIZE], const float a2[AABB_SIZE]);
+extern void AabbTransform(float out[AABB_SIZE], const float a[AABB_SIZE], const float m[MAT_4_SIZE]);
+extern float AabbSurfaceArea(const float a[AABB_SIZE]);
+extern int AabbContains(const float outer[AABB_SIZE], const float inner[AABB_SIZE]);
+extern int AabbOverlaps(const float a1[AABB_SIZE], const float a2[AABB_SIZE]);
+extern float AabbDistanceSquared(const float a[AABB_SIZE], const float p[VEC_3_SIZE]);
+extern int AabbRayIntersect(float *outT, const float a[AABB_SIZE], const float origin[VEC_3_SIZE], const float invDir[VEC_3_SIZE], float maxT);
+
+extern int BvhInit(struct Bvh *bvh, float margin);
+extern void BvhRelease(struct Bvh *bvh);
+
+extern int BvhInsert(struct Bvh *bvh, const float aabb[AABB_SIZE], int userData);
+extern void BvhRemove(struct Bvh *bvh, int proxy);
+extern int BvhUpdate(struct Bvh *bvh, int proxy, const float aabb[AABB_SIZE]);
+extern void BvhSetLeafAabb(struct Bvh *bvh, int proxy, const float aabb[AABB_SIZE]);
+extern void BvhRefit(struct Bvh *bvh);
+extern int BvhRebuild(struct Bvh *bvh);
+
+extern int BvhGetUserData(const struct Bvh *bvh, int proxy);
+extern int BvhGetHeight(const struct Bvh *bvh);
+extern int BvhIsValidProxy(const struct Bvh *bvh, int proxy);
+
+extern int BvhRayCast(const struct Bvh *bvh, const float origin[VEC_3_SIZE], const float dir[VEC_3_SIZE], float maxT, int *outProxy, float *outT);
+extern int BvhQueryAabb(const struct Bvh *bvh, const float aabb[AABB_SIZE], int *outProxies, int capacity);
+extern int BvhQuerySphere(const struct Bvh *bvh, const float center[VEC_3_SIZE], float radius, int *outProxies, int capacity);
+extern int BvhQueryNearest(const struct Bvh *bvh, const float p[VEC_3_SIZE], int k, int *outProxies, float *outDistSq);
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef DISPATCH_H_
+#define DISPATCH_H_
+
+/**
+ * Runtime selection of the SIMD kernels of the hot math functions.
+ *
+ * Every kernel is compiled for each tier with target attributes, so a library built for the baseline instruction set
+ * still carries the AVX2 and AVX-512 variants. DispatchInit detects what the CPU supports once and each module binds
+ * its function pointers to the matching variants. Until DispatchInit runs the scalar variants are bound, so the
+ * library stays usable without it.
+ *
+ * Changing the tier is not synchronized with kernels running on other threads, it belongs at startup.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DISPATCH_X86 1
+#define DISPATCH_TARGET(features) __attribute__((target(features)))
+#else
+#define DISPATCH_X86 0
+#define DISPATCH_TARGET(features)
+#endif
+
+enum DispatchTier {
+    DISPATCH_TIER_SCALAR = 0,
+    DISPATCH_TIER_SSE,
+    // AVX2 together with FMA, which every AVX2 CPU has
+    DISPATCH_TIER_AVX2,
+    DISPATCH_TIER_AVX512,
+    DISPATCH_TIER_COUNT
+};
+
+extern enum DispatchTier DispatchDetectTier(void);
+extern int DispatchTierSupported(enum DispatchTier tier);
+extern const char *DispatchTierName(enum DispatchTier tier);
+// Returns -1 for names that are not a tier
+extern int DispatchTierFromName(const char *name);
+
+// Returns 0 without changing anything when the CPU does not support the tier
+extern int DispatchInit(enum DispatchTier tier);
+extern enum DispatchTier DispatchCurrentTier(void);
+
+// Called by DispatchInit, each module binds its own kernels
+extern void MatrixBindTier(enum DispatchTier tier);
+extern void QuaternionBindTier(enum DispatchTier tier);
+extern void FrustumBindTier(enum DispatchTier tier);
+extern void SkinningBindTier(enum DispatchTier tier);
+extern void RasterBindTier(enum DispatchTier tier);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef FRUSTUM_H_
+#define FRUSTUM_H_
+
+#include "vector.h"
+#include "matrix.h"
+
+#define FRUSTUM_PLANE_COUNT 6
+#define FRUSTUM_SIZE (FRUSTUM_PLANE_COUNT * VEC_4_SIZE)
+
+#define FRUSTUM_LEFT 0
+#define FRUSTUM_RIGHT 1
+#define FRUSTUM_BOTTOM 2
+#define FRUSTUM_TOP 3
+#define FRUSTUM_NEAR 4
+#define FRUSTUM_FAR 5
+
+/**
+ * View frustum culling.
+ *
+ * A frustum is 6 planes of 4 floats (a, b, c, d) with normals pointing inwards, a point p is inside a plane when
+ * a * p.x + b * p.y + c * p.z + d >= 0. Planes are extracted from a row vector view projection matrix with
+ * a clip space depth range of 0 to w. A plane that degenerates (eg. the far plane of an infinite projection)
+ * is replaced by one that accepts everything.
+ *
+ * The cull functions take bounding volumes as structure of arrays, write the indices of every volume that is
+ * at least partially inside to outIndices (which must hold count entries) in ascending order and return
+ * how many were written. They process 8 (AVX2) or 4 (SSE) volumes at a time, picked at runtime by DispatchInit,
+ * and fall back to scalar code for the rest.
+ */
+
+extern void FrustumFromMatrix(float out[FRUSTUM_SIZE], const float viewProj[MAT_4_SIZE]);
+
+extern int FrustumTestPoint(const float frustum[FRUSTUM_SIZE], const float p[VEC_3_SIZE]);
+extern int FrustumTestSphere(const float frustum[FRUSTUM_SIZE], const float center[VEC_3_SIZE], float radius);
+extern int FrustumTestAabb(const float frustum[FRUSTUM_SIZE], const float min[VEC_3_SIZE], const float max[VEC_3_SIZE]);
+
+extern int FrustumCullSpheres(
+    int *outIndices,
+    const float frustum[FRUSTUM_SIZE],
+    const float *x, const float *y, const float *z, const float *radius,
+    int count
+);
+extern int FrustumCullAabbs(
+    int *outIndices,
+    const float frustum[FRUSTUM_SIZE],
+    const float *minX, const float *minY, const float *minZ,
+    const float *maxX, const float *maxY, const float *maxZ,
+    int count
+);
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef MATHINLINE_H_
+#define MATHINLINE_H_
+
+#include <assert.h>
+#include <math.h>
+
+#include "vector.h"
+#include "quaternion.h"
+#include "matrix.h"
+
+/**
+ * Header only variants of the small vector, quaternion and matrix functions for hot loops.
+ *
+ * The out of line functions check every pointer for NULL and allow out to alias an input, so the compiler can neither
+ * inline them across translation units nor keep values in registers across a store. These variants do neither: they
+ * are static inline, out must not overlap any input, and the checks are asserts that only debug builds (without
+ * NDEBUG) compile in. Results match the out of line functions.
+ *
+ * Values returned through an out pointer by the out of line functions are returned directly, e.g. Vec3DotInline.
+ */
+
+#ifndef NDEBUG
+static inline int mathInlineDisjoint(const float *a, int aSize, const float *b, int bSize) {
+    return a + aSize <= b || b + bSize <= a;
+}
+#endif
+
+#define MATH_INLINE_CHECK_IN(in) assert((in) != NULL)
+#define MATH_INLINE_CHECK_OUT(out, outSize, in, inSize) \
+    assert((out) != NULL && (in) != NULL && mathInlineDisjoint((out), (outSize), (in), (inSize)))
+
+/** Vector 3 */
+static inline void Vec3CopyInline(float *restrict out, const float *restrict v) {
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v, VEC_3_SIZE);
+
+    out[0] = v[0];
+    out[1] = v[1];
+    out[2] = v[2];
+}
+
+static inline void Vec3AddInline(float *restrict out, const float *restrict v1, const float *restrict v2) {
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v1, VEC_3_SIZE);
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v2, VEC_3_SIZE);
+
+    out[0] = v1[0] + v2[0];
+    out[1] = v1[1] + v2[1];
+    out[2] = v1[2] + v2[2];
+}
+
+static inline void Vec3SubtractInline(float *restrict out, const float *restrict v1, const float *restrict v2) {
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v1, VEC_3_SIZE);
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v2, VEC_3_SIZE);
+
+    out[0] = v1[0] - v2[0];
+    out[1] = v1[1] - v2[1];
+    out[2] = v1[2] - v2[2];
+}
+
+static inline void Vec3ScalarInline(float *restrict out, const float *restrict v, float scalar) {
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v, VEC_3_SIZE);
+
+    out[0] = v[0] * scalar;
+    out[1] = v[1] * scalar;
+    out[2] = v[2] * scalar;
+}
+
+static inline void Vec3DivideInline(float *restrict out, const float *restrict v, float scalar) {
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v, VEC_3_SIZE);
+
+    out[0] = v[0] / scalar;
+    out[1] = v[1] / scalar;
+    out[2] = v[2] / scalar;
+}
+
+static inline float Vec3DotInline(const float *restrict v1, const float *restrict v2) {
+    MATH_INLINE_CHECK_IN(v1);
+    MATH_INLINE_CHECK_IN(v2);
+
+    return (v1[0] * v2[0]) + (v1[1] * v2[1]) + (v1[2] * v2[2]);
+}
+
+static inline void Vec3CrossInline(float *restrict out, const float *restrict v1, const float *restrict v2) {
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v1, VEC_3_SIZE);
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v2, VEC_3_SIZE);
+
+    out[0] = (v1[1] * v2[2]) - (v1[2] * v2[1]);
+    out[1] = (v1[2] * v2[0]) - (v1[0] * v2[2]);
+    out[2] = (v1[0] * v2[1]) - (v1[1] * v2[0]);
+}
+
+static inline float Vec3LengthInline(const float *restrict v) {
+    MATH_INLINE_CHECK_IN(v);
+
+    return sqrtf((v[0] * v[0]) + (v[1] * v[1]) + (v[2] * v[2]));
+}
+
+// Like Vec3Normalize a zero length vector leaves out unchanged
+static inline void Vec3NormalizeInline(float *restrict out, const float *restrict v) {
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v, VEC_3_SIZE);
+
+    float len = Vec3LengthInline(v);
+    if (len == 0.0f) return;
+
+    Vec3DivideInline(out, v, len);
+}
+
+/** Quaternion */
+static inline void QuaternionCopyInline(float *restrict out, const float *restrict q) {
+    MATH_INLINE_CHECK_OUT(out, QUATERNION_SIZE, q, QUATERNION_SIZE);
+
+    out[0] = q[0];
+    out[1] = q[1];
+    out[2] = q[2];
+    out[3] = q[3];
+}
+
+static inline void QuaternionMultInline(float *restrict out, const float *restrict q1, const float *restrict q2) {
+    MATH_INLINE_CHECK_OUT(out, QUATERNION_SIZE, q1, QUATERNION_SIZE);
+    MATH_INLINE_CHECK_OUT(out, QUATERNION_SIZE, q2, QUATERNION_SIZE);
+
+    out[0] = (q1[3] * q2[0]) + (q1[0] * q2[3]) + (q1[1] * q2[2]) - (q1[2] * q2[1]);
+    out[1] = (q1[3] * q2[1]) - (q1[0] * q2[2]) + (q1[1] * q2[3]) + (q1[2] * q2[0]);
+    out[2] = (q1[3] * q2[2]) + (q1[0] * q2[1]) - (q1[1] * q2[0]) + (q1[2] * q2[3]);
+    out[3] = (q1[3] * q2[3]) - (q1[0] * q2[0]) - (q1[1] * q2[1]) - (q1[2] * q2[2]);
+}
+
+// Like QuaternionNormalize a zero length quaternion gives the identity
+static inline void QuaternionNormalizeInline(float *restrict out, const float *restrict q) {
+    MATH_INLINE_CHECK_OUT(out, QUATERNION_SIZE, q, QUATERNION_SIZE);
+
+    float len = sqrtf((q[0] * q[0]) + (q[1] * q[1]) + (q[2] * q[2]) + (q[3] * q[3]));
+    if (len == 0.0f) {
+        out[0] = out[1] = out[2] = 0.0f;
+        out[3] = 1.0f;
+        return;
+    }
+
+    out[0] = q[0] / len;
+    out[1] = q[1] / len;
+    out[2] = q[2] / len;
+    out[3] = q[3] / len;
+}
+
+// 2 (q.v) q + (w^2 - q.q) v + 2 w (q x v), the expansion QuaternionVec3Rotation uses
+static inline void QuaternionVec3RotationInline(float *restrict out, const float *restrict v, const float *restrict q) {
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, v, VEC_3_SIZE);
+    MATH_INLINE_CHECK_OUT(out, VEC_3_SIZE, q, QUATERNION_SIZE);
+
+    float x = v[0], y = v[1], z = v[2];
+    float twoQDotV = 2.0f * (q[0] * x + q[1] * y + q[2] * z);
+    float wwMinusQDotQ = q[3] * q[3] - (q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+    float twoW = 2.0f * q[3];
+
+    out[0] = twoQDotV * q[0] + wwMinusQDotQ * x + twoW * (q[1] * z - q[2] * y);
+    out[1] = twoQDotV * q[1] + wwMinusQDotQ * y + twoW * (q[2] * x - q[0] * z);
+    out[2] = twoQDotV * q[2] + wwMinusQDotQ * z + twoW * (q[0] * y - q[1] * x);
+}
+
+/** Matrix 4x4 */
+static inline void Mat4CopyInline(float *restrict out, const float *restrict m) {
+    MATH_INLINE_CHECK_OUT(out, MAT_4_SIZE, m, MAT_4_SIZE);
+
+    for (int i = 0; i < MAT_4_SIZE; ++i) {
+        out[i] = m[i];
+    }
+}
+
+static inline void Mat4IdentityInline(float *restrict out) {
+    MATH_INLINE_CHECK_IN(out);
+
+    for (int i = 0; i < MAT_4_SIZE; ++i) {
+        out[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+}
+
+// Row vector v times m, like Mat4Vec4Mult
+static inline void Mat4Vec4MultInline(float *restrict out, const float *restrict m, const float *restrict v) {
+    MATH_INLINE_CHECK_OUT(out, VEC_4_SIZE, m, MAT_4_SIZE);
+    MATH_INLINE_CHECK_OUT(out, VEC_4_SIZE, v, VEC_4_SIZE);
+
+    out[0] = (m[0] * v[0]) + (m[4] * v[1]) + (m[8] * v[2]) + (m[12] * v[3]);
+    out[1] = (m[1] * v[0]) + (m[5] * v[1]) + (m[9] * v[2]) + (m[13] * v[3]);
+    out[2] = (m[2] * v[0]) + (m[6] * v[1]) + (m[10] * v[2]) + (m[14] * v[3]);
+    out[3] = (m[3] * v[0]) + (m[7] * v[1]) + (m[11] * v[2]) + (m[15] * v[3]);
+}
+
+#endif
@@ -24,6 +24,7 @@ extern void Mat4RotationAxisF(float out[MAT_4_SIZE], float x, float y, float z,
 extern void Mat4RotationAxisFA(float out[MAT_4_SIZE], const float v[VEC_3_SIZE], float theta);
 extern void Mat4RotationQuaternionF(float out[MAT_4_SIZE], float x, float y, float z, float w);
 extern void Mat4RotationQuaternionFA(float out[MAT_4_SIZE], const float q[QUATERNION_SIZE]);
+extern void Mat4ToQuaternion(float out[QUATERNION_SIZE], const float m[MAT_4_SIZE]);
 extern void Mat4ScalingF(float out[MAT_4_SIZE], float x, float y, float z);
 extern void Mat4ScalingFA(float out[MAT_4_SIZE], const float v[VEC_3_SIZE]);
 
@@ -31,6 +32,20 @@ extern void Mat4Mult(float out[MAT_4_SIZE], const float m1[MAT_4_SIZE], const fl
 extern int Mat4Inverse(float out[MAT_4_SIZE], const float m[MAT_4_SIZE]);
 extern void Mat4Vec4Mult(float out[VEC_4_SIZE], const float m[MAT_4_SIZE], const float v[VEC_4_SIZE]);
 
+extern void Mat4MultBatch(float *out, const float *worlds, const float viewProj[MAT_4_SIZE], int count);
+
 extern void Mat4LookAtLH(float out[MAT_4_SIZE], const float camPosW[VEC_3_SIZE], const float camTargetW[VEC_3_SIZE], const float camUpW[VEC_3_SIZE]);
+extern void Mat4LookAtRH(float out[MAT_4_SIZE], const float camPosW[VEC_3_SIZE], const float camTargetW[VEC_3_SIZE], const float camUpW[VEC_3_SIZE]);
+
+/**
+ * Projections map view space to a clip space depth range of 0 to w, the field of view is vertical and in degrees.
+ * The reverse z variants put the near plane at depth 1 and the far plane at infinity at depth 0.
+ */
+extern void Mat4PerspectiveFovLH(float out[MAT_4_SIZE], float fovY, float aspect, float nearZ, float farZ);
+extern void Mat4PerspectiveFovRH(float out[MAT_4_SIZE], float fovY, float aspect, float nearZ, float farZ);
+extern void Mat4PerspectiveInfiniteReverseZLH(float out[MAT_4_SIZE], float fovY, float aspect, float nearZ);
+extern void Mat4PerspectiveInfiniteReverseZRH(float out[MAT_4_SIZE], float fovY, float aspect, float nearZ);
+extern void Mat4OrthographicLH(float out[MAT_4_SIZE], float width, float height, float nearZ, float farZ);
+extern void Mat4OrthographicRH(float out[MAT_4_SIZE], float width, float height, float nearZ, float farZ);
 
 #endif
@@ -0,0 +1,18 @@
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+/**
+ * Minimal fork/join helper for the batch kernels.
+ *
+ * ParallelFor splits [0, count) into contiguous ranges of at least minRange items, runs fn on each range from up to
+ * threadCount threads (the calling thread takes the first range) and returns once every range is done.
+ * A threadCount of 0 or less uses every online CPU. Returns 1 on success, 0 if a thread could not be started,
+ * in which case its range is run on the calling thread instead.
+ */
+
+typedef void (*ParallelRangeFn)(void *context, int begin, int end);
+
+extern int ParallelHardwareThreads(void);
+extern int ParallelFor(int count, int minRange, int threadCount, ParallelRangeFn fn, void *context);
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef PHYSICS_H_
+#define PHYSICS_H_
+
+#include "vector.h"
+#include "quaternion.h"
+#include "bvh.h"
+#include "broadphase.h"
+
+#define PHYSICS_SHAPE_SPHERE 0
+#define PHYSICS_SHAPE_BOX 1
+#define PHYSICS_SHAPE_CAPSULE 2
+
+#define PHYSICS_DEFAULT_ITERATIONS 10
+
+/**
+ * Rigid body physics.
+ *
+ * Shapes are sized by 3 floats: a sphere uses size[0] as its radius, a box uses size as its half extents and a capsule
+ * uses size[0] as its radius and size[1] as the half height of its segment, which runs along the body's local y axis.
+ * Bodies with a mass of 0 are static. Body ids are slots in the bodies array and are reused after PhysicsRemoveBody.
+ *
+ * PhysicsStep integrates velocities (semi-implicit Euler), updates the AABB pairs of the incremental sweep and prune
+ * broadphase, generates contacts for every shape pair and resolves them with sequential impulses, warm started from
+ * the previous step, before integrating positions. Everything runs in a fixed order on the calling thread so the same
+ * world stepped with the same time steps always ends up in the same state.
+ */
+
+struct PhysicsBody {
+    float position[VEC_3_SIZE];
+    float orientation[QUATERNION_SIZE];
+    float linearVelocity[VEC_3_SIZE];
+    float angularVelocity[VEC_3_SIZE];
+    float invMass;
+    float invInertiaLocal[VEC_3_SIZE];
+
+    // Derived from orientation at the start of every step: row major rotation and world space inverse inertia
+    float rotation[9];
+    float invInertiaWorld[9];
+
+    float size[VEC_3_SIZE];
+    float restitution;
+    float friction;
+    float aabb[AABB_SIZE];
+    int shape;
+    int active;
+    int proxy;
+};
+
+struct PhysicsContact {
+    int a;
+    int b;
+    int feature;
+    float normal[VEC_3_SIZE];
+    float point[VEC_3_SIZE];
+    float depth;
+
+    float rA[VEC_3_SIZE];
+    float rB[VEC_3_SIZE];
+    float tangents[2][VEC_3_SIZE];
+    float normalMass;
+    float tangentMass[2];
+    float bias;
+    float friction;
+    float normalImpulse;
+    float tangentImpulse[2];
+};
+
+struct PhysicsWorld {
+    struct PhysicsBody *bodies;
+    int bodyCount;
+    int capacity;
+    int activeCount;
+    int *freeSlots;
+    int freeCount;
+
+    float gravity[VEC_3_SIZE];
+    int iterations;
+
+    struct SweepAndPrune broadphase;
+
+    struct PhysicsContact *contacts;
+    int contactCount;
+    int contactCapacity;
+
+    // Last step's contacts sorted by (a, b, feature), their impulses warm start the matching new contacts
+    struct PhysicsContact *previousContacts;
+    int previousCount;
+    int previousCapacity;
+};
+
+extern int PhysicsWorldInit(struct PhysicsWorld *world, const float gravity[VEC_3_SIZE]);
+extern void PhysicsWorldRelease(struct PhysicsWorld *world);
+
+extern int PhysicsAddBody(
+    struct PhysicsWorld *world,
+    int shape,
+    const float size[VEC_3_SIZE],
+    float mass,
+    const float position[VEC_3_SIZE],
+    const float orientation[QUATERNION_SIZE]
+);
+extern void PhysicsRemoveBody(struct PhysicsWorld *world, int body);
+extern int PhysicsIsValidBody(const struct PhysicsWorld *world, int body);
+extern void PhysicsSetBodyPose(struct PhysicsWorld *world, int body, const float position[VEC_3_SIZE], const float orientation[QUATERNION_SIZE]);
+extern void PhysicsApplyImpulse(struct PhysicsWorld *world, int body, const float impulse[VEC_3_SIZE], const float point[VEC_3_SIZE]);
+
+extern int PhysicsStep(struct PhysicsWorld *world, float dt);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define PROFILER_RING_SIZE 65536
+#define PROFILER_ZONE_BEGIN 0
+#define PROFILER_ZONE_END 1
+
+/**
+ * Low overhead frame profiler with hierarchical zones.
+ *
+ * A zone is a begin and an end event on one thread, zones nest by time. Every thread records into its own ring of
+ * PROFILER_RING_SIZE events that only it writes and only ProfilerCollect reads, so recording takes no lock. A full
+ * ring drops new events and counts them instead of blocking the thread. Rings are created on the first event a thread
+ * records and are kept for the life of the process, so zones belong on long lived threads and not in ParallelFor ranges.
+ *
+ * While the profiler is disabled a zone costs one relaxed atomic load. Zone names are stored as pointers and must
+ * outlive collection, string literals are the intended use. Defining PY3DMATH_NO_PROFILER compiles every zone out.
+ *
+ * Timestamps are CLOCK_MONOTONIC nanoseconds, the clock of Python's time.perf_counter_ns on Linux.
+ */
+
+struct ProfilerEvent {
+    uint64_t timestamp;
+    const char *name;
+    // Order of the thread's first event, starting at 0
+    uint32_t thread;
+    uint32_t type;
+};
+
+extern atomic_int profilerEnabled;
+
+extern void ProfilerSetEnabled(int enabled);
+extern uint64_t ProfilerNow(void);
+extern void ProfilerRecord(const char *name, int type);
+extern int ProfilerSetThreadName(const char *name);
+extern const char *ProfilerThreadName(uint32_t thread);
+extern int ProfilerCollect(struct ProfilerEvent *out, int capacity);
+extern uint64_t ProfilerDroppedEvents(void);
+
+#ifdef PY3DMATH_NO_PROFILER
+#define PROFILE_ZONE_BEGIN(name) ((void) 0)
+#define PROFILE_ZONE_END(name) ((void) 0)
+#else
+#define PROFILE_ZONE_BEGIN(name) \
+    do { \
+        if (atomic_load_explicit(&profilerEnabled, memory_order_relaxed)) ProfilerRecord(name, PROFILER_ZONE_BEGIN); \
+    } while (0)
+#define PROFILE_ZONE_END(name) \
+    do { \
+        if (atomic_load_explicit(&profilerEnabled, memory_order_relaxed)) ProfilerRecord(name, PROFILER_ZONE_END); \
+    } while (0)
+#endif
+
+#endif
@@ -11,5 +11,17 @@ extern void QuaternionVec3Rotation (float out[VEC_3_SIZE], const float v[VEC_3_S
 extern void QuaternionFromAxisAngle (float out[QUATERNION_SIZE], float x, float y, float z, float a);
 extern void QuaternionNormalize(float out[QUATERNION_SIZE], const float q[QUATERNION_SIZE]);
 extern void QuaternionMult(float out[QUATERNION_SIZE], const float q1[QUATERNION_SIZE], const float q2[QUATERNION_SIZE]);
+extern void QuaternionDot(float *out, const float q1[QUATERNION_SIZE], const float q2[QUATERNION_SIZE]);
+extern void QuaternionNlerp(float out[QUATERNION_SIZE], const float q1[QUATERNION_SIZE], const float q2[QUATERNION_SIZE], float t);
+extern void QuaternionSlerp(float out[QUATERNION_SIZE], const float q1[QUATERNION_SIZE], const float q2[QUATERNION_SIZE], float t);
+
+/**
+ * Batch operations over packed arrays, quaternions are 4 floats (x, y, z, w) and vectors 3 floats (x, y, z) each.
+ * out may alias the input array. DispatchInit picks their kernels at runtime: 8 elements at a time with AVX2 (also
+ * used for AVX-512), 4 with SSE or scalar code, which is bound until DispatchInit runs.
+ */
+extern void QuaternionNormalizeBatch(float *out, const float *q, int count);
+extern void QuaternionVec3RotationBatch(float *out, const float *v, const float q[QUATERNION_SIZE], int count);
+extern void QuaternionVec3RotationBatchEach(float *out, const float *v, const float *q, int count);
 
 #endif
@@ -0,0 +1,80 @@
+#ifndef RASTER_H_
+#define RASTER_H_
+
+#include "vector.h"
+#include "matrix.h"
+
+#define RASTER_TILE_SIZE 64
+#define RASTER_MAX_SIZE 8192
+#define RASTER_SUBPIXEL_BITS 4
+#define RASTER_COLOR_CHANNELS 4
+
+/**
+ * Tile based software rasterizer for headless rendering.
+ *
+ * A target holds an RGBA8 color buffer (rows top to bottom) and a float depth buffer. RasterDrawIndexed transforms
+ * packed positions (3 floats per vertex) by an MVP matrix built with the Mat4 functions (row vectors, depth in [0, 1]),
+ * clips triangles in homogeneous space against the depth range and a guard band, snaps them to a 1/16 pixel grid and
+ * bins them into RASTER_TILE_SIZE square tiles. Tiles are then rasterized on up to threadCount threads: coverage
+ * uses exact integer edge functions with a top-left fill rule, so neighbouring triangles never share or miss a pixel,
+ * and depth and normals are interpolated perspective correctly.
+ *
+ * Pixels are shaded with a single directional light (Lambert plus ambient) from interpolated vertex normals, or the
+ * face normal when normals is NULL. Normals and lightDir are in the same space as positions. Front faces are counter
+ * clockwise on screen; back faces are culled, or lit from behind when cullBackFaces is 0. With reverseZ depth tests
+ * keep the greater depth instead of the lesser.
+ *
+ * Every tile draws its triangles in submission order, so the image is the same whatever the thread count.
+ */
+
+struct RasterShading {
+    float color[VEC_3_SIZE];
+    float lightDir[VEC_3_SIZE];
+    float ambient;
+    int cullBackFaces;
+    int reverseZ;
+};
+
+struct RasterTriangle;
+
+struct RasterBin {
+    int *items;
+    int count;
+    int capacity;
+};
+
+struct RasterTarget {
+    int width;
+    int height;
+    int tilesX;
+    int tilesY;
+    int threadCount;
+    unsigned char *color;
+    float *depth;
+
+    // Scratch buffers reused between draws
+    float *clip;
+    int clipCapacity;
+    unsigned char *status;
+    int statusCapacity;
+    struct RasterTriangle *triangles;
+    int triangleCapacity;
+    struct RasterBin *bins;
+};
+
+extern int RasterInit(struct RasterTarget *target, int width, int height, int threadCount);
+extern void RasterRelease(struct RasterTarget *target);
+
+extern void RasterClear(struct RasterTarget *target, const float color[4], float depth);
+extern int RasterDrawIndexed(
+    struct RasterTarget *target,
+    const float mvp[MAT_4_SIZE],
+    const float *positions,
+    const float *normals,
+    int vertexCount,
+    const unsigned int *indices,
+    int indexCount,
+    const struct RasterShading *shading
+);
+
+#endif
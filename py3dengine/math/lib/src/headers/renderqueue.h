@@ -0,0 +1,73 @@
+#ifndef RENDERQUEUE_H_
+#define RENDERQUEUE_H_
+
+#include <stdint.h>
+
+#include "matrix.h"
+
+#define RENDER_MAX_LAYER 255
+#define RENDER_MAX_STATE 65535
+
+/**
+ * Backend agnostic render command queue.
+ *
+ * Every visible object submits one command: a 64 bit sort key and its world matrix. RenderQueueBuild radix sorts the
+ * keys and merges runs of commands with the same layer, material and mesh into batches whose world matrices are
+ * gathered contiguously, so a backend binds each state once and draws a batch as one instanced call.
+ *
+ * Key layout, most significant bits first:
+ *   layer (8) | translucent (1) | material (16) | mesh (16) | depth (23)     opaque, front to back within a state
+ *   layer (8) | translucent (1) | inverted depth (23) | material (16) | mesh (16)     translucent, back to front
+ *
+ * Layers draw in ascending order and opaque commands draw before the translucent ones of their layer. Opaque
+ * commands group by state first, translucent ones keep their depth order and only merge when neighbours share a state.
+ * Depth is any non negative view distance, it is quantized to the top 23 bits of its float representation, which
+ * orders the same as the floats themselves.
+ *
+ * The radix sort is stable, so commands with equal keys keep their submission order.
+ */
+
+struct RenderCommand {
+    uint64_t key;
+    // Index of the command's world matrix in the submission order
+    uint32_t instance;
+};
+
+struct RenderBatch {
+    uint64_t key;
+    int layer;
+    int translucent;
+    int material;
+    int mesh;
+    int firstInstance;
+    int instanceCount;
+};
+
+struct RenderQueue {
+    struct RenderCommand *commands;
+    struct RenderCommand *scratch;
+    int commandCount;
+    int commandCapacity;
+
+    // World matrices in submission order, and gathered in sorted order by RenderQueueBuild
+    float *worlds;
+    float *instances;
+
+    struct RenderBatch *batches;
+    int batchCount;
+    int batchCapacity;
+};
+
+extern uint64_t RenderKeyMake(int layer, int translucent, int material, int mesh, float depth);
+extern void RenderKeyDecode(uint64_t key, int *layer, int *translucent, int *material, int *mesh);
+
+extern void RenderSortCommands(struct RenderCommand *commands, struct RenderCommand *scratch, int count);
+
+extern void RenderQueueInit(struct RenderQueue *queue);
+extern void RenderQueueRelease(struct RenderQueue *queue);
+extern void RenderQueueReset(struct RenderQueue *queue);
+
+extern int RenderQueueSubmit(struct RenderQueue *queue, uint64_t key, const float world[MAT_4_SIZE]);
+extern int RenderQueueBuild(struct RenderQueue *queue);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef SKINNING_H_
+#define SKINNING_H_
+
+#include "vector.h"
+#include "matrix.h"
+
+#define SKIN_INFLUENCES 4
+
+/**
+ * Linear blend skinning on the CPU.
+ *
+ * Vertices are packed buffers: 3 floats per position and normal, SKIN_INFLUENCES bone indices and weights per vertex.
+ * Each vertex is transformed by the weighted sum of its bones' palette matrices (as written by AnimEvaluate), normals
+ * by its upper 3x3 and then renormalized, which is exact for rotations and uniform scales. Weights are used as given,
+ * unused influences should have a weight of 0. Bone indices are not range checked against the palette.
+ *
+ * Normals are optional: pass NULL for both normals and outNormals. Outputs may alias their inputs.
+ * Vertex ranges are skinned on up to threadCount threads (0 uses every CPU), returns 0 on NULL buffers.
+ */
+
+extern int SkinVertices(
+    float *outPositions,
+    float *outNormals,
+    const float *positions,
+    const float *normals,
+    const int *boneIndices,
+    const float *boneWeights,
+    const float *palette,
+    int vertexCount,
+    int threadCount
+);
+
+#endif
@@ -0,0 +1,372 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "animation.h"
+#include "mathinline.h"
+#include "parallel.h"
+
+#define ANIM_JOBS_PER_RANGE 4
+
+static const int channelStrides[ANIM_CHANNEL_COUNT] = {VEC_3_SIZE, QUATERNION_SIZE, VEC_3_SIZE};
+
+/** Poses */
+int AnimPoseInit(struct AnimPose *pose, int boneCount) {
+    if (pose == NULL || boneCount < 0) return 0;
+
+    // One block for all three channels, translations first
+    size_t floatCount = (size_t) boneCount * (VEC_3_SIZE + QUATERNION_SIZE + VEC_3_SIZE);
+    float *block = malloc(sizeof(float) * (floatCount > 0 ? floatCount : 1));
+    if (block == NULL) return 0;
+
+    pose->boneCount = boneCount;
+    pose->translations = block;
+    pose->rotations = &block[boneCount * VEC_3_SIZE];
+    pose->scales = &block[boneCount * (VEC_3_SIZE + QUATERNION_SIZE)];
+
+    for (int i = 0; i < boneCount; ++i) {
+        Vec3Fill(&pose->translations[i * 3], 0.0f);
+        QuaternionIdentity(&pose->rotations[i * 4]);
+        Vec3Fill(&pose->scales[i * 3], 1.0f);
+    }
+
+    return 1;
+}
+
+void AnimPoseRelease(struct AnimPose *pose) {
+    if (pose == NULL) return;
+
+    free(pose->translations);
+    memset(pose, 0, sizeof(struct AnimPose));
+}
+
+void AnimPoseCopy(struct AnimPose *out, const struct AnimPose *pose) {
+    if (out == NULL || pose == NULL || out->boneCount != pose->boneCount) return;
+
+    size_t floatCount = (size_t) pose->boneCount * (VEC_3_SIZE + QUATERNION_SIZE + VEC_3_SIZE);
+    memcpy(out->translations, pose->translations, sizeof(float) * floatCount);
+}
+
+void AnimPoseBlend(struct AnimPose *out, const struct AnimPose *a, const struct AnimPose *b, float weight) {
+    if (out == NULL || a == NULL || b == NULL) return;
+    if (out->boneCount != a->boneCount || out->boneCount != b->boneCount) return;
+
+    int n = out->boneCount;
+    float keep = 1.0f - weight;
+
+    for (int i = 0; i < n * VEC_3_SIZE; ++i) {
+        out->translations[i] = a->translations[i] * keep + b->translations[i] * weight;
+        out->scales[i] = a->scales[i] * keep + b->scales[i] * weight;
+    }
+
+    // nlerp split in two: a shortest path lerp of every bone, then one batch normalize
+    for (int i = 0; i < n; ++i) {
+        const float *qa = &a->rotations[i * 4];
+        const float *qb = &b->rotations[i * 4];
+        float dot = 0.0f;
+        QuaternionDot(&dot, qa, qb);
+        float w = dot < 0.0f ? -weight : weight;
+
+        for (int j = 0; j < QUATERNION_SIZE; ++j) {
+            out->rotations[i * 4 + j] = qa[j] * keep + qb[j] * w;
+        }
+    }
+
+    QuaternionNormalizeBatch(out->rotations, out->rotations, n);
+}
+
+/** Skeletons */
+int AnimSkeletonInit(
+    struct AnimSkeleton *skeleton,
+    int boneCount,
+    const int *parents,
+    const float *inverseBind,
+    const float *restTransforms
+) {
+    if (skeleton == NULL || parents == NULL || boneCount < 0) return 0;
+
+    memset(skeleton, 0, sizeof(struct AnimSkeleton));
+
+    for (int i = 0; i < boneCount; ++i) {
+        if (parents[i] >= i || parents[i] < -1) return 0;
+    }
+
+    skeleton->parents = malloc(sizeof(int) * (boneCount > 0 ? boneCount : 1));
+    skeleton->inverseBind = malloc(sizeof(float) * MAT_4_SIZE * (boneCount > 0 ? boneCount : 1));
+    if (skeleton->parents == NULL || skeleton->inverseBind == NULL || !AnimPoseInit(&skeleton->rest, boneCount)) {
+        AnimSkeletonRelease(skeleton);
+        return 0;
+    }
+
+    skeleton->boneCount = boneCount;
+    memcpy(skeleton->parents, parents, sizeof(int) * boneCount);
+
+    for (int i = 0; i < boneCount; ++i) {
+        if (inverseBind != NULL) {
+            Mat4Copy(&skeleton->inverseBind[i * MAT_4_SIZE], &inverseBind[i * MAT_4_SIZE]);
+        } else {
+            Mat4Identity(&skeleton->inverseBind[i * MAT_4_SIZE]);
+        }
+
+        if (restTransforms != NULL) {
+            const float *rest = &restTransforms[i * ANIM_TRANSFORM_SIZE];
+            Vec3Copy(&skeleton->rest.translations[i * 3], &rest[0]);
+            QuaternionCopy(&skeleton->rest.rotations[i * 4], &rest[3]);
+            Vec3Copy(&skeleton->rest.scales[i * 3], &rest[7]);
+        }
+    }
+
+    return 1;
+}
+
+void AnimSkeletonRelease(struct AnimSkeleton *skeleton) {
+    if (skeleton == NULL) return;
+
+    free(skeleton->parents);
+    free(skeleton->inverseBind);
+    AnimPoseRelease(&skeleton->rest);
+    memset(skeleton, 0, sizeof(struct AnimSkeleton));
+}
+
+/** Clips */
+int AnimClipInit(
+    struct AnimClip *clip,
+    float duration,
+    int trackCount,
+    const int *trackBones,
+    const int *trackChannels,
+    const int *trackKeyCounts,
+    const float *times,
+    const float *values
+) {
+    if (clip == NULL || trackCount < 0 || !(duration > 0.0f)) return 0;
+    if (
+        trackCount > 0 &&
+        (trackBones == NULL || trackChannels == NULL || trackKeyCounts == NULL || times == NULL || values == NULL)
+    ) return 0;
+
+    memset(clip, 0, sizeof(struct AnimClip));
+
+    int keyCount = 0;
+    int valueCount = 0;
+    int maxBone = -1;
+    for (int t = 0; t < trackCount; ++t) {
+        int channel = trackChannels[t];
+        if (channel < 0 || channel >= ANIM_CHANNEL_COUNT || trackKeyCounts[t] < 1 || trackBones[t] < 0) return 0;
+
+        for (int k = keyCount + 1; k < keyCount + trackKeyCounts[t]; ++k) {
+            if (!(times[k] > times[k - 1])) return 0;
+        }
+
+        keyCount += trackKeyCounts[t];
+        valueCount += trackKeyCounts[t] * channelStrides[channel];
+        if (trackBones[t] > maxBone) maxBone = trackBones[t];
+    }
+
+    size_t trackInts = (size_t) (trackCount > 0 ? trackCount : 1);
+    clip->trackBones = malloc(sizeof(int) * trackInts);
+    clip->trackChannels = malloc(sizeof(int) * trackInts);
+    clip->trackKeyCounts = malloc(sizeof(int) * trackInts);
+    clip->trackKeyOffsets = malloc(sizeof(int) * trackInts);
+    clip->trackValueOffsets = malloc(sizeof(int) * trackInts);
+    clip->times = malloc(sizeof(float) * (keyCount > 0 ? keyCount : 1));
+    clip->values = malloc(sizeof(float) * (valueCount > 0 ? valueCount : 1));
+    if (
+        clip->trackBones == NULL || clip->trackChannels == NULL || clip->trackKeyCounts == NULL ||
+        clip->trackKeyOffsets == NULL || clip->trackValueOffsets == NULL || clip->times == NULL || clip->values == NULL
+    ) {
+        AnimClipRelease(clip);
+        return 0;
+    }
+
+    clip->duration = duration;
+    clip->trackCount = trackCount;
+    clip->maxBone = maxBone;
+
+    int keyOffset = 0;
+    int valueOffset = 0;
+    for (int t = 0; t < trackCount; ++t) {
+        clip->trackBones[t] = trackBones[t];
+        clip->trackChannels[t] = trackChannels[t];
+        clip->trackKeyCounts[t] = trackKeyCounts[t];
+        clip->trackKeyOffsets[t] = keyOffset;
+        clip->trackValueOffsets[t] = valueOffset;
+
+        keyOffset += trackKeyCounts[t];
+        valueOffset += trackKeyCounts[t] * channelStrides[trackChannels[t]];
+    }
+
+    if (keyCount > 0) memcpy(clip->times, times, sizeof(float) * keyCount);
+    if (valueCount > 0) memcpy(clip->values, values, sizeof(float) * valueCount);
+
+    return 1;
+}
+
+void AnimClipRelease(struct AnimClip *clip) {
+    if (clip == NULL) return;
+
+    free(clip->trackBones);
+    free(clip->trackChannels);
+    free(clip->trackKeyCounts);
+    free(clip->trackKeyOffsets);
+    free(clip->trackValueOffsets);
+    free(clip->times);
+    free(clip->values);
+    memset(clip, 0, sizeof(struct AnimClip));
+}
+
+// Index of the last key at or before time, keys are sorted so this is a binary search
+static int findKey(const float *times, int keyCount, float time) {
+    int low = 0;
+    int high = keyCount - 1;
+
+    while (low < high) {
+        int mid = (low + high + 1) / 2;
+        if (times[mid] <= time) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return low;
+}
+
+// Writes only the animated channels, bones and channels without a track keep what out already holds
+void AnimClipSample(struct AnimPose *out, const struct AnimClip *clip, float time, int loop) {
+    if (out == NULL || clip == NULL) return;
+
+    if (loop) {
+        time = fmodf(time, clip->duration);
+        if (time < 0.0f) time += clip->duration;
+    } else {
+        time = fminf(fmaxf(time, 0.0f), clip->duration);
+    }
+
+    for (int t = 0; t < clip->trackCount; ++t) {
+        int bone = clip->trackBones[t];
+        if (bone >= out->boneCount) continue;
+
+        int channel = clip->trackChannels[t];
+        int stride = channelStrides[channel];
+        int keyCount = clip->trackKeyCounts[t];
+        const float *times = &clip->times[clip->trackKeyOffsets[t]];
+        const float *values = &clip->values[clip->trackValueOffsets[t]];
+
+        int key = findKey(times, keyCount, time);
+        int next = key + 1 < keyCount ? key + 1 : key;
+        float alpha = next == key ? 0.0f : (time - times[key]) / (times[next] - times[key]);
+        alpha = fminf(fmaxf(alpha, 0.0f), 1.0f);
+
+        const float *from = &values[key * stride];
+        const float *to = &values[next * stride];
+
+        switch (channel) {
+            case ANIM_CHANNEL_TRANSLATION:
+            case ANIM_CHANNEL_SCALE: {
+                float *dest = channel == ANIM_CHANNEL_TRANSLATION ? &out->translations[bone * 3] : &out->scales[bone * 3];
+                for (int i = 0; i < VEC_3_SIZE; ++i) {
+                    dest[i] = from[i] + (to[i] - from[i]) * alpha;
+                }
+                break;
+            }
+            case ANIM_CHANNEL_ROTATION:
+                QuaternionNlerp(&out->rotations[bone * 4], from, to, alpha);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/** Matrices */
+void AnimPoseToModel(float *outModel, const struct AnimPose *pose, const struct AnimSkeleton *skeleton) {
+    if (outModel == NULL || pose == NULL || skeleton == NULL || pose->boneCount != skeleton->boneCount) return;
+
+    for (int i = 0; i < skeleton->boneCount; ++i) {
+        float local[MAT_4_SIZE];
+        const float *s = &pose->scales[i * 3];
+        const float *t = &pose->translations[i * 3];
+
+        // S * R * T without the two multiplies: scale the rotation rows and put the translation in the last row
+        Mat4RotationQuaternionFA(local, &pose->rotations[i * 4]);
+        for (int row = 0; row < 3; ++row) {
+            for (int col = 0; col < 3; ++col) {
+                local[row * 4 + col] *= s[row];
+            }
+        }
+        local[12] = t[0];
+        local[13] = t[1];
+        local[14] = t[2];
+
+        float *model = &outModel[i * MAT_4_SIZE];
+        int parent = skeleton->parents[i];
+        if (parent >= 0) {
+            Mat4Mult(model, local, &outModel[parent * MAT_4_SIZE]);
+        } else {
+            Mat4CopyInline(model, local);
+        }
+    }
+}
+
+void AnimSkinningPalette(float *outPalette, const float *model, const struct AnimSkeleton *skeleton) {
+    if (outPalette == NULL || model == NULL || skeleton == NULL) return;
+
+    for (int i = 0; i < skeleton->boneCount; ++i) {
+        Mat4Mult(&outPalette[i * MAT_4_SIZE], &skeleton->inverseBind[i * MAT_4_SIZE], &model[i * MAT_4_SIZE]);
+    }
+}
+
+/** Batch evaluation */
+struct EvaluateContext {
+    const struct AnimSkeleton *skeleton;
+    const struct AnimJob *jobs;
+    int loop;
+    atomic_int failed;
+};
+
+static void evaluateRange(void *arg, int begin, int end) {
+    struct EvaluateContext *context = arg;
+    const struct AnimSkeleton *skeleton = context->skeleton;
+    int boneCount = skeleton->boneCount;
+
+    struct AnimPose poseA, poseB;
+    float *model = malloc(sizeof(float) * MAT_4_SIZE * (boneCount > 0 ? boneCount : 1));
+    int havePoseA = AnimPoseInit(&poseA, boneCount);
+    int havePoseB = AnimPoseInit(&poseB, boneCount);
+
+    if (model == NULL || !havePoseA || !havePoseB) {
+        atomic_store(&context->failed, 1);
+    } else {
+        for (int j = begin; j < end; ++j) {
+            const struct AnimJob *job = &context->jobs[j];
+
+            AnimPoseCopy(&poseA, &skeleton->rest);
+            AnimClipSample(&poseA, job->clipA, job->timeA, context->loop);
+
+            if (job->clipB != NULL && job->weight > 0.0f) {
+                AnimPoseCopy(&poseB, &skeleton->rest);
+                AnimClipSample(&poseB, job->clipB, job->timeB, context->loop);
+                AnimPoseBlend(&poseA, &poseA, &poseB, job->weight);
+            }
+
+            AnimPoseToModel(model, &poseA, skeleton);
+            AnimSkinningPalette(job->outPalette, model, skeleton);
+        }
+    }
+
+    free(model);
+    if (havePoseA) AnimPoseRelease(&poseA);
+    if (havePoseB) AnimPoseRelease(&poseB);
+}
+
+// Jobs are independent so they are split across threads, each range owns its own scratch poses
+int AnimEvaluate(const struct AnimSkeleton *skeleton, const struct AnimJob *jobs, int jobCount, int loop, int threadCount) {
+    if (skeleton == NULL || jobs == NULL) return 0;
+
+    struct EvaluateContext context = {skeleton, jobs, loop, 0};
+    ParallelFor(jobCount, ANIM_JOBS_PER_RANGE, threadCount, evaluateRange, &context);
+
+    return !atomic_load(&context.failed);
+}
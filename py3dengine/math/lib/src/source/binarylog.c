@@ -0,0 +1,119 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "binarylog.h"
+
+static uint32_t recordSizeAt(const struct BinaryLog *log, size_t offset) {
+    uint32_t size;
+    memcpy(&size, &log->data[offset], sizeof(uint32_t));
+
+    return size;
+}
+
+int BinaryLogInit(struct BinaryLog *log, size_t capacity) {
+    if (log == NULL) return 0;
+
+    memset(log, 0, sizeof(struct BinaryLog));
+    if (capacity < BINARY_LOG_MIN_CAPACITY) capacity = BINARY_LOG_MIN_CAPACITY;
+    capacity = (capacity + BINARY_LOG_ALIGNMENT - 1) / BINARY_LOG_ALIGNMENT * BINARY_LOG_ALIGNMENT;
+
+    log->data = malloc(capacity);
+    if (log->data == NULL) return 0;
+
+    log->capacity = capacity;
+
+    return 1;
+}
+
+void BinaryLogRelease(struct BinaryLog *log) {
+    if (log == NULL) return;
+
+    free(log->data);
+    memset(log, 0, sizeof(struct BinaryLog));
+}
+
+void BinaryLogReset(struct BinaryLog *log) {
+    if (log == NULL) return;
+
+    log->head = 0;
+    log->tail = 0;
+    log->wrapEnd = 0;
+    log->wrapped = 0;
+    log->recordCount = 0;
+    log->overwrittenCount = 0;
+}
+
+int BinaryLogWrite(
+    struct BinaryLog *log, uint32_t formatId, uint64_t timestamp, const void *payload, size_t payloadSize
+) {
+    if (log == NULL || log->data == NULL || (payload == NULL && payloadSize > 0)) return 0;
+
+    size_t size = (BINARY_LOG_HEADER_SIZE + payloadSize + BINARY_LOG_ALIGNMENT - 1)
+        / BINARY_LOG_ALIGNMENT * BINARY_LOG_ALIGNMENT;
+    if (size > log->capacity || size > UINT32_MAX) return 0;
+
+    for (;;) {
+        if (log->recordCount == 0) {
+            log->head = 0;
+            log->tail = 0;
+            log->wrapped = 0;
+        }
+
+        if (!log->wrapped) {
+            if (log->head + size <= log->capacity) break;
+
+            // Start over at the beginning, the records from tail to here are read before the ones written next
+            log->wrapEnd = log->head;
+            log->wrapped = 1;
+            log->head = 0;
+            continue;
+        }
+
+        if (log->head + size <= log->tail) break;
+
+        log->tail += recordSizeAt(log, log->tail);
+        --log->recordCount;
+        ++log->overwrittenCount;
+        if (log->tail >= log->wrapEnd) {
+            log->tail = 0;
+            log->wrapped = 0;
+        }
+    }
+
+    unsigned char *record = &log->data[log->head];
+    uint32_t recordSize = (uint32_t) size;
+    memcpy(record, &recordSize, sizeof(uint32_t));
+    memcpy(record + 4, &formatId, sizeof(uint32_t));
+    memcpy(record + 8, &timestamp, sizeof(uint64_t));
+    if (payloadSize > 0) memcpy(record + BINARY_LOG_HEADER_SIZE, payload, payloadSize);
+    // Padding is zeroed so snapshots never leak stale bytes
+    memset(record + BINARY_LOG_HEADER_SIZE + payloadSize, 0, size - BINARY_LOG_HEADER_SIZE - payloadSize);
+
+    log->head += size;
+    ++log->recordCount;
+
+    return 1;
+}
+
+size_t BinaryLogSize(const struct BinaryLog *log) {
+    if (log == NULL || log->recordCount == 0) return 0;
+
+    if (log->wrapped) return log->wrapEnd - log->tail + log->head;
+
+    return log->head - log->tail;
+}
+
+size_t BinaryLogSnapshot(const struct BinaryLog *log, unsigned char *out, size_t outCapacity) {
+    size_t size = BinaryLogSize(log);
+    if (out == NULL || size == 0 || outCapacity < size) return 0;
+
+    if (log->wrapped) {
+        size_t first = log->wrapEnd - log->tail;
+        memcpy(out, &log->data[log->tail], first);
+        memcpy(out + first, log->data, log->head);
+    } else {
+        memcpy(out, &log->data[log->tail], size);
+    }
+
+    return size;
+}
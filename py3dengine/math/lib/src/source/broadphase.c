@@ -0,0 +1,425 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "broadphase.h"
+
+#define SAP_INITIAL_CAPACITY 64
+#define SAP_PROXY_FREE 0
+#define SAP_PROXY_ACTIVE 1
+#define SAP_PROXY_REMOVED 2
+#define SAP_EMPTY_SLOT (-1)
+
+static int growArray(void **array, int *capacity, int needed, size_t elementSize) {
+    if (needed <= *capacity) return 1;
+
+    int newCapacity = *capacity > 0 ? *capacity : SAP_INITIAL_CAPACITY;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    void *grown = realloc(*array, elementSize * newCapacity);
+    if (grown == NULL) return 0;
+
+    *array = grown;
+    *capacity = newCapacity;
+    return 1;
+}
+
+void SapInit(struct SweepAndPrune *sap) {
+    if (sap == NULL) return;
+
+    memset(sap, 0, sizeof(struct SweepAndPrune));
+    sap->freeList = SAP_NULL_PROXY;
+}
+
+void SapRelease(struct SweepAndPrune *sap) {
+    if (sap == NULL) return;
+
+    free(sap->proxies);
+    for (int axis = 0; axis < 3; ++axis) {
+        free(sap->endpoints[axis]);
+    }
+    free(sap->pairs);
+    free(sap->table);
+    free(sap->touched);
+    free(sap->beginEvents);
+    free(sap->endEvents);
+    SapInit(sap);
+}
+
+/** Proxies */
+static void storeAabb(struct SapProxy *proxy, const float aabb[AABB_SIZE]) {
+    // Clamped so removed proxies, parked at INFINITY, always sort after every live endpoint
+    for (int i = 0; i < 3; ++i) {
+        float min = fminf(aabb[i], aabb[i + 3]);
+        float max = fmaxf(aabb[i], aabb[i + 3]);
+        proxy->aabb[i] = fmaxf(fminf(min, SAP_MAX_COORD), -SAP_MAX_COORD);
+        proxy->aabb[i + 3] = fmaxf(fminf(max, SAP_MAX_COORD), -SAP_MAX_COORD);
+    }
+}
+
+int SapIsValidProxy(const struct SweepAndPrune *sap, int proxy) {
+    if (sap == NULL) return 0;
+
+    return proxy >= 0 && proxy < sap->proxyCount && sap->proxies[proxy].state == SAP_PROXY_ACTIVE;
+}
+
+int SapGetUserData(const struct SweepAndPrune *sap, int proxy) {
+    if (sap == NULL || proxy < 0 || proxy >= sap->proxyCount) return 0;
+
+    return sap->proxies[proxy].userData;
+}
+
+int SapAddProxy(struct SweepAndPrune *sap, const float aabb[AABB_SIZE], int userData) {
+    if (sap == NULL || aabb == NULL) return SAP_NULL_PROXY;
+
+    int needed = sap->endpointCount + 2;
+    if (needed > sap->endpointCapacity) {
+        // Every axis grows from the same capacity, the shared count is only raised once all three succeeded
+        int capacity = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            capacity = sap->endpointCapacity;
+            if (!growArray((void **) &sap->endpoints[axis], &capacity, needed, sizeof(struct SapEndpoint))) {
+                return SAP_NULL_PROXY;
+            }
+        }
+        sap->endpointCapacity = capacity;
+    }
+
+    int proxy = sap->freeList;
+    if (proxy != SAP_NULL_PROXY) {
+        sap->freeList = sap->proxies[proxy].nextFree;
+    } else {
+        if (!growArray((void **) &sap->proxies, &sap->proxyCapacity, sap->proxyCount + 1, sizeof(struct SapProxy))) {
+            return SAP_NULL_PROXY;
+        }
+        proxy = sap->proxyCount++;
+    }
+
+    struct SapProxy *p = &sap->proxies[proxy];
+    storeAabb(p, aabb);
+    p->userData = userData;
+    p->state = SAP_PROXY_ACTIVE;
+    p->nextFree = SAP_NULL_PROXY;
+
+    // New endpoints wait at the end of the arrays, SapUpdate sorts them in
+    for (int axis = 0; axis < 3; ++axis) {
+        sap->endpoints[axis][sap->endpointCount].data = proxy << 1;
+        sap->endpoints[axis][sap->endpointCount + 1].data = proxy << 1 | 1;
+    }
+    sap->endpointCount += 2;
+    sap->activeCount++;
+
+    return proxy;
+}
+
+void SapRemoveProxy(struct SweepAndPrune *sap, int proxy) {
+    if (!SapIsValidProxy(sap, proxy)) return;
+
+    // Parking the proxy past every live endpoint turns its removal into ordinary swaps, which end its pairs
+    struct SapProxy *p = &sap->proxies[proxy];
+    for (int i = 0; i < AABB_SIZE; ++i) {
+        p->aabb[i] = INFINITY;
+    }
+    p->state = SAP_PROXY_REMOVED;
+    sap->activeCount--;
+    sap->pendingRemovals++;
+}
+
+void SapSetProxyAabb(struct SweepAndPrune *sap, int proxy, const float aabb[AABB_SIZE]) {
+    if (!SapIsValidProxy(sap, proxy) || aabb == NULL) return;
+
+    storeAabb(&sap->proxies[proxy], aabb);
+}
+
+/** Pair cache */
+static unsigned int hashPair(int a, int b) {
+    unsigned int h = (unsigned int) a * 0x9E3779B1u ^ (unsigned int) b * 0x85EBCA77u;
+    return h ^ (h >> 15);
+}
+
+static int findSlot(const struct SweepAndPrune *sap, int a, int b) {
+    unsigned int mask = (unsigned int) sap->tableCapacity - 1;
+    unsigned int slot = hashPair(a, b) & mask;
+
+    while (sap->table[slot] != SAP_EMPTY_SLOT) {
+        const struct SapPair *pair = &sap->pairs[sap->table[slot]];
+        if (pair->a == a && pair->b == b) break;
+        slot = (slot + 1) & mask;
+    }
+
+    return (int) slot;
+}
+
+static int growTable(struct SweepAndPrune *sap) {
+    int capacity = sap->tableCapacity > 0 ? sap->tableCapacity * 2 : SAP_INITIAL_CAPACITY * 2;
+    int *table = malloc(sizeof(int) * capacity);
+    if (table == NULL) return 0;
+
+    free(sap->table);
+    sap->table = table;
+    sap->tableCapacity = capacity;
+    for (int i = 0; i < capacity; ++i) {
+        table[i] = SAP_EMPTY_SLOT;
+    }
+
+    for (int i = 0; i < sap->pairCount; ++i) {
+        table[findSlot(sap, sap->pairs[i].a, sap->pairs[i].b)] = i;
+    }
+
+    return 1;
+}
+
+static int findPair(const struct SweepAndPrune *sap, int a, int b) {
+    if (sap->pairCount == 0) return SAP_EMPTY_SLOT;
+
+    return sap->table[findSlot(sap, a, b)];
+}
+
+static int insertPair(struct SweepAndPrune *sap, int a, int b) {
+    // Keep the table at most half full so probes stay short
+    if ((sap->pairCount + 1) * 2 > sap->tableCapacity && !growTable(sap)) return SAP_EMPTY_SLOT;
+    if (!growArray((void **) &sap->pairs, &sap->pairCapacity, sap->pairCount + 1, sizeof(struct SapPair))) {
+        return SAP_EMPTY_SLOT;
+    }
+
+    int index = sap->pairCount++;
+    sap->pairs[index].a = a;
+    sap->pairs[index].b = b;
+    sap->pairs[index].flags = 0;
+    sap->table[findSlot(sap, a, b)] = index;
+
+    return index;
+}
+
+/** Swap removes the pair at index and backward shifts the probe chain its slot was part of */
+static void erasePair(struct SweepAndPrune *sap, int index) {
+    unsigned int mask = (unsigned int) sap->tableCapacity - 1;
+    unsigned int slot = (unsigned int) findSlot(sap, sap->pairs[index].a, sap->pairs[index].b);
+
+    unsigned int next = (slot + 1) & mask;
+    while (sap->table[next] != SAP_EMPTY_SLOT) {
+        const struct SapPair *pair = &sap->pairs[sap->table[next]];
+        unsigned int home = hashPair(pair->a, pair->b) & mask;
+
+        // The entry at next may fill the hole if its home slot is not cyclically within (slot, next]
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            sap->table[slot] = sap->table[next];
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+    sap->table[slot] = SAP_EMPTY_SLOT;
+
+    int last = --sap->pairCount;
+    if (index != last) {
+        sap->pairs[index] = sap->pairs[last];
+        sap->table[findSlot(sap, sap->pairs[index].a, sap->pairs[index].b)] = index;
+    }
+}
+
+static int touchPair(struct SweepAndPrune *sap, int index) {
+    struct SapPair *pair = &sap->pairs[index];
+    if (pair->flags & SAP_PAIR_TOUCHED) return 1;
+
+    if (!growArray((void **) &sap->touched, &sap->touchedCapacity, sap->touchedCount + 1, sizeof(int))) return 0;
+
+    pair->flags |= SAP_PAIR_TOUCHED;
+    if (pair->flags & SAP_PAIR_OVERLAPPING) pair->flags |= SAP_PAIR_WAS_OVERLAPPING;
+    sap->touched[sap->touchedCount++] = index;
+
+    return 1;
+}
+
+static int beginOverlap(struct SweepAndPrune *sap, int p1, int p2) {
+    const struct SapProxy *proxy1 = &sap->proxies[p1];
+    const struct SapProxy *proxy2 = &sap->proxies[p2];
+    if (p1 == p2 || proxy1->state != SAP_PROXY_ACTIVE || proxy2->state != SAP_PROXY_ACTIVE) return 1;
+
+    // The intervals just started overlapping on one axis, the pair only exists if the others agree
+    if (!AabbOverlaps(proxy1->aabb, proxy2->aabb)) return 1;
+
+    int a = p1 < p2 ? p1 : p2;
+    int b = p1 < p2 ? p2 : p1;
+    int index = findPair(sap, a, b);
+    if (index == SAP_EMPTY_SLOT) {
+        index = insertPair(sap, a, b);
+        if (index == SAP_EMPTY_SLOT) return 0;
+    }
+
+    if (!touchPair(sap, index)) return 0;
+    sap->pairs[index].flags |= SAP_PAIR_OVERLAPPING;
+
+    return 1;
+}
+
+static int endOverlap(struct SweepAndPrune *sap, int p1, int p2) {
+    int a = p1 < p2 ? p1 : p2;
+    int b = p1 < p2 ? p2 : p1;
+    int index = findPair(sap, a, b);
+    if (index == SAP_EMPTY_SLOT) return 1;
+
+    if (!touchPair(sap, index)) return 0;
+    sap->pairs[index].flags &= ~SAP_PAIR_OVERLAPPING;
+
+    return 1;
+}
+
+/** Sorting */
+static int endpointLess(const struct SapEndpoint *e1, const struct SapEndpoint *e2) {
+    if (e1->value != e2->value) return e1->value < e2->value;
+
+    // Removed proxies are parked at INFINITY with their max endpoints first, so pairs of two removed proxies end too
+    if (e1->value == INFINITY) return (e1->data & 1) > (e2->data & 1);
+
+    // Otherwise min endpoints sort first on ties so touching boxes overlap, the same rule AabbOverlaps uses
+    return (e1->data & 1) < (e2->data & 1);
+}
+
+static int compareEndpoints(const void *e1, const void *e2) {
+    const struct SapEndpoint *a = e1, *b = e2;
+    if (endpointLess(a, b)) return -1;
+    if (endpointLess(b, a)) return 1;
+
+    return (a->data > b->data) - (a->data < b->data);
+}
+
+static void refreshValues(struct SweepAndPrune *sap, int axis) {
+    struct SapEndpoint *endpoints = sap->endpoints[axis];
+    for (int i = 0; i < sap->endpointCount; ++i) {
+        int data = endpoints[i].data;
+        endpoints[i].value = sap->proxies[data >> 1].aabb[axis + (data & 1) * 3];
+    }
+}
+
+/** Finds the overlaps among the proxies added since the last update, which sort without swapping each other */
+static int addNewPairs(struct SweepAndPrune *sap) {
+    struct SapEndpoint *endpoints = sap->endpoints[0];
+
+    for (int i = sap->sortedCount; i < sap->endpointCount; ++i) {
+        if (endpoints[i].data & 1) continue;
+
+        int proxy = endpoints[i].data >> 1;
+        float max = sap->proxies[proxy].aabb[3];
+        for (int j = i + 1; j < sap->endpointCount && endpoints[j].value <= max; ++j) {
+            if (endpoints[j].data & 1) continue;
+            if (!beginOverlap(sap, proxy, endpoints[j].data >> 1)) return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int insertionSort(struct SweepAndPrune *sap, int axis) {
+    struct SapEndpoint *endpoints = sap->endpoints[axis];
+
+    for (int i = 1; i < sap->endpointCount; ++i) {
+        struct SapEndpoint e = endpoints[i];
+        int j = i - 1;
+
+        while (j >= 0 && endpointLess(&e, &endpoints[j])) {
+            const struct SapEndpoint *passed = &endpoints[j];
+            int isMax = e.data & 1;
+
+            if (isMax != (passed->data & 1)) {
+                // A min passing a max starts an overlap on this axis, a max passing a min ends one
+                int ok = isMax
+                    ? endOverlap(sap, e.data >> 1, passed->data >> 1)
+                    : beginOverlap(sap, e.data >> 1, passed->data >> 1);
+                if (!ok) {
+                    endpoints[j + 1] = e;
+                    return 0;
+                }
+            }
+
+            endpoints[j + 1] = endpoints[j];
+            --j;
+        }
+        endpoints[j + 1] = e;
+    }
+
+    return 1;
+}
+
+static int pushEvent(int **events, int *count, int *capacity, const struct SapPair *pair) {
+    if (!growArray((void **) events, capacity, (*count + 1) * 2, sizeof(int))) return 0;
+
+    (*events)[*count * 2] = pair->a;
+    (*events)[*count * 2 + 1] = pair->b;
+    (*count)++;
+
+    return 1;
+}
+
+static int compareDescending(const void *i1, const void *i2) {
+    int a = *(const int *) i1, b = *(const int *) i2;
+
+    return (a < b) - (a > b);
+}
+
+static int publishEvents(struct SweepAndPrune *sap) {
+    for (int i = 0; i < sap->touchedCount; ++i) {
+        struct SapPair *pair = &sap->pairs[sap->touched[i]];
+        int now = pair->flags & SAP_PAIR_OVERLAPPING;
+        int before = pair->flags & SAP_PAIR_WAS_OVERLAPPING;
+
+        if (now && !before && !pushEvent(&sap->beginEvents, &sap->beginCount, &sap->beginCapacity, pair)) return 0;
+        if (!now && before && !pushEvent(&sap->endEvents, &sap->endCount, &sap->endCapacity, pair)) return 0;
+        pair->flags &= SAP_PAIR_OVERLAPPING;
+    }
+
+    // Removing from the back keeps the indices still to be visited in place
+    qsort(sap->touched, sap->touchedCount, sizeof(int), compareDescending);
+    for (int i = 0; i < sap->touchedCount; ++i) {
+        if (!(sap->pairs[sap->touched[i]].flags & SAP_PAIR_OVERLAPPING)) erasePair(sap, sap->touched[i]);
+    }
+    sap->touchedCount = 0;
+
+    return 1;
+}
+
+static void releaseRemoved(struct SweepAndPrune *sap) {
+    if (sap->pendingRemovals == 0) return;
+
+    // Removed proxies sorted past every live endpoint on every axis, so they are the last endpoints
+    int count = sap->endpointCount - sap->pendingRemovals * 2;
+    const struct SapEndpoint *endpoints = sap->endpoints[0];
+    for (int i = count; i < sap->endpointCount; ++i) {
+        if (endpoints[i].data & 1) continue;
+
+        int proxy = endpoints[i].data >> 1;
+        sap->proxies[proxy].state = SAP_PROXY_FREE;
+        sap->proxies[proxy].nextFree = sap->freeList;
+        sap->freeList = proxy;
+    }
+
+    sap->endpointCount = count;
+    sap->pendingRemovals = 0;
+}
+
+int SapUpdate(struct SweepAndPrune *sap) {
+    if (sap == NULL) return 0;
+
+    sap->beginCount = 0;
+    sap->endCount = 0;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        refreshValues(sap, axis);
+
+        // New proxies are sorted among themselves up front, otherwise a bulk insert would be quadratic
+        int added = sap->endpointCount - sap->sortedCount;
+        if (added > 1) {
+            qsort(sap->endpoints[axis] + sap->sortedCount, added, sizeof(struct SapEndpoint), compareEndpoints);
+        }
+    }
+
+    if (!addNewPairs(sap)) return 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!insertionSort(sap, axis)) return 0;
+    }
+    if (!publishEvents(sap)) return 0;
+
+    releaseRemoved(sap);
+    sap->sortedCount = sap->endpointCount;
+
+    return 1;
+}
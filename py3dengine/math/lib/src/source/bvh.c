@@ -0,0 +1,783 @@
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bvh.h"
+
+#define BVH_INITIAL_CAPACITY 16
+#define BVH_STACK_SIZE 128
+#define BVH_SAH_BINS 12
+
+/** AABB helpers */
+void AabbCopy(float out[AABB_SIZE], const float a[AABB_SIZE]) {
+    if (out == NULL || a == NULL) return;
+
+    for (int i = 0; i < AABB_SIZE; ++i) {
+        out[i] = a[i];
+    }
+}
+
+void AabbUnion(float out[AABB_SIZE], const float a1[AABB_SIZE], const float a2[AABB_SIZE]) {
+    if (out == NULL || a1 == NULL || a2 == NULL) return;
+
+    for (int i = 0; i < 3; ++i) {
+        out[i] = fminf(a1[i], a2[i]);
+        out[i + 3] = fmaxf(a1[i + 3], a2[i + 3]);
+    }
+}
+
+// Arvo's method, transforms the box extents instead of all 8 corners
+void AabbTransform(float out[AABB_SIZE], const float a[AABB_SIZE], const float m[MAT_4_SIZE]) {
+    if (out == NULL || a == NULL || m == NULL) return;
+
+    float temp[AABB_SIZE] = {m[12], m[13], m[14], m[12], m[13], m[14]};
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            float e = m[i * 4 + j] * a[i];
+            float f = m[i * 4 + j] * a[i + 3];
+            temp[j] += fminf(e, f);
+            temp[j + 3] += fmaxf(e, f);
+        }
+    }
+
+    AabbCopy(out, temp);
+}
+
+float AabbSurfaceArea(const float a[AABB_SIZE]) {
+    if (a == NULL) return 0.0f;
+
+    float dx = a[3] - a[0];
+    float dy = a[4] - a[1];
+    float dz = a[5] - a[2];
+
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+int AabbContains(const float outer[AABB_SIZE], const float inner[AABB_SIZE]) {
+    if (outer == NULL || inner == NULL) return 0;
+
+    return outer[0] <= inner[0] && outer[1] <= inner[1] && outer[2] <= inner[2] &&
+           outer[3] >= inner[3] && outer[4] >= inner[4] && outer[5] >= inner[5];
+}
+
+int AabbOverlaps(const float a1[AABB_SIZE], const float a2[AABB_SIZE]) {
+    if (a1 == NULL || a2 == NULL) return 0;
+
+    return a1[0] <= a2[3] && a1[3] >= a2[0] &&
+           a1[1] <= a2[4] && a1[4] >= a2[1] &&
+           a1[2] <= a2[5] && a1[5] >= a2[2];
+}
+
+float AabbDistanceSquared(const float a[AABB_SIZE], const float p[VEC_3_SIZE]) {
+    if (a == NULL || p == NULL) return 0.0f;
+
+    float distSq = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        float d = 0.0f;
+        if (p[i] < a[i]) {
+            d = a[i] - p[i];
+        } else if (p[i] > a[i + 3]) {
+            d = p[i] - a[i + 3];
+        }
+        distSq += d * d;
+    }
+
+    return distSq;
+}
+
+// slab test, fminf / fmaxf discard the NaNs produced by axis aligned rays starting on a slab plane
+int AabbRayIntersect(float *outT, const float a[AABB_SIZE], const float origin[VEC_3_SIZE], const float invDir[VEC_3_SIZE], float maxT) {
+    if (a == NULL || origin == NULL || invDir == NULL) return 0;
+
+    float tMin = 0.0f;
+    float tMax = maxT;
+    for (int i = 0; i < 3; ++i) {
+        float t1 = (a[i] - origin[i]) * invDir[i];
+        float t2 = (a[i + 3] - origin[i]) * invDir[i];
+        tMin = fmaxf(tMin, fminf(t1, t2));
+        tMax = fminf(tMax, fmaxf(t1, t2));
+    }
+
+    if (tMax < tMin) return 0;
+
+    if (outT != NULL) (*outT) = tMin;
+    return 1;
+}
+
+/** Node pool */
+static int isLeaf(const struct BvhNode *node) {
+    return node->left == BVH_NULL_NODE;
+}
+
+static const float *queryBox(const struct BvhNode *node) {
+    return isLeaf(node) ? node->tight : node->aabb;
+}
+
+static int allocateNode(struct Bvh *bvh) {
+    if (bvh->freeList == BVH_NULL_NODE) {
+        int newCapacity = bvh->capacity == 0 ? BVH_INITIAL_CAPACITY : bvh->capacity * 2;
+        struct BvhNode *newNodes = realloc(bvh->nodes, sizeof(struct BvhNode) * newCapacity);
+        if (newNodes == NULL) return BVH_NULL_NODE;
+
+        for (int i = bvh->capacity; i < newCapacity; ++i) {
+            newNodes[i].parent = (i + 1 < newCapacity) ? i + 1 : BVH_NULL_NODE;
+            newNodes[i].height = -1;
+        }
+
+        bvh->nodes = newNodes;
+        bvh->freeList = bvh->capacity;
+        bvh->capacity = newCapacity;
+    }
+
+    int index = bvh->freeList;
+    struct BvhNode *node = &bvh->nodes[index];
+    bvh->freeList = node->parent;
+
+    node->parent = BVH_NULL_NODE;
+    node->left = BVH_NULL_NODE;
+    node->right = BVH_NULL_NODE;
+    node->height = 0;
+    node->userData = -1;
+    bvh->count++;
+
+    return index;
+}
+
+static void freeNode(struct Bvh *bvh, int index) {
+    bvh->nodes[index].parent = bvh->freeList;
+    bvh->nodes[index].height = -1;
+    bvh->freeList = index;
+    bvh->count--;
+}
+
+static void refreshNode(struct Bvh *bvh, int index) {
+    struct BvhNode *node = &bvh->nodes[index];
+    const struct BvhNode *left = &bvh->nodes[node->left];
+    const struct BvhNode *right = &bvh->nodes[node->right];
+
+    node->height = 1 + (left->height > right->height ? left->height : right->height);
+    AabbUnion(node->aabb, left->aabb, right->aabb);
+}
+
+static void replaceChild(struct Bvh *bvh, int parent, int oldChild, int newChild) {
+    if (parent == BVH_NULL_NODE) {
+        bvh->root = newChild;
+    } else if (bvh->nodes[parent].left == oldChild) {
+        bvh->nodes[parent].left = newChild;
+    } else {
+        bvh->nodes[parent].right = newChild;
+    }
+}
+
+// Rotates the taller grandchild up when the subtree at iA is imbalanced, returns the new subtree root
+static int balance(struct Bvh *bvh, int iA) {
+    struct BvhNode *n = bvh->nodes;
+    struct BvhNode *a = &n[iA];
+    if (isLeaf(a) || a->height < 2) return iA;
+
+    int iB = a->left;
+    int iC = a->right;
+    struct BvhNode *b = &n[iB];
+    struct BvhNode *c = &n[iC];
+
+    int heightDiff = c->height - b->height;
+
+    if (heightDiff > 1) {
+        int iF = c->left;
+        int iG = c->right;
+
+        c->left = iA;
+        c->parent = a->parent;
+        a->parent = iC;
+        replaceChild(bvh, c->parent, iA, iC);
+
+        int iKeep = n[iF].height > n[iG].height ? iF : iG;
+        int iMove = iKeep == iF ? iG : iF;
+        c->right = iKeep;
+        a->right = iMove;
+        n[iMove].parent = iA;
+
+        refreshNode(bvh, iA);
+        refreshNode(bvh, iC);
+
+        return iC;
+    }
+
+    if (heightDiff < -1) {
+        int iD = b->left;
+        int iE = b->right;
+
+        b->left = iA;
+        b->parent = a->parent;
+        a->parent = iB;
+        replaceChild(bvh, b->parent, iA, iB);
+
+        int iKeep = n[iD].height > n[iE].height ? iD : iE;
+        int iMove = iKeep == iD ? iE : iD;
+        b->right = iKeep;
+        a->left = iMove;
+        n[iMove].parent = iA;
+
+        refreshNode(bvh, iA);
+        refreshNode(bvh, iB);
+
+        return iB;
+    }
+
+    return iA;
+}
+
+static void fixUpwards(struct Bvh *bvh, int index) {
+    while (index != BVH_NULL_NODE) {
+        index = balance(bvh, index);
+        refreshNode(bvh, index);
+        index = bvh->nodes[index].parent;
+    }
+}
+
+// newParent must be a freshly allocated node unless the tree is empty
+static void insertLeaf(struct Bvh *bvh, int leaf, int newParent) {
+    struct BvhNode *n = bvh->nodes;
+
+    if (bvh->root == BVH_NULL_NODE) {
+        bvh->root = leaf;
+        n[leaf].parent = BVH_NULL_NODE;
+        return;
+    }
+
+    // descend towards the sibling with the smallest surface area increase
+    const float *leafAabb = n[leaf].aabb;
+    float combined[AABB_SIZE];
+    int index = bvh->root;
+    while (!isLeaf(&n[index])) {
+        int left = n[index].left;
+        int right = n[index].right;
+
+        float area = AabbSurfaceArea(n[index].aabb);
+        AabbUnion(combined, n[index].aabb, leafAabb);
+        float combinedArea = AabbSurfaceArea(combined);
+
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        AabbUnion(combined, leafAabb, n[left].aabb);
+        float costLeft = AabbSurfaceArea(combined) + inheritanceCost;
+        if (!isLeaf(&n[left])) costLeft -= AabbSurfaceArea(n[left].aabb);
+
+        AabbUnion(combined, leafAabb, n[right].aabb);
+        float costRight = AabbSurfaceArea(combined) + inheritanceCost;
+        if (!isLeaf(&n[right])) costRight -= AabbSurfaceArea(n[right].aabb);
+
+        if (cost < costLeft && cost < costRight) break;
+
+        index = costLeft < costRight ? left : right;
+    }
+
+    int sibling = index;
+    int oldParent = n[sibling].parent;
+
+    n[newParent].parent = oldParent;
+    n[newParent].left = sibling;
+    n[newParent].right = leaf;
+    n[newParent].userData = -1;
+    replaceChild(bvh, oldParent, sibling, newParent);
+
+    n[sibling].parent = newParent;
+    n[leaf].parent = newParent;
+
+    fixUpwards(bvh, newParent);
+}
+
+static void removeLeaf(struct Bvh *bvh, int leaf) {
+    struct BvhNode *n = bvh->nodes;
+
+    if (leaf == bvh->root) {
+        bvh->root = BVH_NULL_NODE;
+        return;
+    }
+
+    int parent = n[leaf].parent;
+    int grandParent = n[parent].parent;
+    int sibling = n[parent].left == leaf ? n[parent].right : n[parent].left;
+
+    replaceChild(bvh, grandParent, parent, sibling);
+    n[sibling].parent = grandParent;
+    freeNode(bvh, parent);
+
+    if (grandParent != BVH_NULL_NODE) {
+        fixUpwards(bvh, grandParent);
+    }
+}
+
+static void setLeafBoxes(struct Bvh *bvh, int proxy, const float aabb[AABB_SIZE]) {
+    struct BvhNode *node = &bvh->nodes[proxy];
+
+    AabbCopy(node->tight, aabb);
+    for (int i = 0; i < 3; ++i) {
+        node->aabb[i] = aabb[i] - bvh->margin;
+        node->aabb[i + 3] = aabb[i + 3] + bvh->margin;
+    }
+}
+
+/** Tree */
+int BvhInit(struct Bvh *bvh, float margin) {
+    if (bvh == NULL) return 0;
+
+    memset(bvh, 0, sizeof(struct Bvh));
+    bvh->root = BVH_NULL_NODE;
+    bvh->freeList = BVH_NULL_NODE;
+    bvh->margin = margin < 0.0f ? 0.0f : margin;
+
+    return 1;
+}
+
+void BvhRelease(struct Bvh *bvh) {
+    if (bvh == NULL) return;
+
+    free(bvh->nodes);
+    BvhInit(bvh, bvh->margin);
+}
+
+int BvhInsert(struct Bvh *bvh, const float aabb[AABB_SIZE], int userData) {
+    if (bvh == NULL || aabb == NULL) return BVH_NULL_NODE;
+
+    int leaf = allocateNode(bvh);
+    if (leaf == BVH_NULL_NODE) return BVH_NULL_NODE;
+
+    int newParent = BVH_NULL_NODE;
+    if (bvh->root != BVH_NULL_NODE) {
+        newParent = allocateNode(bvh);
+        if (newParent == BVH_NULL_NODE) {
+            freeNode(bvh, leaf);
+            return BVH_NULL_NODE;
+        }
+    }
+
+    setLeafBoxes(bvh, leaf, aabb);
+    bvh->nodes[leaf].userData = userData;
+    insertLeaf(bvh, leaf, newParent);
+    bvh->leafCount++;
+
+    return leaf;
+}
+
+void BvhRemove(struct Bvh *bvh, int proxy) {
+    if (!BvhIsValidProxy(bvh, proxy)) return;
+
+    removeLeaf(bvh, proxy);
+    freeNode(bvh, proxy);
+    bvh->leafCount--;
+}
+
+// Returns 1 when the leaf left its fat AABB and had to be re-inserted
+int BvhUpdate(struct Bvh *bvh, int proxy, const float aabb[AABB_SIZE]) {
+    if (!BvhIsValidProxy(bvh, proxy) || aabb == NULL) return 0;
+
+    if (AabbContains(bvh->nodes[proxy].aabb, aabb)) {
+        AabbCopy(bvh->nodes[proxy].tight, aabb);
+        return 0;
+    }
+
+    removeLeaf(bvh, proxy);
+    setLeafBoxes(bvh, proxy, aabb);
+
+    // removing a leaf from a tree with more than one leaf frees exactly the parent that re-inserting needs
+    int newParent = bvh->root == BVH_NULL_NODE ? BVH_NULL_NODE : allocateNode(bvh);
+    insertLeaf(bvh, proxy, newParent);
+
+    return 1;
+}
+
+// Moves a leaf without touching the tree structure, BvhRefit must be called before the next query
+void BvhSetLeafAabb(struct Bvh *bvh, int proxy, const float aabb[AABB_SIZE]) {
+    if (!BvhIsValidProxy(bvh, proxy) || aabb == NULL) return;
+
+    setLeafBoxes(bvh, proxy, aabb);
+}
+
+static void refitNode(struct Bvh *bvh, int index) {
+    struct BvhNode *node = &bvh->nodes[index];
+    if (isLeaf(node)) return;
+
+    refitNode(bvh, node->left);
+    refitNode(bvh, node->right);
+    refreshNode(bvh, index);
+}
+
+void BvhRefit(struct Bvh *bvh) {
+    if (bvh == NULL || bvh->root == BVH_NULL_NODE) return;
+
+    refitNode(bvh, bvh->root);
+}
+
+static float centroid(const float aabb[AABB_SIZE], int axis) {
+    return 0.5f * (aabb[axis] + aabb[axis + 3]);
+}
+
+// Top down binned SAH build over leaves[0..count), internal nodes are taken from the free list
+static int buildSah(struct Bvh *bvh, int *leaves, int count) {
+    struct BvhNode *n = bvh->nodes;
+    if (count == 1) return leaves[0];
+
+    float cMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float cMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (int i = 0; i < count; ++i) {
+        for (int axis = 0; axis < 3; ++axis) {
+            float c = centroid(n[leaves[i]].aabb, axis);
+            cMin[axis] = fminf(cMin[axis], c);
+            cMax[axis] = fmaxf(cMax[axis], c);
+        }
+    }
+
+    int axis = 0;
+    for (int i = 1; i < 3; ++i) {
+        if (cMax[i] - cMin[i] > cMax[axis] - cMin[axis]) axis = i;
+    }
+    float extent = cMax[axis] - cMin[axis];
+
+    int split = count / 2;
+    if (extent > 0.0f) {
+        int binCounts[BVH_SAH_BINS] = {0};
+        float binBoxes[BVH_SAH_BINS][AABB_SIZE];
+        float scale = (float) BVH_SAH_BINS / extent;
+
+        for (int i = 0; i < count; ++i) {
+            int bin = (int) ((centroid(n[leaves[i]].aabb, axis) - cMin[axis]) * scale);
+            if (bin >= BVH_SAH_BINS) bin = BVH_SAH_BINS - 1;
+
+            if (binCounts[bin] == 0) {
+                AabbCopy(binBoxes[bin], n[leaves[i]].aabb);
+            } else {
+                AabbUnion(binBoxes[bin], binBoxes[bin], n[leaves[i]].aabb);
+            }
+            binCounts[bin]++;
+        }
+
+        // sweep from the right to get the cost of every right hand side, then from the left to pick the split
+        float rightArea[BVH_SAH_BINS] = {0.0f};
+        int rightCount[BVH_SAH_BINS] = {0};
+        float box[AABB_SIZE];
+        int running = 0;
+        for (int bin = BVH_SAH_BINS - 1; bin > 0; --bin) {
+            if (binCounts[bin] > 0) {
+                if (running == 0) AabbCopy(box, binBoxes[bin]);
+                else AabbUnion(box, box, binBoxes[bin]);
+                running += binCounts[bin];
+            }
+            rightCount[bin] = running;
+            rightArea[bin] = running > 0 ? AabbSurfaceArea(box) : 0.0f;
+        }
+
+        int bestBin = -1;
+        float bestCost = FLT_MAX;
+        running = 0;
+        for (int bin = 0; bin < BVH_SAH_BINS - 1; ++bin) {
+            if (binCounts[bin] > 0) {
+                if (running == 0) AabbCopy(box, binBoxes[bin]);
+                else AabbUnion(box, box, binBoxes[bin]);
+                running += binCounts[bin];
+            }
+            if (running == 0 || rightCount[bin + 1] == 0) continue;
+
+            float cost = AabbSurfaceArea(box) * (float) running + rightArea[bin + 1] * (float) rightCount[bin + 1];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestBin = bin;
+            }
+        }
+
+        if (bestBin >= 0) {
+            int lo = 0;
+            int hi = count - 1;
+            while (lo <= hi) {
+                int bin = (int) ((centroid(n[leaves[lo]].aabb, axis) - cMin[axis]) * scale);
+                if (bin >= BVH_SAH_BINS) bin = BVH_SAH_BINS - 1;
+
+                if (bin <= bestBin) {
+                    lo++;
+                } else {
+                    int temp = leaves[lo];
+                    leaves[lo] = leaves[hi];
+                    leaves[hi] = temp;
+                    hi--;
+                }
+            }
+            split = lo;
+        }
+    }
+
+    int left = buildSah(bvh, leaves, split);
+    int right = buildSah(bvh, leaves + split, count - split);
+
+    int index = allocateNode(bvh);
+    n = bvh->nodes;
+    n[index].left = left;
+    n[index].right = right;
+    n[left].parent = index;
+    n[right].parent = index;
+    refreshNode(bvh, index);
+
+    return index;
+}
+
+// Rebuilds every internal node with a binned SAH split, proxies stay valid. Returns 0 if out of memory.
+int BvhRebuild(struct Bvh *bvh) {
+    if (bvh == NULL) return 0;
+    if (bvh->leafCount < 2) return 1;
+
+    int *leaves = malloc(sizeof(int) * bvh->leafCount);
+    if (leaves == NULL) return 0;
+
+    int leafCount = 0;
+    for (int i = 0; i < bvh->capacity; ++i) {
+        struct BvhNode *node = &bvh->nodes[i];
+        if (node->height < 0) continue;
+
+        if (isLeaf(node)) {
+            leaves[leafCount++] = i;
+        } else {
+            freeNode(bvh, i);
+        }
+    }
+
+    bvh->root = buildSah(bvh, leaves, leafCount);
+    bvh->nodes[bvh->root].parent = BVH_NULL_NODE;
+    free(leaves);
+
+    return 1;
+}
+
+int BvhGetUserData(const struct Bvh *bvh, int proxy) {
+    if (!BvhIsValidProxy(bvh, proxy)) return -1;
+
+    return bvh->nodes[proxy].userData;
+}
+
+int BvhGetHeight(const struct Bvh *bvh) {
+    if (bvh == NULL || bvh->root == BVH_NULL_NODE) return 0;
+
+    return bvh->nodes[bvh->root].height;
+}
+
+int BvhIsValidProxy(const struct Bvh *bvh, int proxy) {
+    if (bvh == NULL || proxy < 0 || proxy >= bvh->capacity) return 0;
+
+    const struct BvhNode *node = &bvh->nodes[proxy];
+    return node->height == 0 && isLeaf(node);
+}
+
+/** Queries */
+struct TraversalStack {
+    int *items;
+    int size;
+    int capacity;
+    int local[BVH_STACK_SIZE];
+};
+
+static void stackInit(struct TraversalStack *stack) {
+    stack->items = stack->local;
+    stack->size = 0;
+    stack->capacity = BVH_STACK_SIZE;
+}
+
+static int stackPush(struct TraversalStack *stack, int value) {
+    if (stack->size == stack->capacity) {
+        int *newItems = malloc(sizeof(int) * stack->capacity * 2);
+        if (newItems == NULL) return 0;
+
+        memcpy(newItems, stack->items, sizeof(int) * stack->size);
+        if (stack->items != stack->local) free(stack->items);
+        stack->items = newItems;
+        stack->capacity *= 2;
+    }
+
+    stack->items[stack->size++] = value;
+    return 1;
+}
+
+static void stackRelease(struct TraversalStack *stack) {
+    if (stack->items != stack->local) free(stack->items);
+}
+
+// Returns 1 and the closest proxy hit along the ray within maxT, 0 if nothing was hit or -1 if out of memory
+int BvhRayCast(const struct Bvh *bvh, const float origin[VEC_3_SIZE], const float dir[VEC_3_SIZE], float maxT, int *outProxy, float *outT) {
+    if (bvh == NULL || origin == NULL || dir == NULL || bvh->root == BVH_NULL_NODE) return 0;
+
+    float invDir[VEC_3_SIZE] = {1.0f / dir[0], 1.0f / dir[1], 1.0f / dir[2]};
+    const struct BvhNode *n = bvh->nodes;
+    float bestT = maxT;
+    int bestProxy = BVH_NULL_NODE;
+
+    struct TraversalStack stack;
+    stackInit(&stack);
+    stackPush(&stack, bvh->root);
+
+    while (stack.size > 0) {
+        int index = stack.items[--stack.size];
+        float t = 0.0f;
+        if (!AabbRayIntersect(&t, queryBox(&n[index]), origin, invDir, bestT)) continue;
+
+        if (isLeaf(&n[index])) {
+            bestT = t;
+            bestProxy = index;
+            continue;
+        }
+
+        // visit the nearer child first so bestT shrinks as early as possible
+        float tLeft = FLT_MAX, tRight = FLT_MAX;
+        int hitLeft = AabbRayIntersect(&tLeft, n[n[index].left].aabb, origin, invDir, bestT);
+        int hitRight = AabbRayIntersect(&tRight, n[n[index].right].aabb, origin, invDir, bestT);
+        int nearChild = tLeft <= tRight ? n[index].left : n[index].right;
+        int farChild = nearChild == n[index].left ? n[index].right : n[index].left;
+        int hitNear = nearChild == n[index].left ? hitLeft : hitRight;
+        int hitFar = nearChild == n[index].left ? hitRight : hitLeft;
+
+        if ((hitFar && !stackPush(&stack, farChild)) || (hitNear && !stackPush(&stack, nearChild))) {
+            stackRelease(&stack);
+            return -1;
+        }
+    }
+    stackRelease(&stack);
+
+    if (bestProxy == BVH_NULL_NODE) return 0;
+
+    if (outProxy != NULL) (*outProxy) = bestProxy;
+    if (outT != NULL) (*outT) = bestT;
+    return 1;
+}
+
+// Writes up to capacity proxies whose AABB overlaps aabb, returns the total number of overlaps or -1 if out of memory
+int BvhQueryAabb(const struct Bvh *bvh, const float aabb[AABB_SIZE], int *outProxies, int capacity) {
+    if (bvh == NULL || aabb == NULL || bvh->root == BVH_NULL_NODE) return 0;
+
+    const struct BvhNode *n = bvh->nodes;
+    int found = 0;
+
+    struct TraversalStack stack;
+    stackInit(&stack);
+    stackPush(&stack, bvh->root);
+
+    while (stack.size > 0) {
+        int index = stack.items[--stack.size];
+        if (!AabbOverlaps(queryBox(&n[index]), aabb)) continue;
+
+        if (isLeaf(&n[index])) {
+            if (outProxies != NULL && found < capacity) outProxies[found] = index;
+            found++;
+            continue;
+        }
+
+        if (!stackPush(&stack, n[index].left) || !stackPush(&stack, n[index].right)) {
+            stackRelease(&stack);
+            return -1;
+        }
+    }
+    stackRelease(&stack);
+
+    return found;
+}
+
+// Same contract as BvhQueryAabb for proxies whose AABB comes within radius of center
+int BvhQuerySphere(const struct Bvh *bvh, const float center[VEC_3_SIZE], float radius, int *outProxies, int capacity) {
+    if (bvh == NULL || center == NULL || bvh->root == BVH_NULL_NODE) return 0;
+
+    const struct BvhNode *n = bvh->nodes;
+    float radiusSq = radius * radius;
+    int found = 0;
+
+    struct TraversalStack stack;
+    stackInit(&stack);
+    stackPush(&stack, bvh->root);
+
+    while (stack.size > 0) {
+        int index = stack.items[--stack.size];
+        if (AabbDistanceSquared(queryBox(&n[index]), center) > radiusSq) continue;
+
+        if (isLeaf(&n[index])) {
+            if (outProxies != NULL && found < capacity) outProxies[found] = index;
+            found++;
+            continue;
+        }
+
+        if (!stackPush(&stack, n[index].left) || !stackPush(&stack, n[index].right)) {
+            stackRelease(&stack);
+            return -1;
+        }
+    }
+    stackRelease(&stack);
+
+    return found;
+}
+
+struct HeapEntry {
+    float distSq;
+    int index;
+};
+
+static void heapPush(struct HeapEntry *heap, int *size, float distSq, int index) {
+    int i = (*size)++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap[parent].distSq <= distSq) break;
+
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i].distSq = distSq;
+    heap[i].index = index;
+}
+
+static struct HeapEntry heapPop(struct HeapEntry *heap, int *size) {
+    struct HeapEntry top = heap[0];
+    struct HeapEntry last = heap[--(*size)];
+
+    int i = 0;
+    while (1) {
+        int child = i * 2 + 1;
+        if (child >= *size) break;
+        if (child + 1 < *size && heap[child + 1].distSq < heap[child].distSq) child++;
+        if (last.distSq <= heap[child].distSq) break;
+
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (*size > 0) heap[i] = last;
+
+    return top;
+}
+
+// Best first search for the k proxies closest to p, sorted nearest first. Returns how many were found or -1.
+int BvhQueryNearest(const struct Bvh *bvh, const float p[VEC_3_SIZE], int k, int *outProxies, float *outDistSq) {
+    if (bvh == NULL || p == NULL || outProxies == NULL || k <= 0 || bvh->root == BVH_NULL_NODE) return 0;
+
+    // every node is pushed at most once, so the node count bounds the heap
+    struct HeapEntry *heap = malloc(sizeof(struct HeapEntry) * bvh->count);
+    if (heap == NULL) return -1;
+
+    const struct BvhNode *n = bvh->nodes;
+    int heapSize = 0;
+    int found = 0;
+    heapPush(heap, &heapSize, AabbDistanceSquared(queryBox(&n[bvh->root]), p), bvh->root);
+
+    while (heapSize > 0 && found < k) {
+        struct HeapEntry entry = heapPop(heap, &heapSize);
+
+        if (isLeaf(&n[entry.index])) {
+            outProxies[found] = entry.index;
+            if (outDistSq != NULL) outDistSq[found] = entry.distSq;
+            found++;
+            continue;
+        }
+
+        int left = n[entry.index].left;
+        int right = n[entry.index].right;
+        // leaves are pushed with their exact distance, internal nodes with a lower bound
+        heapPush(heap, &heapSize, AabbDistanceSquared(queryBox(&n[left]), p), left);
+        heapPush(heap, &heapSize, AabbDistanceSquared(queryBox(&n[right]), p), right);
+    }
+
+    free(heap);
+
+    return found;
+}
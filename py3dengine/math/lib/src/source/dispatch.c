@@ -0,0 +1,68 @@
+#include <string.h>
+
+#include "dispatch.h"
+
+static const char *tierNames[DISPATCH_TIER_COUNT] = {"scalar", "sse", "avx2", "avx512"};
+static enum DispatchTier currentTier = DISPATCH_TIER_SCALAR;
+
+enum DispatchTier DispatchDetectTier(void) {
+    for (int tier = DISPATCH_TIER_COUNT - 1; tier > DISPATCH_TIER_SCALAR; --tier) {
+        if (DispatchTierSupported(tier)) return tier;
+    }
+
+    return DISPATCH_TIER_SCALAR;
+}
+
+int DispatchTierSupported(enum DispatchTier tier) {
+    switch (tier) {
+        case DISPATCH_TIER_SCALAR:
+            return 1;
+#if DISPATCH_X86
+        case DISPATCH_TIER_SSE:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        case DISPATCH_TIER_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case DISPATCH_TIER_AVX512:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") &&
+                   __builtin_cpu_supports("fma");
+#endif
+        default:
+            return 0;
+    }
+}
+
+const char *DispatchTierName(enum DispatchTier tier) {
+    if (tier < 0 || tier >= DISPATCH_TIER_COUNT) return NULL;
+
+    return tierNames[tier];
+}
+
+int DispatchTierFromName(const char *name) {
+    if (name == NULL) return -1;
+
+    for (int tier = 0; tier < DISPATCH_TIER_COUNT; ++tier) {
+        if (strcmp(name, tierNames[tier]) == 0) return tier;
+    }
+
+    return -1;
+}
+
+int DispatchInit(enum DispatchTier tier) {
+    if (!DispatchTierSupported(tier)) return 0;
+
+    MatrixBindTier(tier);
+    QuaternionBindTier(tier);
+    FrustumBindTier(tier);
+    SkinningBindTier(tier);
+    RasterBindTier(tier);
+    currentTier = tier;
+
+    return 1;
+}
+
+enum DispatchTier DispatchCurrentTier(void) {
+    return currentTier;
+}
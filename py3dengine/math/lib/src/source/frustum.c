@@ -0,0 +1,390 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "frustum.h"
+#include "dispatch.h"
+
+#if DISPATCH_X86
+#include <immintrin.h>
+#endif
+
+#define PLANE_EPSILON 1e-12f
+
+static float planeDistance(const float plane[VEC_4_SIZE], float x, float y, float z) {
+    return plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+}
+
+#if DISPATCH_X86
+// Writes the base index of every set bit in mask without branching on the mask
+static int compactLanes(int *outIndices, int written, int base, int mask, int lanes) {
+    for (int lane = 0; lane < lanes; ++lane) {
+        outIndices[written] = base + lane;
+        written += (mask >> lane) & 1;
+    }
+
+    return written;
+}
+#endif
+
+void FrustumFromMatrix(float out[FRUSTUM_SIZE], const float viewProj[MAT_4_SIZE]) {
+    if (out == NULL || viewProj == NULL) return;
+
+    // With row vectors clip = v * M, so each clip component is the dot product of v with a column of M
+    for (int i = 0; i < VEC_4_SIZE; ++i) {
+        float x = viewProj[i * 4];
+        float y = viewProj[i * 4 + 1];
+        float z = viewProj[i * 4 + 2];
+        float w = viewProj[i * 4 + 3];
+
+        out[FRUSTUM_LEFT * 4 + i] = w + x;
+        out[FRUSTUM_RIGHT * 4 + i] = w - x;
+        out[FRUSTUM_BOTTOM * 4 + i] = w + y;
+        out[FRUSTUM_TOP * 4 + i] = w - y;
+        out[FRUSTUM_NEAR * 4 + i] = z;
+        out[FRUSTUM_FAR * 4 + i] = w - z;
+    }
+
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        float *plane = &out[p * 4];
+        float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+
+        if (length < PLANE_EPSILON) {
+            plane[0] = 0.0f;
+            plane[1] = 0.0f;
+            plane[2] = 0.0f;
+            plane[3] = 1.0f;
+            continue;
+        }
+
+        for (int i = 0; i < VEC_4_SIZE; ++i) {
+            plane[i] /= length;
+        }
+    }
+}
+
+int FrustumTestPoint(const float frustum[FRUSTUM_SIZE], const float p[VEC_3_SIZE]) {
+    return FrustumTestSphere(frustum, p, 0.0f);
+}
+
+int FrustumTestSphere(const float frustum[FRUSTUM_SIZE], const float center[VEC_3_SIZE], float radius) {
+    if (frustum == NULL || center == NULL) return 0;
+
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        if (planeDistance(&frustum[p * 4], center[0], center[1], center[2]) < -radius) return 0;
+    }
+
+    return 1;
+}
+
+// Tests the box corner furthest along each plane normal, which is the center pushed out by the projected extents
+int FrustumTestAabb(const float frustum[FRUSTUM_SIZE], const float min[VEC_3_SIZE], const float max[VEC_3_SIZE]) {
+    if (frustum == NULL || min == NULL || max == NULL) return 0;
+
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        const float *plane = &frustum[p * 4];
+        float x = plane[0] >= 0.0f ? max[0] : min[0];
+        float y = plane[1] >= 0.0f ? max[1] : min[1];
+        float z = plane[2] >= 0.0f ? max[2] : min[2];
+
+        if (planeDistance(plane, x, y, z) < 0.0f) return 0;
+    }
+
+    return 1;
+}
+
+/** Cull kernels, the vector ones leave the volumes that do not fill a register to the scalar ones */
+static int cullSpheresScalar(
+    int *outIndices,
+    int written,
+    const float frustum[FRUSTUM_SIZE],
+    const float *x, const float *y, const float *z, const float *radius,
+    int start,
+    int count
+) {
+    for (int i = start; i < count; ++i) {
+        float center[VEC_3_SIZE] = {x[i], y[i], z[i]};
+        if (FrustumTestSphere(frustum, center, radius[i])) {
+            outIndices[written++] = i;
+        }
+    }
+
+    return written;
+}
+
+static int cullAabbsScalar(
+    int *outIndices,
+    int written,
+    const float frustum[FRUSTUM_SIZE],
+    const float *minX, const float *minY, const float *minZ,
+    const float *maxX, const float *maxY, const float *maxZ,
+    int start,
+    int count
+) {
+    for (int i = start; i < count; ++i) {
+        float min[VEC_3_SIZE] = {minX[i], minY[i], minZ[i]};
+        float max[VEC_3_SIZE] = {maxX[i], maxY[i], maxZ[i]};
+        if (FrustumTestAabb(frustum, min, max)) {
+            outIndices[written++] = i;
+        }
+    }
+
+    return written;
+}
+
+static int cullSpheresScalarAll(
+    int *outIndices,
+    const float frustum[FRUSTUM_SIZE],
+    const float *x, const float *y, const float *z, const float *radius,
+    int count
+) {
+    return cullSpheresScalar(outIndices, 0, frustum, x, y, z, radius, 0, count);
+}
+
+static int cullAabbsScalarAll(
+    int *outIndices,
+    const float frustum[FRUSTUM_SIZE],
+    const float *minX, const float *minY, const float *minZ,
+    const float *maxX, const float *maxY, const float *maxZ,
+    int count
+) {
+    return cullAabbsScalar(outIndices, 0, frustum, minX, minY, minZ, maxX, maxY, maxZ, 0, count);
+}
+
+#if DISPATCH_X86
+DISPATCH_TARGET("sse2")
+static int cullSpheresSse(
+    int *outIndices,
+    const float frustum[FRUSTUM_SIZE],
+    const float *x, const float *y, const float *z, const float *radius,
+    int count
+) {
+    int written = 0;
+    int i = 0;
+
+    __m128 planes[FRUSTUM_SIZE];
+    for (int p = 0; p < FRUSTUM_SIZE; ++p) {
+        planes[p] = _mm_set1_ps(frustum[p]);
+    }
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(&x[i]);
+        __m128 py = _mm_loadu_ps(&y[i]);
+        __m128 pz = _mm_loadu_ps(&z[i]);
+        __m128 negR = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&radius[i]));
+        __m128 inside = _mm_cmpeq_ps(px, px);
+
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+            __m128 d = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(planes[p * 4], px), _mm_mul_ps(planes[p * 4 + 1], py)),
+                _mm_add_ps(_mm_mul_ps(planes[p * 4 + 2], pz), planes[p * 4 + 3])
+            );
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negR));
+        }
+
+        written = compactLanes(outIndices, written, i, _mm_movemask_ps(inside), 4);
+    }
+
+    return cullSpheresScalar(outIndices, written, frustum, x, y, z, radius, i, count);
+}
+
+// The vector kernels test the box center against each plane, pushed out by the extents projected on the normal
+DISPATCH_TARGET("sse2")
+static int cullAabbsSse(
+    int *outIndices,
+    const float frustum[FRUSTUM_SIZE],
+    const float *minX, const float *minY, const float *minZ,
+    const float *maxX, const float *maxY, const float *maxZ,
+    int count
+) {
+    int written = 0;
+    int i = 0;
+
+    __m128 planes[FRUSTUM_SIZE];
+    __m128 absNormals[FRUSTUM_PLANE_COUNT * 3];
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        for (int j = 0; j < 3; ++j) {
+            absNormals[p * 3 + j] = _mm_set1_ps(fabsf(frustum[p * 4 + j]));
+        }
+    }
+    for (int p = 0; p < FRUSTUM_SIZE; ++p) {
+        planes[p] = _mm_set1_ps(frustum[p]);
+    }
+
+    __m128 half = _mm_set1_ps(0.5f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 lowX = _mm_loadu_ps(&minX[i]), highX = _mm_loadu_ps(&maxX[i]);
+        __m128 lowY = _mm_loadu_ps(&minY[i]), highY = _mm_loadu_ps(&maxY[i]);
+        __m128 lowZ = _mm_loadu_ps(&minZ[i]), highZ = _mm_loadu_ps(&maxZ[i]);
+        __m128 cx = _mm_mul_ps(_mm_add_ps(lowX, highX), half);
+        __m128 cy = _mm_mul_ps(_mm_add_ps(lowY, highY), half);
+        __m128 cz = _mm_mul_ps(_mm_add_ps(lowZ, highZ), half);
+        __m128 ex = _mm_mul_ps(_mm_sub_ps(highX, lowX), half);
+        __m128 ey = _mm_mul_ps(_mm_sub_ps(highY, lowY), half);
+        __m128 ez = _mm_mul_ps(_mm_sub_ps(highZ, lowZ), half);
+        __m128 inside = _mm_cmpeq_ps(cx, cx);
+
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+            __m128 d = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(planes[p * 4], cx), _mm_mul_ps(planes[p * 4 + 1], cy)),
+                _mm_add_ps(_mm_mul_ps(planes[p * 4 + 2], cz), planes[p * 4 + 3])
+            );
+            __m128 r = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(absNormals[p * 3], ex), _mm_mul_ps(absNormals[p * 3 + 1], ey)),
+                _mm_mul_ps(absNormals[p * 3 + 2], ez)
+            );
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+        }
+
+        written = compactLanes(outIndices, written, i, _mm_movemask_ps(inside), 4);
+    }
+
+    return cullAabbsScalar(outIndices, written, frustum, minX, minY, minZ, maxX, maxY, maxZ, i, count);
+}
+
+DISPATCH_TARGET("avx2,fma")
+static int cullSpheresAvx2(
+    int *outIndices,
+    const float frustum[FRUSTUM_SIZE],
+    const float *x, const float *y, const float *z, const float *radius,
+    int count
+) {
+    int written = 0;
+    int i = 0;
+
+    __m256 planes[FRUSTUM_SIZE];
+    for (int p = 0; p < FRUSTUM_SIZE; ++p) {
+        planes[p] = _mm256_set1_ps(frustum[p]);
+    }
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_loadu_ps(&x[i]);
+        __m256 py = _mm256_loadu_ps(&y[i]);
+        __m256 pz = _mm256_loadu_ps(&z[i]);
+        __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&radius[i]));
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+            __m256 d = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(planes[p * 4], px), _mm256_mul_ps(planes[p * 4 + 1], py)),
+                _mm256_add_ps(_mm256_mul_ps(planes[p * 4 + 2], pz), planes[p * 4 + 3])
+            );
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negR, _CMP_GE_OQ));
+        }
+
+        written = compactLanes(outIndices, written, i, _mm256_movemask_ps(inside), 8);
+    }
+
+    return cullSpheresScalar(outIndices, written, frustum, x, y, z, radius, i, count);
+}
+
+DISPATCH_TARGET("avx2,fma")
+static int cullAabbsAvx2(
+    int *outIndices,
+    const float frustum[FRUSTUM_SIZE],
+    const float *minX, const float *minY, const float *minZ,
+    const float *maxX, const float *maxY, const float *maxZ,
+    int count
+) {
+    int written = 0;
+    int i = 0;
+
+    __m256 planes[FRUSTUM_SIZE];
+    __m256 absNormals[FRUSTUM_PLANE_COUNT * 3];
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+        for (int j = 0; j < 3; ++j) {
+            absNormals[p * 3 + j] = _mm256_set1_ps(fabsf(frustum[p * 4 + j]));
+        }
+    }
+    for (int p = 0; p < FRUSTUM_SIZE; ++p) {
+        planes[p] = _mm256_set1_ps(frustum[p]);
+    }
+
+    __m256 half = _mm256_set1_ps(0.5f);
+    for (; i + 8 <= count; i += 8) {
+        __m256 lowX = _mm256_loadu_ps(&minX[i]), highX = _mm256_loadu_ps(&maxX[i]);
+        __m256 lowY = _mm256_loadu_ps(&minY[i]), highY = _mm256_loadu_ps(&maxY[i]);
+        __m256 lowZ = _mm256_loadu_ps(&minZ[i]), highZ = _mm256_loadu_ps(&maxZ[i]);
+        __m256 cx = _mm256_mul_ps(_mm256_add_ps(lowX, highX), half);
+        __m256 cy = _mm256_mul_ps(_mm256_add_ps(lowY, highY), half);
+        __m256 cz = _mm256_mul_ps(_mm256_add_ps(lowZ, highZ), half);
+        __m256 ex = _mm256_mul_ps(_mm256_sub_ps(highX, lowX), half);
+        __m256 ey = _mm256_mul_ps(_mm256_sub_ps(highY, lowY), half);
+        __m256 ez = _mm256_mul_ps(_mm256_sub_ps(highZ, lowZ), half);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; ++p) {
+            __m256 d = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(planes[p * 4], cx), _mm256_mul_ps(planes[p * 4 + 1], cy)),
+                _mm256_add_ps(_mm256_mul_ps(planes[p * 4 + 2], cz), planes[p * 4 + 3])
+            );
+            __m256 r = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(absNormals[p * 3], ex), _mm256_mul_ps(absNormals[p * 3 + 1], ey)),
+                _mm256_mul_ps(absNormals[p * 3 + 2], ez)
+            );
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(d, r), _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        written = compactLanes(outIndices, written, i, _mm256_movemask_ps(inside), 8);
+    }
+
+    return cullAabbsScalar(outIndices, written, frustum, minX, minY, minZ, maxX, maxY, maxZ, i, count);
+}
+#endif
+
+static int (*cullSpheres)(
+    int *, const float *, const float *, const float *, const float *, const float *, int
+) = cullSpheresScalarAll;
+static int (*cullAabbs)(
+    int *, const float *, const float *, const float *, const float *, const float *, const float *, const float *, int
+) = cullAabbsScalarAll;
+
+int FrustumCullSpheres(
+    int *outIndices,
+    const float frustum[FRUSTUM_SIZE],
+    const float *x, const float *y, const float *z, const float *radius,
+    int count
+) {
+    if (outIndices == NULL || frustum == NULL || x == NULL || y == NULL || z == NULL || radius == NULL) return 0;
+
+    return cullSpheres(outIndices, frustum, x, y, z, radius, count);
+}
+
+int FrustumCullAabbs(
+    int *outIndices,
+    const float frustum[FRUSTUM_SIZE],
+    const float *minX, const float *minY, const float *minZ,
+    const float *maxX, const float *maxY, const float *maxZ,
+    int count
+) {
+    if (
+        outIndices == NULL || frustum == NULL ||
+        minX == NULL || minY == NULL || minZ == NULL ||
+        maxX == NULL || maxY == NULL || maxZ == NULL
+    ) return 0;
+
+    return cullAabbs(outIndices, frustum, minX, minY, minZ, maxX, maxY, maxZ, count);
+}
+
+// AVX-512 has no cull kernels of its own, the 8 lane AVX2 ones are used
+void FrustumBindTier(enum DispatchTier tier) {
+    cullSpheres = cullSpheresScalarAll;
+    cullAabbs = cullAabbsScalarAll;
+
+#if DISPATCH_X86
+    switch (tier) {
+        case DISPATCH_TIER_AVX512:
+        case DISPATCH_TIER_AVX2:
+            cullSpheres = cullSpheresAvx2;
+            cullAabbs = cullAabbsAvx2;
+            break;
+        case DISPATCH_TIER_SSE:
+            cullSpheres = cullSpheresSse;
+            cullAabbs = cullAabbsSse;
+            break;
+        default:
+            break;
+    }
+#else
+    (void) tier;
+#endif
+}
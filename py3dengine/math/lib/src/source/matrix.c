@@ -6,6 +6,12 @@
 #include "vector.h"
 #include "quaternion.h"
 #include "matrix.h"
+#include "profiler.h"
+#include "dispatch.h"
+
+#if DISPATCH_X86
+#include <immintrin.h>
+#endif
 
 void Mat3Identity(float out[MAT_3_SIZE]) {
     if (out == NULL) return;
@@ -215,6 +221,56 @@ void Mat4RotationQuaternionFA(float out[MAT_4_SIZE], const float q[QUATERNION_SI
     out[10] = 1.0f - (xx + yy);
 }
 
+// Inverse of Mat4RotationQuaternionFA, any scale is divided out of the rotation rows first.
+// Shepperd's method: solve for the largest component so the division is well conditioned.
+void Mat4ToQuaternion(float out[QUATERNION_SIZE], const float m[MAT_4_SIZE]) {
+    if (out == NULL || m == NULL) return;
+
+    float r[MAT_3_SIZE];
+    for (int row = 0; row < 3; ++row) {
+        float len = sqrtf(m[row * 4] * m[row * 4] + m[row * 4 + 1] * m[row * 4 + 1] + m[row * 4 + 2] * m[row * 4 + 2]);
+        if (len == 0.0f) {
+            QuaternionIdentity(out);
+            return;
+        }
+
+        for (int col = 0; col < 3; ++col) {
+            r[row * 3 + col] = m[row * 4 + col] / len;
+        }
+    }
+
+    float trace = r[0] + r[4] + r[8];
+    float q[QUATERNION_SIZE];
+
+    if (trace > 0.0f) {
+        float s = sqrtf(trace + 1.0f) * 2.0f;
+        q[3] = 0.25f * s;
+        q[0] = (r[5] - r[7]) / s;
+        q[1] = (r[6] - r[2]) / s;
+        q[2] = (r[1] - r[3]) / s;
+    } else if (r[0] > r[4] && r[0] > r[8]) {
+        float s = sqrtf(1.0f + r[0] - r[4] - r[8]) * 2.0f;
+        q[3] = (r[5] - r[7]) / s;
+        q[0] = 0.25f * s;
+        q[1] = (r[3] + r[1]) / s;
+        q[2] = (r[6] + r[2]) / s;
+    } else if (r[4] > r[8]) {
+        float s = sqrtf(1.0f + r[4] - r[0] - r[8]) * 2.0f;
+        q[3] = (r[6] - r[2]) / s;
+        q[0] = (r[3] + r[1]) / s;
+        q[1] = 0.25f * s;
+        q[2] = (r[7] + r[5]) / s;
+    } else {
+        float s = sqrtf(1.0f + r[8] - r[0] - r[4]) * 2.0f;
+        q[3] = (r[1] - r[3]) / s;
+        q[0] = (r[6] + r[2]) / s;
+        q[1] = (r[7] + r[5]) / s;
+        q[2] = 0.25f * s;
+    }
+
+    QuaternionNormalize(out, q);
+}
+
 void Mat4ScalingF(float out[MAT_4_SIZE], float x, float y, float z) {
     if (out == NULL) return;
 
@@ -234,10 +290,8 @@ void Mat4ScalingFA(float out[MAT_4_SIZE], const float v[VEC_3_SIZE]) {
 }
 
 // non gsl version
-void Mat4Mult(float out[MAT_4_SIZE], const float m1[MAT_4_SIZE], const float m2[MAT_4_SIZE]) {
-    float temp[MAT_4_SIZE] = {0.0f};
-
-    if (out == NULL || m1 == NULL || m2 == NULL) return;
+static void mat4MultScalar(float out[MAT_4_SIZE], const float m1[MAT_4_SIZE], const float m2[MAT_4_SIZE]) {
+    float temp[MAT_4_SIZE];
 
     temp[0] = (m1[0] * m2[0]) + (m1[1] * m2[4]) + (m1[2] * m2[8]) + (m1[3] * m2[12]);
     temp[1] = (m1[0] * m2[1]) + (m1[1] * m2[5]) + (m1[2] * m2[9]) + (m1[3] * m2[13]);
@@ -262,12 +316,153 @@ void Mat4Mult(float out[MAT_4_SIZE], const float m1[MAT_4_SIZE], const float m2[
     Mat4Copy(out, temp);
 }
 
+static void mat4MultBatchScalar(float *out, const float *worlds, const float viewProj[MAT_4_SIZE], int count) {
+    for (int r = 0; r < count * 4; ++r) {
+        float row[VEC_4_SIZE] = {worlds[r * 4], worlds[r * 4 + 1], worlds[r * 4 + 2], worlds[r * 4 + 3]};
+
+        for (int c = 0; c < VEC_4_SIZE; ++c) {
+            out[r * 4 + c] = row[0] * viewProj[c] + row[1] * viewProj[4 + c] +
+                             row[2] * viewProj[8 + c] + row[3] * viewProj[12 + c];
+        }
+    }
+}
+
+#if DISPATCH_X86
+// Every output row is the matching row of the left matrix times the right one, so the right matrix rows are kept in
+// registers and every left row becomes 4 broadcasts and multiply adds. Rows are read before any is written, so out
+// may alias either input.
+DISPATCH_TARGET("sse2")
+static inline __m128 mat4RowSse(__m128 row, __m128 m0, __m128 m1, __m128 m2, __m128 m3) {
+    __m128 result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), m0);
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), m1));
+    result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), m2));
+    return _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), m3));
+}
+
+DISPATCH_TARGET("sse2")
+static void mat4MultSse(float out[MAT_4_SIZE], const float m1[MAT_4_SIZE], const float m2[MAT_4_SIZE]) {
+    __m128 b0 = _mm_loadu_ps(&m2[0]);
+    __m128 b1 = _mm_loadu_ps(&m2[4]);
+    __m128 b2 = _mm_loadu_ps(&m2[8]);
+    __m128 b3 = _mm_loadu_ps(&m2[12]);
+
+    __m128 r0 = mat4RowSse(_mm_loadu_ps(&m1[0]), b0, b1, b2, b3);
+    __m128 r1 = mat4RowSse(_mm_loadu_ps(&m1[4]), b0, b1, b2, b3);
+    __m128 r2 = mat4RowSse(_mm_loadu_ps(&m1[8]), b0, b1, b2, b3);
+    __m128 r3 = mat4RowSse(_mm_loadu_ps(&m1[12]), b0, b1, b2, b3);
+
+    _mm_storeu_ps(&out[0], r0);
+    _mm_storeu_ps(&out[4], r1);
+    _mm_storeu_ps(&out[8], r2);
+    _mm_storeu_ps(&out[12], r3);
+}
+
+DISPATCH_TARGET("sse2")
+static void mat4MultBatchSse(float *out, const float *worlds, const float viewProj[MAT_4_SIZE], int count) {
+    __m128 vp0 = _mm_loadu_ps(&viewProj[0]);
+    __m128 vp1 = _mm_loadu_ps(&viewProj[4]);
+    __m128 vp2 = _mm_loadu_ps(&viewProj[8]);
+    __m128 vp3 = _mm_loadu_ps(&viewProj[12]);
+
+    for (int r = 0; r < count * 4; ++r) {
+        _mm_storeu_ps(&out[r * 4], mat4RowSse(_mm_loadu_ps(&worlds[r * 4]), vp0, vp1, vp2, vp3));
+    }
+}
+
+// Two rows per register with each right matrix row duplicated in both 128 bit lanes, the in lane permutes broadcast
+// the element of the row held by that lane
+DISPATCH_TARGET("avx2,fma")
+static inline __m256 mat4RowPairAvx2(__m256 rows, __m256 m0, __m256 m1, __m256 m2, __m256 m3) {
+    __m256 result = _mm256_mul_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(0, 0, 0, 0)), m0);
+    result = _mm256_fmadd_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(1, 1, 1, 1)), m1, result);
+    result = _mm256_fmadd_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(2, 2, 2, 2)), m2, result);
+    return _mm256_fmadd_ps(_mm256_permute_ps(rows, _MM_SHUFFLE(3, 3, 3, 3)), m3, result);
+}
+
+DISPATCH_TARGET("avx2,fma")
+static void mat4MultAvx2(float out[MAT_4_SIZE], const float m1[MAT_4_SIZE], const float m2[MAT_4_SIZE]) {
+    __m256 b0 = _mm256_broadcast_ps((const __m128 *) &m2[0]);
+    __m256 b1 = _mm256_broadcast_ps((const __m128 *) &m2[4]);
+    __m256 b2 = _mm256_broadcast_ps((const __m128 *) &m2[8]);
+    __m256 b3 = _mm256_broadcast_ps((const __m128 *) &m2[12]);
+
+    __m256 r01 = mat4RowPairAvx2(_mm256_loadu_ps(&m1[0]), b0, b1, b2, b3);
+    __m256 r23 = mat4RowPairAvx2(_mm256_loadu_ps(&m1[8]), b0, b1, b2, b3);
+
+    _mm256_storeu_ps(&out[0], r01);
+    _mm256_storeu_ps(&out[8], r23);
+}
+
+DISPATCH_TARGET("avx2,fma")
+static void mat4MultBatchAvx2(float *out, const float *worlds, const float viewProj[MAT_4_SIZE], int count) {
+    __m256 vp0 = _mm256_broadcast_ps((const __m128 *) &viewProj[0]);
+    __m256 vp1 = _mm256_broadcast_ps((const __m128 *) &viewProj[4]);
+    __m256 vp2 = _mm256_broadcast_ps((const __m128 *) &viewProj[8]);
+    __m256 vp3 = _mm256_broadcast_ps((const __m128 *) &viewProj[12]);
+
+    // Matrices have 4 rows, so the row count is always even
+    for (int r = 0; r < count * 4; r += 2) {
+        _mm256_storeu_ps(&out[r * 4], mat4RowPairAvx2(_mm256_loadu_ps(&worlds[r * 4]), vp0, vp1, vp2, vp3));
+    }
+}
+
+// A whole matrix per register with each right matrix row duplicated in all four 128 bit lanes
+DISPATCH_TARGET("avx512f")
+static inline __m512 mat4RowsAvx512(__m512 rows, __m512 m0, __m512 m1, __m512 m2, __m512 m3) {
+    __m512 result = _mm512_mul_ps(_mm512_permute_ps(rows, _MM_SHUFFLE(0, 0, 0, 0)), m0);
+    result = _mm512_fmadd_ps(_mm512_permute_ps(rows, _MM_SHUFFLE(1, 1, 1, 1)), m1, result);
+    result = _mm512_fmadd_ps(_mm512_permute_ps(rows, _MM_SHUFFLE(2, 2, 2, 2)), m2, result);
+    return _mm512_fmadd_ps(_mm512_permute_ps(rows, _MM_SHUFFLE(3, 3, 3, 3)), m3, result);
+}
+
+DISPATCH_TARGET("avx512f")
+static void mat4MultAvx512(float out[MAT_4_SIZE], const float m1[MAT_4_SIZE], const float m2[MAT_4_SIZE]) {
+    __m512 b0 = _mm512_broadcast_f32x4(_mm_loadu_ps(&m2[0]));
+    __m512 b1 = _mm512_broadcast_f32x4(_mm_loadu_ps(&m2[4]));
+    __m512 b2 = _mm512_broadcast_f32x4(_mm_loadu_ps(&m2[8]));
+    __m512 b3 = _mm512_broadcast_f32x4(_mm_loadu_ps(&m2[12]));
+
+    _mm512_storeu_ps(out, mat4RowsAvx512(_mm512_loadu_ps(m1), b0, b1, b2, b3));
+}
+
+DISPATCH_TARGET("avx512f")
+static void mat4MultBatchAvx512(float *out, const float *worlds, const float viewProj[MAT_4_SIZE], int count) {
+    __m512 vp0 = _mm512_broadcast_f32x4(_mm_loadu_ps(&viewProj[0]));
+    __m512 vp1 = _mm512_broadcast_f32x4(_mm_loadu_ps(&viewProj[4]));
+    __m512 vp2 = _mm512_broadcast_f32x4(_mm_loadu_ps(&viewProj[8]));
+    __m512 vp3 = _mm512_broadcast_f32x4(_mm_loadu_ps(&viewProj[12]));
+
+    for (int i = 0; i < count; ++i) {
+        _mm512_storeu_ps(&out[i * 16], mat4RowsAvx512(_mm512_loadu_ps(&worlds[i * 16]), vp0, vp1, vp2, vp3));
+    }
+}
+#endif
+
+static void (*mat4Mult)(float *, const float *, const float *) = mat4MultScalar;
+static void (*mat4MultBatch)(float *, const float *, const float *, int) = mat4MultBatchScalar;
+
+void Mat4Mult(float out[MAT_4_SIZE], const float m1[MAT_4_SIZE], const float m2[MAT_4_SIZE]) {
+    if (out == NULL || m1 == NULL || m2 == NULL) return;
+
+    mat4Mult(out, m1, m2);
+}
+
+// out may alias worlds
+void Mat4MultBatch(float *out, const float *worlds, const float viewProj[MAT_4_SIZE], int count) {
+    if (out == NULL || worlds == NULL || viewProj == NULL || count <= 0) return;
+
+    PROFILE_ZONE_BEGIN("Mat4MultBatch");
+    mat4MultBatch(out, worlds, viewProj, count);
+    PROFILE_ZONE_END("Mat4MultBatch");
+}
+
 // lifted this from:
 //http://stackoverflow.com/questions/1148309/inverting-a-4x4-matrix
 // seems to be a copy of bool gluInvertMatrix(const double m[16], double invOut[16])
-int Mat4Inverse(float out[MAT_4_SIZE], const float m[MAT_4_SIZE]) {
+// The expansion has no vector kernel of its own, the AVX2 variant is the same source compiled with AVX2 and FMA
+static inline __attribute__((always_inline))
+int mat4InverseExpansion(float out[MAT_4_SIZE], const float m[MAT_4_SIZE]) {
     float inv[MAT_4_SIZE], det;
-    Mat4Fill(inv, 0.0f);
 
     inv[0] = m[5] * m[10] * m[15] -
              m[5] * m[11] * m[14] -
@@ -394,6 +589,52 @@ int Mat4Inverse(float out[MAT_4_SIZE], const float m[MAT_4_SIZE]) {
     return 1;
 }
 
+static int mat4InverseScalar(float out[MAT_4_SIZE], const float m[MAT_4_SIZE]) {
+    return mat4InverseExpansion(out, m);
+}
+
+#if DISPATCH_X86
+DISPATCH_TARGET("avx2,fma")
+static int mat4InverseAvx2(float out[MAT_4_SIZE], const float m[MAT_4_SIZE]) {
+    return mat4InverseExpansion(out, m);
+}
+#endif
+
+static int (*mat4Inverse)(float *, const float *) = mat4InverseScalar;
+
+int Mat4Inverse(float out[MAT_4_SIZE], const float m[MAT_4_SIZE]) {
+    return mat4Inverse(out, m);
+}
+
+void MatrixBindTier(enum DispatchTier tier) {
+    mat4Mult = mat4MultScalar;
+    mat4MultBatch = mat4MultBatchScalar;
+    mat4Inverse = mat4InverseScalar;
+
+#if DISPATCH_X86
+    switch (tier) {
+        case DISPATCH_TIER_AVX512:
+            mat4Mult = mat4MultAvx512;
+            mat4MultBatch = mat4MultBatchAvx512;
+            mat4Inverse = mat4InverseAvx2;
+            break;
+        case DISPATCH_TIER_AVX2:
+            mat4Mult = mat4MultAvx2;
+            mat4MultBatch = mat4MultBatchAvx2;
+            mat4Inverse = mat4InverseAvx2;
+            break;
+        case DISPATCH_TIER_SSE:
+            mat4Mult = mat4MultSse;
+            mat4MultBatch = mat4MultBatchSse;
+            break;
+        default:
+            break;
+    }
+#else
+    (void) tier;
+#endif
+}
+
 void Mat4Vec4Mult(float out[VEC_4_SIZE], const float m[MAT_4_SIZE], const float v[VEC_4_SIZE]) {
     if (out == NULL || m == NULL || v == NULL) return;
 
@@ -460,3 +701,86 @@ void Mat4LookAtLH(
     Vec3Dot(&out[14], negCamPosW, look);
     out[15] = 1.0f;
 }
+
+void Mat4LookAtRH(
+    float out[MAT_4_SIZE],
+    const float camPosW[VEC_3_SIZE],
+    const float camTargetW[VEC_3_SIZE],
+    const float camUpW[VEC_3_SIZE]
+) {
+    if (
+        out == NULL ||
+        camPosW == NULL ||
+        camTargetW == NULL ||
+        camUpW == NULL
+    ) return;
+
+    // A right handed camera looks down its -z axis, which is the same as a left handed one looking away from target
+    float mirroredTargetW[VEC_3_SIZE] = {0.0f};
+    Vec3Subtract(mirroredTargetW, camPosW, camTargetW);
+    Vec3Add(mirroredTargetW, mirroredTargetW, camPosW);
+
+    Mat4LookAtLH(out, camPosW, mirroredTargetW, camUpW);
+}
+
+static void perspectiveScale(float out[MAT_4_SIZE], float fovY, float aspect) {
+    float yScale = 1.0f / tanf(DEG_TO_RAD(fovY) * 0.5f);
+
+    Mat4Fill(out, 0.0f);
+    out[0] = yScale / aspect;
+    out[5] = yScale;
+}
+
+void Mat4PerspectiveFovLH(float out[MAT_4_SIZE], float fovY, float aspect, float nearZ, float farZ) {
+    if (out == NULL) return;
+
+    perspectiveScale(out, fovY, aspect);
+    out[10] = farZ / (farZ - nearZ);
+    out[11] = 1.0f;
+    out[14] = -nearZ * farZ / (farZ - nearZ);
+}
+
+void Mat4PerspectiveFovRH(float out[MAT_4_SIZE], float fovY, float aspect, float nearZ, float farZ) {
+    if (out == NULL) return;
+
+    perspectiveScale(out, fovY, aspect);
+    out[10] = farZ / (nearZ - farZ);
+    out[11] = -1.0f;
+    out[14] = nearZ * farZ / (nearZ - farZ);
+}
+
+void Mat4PerspectiveInfiniteReverseZLH(float out[MAT_4_SIZE], float fovY, float aspect, float nearZ) {
+    if (out == NULL) return;
+
+    perspectiveScale(out, fovY, aspect);
+    out[11] = 1.0f;
+    out[14] = nearZ;
+}
+
+void Mat4PerspectiveInfiniteReverseZRH(float out[MAT_4_SIZE], float fovY, float aspect, float nearZ) {
+    if (out == NULL) return;
+
+    perspectiveScale(out, fovY, aspect);
+    out[11] = -1.0f;
+    out[14] = nearZ;
+}
+
+void Mat4OrthographicLH(float out[MAT_4_SIZE], float width, float height, float nearZ, float farZ) {
+    if (out == NULL) return;
+
+    Mat4Identity(out);
+    out[0] = 2.0f / width;
+    out[5] = 2.0f / height;
+    out[10] = 1.0f / (farZ - nearZ);
+    out[14] = nearZ / (nearZ - farZ);
+}
+
+void Mat4OrthographicRH(float out[MAT_4_SIZE], float width, float height, float nearZ, float farZ) {
+    if (out == NULL) return;
+
+    Mat4Identity(out);
+    out[0] = 2.0f / width;
+    out[5] = 2.0f / height;
+    out[10] = 1.0f / (nearZ - farZ);
+    out[14] = nearZ / (nearZ - farZ);
+}
@@ -0,0 +1,73 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "parallel.h"
+
+#define PARALLEL_MAX_THREADS 64
+
+struct ParallelRange {
+    ParallelRangeFn fn;
+    void *context;
+    int begin;
+    int end;
+};
+
+static void *runRange(void *arg) {
+    struct ParallelRange *range = arg;
+    range->fn(range->context, range->begin, range->end);
+
+    return NULL;
+}
+
+int ParallelHardwareThreads(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return 1;
+    if (cpus > PARALLEL_MAX_THREADS) return PARALLEL_MAX_THREADS;
+
+    return (int) cpus;
+}
+
+int ParallelFor(int count, int minRange, int threadCount, ParallelRangeFn fn, void *context) {
+    if (fn == NULL || count <= 0) return 1;
+    if (minRange < 1) minRange = 1;
+    if (threadCount <= 0) threadCount = ParallelHardwareThreads();
+    if (threadCount > PARALLEL_MAX_THREADS) threadCount = PARALLEL_MAX_THREADS;
+
+    int rangeCount = (count + minRange - 1) / minRange;
+    if (rangeCount > threadCount) rangeCount = threadCount;
+
+    if (rangeCount <= 1) {
+        fn(context, 0, count);
+        return 1;
+    }
+
+    struct ParallelRange ranges[PARALLEL_MAX_THREADS];
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    int started[PARALLEL_MAX_THREADS] = {0};
+    int success = 1;
+
+    for (int i = 0; i < rangeCount; ++i) {
+        ranges[i].fn = fn;
+        ranges[i].context = context;
+        ranges[i].begin = (int) ((long long) count * i / rangeCount);
+        ranges[i].end = (int) ((long long) count * (i + 1) / rangeCount);
+    }
+
+    for (int i = 1; i < rangeCount; ++i) {
+        started[i] = pthread_create(&threads[i], NULL, runRange, &ranges[i]) == 0;
+    }
+
+    runRange(&ranges[0]);
+
+    for (int i = 1; i < rangeCount; ++i) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            success = 0;
+            runRange(&ranges[i]);
+        }
+    }
+
+    return success;
+}
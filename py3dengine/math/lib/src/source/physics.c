@@ -0,0 +1,896 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "physics.h"
+#include "mathinline.h"
+
+#define PHYSICS_EPSILON 1e-6f
+#define PHYSICS_LINEAR_SLOP 0.005f
+#define PHYSICS_BAUMGARTE 0.2f
+#define PHYSICS_RESTITUTION_THRESHOLD 1.0f
+#define PHYSICS_CAPSULE_SEARCH_STEPS 24
+
+/** Small vector helpers, kept local so the inner loops do not pay for the NULL checks of the public functions */
+static float dot3(const float a[VEC_3_SIZE], const float b[VEC_3_SIZE]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static void cross3(float out[VEC_3_SIZE], const float a[VEC_3_SIZE], const float b[VEC_3_SIZE]) {
+    float x = a[1] * b[2] - a[2] * b[1];
+    float y = a[2] * b[0] - a[0] * b[2];
+    float z = a[0] * b[1] - a[1] * b[0];
+
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+}
+
+// out = a + b * scale
+static void madd3(float out[VEC_3_SIZE], const float a[VEC_3_SIZE], const float b[VEC_3_SIZE], float scale) {
+    out[0] = a[0] + b[0] * scale;
+    out[1] = a[1] + b[1] * scale;
+    out[2] = a[2] + b[2] * scale;
+}
+
+static void sub3(float out[VEC_3_SIZE], const float a[VEC_3_SIZE], const float b[VEC_3_SIZE]) {
+    out[0] = a[0] - b[0];
+    out[1] = a[1] - b[1];
+    out[2] = a[2] - b[2];
+}
+
+static void mat3Mult(float out[VEC_3_SIZE], const float m[9], const float v[VEC_3_SIZE]) {
+    float x = m[0] * v[0] + m[1] * v[1] + m[2] * v[2];
+    float y = m[3] * v[0] + m[4] * v[1] + m[5] * v[2];
+    float z = m[6] * v[0] + m[7] * v[1] + m[8] * v[2];
+
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+}
+
+static void mat3TransposeMult(float out[VEC_3_SIZE], const float m[9], const float v[VEC_3_SIZE]) {
+    float x = m[0] * v[0] + m[3] * v[1] + m[6] * v[2];
+    float y = m[1] * v[0] + m[4] * v[1] + m[7] * v[2];
+    float z = m[2] * v[0] + m[5] * v[1] + m[8] * v[2];
+
+    out[0] = x;
+    out[1] = y;
+    out[2] = z;
+}
+
+// Column i of a row major rotation is the world direction of the body's local axis i
+static void axis3(float out[VEC_3_SIZE], const float m[9], int i) {
+    out[0] = m[i];
+    out[1] = m[3 + i];
+    out[2] = m[6 + i];
+}
+
+/** Bodies */
+static void updateDerived(struct PhysicsBody *body) {
+    const float *q = body->orientation;
+    float xx = q[0] * q[0], yy = q[1] * q[1], zz = q[2] * q[2];
+    float xy = q[0] * q[1], xz = q[0] * q[2], yz = q[1] * q[2];
+    float wx = q[3] * q[0], wy = q[3] * q[1], wz = q[3] * q[2];
+    float *r = body->rotation;
+
+    r[0] = 1.0f - 2.0f * (yy + zz);
+    r[1] = 2.0f * (xy - wz);
+    r[2] = 2.0f * (xz + wy);
+    r[3] = 2.0f * (xy + wz);
+    r[4] = 1.0f - 2.0f * (xx + zz);
+    r[5] = 2.0f * (yz - wx);
+    r[6] = 2.0f * (xz - wy);
+    r[7] = 2.0f * (yz + wx);
+    r[8] = 1.0f - 2.0f * (xx + yy);
+
+    // R * diag(invInertiaLocal) * R^T
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            float sum = 0.0f;
+            for (int k = 0; k < 3; ++k) {
+                sum += r[i * 3 + k] * body->invInertiaLocal[k] * r[j * 3 + k];
+            }
+            body->invInertiaWorld[i * 3 + j] = sum;
+        }
+    }
+
+    float extents[VEC_3_SIZE];
+    const float *size = body->size;
+    switch (body->shape) {
+        case PHYSICS_SHAPE_BOX:
+            for (int i = 0; i < 3; ++i) {
+                extents[i] = fabsf(r[i * 3]) * size[0] + fabsf(r[i * 3 + 1]) * size[1] + fabsf(r[i * 3 + 2]) * size[2];
+            }
+            break;
+        case PHYSICS_SHAPE_CAPSULE:
+            for (int i = 0; i < 3; ++i) {
+                extents[i] = fabsf(r[i * 3 + 1]) * size[1] + size[0];
+            }
+            break;
+        default:
+            Vec3Fill(extents, size[0]);
+            break;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        body->aabb[i] = body->position[i] - extents[i];
+        body->aabb[i + 3] = body->position[i] + extents[i];
+    }
+}
+
+static void computeInverseInertia(float out[VEC_3_SIZE], int shape, const float size[VEC_3_SIZE], float mass) {
+    float inertia[VEC_3_SIZE];
+
+    switch (shape) {
+        case PHYSICS_SHAPE_BOX:
+            inertia[0] = mass / 3.0f * (size[1] * size[1] + size[2] * size[2]);
+            inertia[1] = mass / 3.0f * (size[0] * size[0] + size[2] * size[2]);
+            inertia[2] = mass / 3.0f * (size[0] * size[0] + size[1] * size[1]);
+            break;
+        case PHYSICS_SHAPE_CAPSULE: {
+            // Approximated as a solid cylinder covering the whole capsule
+            float radiusSq = size[0] * size[0];
+            float length = 2.0f * (size[1] + size[0]);
+            inertia[0] = mass * (3.0f * radiusSq + length * length) / 12.0f;
+            inertia[1] = mass * radiusSq * 0.5f;
+            inertia[2] = inertia[0];
+            break;
+        }
+        default:
+            Vec3Fill(inertia, 0.4f * mass * size[0] * size[0]);
+            break;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        out[i] = inertia[i] > 0.0f ? 1.0f / inertia[i] : 0.0f;
+    }
+}
+
+static int growBodies(struct PhysicsWorld *world) {
+    int capacity = world->capacity > 0 ? world->capacity * 2 : 64;
+
+    struct PhysicsBody *bodies = realloc(world->bodies, sizeof(struct PhysicsBody) * capacity);
+    if (bodies == NULL) return 0;
+    world->bodies = bodies;
+
+    int *freeSlots = realloc(world->freeSlots, sizeof(int) * capacity);
+    if (freeSlots == NULL) return 0;
+    world->freeSlots = freeSlots;
+
+    world->capacity = capacity;
+    return 1;
+}
+
+int PhysicsWorldInit(struct PhysicsWorld *world, const float gravity[VEC_3_SIZE]) {
+    if (world == NULL || gravity == NULL) return 0;
+
+    memset(world, 0, sizeof(struct PhysicsWorld));
+    Vec3Copy(world->gravity, gravity);
+    world->iterations = PHYSICS_DEFAULT_ITERATIONS;
+    SapInit(&world->broadphase);
+
+    return 1;
+}
+
+void PhysicsWorldRelease(struct PhysicsWorld *world) {
+    if (world == NULL) return;
+
+    free(world->bodies);
+    free(world->freeSlots);
+    SapRelease(&world->broadphase);
+    free(world->contacts);
+    free(world->previousContacts);
+    memset(world, 0, sizeof(struct PhysicsWorld));
+}
+
+int PhysicsAddBody(
+    struct PhysicsWorld *world,
+    int shape,
+    const float size[VEC_3_SIZE],
+    float mass,
+    const float position[VEC_3_SIZE],
+    const float orientation[QUATERNION_SIZE]
+) {
+    if (world == NULL || size == NULL || position == NULL || orientation == NULL) return -1;
+    if (shape < PHYSICS_SHAPE_SPHERE || shape > PHYSICS_SHAPE_CAPSULE) return -1;
+
+    int id;
+    if (world->freeCount > 0) {
+        id = world->freeSlots[--world->freeCount];
+    } else {
+        if (world->bodyCount == world->capacity && !growBodies(world)) return -1;
+        id = world->bodyCount++;
+    }
+
+    struct PhysicsBody *body = &world->bodies[id];
+    memset(body, 0, sizeof(struct PhysicsBody));
+    body->shape = shape;
+    Vec3Copy(body->size, size);
+    Vec3Copy(body->position, position);
+    QuaternionNormalize(body->orientation, orientation);
+    body->friction = 0.5f;
+    body->active = 1;
+
+    if (mass > 0.0f) {
+        body->invMass = 1.0f / mass;
+        computeInverseInertia(body->invInertiaLocal, shape, size, mass);
+    }
+    updateDerived(body);
+
+    body->proxy = SapAddProxy(&world->broadphase, body->aabb, id);
+    if (body->proxy == SAP_NULL_PROXY) {
+        body->active = 0;
+        world->freeSlots[world->freeCount++] = id;
+        return -1;
+    }
+
+    world->activeCount++;
+
+    return id;
+}
+
+int PhysicsIsValidBody(const struct PhysicsWorld *world, int body) {
+    if (world == NULL) return 0;
+
+    return body >= 0 && body < world->bodyCount && world->bodies[body].active;
+}
+
+void PhysicsRemoveBody(struct PhysicsWorld *world, int body) {
+    if (!PhysicsIsValidBody(world, body)) return;
+
+    SapRemoveProxy(&world->broadphase, world->bodies[body].proxy);
+    memset(&world->bodies[body], 0, sizeof(struct PhysicsBody));
+    world->freeSlots[world->freeCount++] = body;
+    world->activeCount--;
+}
+
+// Moving a body keeps its velocities, the broadphase sees the new AABB on the next step
+void PhysicsSetBodyPose(struct PhysicsWorld *world, int body, const float position[VEC_3_SIZE], const float orientation[QUATERNION_SIZE]) {
+    if (!PhysicsIsValidBody(world, body)) return;
+
+    struct PhysicsBody *b = &world->bodies[body];
+    Vec3Copy(b->position, position);
+    QuaternionNormalize(b->orientation, orientation);
+    updateDerived(b);
+}
+
+void PhysicsApplyImpulse(struct PhysicsWorld *world, int body, const float impulse[VEC_3_SIZE], const float point[VEC_3_SIZE]) {
+    if (!PhysicsIsValidBody(world, body) || impulse == NULL) return;
+
+    struct PhysicsBody *b = &world->bodies[body];
+    madd3(b->linearVelocity, b->linearVelocity, impulse, b->invMass);
+
+    if (point != NULL) {
+        float r[VEC_3_SIZE], torque[VEC_3_SIZE];
+        updateDerived(b);
+        sub3(r, point, b->position);
+        cross3(torque, r, impulse);
+        mat3Mult(torque, b->invInertiaWorld, torque);
+        madd3(b->angularVelocity, b->angularVelocity, torque, 1.0f);
+    }
+}
+
+/** Narrowphase, normals always point from body a to body b */
+static int addContact(
+    struct PhysicsWorld *world,
+    int a,
+    int b,
+    int feature,
+    const float normal[VEC_3_SIZE],
+    const float point[VEC_3_SIZE],
+    float depth
+) {
+    if (world->contactCount == world->contactCapacity) {
+        int capacity = world->contactCapacity > 0 ? world->contactCapacity * 2 : 256;
+        struct PhysicsContact *contacts = realloc(world->contacts, sizeof(struct PhysicsContact) * capacity);
+        if (contacts == NULL) return 0;
+
+        world->contacts = contacts;
+        world->contactCapacity = capacity;
+    }
+
+    struct PhysicsContact *contact = &world->contacts[world->contactCount++];
+    memset(contact, 0, sizeof(struct PhysicsContact));
+    contact->a = a;
+    contact->b = b;
+    contact->feature = feature;
+    Vec3Copy(contact->normal, normal);
+    Vec3Copy(contact->point, point);
+    contact->depth = depth;
+
+    return 1;
+}
+
+static void capsuleSegment(float p0[VEC_3_SIZE], float p1[VEC_3_SIZE], const struct PhysicsBody *capsule) {
+    float axis[VEC_3_SIZE];
+    axis3(axis, capsule->rotation, 1);
+    madd3(p0, capsule->position, axis, -capsule->size[1]);
+    madd3(p1, capsule->position, axis, capsule->size[1]);
+}
+
+static float closestOnSegment(float out[VEC_3_SIZE], const float p[VEC_3_SIZE], const float a[VEC_3_SIZE], const float b[VEC_3_SIZE]) {
+    float ab[VEC_3_SIZE], ap[VEC_3_SIZE];
+    sub3(ab, b, a);
+    sub3(ap, p, a);
+
+    float lengthSq = dot3(ab, ab);
+    float t = lengthSq > PHYSICS_EPSILON ? fminf(fmaxf(dot3(ap, ab) / lengthSq, 0.0f), 1.0f) : 0.0f;
+    madd3(out, a, ab, t);
+
+    return t;
+}
+
+// Closest points between segments p1-q1 and p2-q2 (Ericson, Real-Time Collision Detection 5.1.9)
+static void closestBetweenSegments(
+    float c1[VEC_3_SIZE],
+    float c2[VEC_3_SIZE],
+    const float p1[VEC_3_SIZE],
+    const float q1[VEC_3_SIZE],
+    const float p2[VEC_3_SIZE],
+    const float q2[VEC_3_SIZE]
+) {
+    float d1[VEC_3_SIZE], d2[VEC_3_SIZE], r[VEC_3_SIZE];
+    sub3(d1, q1, p1);
+    sub3(d2, q2, p2);
+    sub3(r, p1, p2);
+
+    float a = dot3(d1, d1), e = dot3(d2, d2), f = dot3(d2, r);
+    float s, t;
+
+    if (a <= PHYSICS_EPSILON && e <= PHYSICS_EPSILON) {
+        s = t = 0.0f;
+    } else if (a <= PHYSICS_EPSILON) {
+        s = 0.0f;
+        t = fminf(fmaxf(f / e, 0.0f), 1.0f);
+    } else {
+        float c = dot3(d1, r);
+        if (e <= PHYSICS_EPSILON) {
+            t = 0.0f;
+            s = fminf(fmaxf(-c / a, 0.0f), 1.0f);
+        } else {
+            float b = dot3(d1, d2);
+            float denom = a * e - b * b;
+            s = denom > PHYSICS_EPSILON ? fminf(fmaxf((b * f - c * e) / denom, 0.0f), 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = fminf(fmaxf(-c / a, 0.0f), 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = fminf(fmaxf((b - c) / a, 0.0f), 1.0f);
+            }
+        }
+    }
+
+    madd3(c1, p1, d1, s);
+    madd3(c2, p2, d2, t);
+}
+
+static int sphereSphere(
+    struct PhysicsWorld *world,
+    int a, const float centerA[VEC_3_SIZE], float radiusA,
+    int b, const float centerB[VEC_3_SIZE], float radiusB
+) {
+    float d[VEC_3_SIZE], normal[VEC_3_SIZE] = {0.0f, 1.0f, 0.0f}, point[VEC_3_SIZE];
+    sub3(d, centerB, centerA);
+
+    float radii = radiusA + radiusB;
+    float distSq = dot3(d, d);
+    if (distSq > radii * radii) return 1;
+
+    float dist = sqrtf(distSq);
+    if (dist > PHYSICS_EPSILON) Vec3Scalar(normal, d, 1.0f / dist);
+
+    float depth = radii - dist;
+    madd3(point, centerA, normal, radiusA - 0.5f * depth);
+
+    return addContact(world, a, b, 0, normal, point, depth);
+}
+
+static float boxDistanceSq(const struct PhysicsBody *box, const float p[VEC_3_SIZE]) {
+    float local[VEC_3_SIZE], distSq = 0.0f;
+    sub3(local, p, box->position);
+    mat3TransposeMult(local, box->rotation, local);
+
+    for (int i = 0; i < 3; ++i) {
+        float excess = fabsf(local[i]) - box->size[i];
+        if (excess > 0.0f) distSq += excess * excess;
+    }
+
+    return distSq;
+}
+
+// Contact of a sphere against a box, the normal points from the box towards the sphere and the point is on the box
+static int sphereBoxContact(
+    float outNormal[VEC_3_SIZE],
+    float outPoint[VEC_3_SIZE],
+    float *outDepth,
+    const struct PhysicsBody *box,
+    const float center[VEC_3_SIZE],
+    float radius
+) {
+    float local[VEC_3_SIZE], closest[VEC_3_SIZE], d[VEC_3_SIZE], normal[VEC_3_SIZE] = {0.0f};
+    sub3(local, center, box->position);
+    mat3TransposeMult(local, box->rotation, local);
+
+    for (int i = 0; i < 3; ++i) {
+        closest[i] = fminf(fmaxf(local[i], -box->size[i]), box->size[i]);
+    }
+    sub3(d, local, closest);
+
+    float distSq = dot3(d, d);
+    if (distSq > radius * radius) return 0;
+
+    if (distSq > PHYSICS_EPSILON * PHYSICS_EPSILON) {
+        float dist = sqrtf(distSq);
+        Vec3Scalar(normal, d, 1.0f / dist);
+        *outDepth = radius - dist;
+    } else {
+        // The center is inside the box, push it out through the nearest face
+        int axis = 0;
+        float nearest = box->size[0] - fabsf(local[0]);
+        for (int i = 1; i < 3; ++i) {
+            float gap = box->size[i] - fabsf(local[i]);
+            if (gap < nearest) {
+                nearest = gap;
+                axis = i;
+            }
+        }
+
+        float sign = local[axis] < 0.0f ? -1.0f : 1.0f;
+        normal[axis] = sign;
+        closest[axis] = sign * box->size[axis];
+        *outDepth = radius + nearest;
+    }
+
+    mat3Mult(outNormal, box->rotation, normal);
+    mat3Mult(outPoint, box->rotation, closest);
+    madd3(outPoint, box->position, outPoint, 1.0f);
+
+    return 1;
+}
+
+static int sphereBox(struct PhysicsWorld *world, int a, const float center[VEC_3_SIZE], float radius, int b) {
+    float normal[VEC_3_SIZE], point[VEC_3_SIZE], depth;
+    if (!sphereBoxContact(normal, point, &depth, &world->bodies[b], center, radius)) return 1;
+
+    Vec3Scalar(normal, normal, -1.0f);
+
+    return addContact(world, a, b, 0, normal, point, depth);
+}
+
+// Both end caps are tested so a capsule lying on a box rests on two contacts, otherwise the closest point is used
+static int boxCapsule(struct PhysicsWorld *world, int a, int b) {
+    const struct PhysicsBody *box = &world->bodies[a];
+    const struct PhysicsBody *capsule = &world->bodies[b];
+    float ends[2][VEC_3_SIZE], normal[VEC_3_SIZE], point[VEC_3_SIZE], depth;
+    int found = 0;
+
+    capsuleSegment(ends[0], ends[1], capsule);
+    for (int e = 0; e < 2; ++e) {
+        if (sphereBoxContact(normal, point, &depth, box, ends[e], capsule->size[0])) {
+            if (!addContact(world, a, b, e, normal, point, depth)) return 0;
+            found = 1;
+        }
+    }
+    if (found) return 1;
+
+    // Distance from the segment to a box is convex along the segment
+    float low = 0.0f, high = 1.0f, p1[VEC_3_SIZE], p2[VEC_3_SIZE], axis[VEC_3_SIZE];
+    sub3(axis, ends[1], ends[0]);
+    for (int i = 0; i < PHYSICS_CAPSULE_SEARCH_STEPS; ++i) {
+        float t1 = low + (high - low) / 3.0f;
+        float t2 = high - (high - low) / 3.0f;
+        madd3(p1, ends[0], axis, t1);
+        madd3(p2, ends[0], axis, t2);
+
+        if (boxDistanceSq(box, p1) < boxDistanceSq(box, p2)) {
+            high = t2;
+        } else {
+            low = t1;
+        }
+    }
+
+    madd3(p1, ends[0], axis, 0.5f * (low + high));
+    if (!sphereBoxContact(normal, point, &depth, box, p1, capsule->size[0])) return 1;
+
+    return addContact(world, a, b, 2, normal, point, depth);
+}
+
+static float projectedRadius(const struct PhysicsBody *box, const float axis[VEC_3_SIZE]) {
+    float r = 0.0f, boxAxis[VEC_3_SIZE];
+    for (int i = 0; i < 3; ++i) {
+        axis3(boxAxis, box->rotation, i);
+        r += box->size[i] * fabsf(dot3(boxAxis, axis));
+    }
+
+    return r;
+}
+
+static int pointInBox(const struct PhysicsBody *box, const float p[VEC_3_SIZE]) {
+    float local[VEC_3_SIZE];
+    sub3(local, p, box->position);
+    mat3TransposeMult(local, box->rotation, local);
+
+    return fabsf(local[0]) <= box->size[0] + PHYSICS_LINEAR_SLOP &&
+           fabsf(local[1]) <= box->size[1] + PHYSICS_LINEAR_SLOP &&
+           fabsf(local[2]) <= box->size[2] + PHYSICS_LINEAR_SLOP;
+}
+
+static void boxVertex(float out[VEC_3_SIZE], const struct PhysicsBody *box, int index) {
+    float local[VEC_3_SIZE];
+    for (int i = 0; i < 3; ++i) {
+        local[i] = (index >> i) & 1 ? box->size[i] : -box->size[i];
+    }
+
+    mat3Mult(out, box->rotation, local);
+    madd3(out, box->position, out, 1.0f);
+}
+
+// The edge of box along axis that is furthest in direction
+static void supportEdge(float p0[VEC_3_SIZE], float p1[VEC_3_SIZE], const struct PhysicsBody *box, int axis, const float direction[VEC_3_SIZE]) {
+    float center[VEC_3_SIZE], boxAxis[VEC_3_SIZE];
+    Vec3Copy(center, box->position);
+
+    for (int i = 0; i < 3; ++i) {
+        axis3(boxAxis, box->rotation, i);
+        if (i != axis) madd3(center, center, boxAxis, dot3(boxAxis, direction) < 0.0f ? -box->size[i] : box->size[i]);
+    }
+
+    axis3(boxAxis, box->rotation, axis);
+    madd3(p0, center, boxAxis, -box->size[axis]);
+    madd3(p1, center, boxAxis, box->size[axis]);
+}
+
+/**
+ * Box against box: the separating axis test over the 15 candidate axes finds the normal of least penetration.
+ * The manifold is every vertex of one box inside the other, measured along that normal. Crossing edges have no
+ * vertex inside either box and get a single contact between the closest points of the two support edges.
+ */
+static int boxBox(struct PhysicsWorld *world, int a, int b) {
+    const struct PhysicsBody *boxA = &world->bodies[a];
+    const struct PhysicsBody *boxB = &world->bodies[b];
+    float d[VEC_3_SIZE], axesA[3][VEC_3_SIZE], axesB[3][VEC_3_SIZE];
+    sub3(d, boxB->position, boxA->position);
+
+    for (int i = 0; i < 3; ++i) {
+        axis3(axesA[i], boxA->rotation, i);
+        axis3(axesB[i], boxB->rotation, i);
+    }
+
+    float faceOverlap = INFINITY, edgeOverlap = INFINITY;
+    float faceNormal[VEC_3_SIZE] = {0.0f}, edgeNormal[VEC_3_SIZE] = {0.0f};
+    int edgeAxisA = 0, edgeAxisB = 0;
+
+    for (int i = 0; i < 15; ++i) {
+        float axis[VEC_3_SIZE];
+        if (i < 3) {
+            Vec3Copy(axis, axesA[i]);
+        } else if (i < 6) {
+            Vec3Copy(axis, axesB[i - 3]);
+        } else {
+            cross3(axis, axesA[(i - 6) / 3], axesB[(i - 6) % 3]);
+            float length = sqrtf(dot3(axis, axis));
+            if (length < 1e-4f) continue;
+
+            Vec3Scalar(axis, axis, 1.0f / length);
+        }
+
+        float distance = dot3(d, axis);
+        float overlap = projectedRadius(boxA, axis) + projectedRadius(boxB, axis) - fabsf(distance);
+        if (overlap < 0.0f) return 1;
+
+        if (distance < 0.0f) Vec3Scalar(axis, axis, -1.0f);
+
+        if (i < 6 && overlap < faceOverlap) {
+            faceOverlap = overlap;
+            Vec3Copy(faceNormal, axis);
+        } else if (i >= 6 && overlap < edgeOverlap) {
+            edgeOverlap = overlap;
+            edgeAxisA = (i - 6) / 3;
+            edgeAxisB = (i - 6) % 3;
+            Vec3Copy(edgeNormal, axis);
+        }
+    }
+
+    // Prefer faces unless an edge axis is clearly better, this keeps resting contacts from flickering between axes
+    int useEdge = edgeOverlap < 0.95f * faceOverlap - 0.01f;
+    const float *normal = useEdge ? edgeNormal : faceNormal;
+    float depth = useEdge ? edgeOverlap : faceOverlap;
+
+    if (!useEdge) {
+        float faceA = dot3(boxA->position, normal) + projectedRadius(boxA, normal);
+        float faceB = dot3(boxB->position, normal) - projectedRadius(boxB, normal);
+        int found = 0;
+
+        for (int v = 0; v < 8; ++v) {
+            float vertex[VEC_3_SIZE];
+
+            boxVertex(vertex, boxB, v);
+            if (pointInBox(boxA, vertex)) {
+                if (!addContact(world, a, b, v, normal, vertex, fmaxf(faceA - dot3(vertex, normal), 0.0f))) return 0;
+                found = 1;
+            }
+
+            boxVertex(vertex, boxA, v);
+            if (pointInBox(boxB, vertex)) {
+                if (!addContact(world, a, b, 8 + v, normal, vertex, fmaxf(dot3(vertex, normal) - faceB, 0.0f))) return 0;
+                found = 1;
+            }
+        }
+        if (found) return 1;
+
+        // No vertex inside: fall back to the edges of each box that lie flattest against the normal
+        float best = INFINITY;
+        for (int i = 0; i < 3; ++i) {
+            float alignment = fabsf(dot3(axesA[i], normal));
+            if (alignment < best) {
+                best = alignment;
+                edgeAxisA = i;
+            }
+        }
+        best = INFINITY;
+        for (int i = 0; i < 3; ++i) {
+            float alignment = fabsf(dot3(axesB[i], normal));
+            if (alignment < best) {
+                best = alignment;
+                edgeAxisB = i;
+            }
+        }
+    }
+
+    float a0[VEC_3_SIZE], a1[VEC_3_SIZE], b0[VEC_3_SIZE], b1[VEC_3_SIZE], towardsA[VEC_3_SIZE];
+    float closestA[VEC_3_SIZE], closestB[VEC_3_SIZE], point[VEC_3_SIZE];
+    Vec3Scalar(towardsA, normal, -1.0f);
+    supportEdge(a0, a1, boxA, edgeAxisA, normal);
+    supportEdge(b0, b1, boxB, edgeAxisB, towardsA);
+    closestBetweenSegments(closestA, closestB, a0, a1, b0, b1);
+
+    Vec3Add(point, closestA, closestB);
+    Vec3Scalar(point, point, 0.5f);
+
+    return addContact(world, a, b, 16 + edgeAxisA * 3 + edgeAxisB, normal, point, depth);
+}
+
+static int collide(struct PhysicsWorld *world, int a, int b) {
+    // Order the pair by shape so each combination has one routine
+    if (world->bodies[a].shape > world->bodies[b].shape) {
+        int swap = a;
+        a = b;
+        b = swap;
+    }
+
+    const struct PhysicsBody *bodyA = &world->bodies[a];
+    const struct PhysicsBody *bodyB = &world->bodies[b];
+    float p0[VEC_3_SIZE], p1[VEC_3_SIZE], q0[VEC_3_SIZE], q1[VEC_3_SIZE], c1[VEC_3_SIZE], c2[VEC_3_SIZE];
+
+    switch (bodyA->shape * 3 + bodyB->shape) {
+        case PHYSICS_SHAPE_SPHERE * 3 + PHYSICS_SHAPE_SPHERE:
+            return sphereSphere(world, a, bodyA->position, bodyA->size[0], b, bodyB->position, bodyB->size[0]);
+        case PHYSICS_SHAPE_SPHERE * 3 + PHYSICS_SHAPE_BOX:
+            return sphereBox(world, a, bodyA->position, bodyA->size[0], b);
+        case PHYSICS_SHAPE_SPHERE * 3 + PHYSICS_SHAPE_CAPSULE:
+            capsuleSegment(q0, q1, bodyB);
+            closestOnSegment(c2, bodyA->position, q0, q1);
+            return sphereSphere(world, a, bodyA->position, bodyA->size[0], b, c2, bodyB->size[0]);
+        case PHYSICS_SHAPE_BOX * 3 + PHYSICS_SHAPE_BOX:
+            return boxBox(world, a, b);
+        case PHYSICS_SHAPE_BOX * 3 + PHYSICS_SHAPE_CAPSULE:
+            return boxCapsule(world, a, b);
+        case PHYSICS_SHAPE_CAPSULE * 3 + PHYSICS_SHAPE_CAPSULE:
+            capsuleSegment(p0, p1, bodyA);
+            capsuleSegment(q0, q1, bodyB);
+            closestBetweenSegments(c1, c2, p0, p1, q0, q1);
+            return sphereSphere(world, a, c1, bodyA->size[0], b, c2, bodyB->size[0]);
+        default:
+            return 1;
+    }
+}
+
+/** Solver */
+static void relativeVelocity(float out[VEC_3_SIZE], const struct PhysicsBody *a, const struct PhysicsBody *b, const struct PhysicsContact *c) {
+    float wA[VEC_3_SIZE], wB[VEC_3_SIZE];
+    cross3(wA, a->angularVelocity, c->rA);
+    cross3(wB, b->angularVelocity, c->rB);
+
+    for (int i = 0; i < 3; ++i) {
+        out[i] = b->linearVelocity[i] + wB[i] - a->linearVelocity[i] - wA[i];
+    }
+}
+
+static float effectiveMass(const struct PhysicsBody *a, const struct PhysicsBody *b, const struct PhysicsContact *c, const float direction[VEC_3_SIZE]) {
+    float rn[VEC_3_SIZE], angular[VEC_3_SIZE];
+    float k = a->invMass + b->invMass;
+
+    cross3(rn, c->rA, direction);
+    mat3Mult(rn, a->invInertiaWorld, rn);
+    cross3(angular, rn, c->rA);
+    k += dot3(angular, direction);
+
+    cross3(rn, c->rB, direction);
+    mat3Mult(rn, b->invInertiaWorld, rn);
+    cross3(angular, rn, c->rB);
+    k += dot3(angular, direction);
+
+    return k > 0.0f ? 1.0f / k : 0.0f;
+}
+
+static void applyImpulse(struct PhysicsBody *a, struct PhysicsBody *b, const struct PhysicsContact *c, const float direction[VEC_3_SIZE], float magnitude) {
+    float impulse[VEC_3_SIZE], torque[VEC_3_SIZE];
+    Vec3Scalar(impulse, direction, magnitude);
+
+    madd3(a->linearVelocity, a->linearVelocity, impulse, -a->invMass);
+    cross3(torque, c->rA, impulse);
+    mat3Mult(torque, a->invInertiaWorld, torque);
+    madd3(a->angularVelocity, a->angularVelocity, torque, -1.0f);
+
+    madd3(b->linearVelocity, b->linearVelocity, impulse, b->invMass);
+    cross3(torque, c->rB, impulse);
+    mat3Mult(torque, b->invInertiaWorld, torque);
+    madd3(b->angularVelocity, b->angularVelocity, torque, 1.0f);
+}
+
+static int compareContacts(const void *c1, const void *c2) {
+    const struct PhysicsContact *a = c1, *b = c2;
+
+    if (a->a != b->a) return a->a < b->a ? -1 : 1;
+    if (a->b != b->b) return a->b < b->b ? -1 : 1;
+
+    return (a->feature > b->feature) - (a->feature < b->feature);
+}
+
+static void warmStart(struct PhysicsWorld *world, struct PhysicsContact *c) {
+    const struct PhysicsContact *previous = NULL;
+    if (world->previousCount > 0) {
+        previous = bsearch(c, world->previousContacts, world->previousCount, sizeof(struct PhysicsContact), compareContacts);
+    }
+    if (previous == NULL) return;
+
+    struct PhysicsBody *a = &world->bodies[c->a];
+    struct PhysicsBody *b = &world->bodies[c->b];
+
+    c->normalImpulse = previous->normalImpulse;
+    c->tangentImpulse[0] = previous->tangentImpulse[0];
+    c->tangentImpulse[1] = previous->tangentImpulse[1];
+
+    applyImpulse(a, b, c, c->normal, c->normalImpulse);
+    applyImpulse(a, b, c, c->tangents[0], c->tangentImpulse[0]);
+    applyImpulse(a, b, c, c->tangents[1], c->tangentImpulse[1]);
+}
+
+static int keepContacts(struct PhysicsWorld *world) {
+    if (world->contactCount > world->previousCapacity) {
+        struct PhysicsContact *previous = realloc(world->previousContacts, sizeof(struct PhysicsContact) * world->contactCount);
+        if (previous == NULL) return 0;
+
+        world->previousContacts = previous;
+        world->previousCapacity = world->contactCount;
+    }
+
+    if (world->contactCount > 0) {
+        memcpy(world->previousContacts, world->contacts, sizeof(struct PhysicsContact) * world->contactCount);
+        qsort(world->previousContacts, world->contactCount, sizeof(struct PhysicsContact), compareContacts);
+    }
+    world->previousCount = world->contactCount;
+
+    return 1;
+}
+
+static void prepareContacts(struct PhysicsWorld *world, float dt) {
+    for (int i = 0; i < world->contactCount; ++i) {
+        struct PhysicsContact *c = &world->contacts[i];
+        const struct PhysicsBody *a = &world->bodies[c->a];
+        const struct PhysicsBody *b = &world->bodies[c->b];
+        const float *n = c->normal;
+
+        sub3(c->rA, c->point, a->position);
+        sub3(c->rB, c->point, b->position);
+
+        if (fabsf(n[0]) >= 0.57735f) {
+            float t[VEC_3_SIZE] = {n[1], -n[0], 0.0f};
+            Vec3Normalize(c->tangents[0], t);
+        } else {
+            float t[VEC_3_SIZE] = {0.0f, n[2], -n[1]};
+            Vec3Normalize(c->tangents[0], t);
+        }
+        cross3(c->tangents[1], n, c->tangents[0]);
+
+        c->normalMass = effectiveMass(a, b, c, n);
+        c->tangentMass[0] = effectiveMass(a, b, c, c->tangents[0]);
+        c->tangentMass[1] = effectiveMass(a, b, c, c->tangents[1]);
+        c->friction = sqrtf(a->friction * b->friction);
+
+        float velocity[VEC_3_SIZE];
+        relativeVelocity(velocity, a, b, c);
+        float approach = dot3(velocity, n);
+
+        c->bias = PHYSICS_BAUMGARTE / dt * fmaxf(c->depth - PHYSICS_LINEAR_SLOP, 0.0f);
+        if (approach < -PHYSICS_RESTITUTION_THRESHOLD) {
+            c->bias = fmaxf(c->bias, -fmaxf(a->restitution, b->restitution) * approach);
+        }
+    }
+
+    // Only once every bias is known, the warm start impulses change the velocities the biases were computed from
+    for (int i = 0; i < world->contactCount; ++i) {
+        warmStart(world, &world->contacts[i]);
+    }
+}
+
+static void solveContacts(struct PhysicsWorld *world) {
+    for (int i = 0; i < world->contactCount; ++i) {
+        struct PhysicsContact *c = &world->contacts[i];
+        struct PhysicsBody *a = &world->bodies[c->a];
+        struct PhysicsBody *b = &world->bodies[c->b];
+        float velocity[VEC_3_SIZE];
+
+        float maxFriction = c->friction * c->normalImpulse;
+        for (int t = 0; t < 2; ++t) {
+            relativeVelocity(velocity, a, b, c);
+            float lambda = -dot3(velocity, c->tangents[t]) * c->tangentMass[t];
+            float accumulated = fminf(fmaxf(c->tangentImpulse[t] + lambda, -maxFriction), maxFriction);
+
+            applyImpulse(a, b, c, c->tangents[t], accumulated - c->tangentImpulse[t]);
+            c->tangentImpulse[t] = accumulated;
+        }
+
+        relativeVelocity(velocity, a, b, c);
+        float lambda = (c->bias - dot3(velocity, c->normal)) * c->normalMass;
+        float accumulated = fmaxf(c->normalImpulse + lambda, 0.0f);
+
+        applyImpulse(a, b, c, c->normal, accumulated - c->normalImpulse);
+        c->normalImpulse = accumulated;
+    }
+}
+
+/** Step */
+int PhysicsStep(struct PhysicsWorld *world, float dt) {
+    if (world == NULL || !(dt > 0.0f)) return 0;
+
+    for (int i = 0; i < world->bodyCount; ++i) {
+        struct PhysicsBody *body = &world->bodies[i];
+        if (!body->active) continue;
+
+        if (body->invMass > 0.0f) madd3(body->linearVelocity, body->linearVelocity, world->gravity, dt);
+        updateDerived(body);
+        SapSetProxyAabb(&world->broadphase, body->proxy, body->aabb);
+    }
+
+    if (!SapUpdate(&world->broadphase)) return 0;
+
+    world->contactCount = 0;
+    for (int p = 0; p < world->broadphase.pairCount; ++p) {
+        const struct SapPair *pair = &world->broadphase.pairs[p];
+        int a = SapGetUserData(&world->broadphase, pair->a);
+        int b = SapGetUserData(&world->broadphase, pair->b);
+        if (world->bodies[a].invMass == 0.0f && world->bodies[b].invMass == 0.0f) continue;
+
+        if (!collide(world, a < b ? a : b, a < b ? b : a)) return 0;
+    }
+
+    prepareContacts(world, dt);
+    for (int iteration = 0; iteration < world->iterations; ++iteration) {
+        solveContacts(world);
+    }
+    if (!keepContacts(world)) return 0;
+
+    for (int i = 0; i < world->bodyCount; ++i) {
+        struct PhysicsBody *body = &world->bodies[i];
+        if (!body->active || body->invMass == 0.0f) continue;
+
+        madd3(body->position, body->position, body->linearVelocity, dt);
+
+        // q += 0.5 * dt * (w, 0) * q
+        float spin[QUATERNION_SIZE] = {body->angularVelocity[0], body->angularVelocity[1], body->angularVelocity[2], 0.0f};
+        float delta[QUATERNION_SIZE];
+        float orientation[QUATERNION_SIZE];
+        QuaternionMultInline(delta, spin, body->orientation);
+        for (int c = 0; c < QUATERNION_SIZE; ++c) {
+            orientation[c] = body->orientation[c] + 0.5f * dt * delta[c];
+        }
+        QuaternionNormalizeInline(body->orientation, orientation);
+    }
+
+    return 1;
+}
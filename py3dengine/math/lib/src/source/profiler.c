@@ -0,0 +1,137 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "profiler.h"
+
+struct ProfilerRecordedEvent {
+    uint64_t timestamp;
+    const char *name;
+    int type;
+};
+
+struct ProfilerRing {
+    struct ProfilerRecordedEvent events[PROFILER_RING_SIZE];
+    // head only moves on the owning thread, tail only in ProfilerCollect
+    atomic_uint_fast64_t head;
+    atomic_uint_fast64_t tail;
+    atomic_uint_fast64_t dropped;
+    _Atomic(char *) name;
+    uint32_t thread;
+    struct ProfilerRing *next;
+};
+
+atomic_int profilerEnabled = 0;
+
+static _Atomic(struct ProfilerRing *) rings = NULL;
+static atomic_uint nextThread = 0;
+static _Thread_local struct ProfilerRing *threadRing = NULL;
+static pthread_mutex_t collectLock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct ProfilerRing *getThreadRing(void) {
+    if (threadRing != NULL) return threadRing;
+
+    struct ProfilerRing *ring = calloc(1, sizeof(struct ProfilerRing));
+    if (ring == NULL) return NULL;
+
+    ring->thread = atomic_fetch_add(&nextThread, 1);
+    ring->next = atomic_load(&rings);
+    while (!atomic_compare_exchange_weak(&rings, &ring->next, ring)) {}
+
+    threadRing = ring;
+
+    return ring;
+}
+
+void ProfilerSetEnabled(int enabled) {
+    atomic_store(&profilerEnabled, enabled != 0);
+}
+
+uint64_t ProfilerNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+void ProfilerRecord(const char *name, int type) {
+    struct ProfilerRing *ring = getThreadRing();
+    if (ring == NULL) return;
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= PROFILER_RING_SIZE) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    struct ProfilerRecordedEvent *event = &ring->events[head & (PROFILER_RING_SIZE - 1)];
+    event->timestamp = ProfilerNow();
+    event->name = name;
+    event->type = type;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+int ProfilerSetThreadName(const char *name) {
+    if (name == NULL) return 0;
+
+    struct ProfilerRing *ring = getThreadRing();
+    if (ring == NULL) return 0;
+
+    // A thread is named once, so the collector never reads a name that is being freed
+    char *copy = strdup(name);
+    if (copy == NULL) return 0;
+
+    char *expected = NULL;
+    if (!atomic_compare_exchange_strong(&ring->name, &expected, copy)) {
+        free(copy);
+        return 0;
+    }
+
+    return 1;
+}
+
+const char *ProfilerThreadName(uint32_t thread) {
+    for (struct ProfilerRing *ring = atomic_load(&rings); ring != NULL; ring = ring->next) {
+        if (ring->thread == thread) return atomic_load(&ring->name);
+    }
+
+    return NULL;
+}
+
+int ProfilerCollect(struct ProfilerEvent *out, int capacity) {
+    if (out == NULL || capacity <= 0) return 0;
+
+    pthread_mutex_lock(&collectLock);
+
+    int count = 0;
+    for (struct ProfilerRing *ring = atomic_load(&rings); ring != NULL && count < capacity; ring = ring->next) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+        for (; tail != head && count < capacity; ++tail, ++count) {
+            const struct ProfilerRecordedEvent *event = &ring->events[tail & (PROFILER_RING_SIZE - 1)];
+            out[count].timestamp = event->timestamp;
+            out[count].name = event->name;
+            out[count].thread = ring->thread;
+            out[count].type = (uint32_t) event->type;
+        }
+
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+
+    pthread_mutex_unlock(&collectLock);
+
+    return count;
+}
+
+uint64_t ProfilerDroppedEvents(void) {
+    uint64_t dropped = 0;
+    for (struct ProfilerRing *ring = atomic_load(&rings); ring != NULL; ring = ring->next) {
+        dropped += atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    }
+
+    return dropped;
+}
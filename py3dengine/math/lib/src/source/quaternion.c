@@ -4,6 +4,13 @@
 
 #include "util.h"
 #include "quaternion.h"
+#include "profiler.h"
+#include "dispatch.h"
+#include "mathinline.h"
+
+#if DISPATCH_X86
+#include <immintrin.h>
+#endif
 
 void QuaternionIdentity(float out[QUATERNION_SIZE]) {
     if (out == NULL) return;
@@ -33,23 +40,15 @@ void QuaternionToCStr(char *out, const float q[QUATERNION_SIZE], ssize_t size) {
 void QuaternionVec3Rotation(float out[VEC_3_SIZE], const float v[VEC_3_SIZE], const float q[QUATERNION_SIZE]) {
     if (out == NULL || v == NULL || q == NULL) return;
 
-    float temp[VEC_3_SIZE] = {0.0f};
-    float temp2[VEC_3_SIZE] = {0.0f};
-    float temp3[VEC_3_SIZE] = {0.0f};
-
-    float q_dot_v = 0.0f;
-    Vec3Dot(&q_dot_v, q, v);
-    float q_dot_q = 0.0f;
-    Vec3Dot(&q_dot_q, q, q);
+    // 2 (q.v) q + (w^2 - q.q) v + 2 w (q x v), expanded so no temporaries are needed
+    float x = v[0], y = v[1], z = v[2];
+    float twoQDotV = 2.0f * (q[0] * x + q[1] * y + q[2] * z);
+    float wwMinusQDotQ = q[3] * q[3] - (q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+    float twoW = 2.0f * q[3];
 
-    Vec3Scalar(temp, q, (2.0f * q_dot_v));
-    Vec3Scalar(temp2, v, ((q[3] * q[3]) - q_dot_q));
-    Vec3Cross(temp3, q, v);
-    Vec3Scalar(temp3, temp3, 2.0f * q[3]);
-
-    for (int i = 0; i < VEC_3_SIZE; ++i) {
-        out[i] = temp[i] + temp2[i] + temp3[i];
-    }
+    out[0] = twoQDotV * q[0] + wwMinusQDotQ * x + twoW * (q[1] * z - q[2] * y);
+    out[1] = twoQDotV * q[1] + wwMinusQDotQ * y + twoW * (q[2] * x - q[0] * z);
+    out[2] = twoQDotV * q[2] + wwMinusQDotQ * z + twoW * (q[0] * y - q[1] * x);
 }
 
 // found this at:
@@ -71,9 +70,14 @@ void QuaternionFromAxisAngle(float out[QUATERNION_SIZE], float x, float y, float
 }
 
 void QuaternionNormalize(float out[QUATERNION_SIZE], const float q[QUATERNION_SIZE]) {
-    if (out == NULL) return;
+    if (out == NULL || q == NULL) return;
+
+    float len = sqrtf((q[0] * q[0]) + (q[1] * q[1]) + (q[2] * q[2]) + (q[3] * q[3]));
+    if (len == 0.0f) {
+        QuaternionIdentity(out);
+        return;
+    }
 
-    float len = sqrtf((out[0] * out[0]) + (out[1] * out[1]) + (out[2] * out[2]) + (out[3] * out[3]));
     out[0] = q[0] / len;
     out[1] = q[1] / len;
     out[2] = q[2] / len;
@@ -99,3 +103,377 @@ void QuaternionMult(float out[QUATERNION_SIZE], const float q1[QUATERNION_SIZE],
 
     QuaternionCopy(out, temp);
 }
+
+void QuaternionDot(float *out, const float q1[QUATERNION_SIZE], const float q2[QUATERNION_SIZE]) {
+    if (out == NULL || q1 == NULL || q2 == NULL) return;
+
+    *out = (q1[0] * q2[0]) + (q1[1] * q2[1]) + (q1[2] * q2[2]) + (q1[3] * q2[3]);
+}
+
+// Both interpolations take the shortest path, q2 is negated when the quaternions are more than 180 degrees apart
+void QuaternionNlerp(float out[QUATERNION_SIZE], const float q1[QUATERNION_SIZE], const float q2[QUATERNION_SIZE], float t) {
+    if (out == NULL || q1 == NULL || q2 == NULL) return;
+
+    float dot = 0.0f;
+    QuaternionDot(&dot, q1, q2);
+    float t2 = dot < 0.0f ? -t : t;
+
+    float temp[QUATERNION_SIZE];
+    for (int i = 0; i < QUATERNION_SIZE; ++i) {
+        temp[i] = q1[i] * (1.0f - t) + q2[i] * t2;
+    }
+
+    QuaternionNormalize(out, temp);
+}
+
+void QuaternionSlerp(float out[QUATERNION_SIZE], const float q1[QUATERNION_SIZE], const float q2[QUATERNION_SIZE], float t) {
+    if (out == NULL || q1 == NULL || q2 == NULL) return;
+
+    float dot = 0.0f;
+    QuaternionDot(&dot, q1, q2);
+    float sign = dot < 0.0f ? -1.0f : 1.0f;
+    dot *= sign;
+
+    // sin(theta) goes to 0 for nearly equal rotations, where nlerp is indistinguishable anyway
+    if (dot > 0.9995f) {
+        QuaternionNlerp(out, q1, q2, t);
+        return;
+    }
+
+    float theta = acosf(dot);
+    float sinTheta = sinf(theta);
+    float s1 = sinf((1.0f - t) * theta) / sinTheta;
+    float s2 = sign * sinf(t * theta) / sinTheta;
+
+    float temp[QUATERNION_SIZE];
+    for (int i = 0; i < QUATERNION_SIZE; ++i) {
+        temp[i] = q1[i] * s1 + q2[i] * s2;
+    }
+
+    QuaternionCopy(out, temp);
+}
+
+// Batches may be transformed in place, so each input is copied out before the restrict qualified inline variants
+// write over it
+static void normalizeBatchScalar(float *out, const float *q, int count) {
+    for (int i = 0; i < count; ++i) {
+        float in[QUATERNION_SIZE];
+        QuaternionCopyInline(in, &q[i * 4]);
+        QuaternionNormalizeInline(&out[i * 4], in);
+    }
+}
+
+static void rotationBatchScalar(float *out, const float *v, const float q[QUATERNION_SIZE], int count) {
+    for (int i = 0; i < count; ++i) {
+        float in[VEC_3_SIZE];
+        Vec3CopyInline(in, &v[i * 3]);
+        QuaternionVec3RotationInline(&out[i * 3], in, q);
+    }
+}
+
+static void rotationBatchEachScalar(float *out, const float *v, const float *q, int count) {
+    for (int i = 0; i < count; ++i) {
+        float in[VEC_3_SIZE];
+        Vec3CopyInline(in, &v[i * 3]);
+        QuaternionVec3RotationInline(&out[i * 3], in, &q[i * 4]);
+    }
+}
+
+#if DISPATCH_X86
+// Splits 4 packed xyz vectors (12 floats) into one register per component
+DISPATCH_TARGET("sse2")
+static inline void deinterleaveVec3(__m128 *x, __m128 *y, __m128 *z, const float *v) {
+    __m128 a = _mm_loadu_ps(&v[0]);
+    __m128 b = _mm_loadu_ps(&v[4]);
+    __m128 c = _mm_loadu_ps(&v[8]);
+
+    *x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 3, 0)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0));
+    *y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    *z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 3, 0)), _MM_SHUFFLE(1, 0, 2, 0));
+}
+
+DISPATCH_TARGET("sse2")
+static inline void interleaveVec3(float *out, __m128 x, __m128 y, __m128 z) {
+    __m128 a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+    __m128 c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+    _mm_storeu_ps(&out[0], a);
+    _mm_storeu_ps(&out[4], b);
+    _mm_storeu_ps(&out[8], c);
+}
+
+// Loads 4 packed quaternions (16 floats) as one register per component
+DISPATCH_TARGET("sse2")
+static inline void loadQuaternionLanes(__m128 *x, __m128 *y, __m128 *z, __m128 *w, const float *q) {
+    __m128 qx = _mm_loadu_ps(&q[0]);
+    __m128 qy = _mm_loadu_ps(&q[4]);
+    __m128 qz = _mm_loadu_ps(&q[8]);
+    __m128 qw = _mm_loadu_ps(&q[12]);
+    _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+    *x = qx;
+    *y = qy;
+    *z = qz;
+    *w = qw;
+}
+
+DISPATCH_TARGET("sse2")
+static inline void storeQuaternionLanes(float *out, __m128 x, __m128 y, __m128 z, __m128 w) {
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(&out[0], x);
+    _mm_storeu_ps(&out[4], y);
+    _mm_storeu_ps(&out[8], z);
+    _mm_storeu_ps(&out[12], w);
+}
+
+// Same expansion as QuaternionVec3Rotation with one quaternion or vector per lane
+DISPATCH_TARGET("sse2")
+static inline void rotateLanes(__m128 *x, __m128 *y, __m128 *z, __m128 qx, __m128 qy, __m128 qz, __m128 qw) {
+    __m128 two = _mm_set1_ps(2.0f);
+    __m128 twoQDotV = _mm_mul_ps(two, _mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, *x), _mm_mul_ps(qy, *y)), _mm_mul_ps(qz, *z)));
+    __m128 qDotQ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy)), _mm_mul_ps(qz, qz));
+    __m128 wwMinusQDotQ = _mm_sub_ps(_mm_mul_ps(qw, qw), qDotQ);
+    __m128 twoW = _mm_mul_ps(two, qw);
+
+    __m128 cx = _mm_sub_ps(_mm_mul_ps(qy, *z), _mm_mul_ps(qz, *y));
+    __m128 cy = _mm_sub_ps(_mm_mul_ps(qz, *x), _mm_mul_ps(qx, *z));
+    __m128 cz = _mm_sub_ps(_mm_mul_ps(qx, *y), _mm_mul_ps(qy, *x));
+
+    *x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(twoQDotV, qx), _mm_mul_ps(wwMinusQDotQ, *x)), _mm_mul_ps(twoW, cx));
+    *y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(twoQDotV, qy), _mm_mul_ps(wwMinusQDotQ, *y)), _mm_mul_ps(twoW, cy));
+    *z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(twoQDotV, qz), _mm_mul_ps(wwMinusQDotQ, *z)), _mm_mul_ps(twoW, cz));
+}
+
+DISPATCH_TARGET("sse2")
+static void normalizeBatchSse(float *out, const float *q, int count) {
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z, w;
+        loadQuaternionLanes(&x, &y, &z, &w, &q[i * 4]);
+
+        __m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+        __m128 isZero = _mm_cmpeq_ps(lenSq, zero);
+        // Zero length lanes divide 0 by 1 and get w forced to 1, giving the identity like QuaternionNormalize
+        __m128 len = _mm_or_ps(_mm_andnot_ps(isZero, _mm_sqrt_ps(lenSq)), _mm_and_ps(isZero, one));
+
+        x = _mm_div_ps(x, len);
+        y = _mm_div_ps(y, len);
+        z = _mm_div_ps(z, len);
+        w = _mm_or_ps(_mm_andnot_ps(isZero, _mm_div_ps(w, len)), _mm_and_ps(isZero, one));
+
+        storeQuaternionLanes(&out[i * 4], x, y, z, w);
+    }
+
+    normalizeBatchScalar(&out[i * 4], &q[i * 4], count - i);
+}
+
+DISPATCH_TARGET("sse2")
+static void rotationBatchSse(float *out, const float *v, const float q[QUATERNION_SIZE], int count) {
+    __m128 qx = _mm_set1_ps(q[0]);
+    __m128 qy = _mm_set1_ps(q[1]);
+    __m128 qz = _mm_set1_ps(q[2]);
+    __m128 qw = _mm_set1_ps(q[3]);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        deinterleaveVec3(&x, &y, &z, &v[i * 3]);
+        rotateLanes(&x, &y, &z, qx, qy, qz, qw);
+        interleaveVec3(&out[i * 3], x, y, z);
+    }
+
+    rotationBatchScalar(&out[i * 3], &v[i * 3], q, count - i);
+}
+
+DISPATCH_TARGET("sse2")
+static void rotationBatchEachSse(float *out, const float *v, const float *q, int count) {
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 qx, qy, qz, qw;
+        loadQuaternionLanes(&qx, &qy, &qz, &qw, &q[i * 4]);
+
+        __m128 x, y, z;
+        deinterleaveVec3(&x, &y, &z, &v[i * 3]);
+        rotateLanes(&x, &y, &z, qx, qy, qz, qw);
+        interleaveVec3(&out[i * 3], x, y, z);
+    }
+
+    rotationBatchEachScalar(&out[i * 3], &v[i * 3], &q[i * 4], count - i);
+}
+
+// The AVX2 kernels handle 8 lanes as two groups of 4 that are shuffled into place with the SSE helpers
+DISPATCH_TARGET("avx2,fma")
+static inline __m256 joinLanes(__m128 low, __m128 high) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+
+DISPATCH_TARGET("avx2,fma")
+static inline void rotateLanes8(__m256 *x, __m256 *y, __m256 *z, __m256 qx, __m256 qy, __m256 qz, __m256 qw) {
+    __m256 two = _mm256_set1_ps(2.0f);
+    __m256 twoQDotV = _mm256_mul_ps(two, _mm256_fmadd_ps(qz, *z, _mm256_fmadd_ps(qy, *y, _mm256_mul_ps(qx, *x))));
+    __m256 qDotQ = _mm256_fmadd_ps(qz, qz, _mm256_fmadd_ps(qy, qy, _mm256_mul_ps(qx, qx)));
+    __m256 wwMinusQDotQ = _mm256_fmsub_ps(qw, qw, qDotQ);
+    __m256 twoW = _mm256_mul_ps(two, qw);
+
+    __m256 cx = _mm256_fmsub_ps(qy, *z, _mm256_mul_ps(qz, *y));
+    __m256 cy = _mm256_fmsub_ps(qz, *x, _mm256_mul_ps(qx, *z));
+    __m256 cz = _mm256_fmsub_ps(qx, *y, _mm256_mul_ps(qy, *x));
+
+    *x = _mm256_fmadd_ps(twoW, cx, _mm256_fmadd_ps(wwMinusQDotQ, *x, _mm256_mul_ps(twoQDotV, qx)));
+    *y = _mm256_fmadd_ps(twoW, cy, _mm256_fmadd_ps(wwMinusQDotQ, *y, _mm256_mul_ps(twoQDotV, qy)));
+    *z = _mm256_fmadd_ps(twoW, cz, _mm256_fmadd_ps(wwMinusQDotQ, *z, _mm256_mul_ps(twoQDotV, qz)));
+}
+
+DISPATCH_TARGET("avx2,fma")
+static inline void loadVec3Lanes8(__m256 *x, __m256 *y, __m256 *z, const float *v) {
+    __m128 x0, y0, z0, x1, y1, z1;
+    deinterleaveVec3(&x0, &y0, &z0, &v[0]);
+    deinterleaveVec3(&x1, &y1, &z1, &v[12]);
+
+    *x = joinLanes(x0, x1);
+    *y = joinLanes(y0, y1);
+    *z = joinLanes(z0, z1);
+}
+
+DISPATCH_TARGET("avx2,fma")
+static inline void storeVec3Lanes8(float *out, __m256 x, __m256 y, __m256 z) {
+    interleaveVec3(&out[0], _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z));
+    interleaveVec3(&out[12], _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1));
+}
+
+DISPATCH_TARGET("avx2,fma")
+static inline void loadQuaternionLanes8(__m256 *x, __m256 *y, __m256 *z, __m256 *w, const float *q) {
+    __m128 x0, y0, z0, w0, x1, y1, z1, w1;
+    loadQuaternionLanes(&x0, &y0, &z0, &w0, &q[0]);
+    loadQuaternionLanes(&x1, &y1, &z1, &w1, &q[16]);
+
+    *x = joinLanes(x0, x1);
+    *y = joinLanes(y0, y1);
+    *z = joinLanes(z0, z1);
+    *w = joinLanes(w0, w1);
+}
+
+DISPATCH_TARGET("avx2,fma")
+static void normalizeBatchAvx2(float *out, const float *q, int count) {
+    __m256 zero = _mm256_setzero_ps();
+    __m256 one = _mm256_set1_ps(1.0f);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y, z, w;
+        loadQuaternionLanes8(&x, &y, &z, &w, &q[i * 4]);
+
+        __m256 lenSq = _mm256_fmadd_ps(w, w, _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x))));
+        __m256 isZero = _mm256_cmp_ps(lenSq, zero, _CMP_EQ_OQ);
+        // Zero length lanes divide 0 by 1 and get w forced to 1, giving the identity like QuaternionNormalize
+        __m256 len = _mm256_blendv_ps(_mm256_sqrt_ps(lenSq), one, isZero);
+
+        x = _mm256_div_ps(x, len);
+        y = _mm256_div_ps(y, len);
+        z = _mm256_div_ps(z, len);
+        w = _mm256_blendv_ps(_mm256_div_ps(w, len), one, isZero);
+
+        storeQuaternionLanes(&out[i * 4], _mm256_castps256_ps128(x), _mm256_castps256_ps128(y),
+                             _mm256_castps256_ps128(z), _mm256_castps256_ps128(w));
+        storeQuaternionLanes(&out[i * 4 + 16], _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1),
+                             _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1));
+    }
+
+    normalizeBatchScalar(&out[i * 4], &q[i * 4], count - i);
+}
+
+DISPATCH_TARGET("avx2,fma")
+static void rotationBatchAvx2(float *out, const float *v, const float q[QUATERNION_SIZE], int count) {
+    __m256 qx = _mm256_set1_ps(q[0]);
+    __m256 qy = _mm256_set1_ps(q[1]);
+    __m256 qz = _mm256_set1_ps(q[2]);
+    __m256 qw = _mm256_set1_ps(q[3]);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 x, y, z;
+        loadVec3Lanes8(&x, &y, &z, &v[i * 3]);
+        rotateLanes8(&x, &y, &z, qx, qy, qz, qw);
+        storeVec3Lanes8(&out[i * 3], x, y, z);
+    }
+
+    rotationBatchScalar(&out[i * 3], &v[i * 3], q, count - i);
+}
+
+DISPATCH_TARGET("avx2,fma")
+static void rotationBatchEachAvx2(float *out, const float *v, const float *q, int count) {
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256 qx, qy, qz, qw;
+        loadQuaternionLanes8(&qx, &qy, &qz, &qw, &q[i * 4]);
+
+        __m256 x, y, z;
+        loadVec3Lanes8(&x, &y, &z, &v[i * 3]);
+        rotateLanes8(&x, &y, &z, qx, qy, qz, qw);
+        storeVec3Lanes8(&out[i * 3], x, y, z);
+    }
+
+    rotationBatchEachScalar(&out[i * 3], &v[i * 3], &q[i * 4], count - i);
+}
+#endif
+
+static void (*normalizeBatch)(float *, const float *, int) = normalizeBatchScalar;
+static void (*rotationBatch)(float *, const float *, const float *, int) = rotationBatchScalar;
+static void (*rotationBatchEach)(float *, const float *, const float *, int) = rotationBatchEachScalar;
+
+void QuaternionNormalizeBatch(float *out, const float *q, int count) {
+    if (out == NULL || q == NULL || count <= 0) return;
+
+    PROFILE_ZONE_BEGIN("QuaternionNormalizeBatch");
+    normalizeBatch(out, q, count);
+    PROFILE_ZONE_END("QuaternionNormalizeBatch");
+}
+
+void QuaternionVec3RotationBatch(float *out, const float *v, const float q[QUATERNION_SIZE], int count) {
+    if (out == NULL || v == NULL || q == NULL || count <= 0) return;
+
+    PROFILE_ZONE_BEGIN("QuaternionVec3RotationBatch");
+    rotationBatch(out, v, q, count);
+    PROFILE_ZONE_END("QuaternionVec3RotationBatch");
+}
+
+void QuaternionVec3RotationBatchEach(float *out, const float *v, const float *q, int count) {
+    if (out == NULL || v == NULL || q == NULL || count <= 0) return;
+
+    PROFILE_ZONE_BEGIN("QuaternionVec3RotationBatchEach");
+    rotationBatchEach(out, v, q, count);
+    PROFILE_ZONE_END("QuaternionVec3RotationBatchEach");
+}
+
+// AVX-512 has no quaternion kernels of its own, the 8 lane AVX2 ones are used
+void QuaternionBindTier(enum DispatchTier tier) {
+    normalizeBatch = normalizeBatchScalar;
+    rotationBatch = rotationBatchScalar;
+    rotationBatchEach = rotationBatchEachScalar;
+
+#if DISPATCH_X86
+    switch (tier) {
+        case DISPATCH_TIER_AVX512:
+        case DISPATCH_TIER_AVX2:
+            normalizeBatch = normalizeBatchAvx2;
+            rotationBatch = rotationBatchAvx2;
+            rotationBatchEach = rotationBatchEachAvx2;
+            break;
+        case DISPATCH_TIER_SSE:
+            normalizeBatch = normalizeBatchSse;
+            rotationBatch = rotationBatchSse;
+            rotationBatchEach = rotationBatchEachSse;
+            break;
+        default:
+            break;
+    }
+#else
+    (void) tier;
+#endif
+}
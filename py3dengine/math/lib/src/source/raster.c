@@ -0,0 +1,828 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "raster.h"
+#include "parallel.h"
+#include "profiler.h"
+#include "dispatch.h"
+
+#if DISPATCH_X86
+#include <immintrin.h>
+#endif
+
+#define RASTER_SUBPIXELS (1 << RASTER_SUBPIXEL_BITS)
+#define RASTER_HALF_SUBPIXEL (RASTER_SUBPIXELS / 2)
+#define RASTER_GUARD_BAND 16384.0f
+#define RASTER_MIN_W 1e-7f
+#define RASTER_VERTICES_PER_RANGE 4096
+#define RASTER_TRIANGLES_PER_RANGE 1024
+
+// Clip space vertices carry x, y, z, w and the normal
+#define RASTER_CLIP_FLOATS 7
+#define RASTER_CLIP_PLANES 6
+#define RASTER_MAX_POLYGON (3 + RASTER_CLIP_PLANES)
+
+// Interpolated per pixel: depth and the normal divided by w
+#define RASTER_PLANES 4
+
+#define STATUS_REJECTED 0
+#define STATUS_READY 1
+#define STATUS_CLIP 2
+
+struct RasterTriangle {
+    // Inclusive pixel bounds, already clamped to the target
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+
+    // Edge functions at subpixel sample positions, E = a * x + b * y + c, a pixel is covered when all three are >= 0
+    int a[3];
+    int b[3];
+    int64_t c[3];
+
+    // Attribute planes at pixel centers: value = planes[i][0] + planes[i][1] * (x - originX) + planes[i][2] * (y - originY)
+    float originX;
+    float originY;
+    float planes[RASTER_PLANES][3];
+};
+
+/** Target */
+int RasterInit(struct RasterTarget *target, int width, int height, int threadCount) {
+    if (target == NULL) return 0;
+
+    memset(target, 0, sizeof(struct RasterTarget));
+    if (width <= 0 || height <= 0 || width > RASTER_MAX_SIZE || height > RASTER_MAX_SIZE) return 0;
+
+    target->width = width;
+    target->height = height;
+    target->tilesX = (width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+    target->tilesY = (height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+    target->threadCount = threadCount;
+
+    size_t pixels = (size_t) width * (size_t) height;
+    target->color = malloc(pixels * RASTER_COLOR_CHANNELS);
+    target->depth = malloc(pixels * sizeof(float));
+    target->bins = calloc((size_t) target->tilesX * (size_t) target->tilesY, sizeof(struct RasterBin));
+    if (target->color == NULL || target->depth == NULL || target->bins == NULL) {
+        RasterRelease(target);
+        return 0;
+    }
+
+    const float black[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    RasterClear(target, black, 1.0f);
+
+    return 1;
+}
+
+void RasterRelease(struct RasterTarget *target) {
+    if (target == NULL) return;
+
+    if (target->bins != NULL) {
+        for (int i = 0; i < target->tilesX * target->tilesY; ++i) {
+            free(target->bins[i].items);
+        }
+    }
+
+    free(target->bins);
+    free(target->color);
+    free(target->depth);
+    free(target->clip);
+    free(target->status);
+    free(target->triangles);
+    memset(target, 0, sizeof(struct RasterTarget));
+}
+
+static int toByte(float value) {
+    return (int) (fminf(fmaxf(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+void RasterClear(struct RasterTarget *target, const float color[4], float depth) {
+    if (target == NULL || target->color == NULL || color == NULL) return;
+
+    uint32_t packed = (uint32_t) toByte(color[0])
+        | (uint32_t) toByte(color[1]) << 8
+        | (uint32_t) toByte(color[2]) << 16
+        | (uint32_t) toByte(color[3]) << 24;
+
+    size_t pixels = (size_t) target->width * (size_t) target->height;
+    uint32_t *colors = (uint32_t *) target->color;
+    for (size_t i = 0; i < pixels; ++i) {
+        colors[i] = packed;
+        target->depth[i] = depth;
+    }
+}
+
+/** Vertex stage */
+struct VertexContext {
+    float *clip;
+    const float *positions;
+    const float *mvp;
+};
+
+static void transformRange(void *arg, int begin, int end) {
+    const struct VertexContext *context = arg;
+    const float *m = context->mvp;
+
+    for (int i = begin; i < end; ++i) {
+        const float *p = context->positions + i * 3;
+        float *out = context->clip + i * 4;
+
+        for (int c = 0; c < 4; ++c) {
+            out[c] = p[0] * m[c] + p[1] * m[4 + c] + p[2] * m[8 + c] + m[12 + c];
+        }
+    }
+}
+
+/** Triangle setup */
+static int64_t floorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+
+static void setupPlane(
+    float out[3],
+    const double x[3],
+    const double y[3],
+    const float values[3],
+    double invDet
+) {
+    double d1 = (double) values[1] - values[0];
+    double d2 = (double) values[2] - values[0];
+
+    out[0] = values[0];
+    out[1] = (float) ((d1 * (y[2] - y[0]) - d2 * (y[1] - y[0])) * invDet);
+    out[2] = (float) ((d2 * (x[1] - x[0]) - d1 * (x[2] - x[0])) * invDet);
+}
+
+/** Projects, snaps and sets up one clipped triangle, returns 0 if it covers no pixel or is culled */
+static int setupTriangle(
+    const struct RasterTarget *target,
+    struct RasterTriangle *out,
+    const float *v0,
+    const float *v1,
+    const float *v2,
+    int cullBackFaces
+) {
+    const float *vertices[3] = {v0, v1, v2};
+    int64_t sx[3], sy[3];
+    float z[3], invW[3];
+
+    for (int i = 0; i < 3; ++i) {
+        const float *v = vertices[i];
+        if (!(v[3] > RASTER_MIN_W)) return 0;
+
+        invW[i] = 1.0f / v[3];
+        float px = (v[0] * invW[i] * 0.5f + 0.5f) * (float) target->width;
+        float py = (0.5f - v[1] * invW[i] * 0.5f) * (float) target->height;
+        sx[i] = (int64_t) floorf(px * RASTER_SUBPIXELS + 0.5f);
+        sy[i] = (int64_t) floorf(py * RASTER_SUBPIXELS + 0.5f);
+        z[i] = v[2] * invW[i];
+    }
+
+    // Rows run top to bottom, so triangles counter clockwise on screen have a negative area here
+    int64_t area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+    if (area == 0) return 0;
+
+    float facing = 1.0f;
+    if (area > 0) {
+        if (cullBackFaces) return 0;
+        facing = -1.0f;
+    } else {
+        // The edge functions below expect a positive area
+        const float *vt = vertices[1]; vertices[1] = vertices[2]; vertices[2] = vt;
+        int64_t t = sx[1]; sx[1] = sx[2]; sx[2] = t;
+        t = sy[1]; sy[1] = sy[2]; sy[2] = t;
+        float f = z[1]; z[1] = z[2]; z[2] = f;
+        f = invW[1]; invW[1] = invW[2]; invW[2] = f;
+    }
+
+    // Pixel x is sampled at x * RASTER_SUBPIXELS + RASTER_HALF_SUBPIXEL
+    int64_t minSx = sx[0], maxSx = sx[0], minSy = sy[0], maxSy = sy[0];
+    for (int i = 1; i < 3; ++i) {
+        if (sx[i] < minSx) minSx = sx[i];
+        if (sx[i] > maxSx) maxSx = sx[i];
+        if (sy[i] < minSy) minSy = sy[i];
+        if (sy[i] > maxSy) maxSy = sy[i];
+    }
+
+    int64_t minX = -floorDiv(-(minSx - RASTER_HALF_SUBPIXEL), RASTER_SUBPIXELS);
+    int64_t maxX = floorDiv(maxSx - RASTER_HALF_SUBPIXEL, RASTER_SUBPIXELS);
+    int64_t minY = -floorDiv(-(minSy - RASTER_HALF_SUBPIXEL), RASTER_SUBPIXELS);
+    int64_t maxY = floorDiv(maxSy - RASTER_HALF_SUBPIXEL, RASTER_SUBPIXELS);
+    if (minX < 0) minX = 0;
+    if (minY < 0) minY = 0;
+    if (maxX > target->width - 1) maxX = target->width - 1;
+    if (maxY > target->height - 1) maxY = target->height - 1;
+    if (minX > maxX || minY > maxY) return 0;
+
+    out->minX = (int) minX;
+    out->minY = (int) minY;
+    out->maxX = (int) maxX;
+    out->maxY = (int) maxY;
+
+    for (int i = 0; i < 3; ++i) {
+        int j = (i + 1) % 3, k = (i + 2) % 3;
+        out->a[i] = (int) (sy[j] - sy[k]);
+        out->b[i] = (int) (sx[k] - sx[j]);
+        out->c[i] = (sy[k] - sy[j]) * sx[j] - (sx[k] - sx[j]) * sy[j];
+
+        // Top-left rule: pixels exactly on an edge belong to the triangle on its top or left side
+        int topLeft = out->a[i] > 0 || (out->a[i] == 0 && out->b[i] > 0);
+        if (!topLeft) out->c[i] -= 1;
+    }
+
+    // Attributes are planes over the snapped positions, in pixel units with pixel centers at + 0.5
+    double x[3], y[3];
+    for (int i = 0; i < 3; ++i) {
+        x[i] = (double) sx[i] / RASTER_SUBPIXELS;
+        y[i] = (double) sy[i] / RASTER_SUBPIXELS;
+    }
+    double invDet = 1.0 / ((x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]));
+    out->originX = (float) x[0];
+    out->originY = (float) y[0];
+
+    setupPlane(out->planes[0], x, y, z, invDet);
+
+    // Normals interpolate as n / w, dividing by the interpolated 1 / w would only rescale them before normalization
+    for (int c = 0; c < 3; ++c) {
+        float values[3];
+        for (int i = 0; i < 3; ++i) {
+            values[i] = vertices[i][4 + c] * invW[i] * facing;
+        }
+        setupPlane(out->planes[1 + c], x, y, values, invDet);
+    }
+
+    return 1;
+}
+
+/** Clipping against the depth range and the guard band, in homogeneous space */
+static void planeDistances(float out[RASTER_CLIP_PLANES], const float *v, float guardX, float guardY) {
+    out[0] = v[2];
+    out[1] = v[3] - v[2];
+    out[2] = guardX * v[3] - v[0];
+    out[3] = guardX * v[3] + v[0];
+    out[4] = guardY * v[3] - v[1];
+    out[5] = guardY * v[3] + v[1];
+}
+
+static int clipPolygon(float polygon[RASTER_MAX_POLYGON][RASTER_CLIP_FLOATS], int count, float guardX, float guardY) {
+    float scratch[RASTER_MAX_POLYGON][RASTER_CLIP_FLOATS];
+
+    for (int plane = 0; plane < RASTER_CLIP_PLANES && count >= 3; ++plane) {
+        int written = 0;
+
+        for (int i = 0; i < count; ++i) {
+            const float *current = polygon[i];
+            const float *next = polygon[(i + 1) % count];
+            float dCurrent[RASTER_CLIP_PLANES], dNext[RASTER_CLIP_PLANES];
+            planeDistances(dCurrent, current, guardX, guardY);
+            planeDistances(dNext, next, guardX, guardY);
+
+            if (dCurrent[plane] >= 0.0f) {
+                memcpy(scratch[written++], current, sizeof(float) * RASTER_CLIP_FLOATS);
+            }
+
+            if ((dCurrent[plane] >= 0.0f) != (dNext[plane] >= 0.0f)) {
+                float t = dCurrent[plane] / (dCurrent[plane] - dNext[plane]);
+                for (int c = 0; c < RASTER_CLIP_FLOATS; ++c) {
+                    scratch[written][c] = current[c] + (next[c] - current[c]) * t;
+                }
+                ++written;
+            }
+        }
+
+        memcpy(polygon, scratch, sizeof(float) * RASTER_CLIP_FLOATS * written);
+        count = written;
+    }
+
+    return count;
+}
+
+struct SetupContext {
+    struct RasterTarget *target;
+    const float *positions;
+    const float *normals;
+    int vertexCount;
+    const unsigned int *indices;
+    int cullBackFaces;
+    float guardX;
+    float guardY;
+};
+
+/** Gathers a triangle's clip space vertices with their normals, the face normal when there are none */
+static int gatherTriangle(const struct SetupContext *context, int triangle, float out[3][RASTER_CLIP_FLOATS]) {
+    const unsigned int *index = context->indices + triangle * 3;
+    for (int i = 0; i < 3; ++i) {
+        if (index[i] >= (unsigned int) context->vertexCount) return 0;
+    }
+
+    float face[VEC_3_SIZE];
+    if (context->normals == NULL) {
+        const float *p0 = context->positions + index[0] * 3;
+        const float *p1 = context->positions + index[1] * 3;
+        const float *p2 = context->positions + index[2] * 3;
+        float e1[VEC_3_SIZE] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+        float e2[VEC_3_SIZE] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+        face[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        face[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        face[2] = e1[0] * e2[1] - e1[1] * e2[0];
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        memcpy(out[i], context->target->clip + index[i] * 4, sizeof(float) * 4);
+        memcpy(out[i] + 4, context->normals != NULL ? context->normals + index[i] * 3 : face, sizeof(float) * 3);
+    }
+
+    return 1;
+}
+
+static void setupRange(void *arg, int begin, int end) {
+    const struct SetupContext *context = arg;
+    struct RasterTarget *target = context->target;
+
+    for (int t = begin; t < end; ++t) {
+        float vertices[3][RASTER_CLIP_FLOATS];
+        target->status[t] = STATUS_REJECTED;
+        if (!gatherTriangle(context, t, vertices)) continue;
+
+        int outside[RASTER_CLIP_PLANES] = {0};
+        int anyOutside = 0;
+        for (int i = 0; i < 3; ++i) {
+            float d[RASTER_CLIP_PLANES];
+            planeDistances(d, vertices[i], context->guardX, context->guardY);
+            for (int p = 0; p < RASTER_CLIP_PLANES; ++p) {
+                if (d[p] < 0.0f) {
+                    outside[p]++;
+                    anyOutside = 1;
+                }
+            }
+        }
+
+        int rejected = 0;
+        for (int p = 0; p < RASTER_CLIP_PLANES; ++p) {
+            if (outside[p] == 3) rejected = 1;
+        }
+        if (rejected) continue;
+
+        if (anyOutside) {
+            target->status[t] = STATUS_CLIP;
+        } else if (setupTriangle(target, &target->triangles[t], vertices[0], vertices[1], vertices[2], context->cullBackFaces)) {
+            target->status[t] = STATUS_READY;
+        }
+    }
+}
+
+/** Binning */
+static int binTriangle(struct RasterTarget *target, int triangle) {
+    const struct RasterTriangle *t = &target->triangles[triangle];
+    int tileMinX = t->minX / RASTER_TILE_SIZE, tileMaxX = t->maxX / RASTER_TILE_SIZE;
+    int tileMinY = t->minY / RASTER_TILE_SIZE, tileMaxY = t->maxY / RASTER_TILE_SIZE;
+
+    for (int ty = tileMinY; ty <= tileMaxY; ++ty) {
+        for (int tx = tileMinX; tx <= tileMaxX; ++tx) {
+            struct RasterBin *bin = &target->bins[ty * target->tilesX + tx];
+            if (bin->count == bin->capacity) {
+                int capacity = bin->capacity > 0 ? bin->capacity * 2 : 64;
+                int *items = realloc(bin->items, sizeof(int) * capacity);
+                if (items == NULL) return 0;
+
+                bin->items = items;
+                bin->capacity = capacity;
+            }
+
+            bin->items[bin->count++] = triangle;
+        }
+    }
+
+    return 1;
+}
+
+static int reserveTriangles(struct RasterTarget *target, int count) {
+    if (count <= target->triangleCapacity) return 1;
+
+    int capacity = target->triangleCapacity > 0 ? target->triangleCapacity : 256;
+    while (capacity < count) capacity *= 2;
+
+    struct RasterTriangle *triangles = realloc(target->triangles, sizeof(struct RasterTriangle) * capacity);
+    if (triangles == NULL) return 0;
+
+    target->triangles = triangles;
+    target->triangleCapacity = capacity;
+    return 1;
+}
+
+/**
+ * Bins the set up triangles in submission order. Triangles crossing a clip plane are clipped here, their pieces
+ * are appended after the submitted triangles. Returns the number of triangles binned or -1 if out of memory.
+ */
+static int binTriangles(struct RasterTarget *target, const struct SetupContext *context, int triangleCount) {
+    int drawn = 0;
+    int extra = triangleCount;
+
+    for (int t = 0; t < triangleCount; ++t) {
+        if (target->status[t] == STATUS_READY) {
+            if (!binTriangle(target, t)) return -1;
+            drawn++;
+            continue;
+        }
+        if (target->status[t] != STATUS_CLIP) continue;
+
+        float polygon[RASTER_MAX_POLYGON][RASTER_CLIP_FLOATS];
+        gatherTriangle(context, t, polygon);
+        int count = clipPolygon(polygon, 3, context->guardX, context->guardY);
+
+        for (int i = 1; i + 1 < count; ++i) {
+            if (!reserveTriangles(target, extra + 1)) return -1;
+            if (!setupTriangle(target, &target->triangles[extra], polygon[0], polygon[i], polygon[i + 1], context->cullBackFaces)) {
+                continue;
+            }
+
+            if (!binTriangle(target, extra)) return -1;
+            extra++;
+            drawn++;
+        }
+    }
+
+    return drawn;
+}
+
+/** Tile rasterization */
+struct ShadeParams {
+    float color[VEC_3_SIZE];
+    float lightDir[VEC_3_SIZE];
+    float ambient;
+    float diffuse;
+    int reverseZ;
+};
+
+struct Span {
+    // Edge values at the first pixel of the row and their step per pixel
+    int e[3];
+    int step[3];
+    // Attribute values at the first pixel of the row and their step per pixel
+    float values[RASTER_PLANES];
+    float dx[RASTER_PLANES];
+};
+
+static uint32_t shadePixel(const struct ShadeParams *shade, float nx, float ny, float nz) {
+    float lengthSq = nx * nx + ny * ny + nz * nz;
+    float d = 0.0f;
+    if (lengthSq > 0.0f) d = (nx * shade->lightDir[0] + ny * shade->lightDir[1] + nz * shade->lightDir[2]) / sqrtf(lengthSq);
+
+    float intensity = shade->ambient + shade->diffuse * fmaxf(d, 0.0f);
+    uint32_t pixel = 0xFF000000u;
+    for (int c = 0; c < 3; ++c) {
+        pixel |= (uint32_t) (int) (fminf(shade->color[c] * intensity, 1.0f) * 255.0f + 0.5f) << (8 * c);
+    }
+
+    return pixel;
+}
+
+static void shadeSpanScalar(const struct ShadeParams *shade, const struct Span *span, int count, uint32_t *colors, float *depths) {
+    for (int x = 0; x < count; ++x) {
+        int e0 = span->e[0] + span->step[0] * x;
+        int e1 = span->e[1] + span->step[1] * x;
+        int e2 = span->e[2] + span->step[2] * x;
+        if ((e0 | e1 | e2) < 0) continue;
+
+        float offset = (float) x;
+        float z = fminf(fmaxf(span->values[0] + span->dx[0] * offset, 0.0f), 1.0f);
+        int pass = shade->reverseZ ? z > depths[x] : z < depths[x];
+        if (!pass) continue;
+
+        depths[x] = z;
+        colors[x] = shadePixel(
+            shade,
+            span->values[1] + span->dx[1] * offset,
+            span->values[2] + span->dx[2] * offset,
+            span->values[3] + span->dx[3] * offset
+        );
+    }
+}
+
+#if DISPATCH_X86
+#define RASTER_SSE_LANES 4
+#define RASTER_AVX2_LANES 8
+
+DISPATCH_TARGET("avx2,fma")
+static void shadeSpanAvx2(const struct ShadeParams *shade, const struct Span *span, int count, uint32_t *colors, float *depths) {
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    const __m256 lx = _mm256_set1_ps(shade->lightDir[0]);
+    const __m256 ly = _mm256_set1_ps(shade->lightDir[1]);
+    const __m256 lz = _mm256_set1_ps(shade->lightDir[2]);
+    const __m256 ambient = _mm256_set1_ps(shade->ambient), diffuse = _mm256_set1_ps(shade->diffuse);
+    const __m256 scale = _mm256_set1_ps(255.0f), half = _mm256_set1_ps(0.5f);
+
+    for (int x = 0; x < count; x += RASTER_AVX2_LANES) {
+        __m256i offsets = _mm256_add_epi32(_mm256_set1_epi32(x), lanes);
+        __m256i covered = _mm256_cmpgt_epi32(_mm256_set1_epi32(count), offsets);
+        for (int i = 0; i < 3; ++i) {
+            __m256i e = _mm256_add_epi32(_mm256_set1_epi32(span->e[i]), _mm256_mullo_epi32(_mm256_set1_epi32(span->step[i]), offsets));
+            covered = _mm256_andnot_si256(_mm256_srai_epi32(e, 31), covered);
+        }
+        if (_mm256_testz_si256(covered, covered)) continue;
+
+        // Lanes past count are masked off, they read and write nothing
+        __m256 mask = _mm256_castsi256_ps(covered);
+        __m256 offset = _mm256_cvtepi32_ps(offsets);
+        __m256 stored = _mm256_maskload_ps(depths + x, covered);
+        __m256 z = _mm256_add_ps(_mm256_set1_ps(span->values[0]), _mm256_mul_ps(_mm256_set1_ps(span->dx[0]), offset));
+        z = _mm256_min_ps(_mm256_max_ps(z, zero), one);
+        __m256 pass = shade->reverseZ ? _mm256_cmp_ps(z, stored, _CMP_GT_OQ) : _mm256_cmp_ps(z, stored, _CMP_LT_OQ);
+        mask = _mm256_and_ps(mask, pass);
+        if (_mm256_testz_ps(mask, mask)) continue;
+
+        __m256 n[3];
+        for (int c = 0; c < 3; ++c) {
+            n[c] = _mm256_add_ps(_mm256_set1_ps(span->values[1 + c]), _mm256_mul_ps(_mm256_set1_ps(span->dx[1 + c]), offset));
+        }
+        __m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(n[0], n[0]), _mm256_mul_ps(n[1], n[1])), _mm256_mul_ps(n[2], n[2]));
+        __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(n[0], lx), _mm256_mul_ps(n[1], ly)), _mm256_mul_ps(n[2], lz));
+        __m256 d = _mm256_and_ps(_mm256_div_ps(dot, _mm256_sqrt_ps(lengthSq)), _mm256_cmp_ps(lengthSq, zero, _CMP_GT_OQ));
+        __m256 intensity = _mm256_add_ps(ambient, _mm256_mul_ps(diffuse, _mm256_max_ps(d, zero)));
+
+        __m256i pixel = _mm256_set1_epi32((int) 0xFF000000u);
+        for (int c = 0; c < 3; ++c) {
+            __m256 value = _mm256_min_ps(_mm256_mul_ps(_mm256_set1_ps(shade->color[c]), intensity), one);
+            __m256i channel = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, scale), half));
+            pixel = _mm256_or_si256(pixel, _mm256_slli_epi32(channel, 8 * c));
+        }
+
+        __m256i write = _mm256_castps_si256(mask);
+        _mm256_maskstore_ps(depths + x, write, z);
+        _mm256_maskstore_epi32((int *) (colors + x), write, pixel);
+    }
+}
+
+DISPATCH_TARGET("sse2")
+static void shadeSpanSse(const struct ShadeParams *shade, const struct Span *span, int count, uint32_t *colors, float *depths) {
+    const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 lx = _mm_set1_ps(shade->lightDir[0]);
+    const __m128 ly = _mm_set1_ps(shade->lightDir[1]);
+    const __m128 lz = _mm_set1_ps(shade->lightDir[2]);
+    const __m128 ambient = _mm_set1_ps(shade->ambient), diffuse = _mm_set1_ps(shade->diffuse);
+    const __m128 scale = _mm_set1_ps(255.0f), half = _mm_set1_ps(0.5f);
+
+    for (int x = 0; x < count; x += RASTER_SSE_LANES) {
+        int e[3][RASTER_SSE_LANES];
+        for (int i = 0; i < 3; ++i) {
+            for (int l = 0; l < RASTER_SSE_LANES; ++l) {
+                e[i][l] = span->e[i] + span->step[i] * (x + l);
+            }
+        }
+
+        // SSE2 has no 32 bit multiply, the edge values above are stepped in scalar and tested together
+        __m128i offsets = _mm_add_epi32(_mm_set1_epi32(x), lanes);
+        __m128i covered = _mm_cmpgt_epi32(_mm_set1_epi32(count), offsets);
+        __m128i any = _mm_or_si128(
+            _mm_or_si128(_mm_loadu_si128((const __m128i *) e[0]), _mm_loadu_si128((const __m128i *) e[1])),
+            _mm_loadu_si128((const __m128i *) e[2])
+        );
+        covered = _mm_andnot_si128(_mm_srai_epi32(any, 31), covered);
+        if (_mm_movemask_epi8(covered) == 0) continue;
+
+        // The tail group may run past count, read through a copy so nothing outside the span is touched
+        int valid = count - x < RASTER_SSE_LANES ? count - x : RASTER_SSE_LANES;
+        float depthCopy[RASTER_SSE_LANES] = {0.0f};
+        uint32_t colorCopy[RASTER_SSE_LANES] = {0};
+        memcpy(depthCopy, depths + x, sizeof(float) * valid);
+        memcpy(colorCopy, colors + x, sizeof(uint32_t) * valid);
+
+        __m128 mask = _mm_castsi128_ps(covered);
+        __m128 offset = _mm_cvtepi32_ps(offsets);
+        __m128 stored = _mm_loadu_ps(depthCopy);
+        __m128 z = _mm_add_ps(_mm_set1_ps(span->values[0]), _mm_mul_ps(_mm_set1_ps(span->dx[0]), offset));
+        z = _mm_min_ps(_mm_max_ps(z, zero), one);
+        __m128 pass = shade->reverseZ ? _mm_cmpgt_ps(z, stored) : _mm_cmplt_ps(z, stored);
+        mask = _mm_and_ps(mask, pass);
+        if (_mm_movemask_ps(mask) == 0) continue;
+
+        __m128 n[3];
+        for (int c = 0; c < 3; ++c) {
+            n[c] = _mm_add_ps(_mm_set1_ps(span->values[1 + c]), _mm_mul_ps(_mm_set1_ps(span->dx[1 + c]), offset));
+        }
+        __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n[0], n[0]), _mm_mul_ps(n[1], n[1])), _mm_mul_ps(n[2], n[2]));
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(n[0], lx), _mm_mul_ps(n[1], ly)), _mm_mul_ps(n[2], lz));
+        __m128 d = _mm_and_ps(_mm_div_ps(dot, _mm_sqrt_ps(lengthSq)), _mm_cmpgt_ps(lengthSq, zero));
+        __m128 intensity = _mm_add_ps(ambient, _mm_mul_ps(diffuse, _mm_max_ps(d, zero)));
+
+        __m128i pixel = _mm_set1_epi32((int) 0xFF000000u);
+        for (int c = 0; c < 3; ++c) {
+            __m128 value = _mm_min_ps(_mm_mul_ps(_mm_set1_ps(shade->color[c]), intensity), one);
+            __m128i channel = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+            pixel = _mm_or_si128(pixel, _mm_slli_epi32(channel, 8 * c));
+        }
+
+        __m128i write = _mm_castps_si128(mask);
+        __m128 newDepth = _mm_or_ps(_mm_and_ps(mask, z), _mm_andnot_ps(mask, stored));
+        __m128i newColor = _mm_or_si128(
+            _mm_and_si128(write, pixel),
+            _mm_andnot_si128(write, _mm_loadu_si128((const __m128i *) colorCopy))
+        );
+        _mm_storeu_ps(depthCopy, newDepth);
+        _mm_storeu_si128((__m128i *) colorCopy, newColor);
+        memcpy(depths + x, depthCopy, sizeof(float) * valid);
+        memcpy(colors + x, colorCopy, sizeof(uint32_t) * valid);
+    }
+}
+#endif
+
+static void (*shadeSpan)(const struct ShadeParams *, const struct Span *, int, uint32_t *, float *) = shadeSpanScalar;
+
+static int64_t edgeAt(const struct RasterTriangle *t, int i, int x, int y) {
+    return (int64_t) t->a[i] * (x * RASTER_SUBPIXELS + RASTER_HALF_SUBPIXEL)
+        + (int64_t) t->b[i] * (y * RASTER_SUBPIXELS + RASTER_HALF_SUBPIXEL)
+        + t->c[i];
+}
+
+static void rasterTriangle(
+    struct RasterTarget *target,
+    const struct ShadeParams *shade,
+    const struct RasterTriangle *t,
+    int x0,
+    int y0,
+    int x1,
+    int y1
+) {
+    struct Span span;
+    int rowStep[3];
+
+    for (int i = 0; i < 3; ++i) {
+        int64_t corners[4] = {edgeAt(t, i, x0, y0), edgeAt(t, i, x1, y0), edgeAt(t, i, x0, y1), edgeAt(t, i, x1, y1)};
+        int64_t min = corners[0], max = corners[0];
+        for (int c = 1; c < 4; ++c) {
+            if (corners[c] < min) min = corners[c];
+            if (corners[c] > max) max = corners[c];
+        }
+
+        if (max < 0) return;
+
+        // An edge that passes the whole region is skipped, one that crosses it stays within int range over the tile
+        if (min >= 0) {
+            span.e[i] = 0;
+            span.step[i] = 0;
+            rowStep[i] = 0;
+        } else {
+            span.e[i] = (int) corners[0];
+            span.step[i] = t->a[i] * RASTER_SUBPIXELS;
+            rowStep[i] = t->b[i] * RASTER_SUBPIXELS;
+        }
+    }
+
+    float startX = (float) x0 + 0.5f - t->originX;
+    for (int p = 0; p < RASTER_PLANES; ++p) {
+        span.dx[p] = t->planes[p][1];
+    }
+
+    int count = x1 - x0 + 1;
+    for (int y = y0; y <= y1; ++y) {
+        float startY = (float) y + 0.5f - t->originY;
+        for (int p = 0; p < RASTER_PLANES; ++p) {
+            span.values[p] = t->planes[p][0] + t->planes[p][1] * startX + t->planes[p][2] * startY;
+        }
+
+        size_t row = (size_t) y * (size_t) target->width + (size_t) x0;
+        shadeSpan(shade, &span, count, (uint32_t *) target->color + row, target->depth + row);
+
+        for (int i = 0; i < 3; ++i) {
+            span.e[i] += rowStep[i];
+        }
+    }
+}
+
+struct TileContext {
+    struct RasterTarget *target;
+    const struct ShadeParams *shade;
+};
+
+static void rasterRange(void *arg, int begin, int end) {
+    const struct TileContext *context = arg;
+    struct RasterTarget *target = context->target;
+
+    for (int tile = begin; tile < end; ++tile) {
+        const struct RasterBin *bin = &target->bins[tile];
+        int tileX = (tile % target->tilesX) * RASTER_TILE_SIZE;
+        int tileY = (tile / target->tilesX) * RASTER_TILE_SIZE;
+        int tileMaxX = tileX + RASTER_TILE_SIZE - 1 < target->width - 1 ? tileX + RASTER_TILE_SIZE - 1 : target->width - 1;
+        int tileMaxY = tileY + RASTER_TILE_SIZE - 1 < target->height - 1 ? tileY + RASTER_TILE_SIZE - 1 : target->height - 1;
+
+        for (int i = 0; i < bin->count; ++i) {
+            const struct RasterTriangle *t = &target->triangles[bin->items[i]];
+            rasterTriangle(
+                target, context->shade, t,
+                t->minX > tileX ? t->minX : tileX,
+                t->minY > tileY ? t->minY : tileY,
+                t->maxX < tileMaxX ? t->maxX : tileMaxX,
+                t->maxY < tileMaxY ? t->maxY : tileMaxY
+            );
+        }
+    }
+}
+
+/** Draw */
+int RasterDrawIndexed(
+    struct RasterTarget *target,
+    const float mvp[MAT_4_SIZE],
+    const float *positions,
+    const float *normals,
+    int vertexCount,
+    const unsigned int *indices,
+    int indexCount,
+    const struct RasterShading *shading
+) {
+    if (target == NULL || target->color == NULL || mvp == NULL || positions == NULL || indices == NULL || shading == NULL) return -1;
+    if (vertexCount <= 0 || indexCount < 3) return 0;
+
+    int triangleCount = indexCount / 3;
+
+    if (vertexCount > target->clipCapacity) {
+        float *clip = realloc(target->clip, sizeof(float) * 4 * (size_t) vertexCount);
+        if (clip == NULL) return -1;
+
+        target->clip = clip;
+        target->clipCapacity = vertexCount;
+    }
+    if (triangleCount > target->statusCapacity) {
+        unsigned char *status = realloc(target->status, (size_t) triangleCount);
+        if (status == NULL) return -1;
+
+        target->status = status;
+        target->statusCapacity = triangleCount;
+    }
+    if (!reserveTriangles(target, triangleCount)) return -1;
+
+    struct VertexContext vertexContext = {target->clip, positions, mvp};
+    PROFILE_ZONE_BEGIN("RasterTransform");
+    ParallelFor(vertexCount, RASTER_VERTICES_PER_RANGE, target->threadCount, transformRange, &vertexContext);
+    PROFILE_ZONE_END("RasterTransform");
+
+    struct SetupContext setupContext = {
+        .target = target,
+        .positions = positions,
+        .normals = normals,
+        .vertexCount = vertexCount,
+        .indices = indices,
+        .cullBackFaces = shading->cullBackFaces,
+        .guardX = 2.0f * RASTER_GUARD_BAND / (float) target->width - 1.0f,
+        .guardY = 2.0f * RASTER_GUARD_BAND / (float) target->height - 1.0f,
+    };
+    PROFILE_ZONE_BEGIN("RasterSetup");
+    ParallelFor(triangleCount, RASTER_TRIANGLES_PER_RANGE, target->threadCount, setupRange, &setupContext);
+    PROFILE_ZONE_END("RasterSetup");
+
+    int tileCount = target->tilesX * target->tilesY;
+    for (int i = 0; i < tileCount; ++i) {
+        target->bins[i].count = 0;
+    }
+
+    int drawn = binTriangles(target, &setupContext, triangleCount);
+    if (drawn <= 0) return drawn;
+
+    struct ShadeParams shade;
+    float lightLength = sqrtf(
+        shading->lightDir[0] * shading->lightDir[0]
+        + shading->lightDir[1] * shading->lightDir[1]
+        + shading->lightDir[2] * shading->lightDir[2]
+    );
+    for (int c = 0; c < 3; ++c) {
+        shade.color[c] = fmaxf(shading->color[c], 0.0f);
+        shade.lightDir[c] = lightLength > 0.0f ? shading->lightDir[c] / lightLength : 0.0f;
+    }
+    shade.ambient = fminf(fmaxf(shading->ambient, 0.0f), 1.0f);
+    shade.diffuse = 1.0f - shade.ambient;
+    shade.reverseZ = shading->reverseZ;
+
+    struct TileContext tileContext = {target, &shade};
+    PROFILE_ZONE_BEGIN("RasterTiles");
+    ParallelFor(tileCount, 1, target->threadCount, rasterRange, &tileContext);
+    PROFILE_ZONE_END("RasterTiles");
+
+    return drawn;
+}
+
+// AVX-512 has no span kernel of its own, the 8 lane AVX2 one is used
+void RasterBindTier(enum DispatchTier tier) {
+    shadeSpan = shadeSpanScalar;
+
+#if DISPATCH_X86
+    switch (tier) {
+        case DISPATCH_TIER_AVX512:
+        case DISPATCH_TIER_AVX2:
+            shadeSpan = shadeSpanAvx2;
+            break;
+        case DISPATCH_TIER_SSE:
+            shadeSpan = shadeSpanSse;
+            break;
+        default:
+            break;
+    }
+#else
+    (void) tier;
+#endif
+}
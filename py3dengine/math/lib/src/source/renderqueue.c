@@ -0,0 +1,221 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "renderqueue.h"
+#include "profiler.h"
+
+#define RENDER_INITIAL_CAPACITY 256
+#define RENDER_RADIX_BITS 8
+#define RENDER_RADIX_BUCKETS (1 << RENDER_RADIX_BITS)
+#define RENDER_RADIX_PASSES (64 / RENDER_RADIX_BITS)
+
+#define RENDER_DEPTH_BITS 23
+#define RENDER_STATE_BITS 16
+#define RENDER_DEPTH_MASK ((UINT64_C(1) << RENDER_DEPTH_BITS) - 1)
+#define RENDER_STATE_MASK ((UINT64_C(1) << RENDER_STATE_BITS) - 1)
+#define RENDER_TRANSLUCENT_SHIFT 55
+#define RENDER_LAYER_SHIFT 56
+
+static int clampInt(int value, int max) {
+    return value < 0 ? 0 : (value > max ? max : value);
+}
+
+static uint64_t quantizeDepth(float depth) {
+    // Also maps NaN and negative depths to 0
+    if (!(depth > 0.0f)) return 0;
+    if (isinf(depth)) return RENDER_DEPTH_MASK;
+
+    uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+
+    // The sign bit is clear, so the exponent and the top of the mantissa order like the float
+    return (bits >> (31 - RENDER_DEPTH_BITS)) & RENDER_DEPTH_MASK;
+}
+
+uint64_t RenderKeyMake(int layer, int translucent, int material, int mesh, float depth) {
+    uint64_t key = (uint64_t) clampInt(layer, RENDER_MAX_LAYER) << RENDER_LAYER_SHIFT;
+    uint64_t state = (uint64_t) clampInt(material, RENDER_MAX_STATE) << RENDER_STATE_BITS
+        | (uint64_t) clampInt(mesh, RENDER_MAX_STATE);
+    uint64_t quantized = quantizeDepth(depth);
+
+    if (translucent) {
+        key |= UINT64_C(1) << RENDER_TRANSLUCENT_SHIFT;
+        key |= (RENDER_DEPTH_MASK - quantized) << (2 * RENDER_STATE_BITS);
+        key |= state;
+    } else {
+        key |= state << RENDER_DEPTH_BITS;
+        key |= quantized;
+    }
+
+    return key;
+}
+
+void RenderKeyDecode(uint64_t key, int *layer, int *translucent, int *material, int *mesh) {
+    int isTranslucent = (int) ((key >> RENDER_TRANSLUCENT_SHIFT) & 1);
+    uint64_t state = isTranslucent ? key : key >> RENDER_DEPTH_BITS;
+
+    if (layer != NULL) *layer = (int) (key >> RENDER_LAYER_SHIFT);
+    if (translucent != NULL) *translucent = isTranslucent;
+    if (material != NULL) *material = (int) ((state >> RENDER_STATE_BITS) & RENDER_STATE_MASK);
+    if (mesh != NULL) *mesh = (int) (state & RENDER_STATE_MASK);
+}
+
+// The key without its depth, equal for commands that can be drawn by one instanced call
+static uint64_t stateKey(uint64_t key) {
+    if ((key >> RENDER_TRANSLUCENT_SHIFT) & 1) return key & ~(RENDER_DEPTH_MASK << (2 * RENDER_STATE_BITS));
+
+    return key & ~RENDER_DEPTH_MASK;
+}
+
+void RenderSortCommands(struct RenderCommand *commands, struct RenderCommand *scratch, int count) {
+    if (commands == NULL || scratch == NULL || count < 2) return;
+
+    // One pass over the keys builds the histograms of every digit
+    unsigned int histograms[RENDER_RADIX_PASSES][RENDER_RADIX_BUCKETS];
+    memset(histograms, 0, sizeof(histograms));
+
+    for (int i = 0; i < count; ++i) {
+        uint64_t key = commands[i].key;
+        for (int pass = 0; pass < RENDER_RADIX_PASSES; ++pass) {
+            ++histograms[pass][(key >> (pass * RENDER_RADIX_BITS)) & (RENDER_RADIX_BUCKETS - 1)];
+        }
+    }
+
+    struct RenderCommand *source = commands;
+    struct RenderCommand *destination = scratch;
+
+    for (int pass = 0; pass < RENDER_RADIX_PASSES; ++pass) {
+        unsigned int *histogram = histograms[pass];
+        int shift = pass * RENDER_RADIX_BITS;
+
+        // Digits every key shares, like unused layers or state bits, need no pass
+        if (histogram[(source[0].key >> shift) & (RENDER_RADIX_BUCKETS - 1)] == (unsigned int) count) continue;
+
+        unsigned int offset = 0;
+        for (int bucket = 0; bucket < RENDER_RADIX_BUCKETS; ++bucket) {
+            unsigned int bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            destination[histogram[(source[i].key >> shift) & (RENDER_RADIX_BUCKETS - 1)]++] = source[i];
+        }
+
+        struct RenderCommand *swap = source;
+        source = destination;
+        destination = swap;
+    }
+
+    if (source != commands) memcpy(commands, source, sizeof(struct RenderCommand) * count);
+}
+
+static int growArray(void **array, int *capacity, int needed, size_t elementSize) {
+    if (needed <= *capacity) return 1;
+
+    int newCapacity = *capacity > 0 ? *capacity : RENDER_INITIAL_CAPACITY;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    void *grown = realloc(*array, elementSize * newCapacity);
+    if (grown == NULL) return 0;
+
+    *array = grown;
+    *capacity = newCapacity;
+    return 1;
+}
+
+void RenderQueueInit(struct RenderQueue *queue) {
+    if (queue == NULL) return;
+
+    memset(queue, 0, sizeof(struct RenderQueue));
+}
+
+void RenderQueueRelease(struct RenderQueue *queue) {
+    if (queue == NULL) return;
+
+    free(queue->commands);
+    free(queue->scratch);
+    free(queue->worlds);
+    free(queue->instances);
+    free(queue->batches);
+    RenderQueueInit(queue);
+}
+
+void RenderQueueReset(struct RenderQueue *queue) {
+    if (queue == NULL) return;
+
+    queue->commandCount = 0;
+    queue->batchCount = 0;
+}
+
+int RenderQueueSubmit(struct RenderQueue *queue, uint64_t key, const float world[MAT_4_SIZE]) {
+    if (queue == NULL || world == NULL) return 0;
+
+    int needed = queue->commandCount + 1;
+    if (needed > queue->commandCapacity) {
+        int commandCapacity = queue->commandCapacity;
+        if (!growArray((void **) &queue->commands, &commandCapacity, needed, sizeof(struct RenderCommand))) return 0;
+
+        // The scratch buffer and both matrix buffers share the command capacity
+        int scratchCapacity = queue->commandCapacity;
+        int worldCapacity = queue->commandCapacity;
+        int instanceCapacity = queue->commandCapacity;
+        if (
+            !growArray((void **) &queue->scratch, &scratchCapacity, commandCapacity, sizeof(struct RenderCommand)) ||
+            !growArray((void **) &queue->worlds, &worldCapacity, commandCapacity, sizeof(float) * MAT_4_SIZE) ||
+            !growArray((void **) &queue->instances, &instanceCapacity, commandCapacity, sizeof(float) * MAT_4_SIZE)
+        ) return 0;
+
+        queue->commandCapacity = commandCapacity;
+    }
+
+    int index = queue->commandCount++;
+    queue->commands[index].key = key;
+    queue->commands[index].instance = (uint32_t) index;
+    memcpy(&queue->worlds[index * MAT_4_SIZE], world, sizeof(float) * MAT_4_SIZE);
+
+    return 1;
+}
+
+int RenderQueueBuild(struct RenderQueue *queue) {
+    if (queue == NULL) return -1;
+
+    queue->batchCount = 0;
+    if (queue->commandCount == 0) return 0;
+
+    PROFILE_ZONE_BEGIN("RenderSortCommands");
+    RenderSortCommands(queue->commands, queue->scratch, queue->commandCount);
+    PROFILE_ZONE_END("RenderSortCommands");
+
+    uint64_t previousState = 0;
+    struct RenderBatch *batch = NULL;
+
+    for (int i = 0; i < queue->commandCount; ++i) {
+        const struct RenderCommand *command = &queue->commands[i];
+        memcpy(
+            &queue->instances[i * MAT_4_SIZE],
+            &queue->worlds[command->instance * MAT_4_SIZE],
+            sizeof(float) * MAT_4_SIZE
+        );
+
+        uint64_t state = stateKey(command->key);
+        if (batch != NULL && state == previousState) {
+            ++batch->instanceCount;
+            continue;
+        }
+
+        if (!growArray(
+            (void **) &queue->batches, &queue->batchCapacity, queue->batchCount + 1, sizeof(struct RenderBatch)
+        )) return -1;
+
+        batch = &queue->batches[queue->batchCount++];
+        batch->key = command->key;
+        RenderKeyDecode(command->key, &batch->layer, &batch->translucent, &batch->material, &batch->mesh);
+        batch->firstInstance = i;
+        batch->instanceCount = 1;
+        previousState = state;
+    }
+
+    return queue->batchCount;
+}
@@ -0,0 +1,193 @@
+#include <math.h>
+#include <stdlib.h>
+
+#include "skinning.h"
+#include "mathinline.h"
+#include "parallel.h"
+#include "profiler.h"
+#include "dispatch.h"
+
+#if DISPATCH_X86
+#include <immintrin.h>
+#endif
+
+#define SKIN_VERTICES_PER_RANGE 2048
+
+struct SkinContext {
+    float *outPositions;
+    float *outNormals;
+    const float *positions;
+    const float *normals;
+    const int *boneIndices;
+    const float *boneWeights;
+    const float *palette;
+};
+
+static void writeNormal(float out[VEC_3_SIZE], float x, float y, float z) {
+    float lengthSq = x * x + y * y + z * z;
+    float scale = lengthSq > 0.0f ? 1.0f / sqrtf(lengthSq) : 0.0f;
+
+    out[0] = x * scale;
+    out[1] = y * scale;
+    out[2] = z * scale;
+}
+
+static void skinRangeScalar(void *arg, int begin, int end) {
+    const struct SkinContext *context = arg;
+
+    for (int v = begin; v < end; ++v) {
+        const int *bones = &context->boneIndices[v * SKIN_INFLUENCES];
+        const float *weights = &context->boneWeights[v * SKIN_INFLUENCES];
+        float m[MAT_4_SIZE] = {0.0f};
+
+        for (int i = 0; i < SKIN_INFLUENCES; ++i) {
+            const float *bone = &context->palette[bones[i] * MAT_4_SIZE];
+            for (int e = 0; e < MAT_4_SIZE; ++e) {
+                m[e] += bone[e] * weights[i];
+            }
+        }
+
+        const float *p = &context->positions[v * VEC_3_SIZE];
+        float point[VEC_4_SIZE] = {p[0], p[1], p[2], 1.0f};
+        float result[VEC_4_SIZE];
+        Mat4Vec4MultInline(result, m, point);
+        Vec3CopyInline(&context->outPositions[v * VEC_3_SIZE], result);
+
+        if (context->normals != NULL) {
+            const float *n = &context->normals[v * VEC_3_SIZE];
+            float direction[VEC_4_SIZE] = {n[0], n[1], n[2], 0.0f};
+            Mat4Vec4MultInline(result, m, direction);
+            writeNormal(&context->outNormals[v * VEC_3_SIZE], result[0], result[1], result[2]);
+        }
+    }
+}
+
+#if DISPATCH_X86
+// v * M is a broadcast multiply-add per row of the blended matrix
+DISPATCH_TARGET("sse2")
+static inline void transformVertex(const struct SkinContext *context, int v, const __m128 rows[4]) {
+    const float *p = &context->positions[v * VEC_3_SIZE];
+    float result[VEC_4_SIZE];
+    __m128 position = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[0]), rows[0]), _mm_mul_ps(_mm_set1_ps(p[1]), rows[1])),
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[2]), rows[2]), rows[3])
+    );
+    _mm_storeu_ps(result, position);
+    Vec3CopyInline(&context->outPositions[v * VEC_3_SIZE], result);
+
+    if (context->normals != NULL) {
+        const float *n = &context->normals[v * VEC_3_SIZE];
+        __m128 normal = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[0]), rows[0]), _mm_mul_ps(_mm_set1_ps(n[1]), rows[1])),
+            _mm_mul_ps(_mm_set1_ps(n[2]), rows[2])
+        );
+        _mm_storeu_ps(result, normal);
+        writeNormal(&context->outNormals[v * VEC_3_SIZE], result[0], result[1], result[2]);
+    }
+}
+
+// Blends the four rows of the influencing matrices, then transforms the vertex by them
+DISPATCH_TARGET("sse2")
+static void skinRangeSse(void *arg, int begin, int end) {
+    const struct SkinContext *context = arg;
+
+    for (int v = begin; v < end; ++v) {
+        const int *bones = &context->boneIndices[v * SKIN_INFLUENCES];
+        const float *weights = &context->boneWeights[v * SKIN_INFLUENCES];
+        __m128 rows[4];
+
+        for (int r = 0; r < 4; ++r) {
+            rows[r] = _mm_setzero_ps();
+        }
+        for (int i = 0; i < SKIN_INFLUENCES; ++i) {
+            const float *m = &context->palette[bones[i] * MAT_4_SIZE];
+            __m128 weight = _mm_set1_ps(weights[i]);
+
+            for (int r = 0; r < 4; ++r) {
+                rows[r] = _mm_add_ps(rows[r], _mm_mul_ps(_mm_loadu_ps(m + r * 4), weight));
+            }
+        }
+
+        transformVertex(context, v, rows);
+    }
+}
+
+// The same as the SSE kernel with two rows blended per 256 bit register
+DISPATCH_TARGET("avx2,fma")
+static void skinRangeAvx2(void *arg, int begin, int end) {
+    const struct SkinContext *context = arg;
+
+    for (int v = begin; v < end; ++v) {
+        const int *bones = &context->boneIndices[v * SKIN_INFLUENCES];
+        const float *weights = &context->boneWeights[v * SKIN_INFLUENCES];
+        __m128 rows[4];
+
+        __m256 rows01 = _mm256_setzero_ps();
+        __m256 rows23 = _mm256_setzero_ps();
+        for (int i = 0; i < SKIN_INFLUENCES; ++i) {
+            const float *m = &context->palette[bones[i] * MAT_4_SIZE];
+            __m256 weight = _mm256_set1_ps(weights[i]);
+
+            rows01 = _mm256_add_ps(rows01, _mm256_mul_ps(_mm256_loadu_ps(m), weight));
+            rows23 = _mm256_add_ps(rows23, _mm256_mul_ps(_mm256_loadu_ps(m + 8), weight));
+        }
+        rows[0] = _mm256_castps256_ps128(rows01);
+        rows[1] = _mm256_extractf128_ps(rows01, 1);
+        rows[2] = _mm256_castps256_ps128(rows23);
+        rows[3] = _mm256_extractf128_ps(rows23, 1);
+
+        transformVertex(context, v, rows);
+    }
+}
+#endif
+
+static void (*skinRange)(void *, int, int) = skinRangeScalar;
+
+int SkinVertices(
+    float *outPositions,
+    float *outNormals,
+    const float *positions,
+    const float *normals,
+    const int *boneIndices,
+    const float *boneWeights,
+    const float *palette,
+    int vertexCount,
+    int threadCount
+) {
+    if (
+        outPositions == NULL ||
+        positions == NULL ||
+        boneIndices == NULL ||
+        boneWeights == NULL ||
+        palette == NULL ||
+        (normals == NULL) != (outNormals == NULL)
+    ) return 0;
+
+    struct SkinContext context = {outPositions, outNormals, positions, normals, boneIndices, boneWeights, palette};
+    PROFILE_ZONE_BEGIN("SkinVertices");
+    ParallelFor(vertexCount, SKIN_VERTICES_PER_RANGE, threadCount, skinRange, &context);
+    PROFILE_ZONE_END("SkinVertices");
+
+    return 1;
+}
+
+// AVX-512 has no skinning kernel of its own, the AVX2 one is used
+void SkinningBindTier(enum DispatchTier tier) {
+    skinRange = skinRangeScalar;
+
+#if DISPATCH_X86
+    switch (tier) {
+        case DISPATCH_TIER_AVX512:
+        case DISPATCH_TIER_AVX2:
+            skinRange = skinRangeAvx2;
+            break;
+        case DISPATCH_TIER_SSE:
+            skinRange = skinRangeSse;
+            break;
+        default:
+            break;
+    }
+#else
+    (void) tier;
+#endif
+}
@@ -0,0 +1,151 @@
+import math
+from array import array
+
+from py3dengine.math import Matrix4x4, Rasterizer, Vector3
+from py3dengine.wfoparser import import_from_file
+
+DEFAULT_COLOR = (0.8, 0.8, 0.8)
+DEFAULT_BACKGROUND = (0.0, 0.0, 0.0, 1.0)
+FRAME_MARGIN = 1.1
+
+
+class RenderError(Exception):
+    pass
+
+
+def frame_mesh(positions, width, height, yaw=30.0, pitch=20.0, fov=45.0):
+    """Build a right handed view projection Matrix4x4 that fits every position in a width x height image
+
+    The camera orbits the center of the positions' bounding sphere, yaw degrees around the y axis and pitch degrees
+    above the xz plane, far enough that the whole sphere plus a margin is inside the vertical and horizontal field of
+    view.
+    """
+    if len(positions) < 3:
+        raise RenderError('Nothing to frame')
+
+    lower = [min(positions[axis::3]) for axis in range(3)]
+    upper = [max(positions[axis::3]) for axis in range(3)]
+    center = [(lo + hi) * 0.5 for lo, hi in zip(lower, upper)]
+    radius = max(math.dist(lower, upper) * 0.5, 1e-4)
+
+    aspect = width / height
+    half_fov = math.radians(min(fov, math.degrees(2.0 * math.atan(math.tan(math.radians(fov) * 0.5) * aspect)))) * 0.5
+    distance = radius * FRAME_MARGIN / math.sin(half_fov)
+
+    yaw_rad = math.radians(yaw)
+    pitch_rad = math.radians(pitch)
+    eye = Vector3(
+        center[0] + distance * math.cos(pitch_rad) * math.sin(yaw_rad),
+        center[1] + distance * math.sin(pitch_rad),
+        center[2] + distance * math.cos(pitch_rad) * math.cos(yaw_rad)
+    )
+
+    view = Matrix4x4.LookAtRH(eye, Vector3(*center), Vector3(0.0, 1.0, 0.0))
+    projection = Matrix4x4.PerspectiveFovRH(fov, aspect, max(distance - radius, distance * 1e-3), distance + radius)
+
+    return view * projection
+
+
+def render_mesh(processor, width, height, color=DEFAULT_COLOR, background=DEFAULT_BACKGROUND, threads=0, **view):
+    """Render a WfoProcessor's mesh into a new Rasterizer, framed by frame_mesh with the optional view arguments
+
+    The light comes from over the camera's shoulder so the faces turned towards the viewer are lit.
+    """
+    positions = processor.get_positions()
+    rasterizer = Rasterizer(width, height, threads)
+    rasterizer.clear(background)
+
+    if len(positions) == 0:
+        return rasterizer
+
+    mvp = frame_mesh(positions, width, height, **view)
+
+    yaw = math.radians(view.get('yaw', 30.0) + 30.0)
+    light = Vector3(math.sin(yaw), 1.0, math.cos(yaw))
+
+    rasterizer.draw(mvp, positions, processor.get_indices(), processor.get_normals(), color=color, light=light)
+
+    return rasterizer
+
+
+def thumbnail(obj_path, ppm_path, size=128, **kwargs):
+    """Render an OBJ file into a size x size PPM image"""
+    rasterizer = render_mesh(import_from_file(obj_path), size, size, **kwargs)
+    write_ppm(ppm_path, rasterizer.width, rasterizer.height, rasterizer.color_bytes())
+
+    return rasterizer
+
+
+def write_ppm(file_path, width, height, rgba):
+    """Write RGBA bytes, rows from top to bottom, as a binary PPM, dropping the alpha channel"""
+    if len(rgba) != width * height * 4:
+        raise RenderError('Expected {} RGBA bytes'.format(width * height * 4))
+
+    with open(file_path, 'wb') as ppm_file:
+        ppm_file.write('P6\n{} {}\n255\n'.format(width, height).encode('ascii'))
+        ppm_file.write(rgba_to_rgb(rgba))
+
+
+def read_ppm(file_path):
+    """Read a binary PPM written by write_ppm, returns (width, height, RGB bytes)"""
+    with open(file_path, 'rb') as ppm_file:
+        data = ppm_file.read()
+
+    fields = []
+    offset = 0
+    while len(fields) < 4:
+        while offset < len(data) and data[offset:offset + 1].isspace():
+            offset += 1
+        if data[offset:offset + 1] == b'#':
+            offset = data.index(b'\n', offset)
+            continue
+
+        end = offset
+        while end < len(data) and not data[end:end + 1].isspace():
+            end += 1
+        if end == offset:
+            raise RenderError('Truncated PPM header')
+
+        fields.append(data[offset:end])
+        offset = end
+
+    if fields[0] != b'P6' or fields[3] != b'255':
+        raise RenderError('Only 8 bit binary PPM images are supported')
+
+    width, height = int(fields[1]), int(fields[2])
+    pixels = data[offset + 1:offset + 1 + width * height * 3]
+    if len(pixels) != width * height * 3:
+        raise RenderError('Truncated PPM pixels')
+
+    return width, height, pixels
+
+
+def rgba_to_rgb(rgba):
+    rgb = bytearray(len(rgba) // 4 * 3)
+    for channel in range(3):
+        rgb[channel::3] = rgba[channel::4]
+
+    return bytes(rgb)
+
+
+def image_difference(expected, actual, tolerance=0):
+    """Compare two equally sized byte images, returns (largest channel difference, pixels off by more than tolerance)
+
+    Pixels are groups of 3 bytes, golden tests pass a small tolerance so a rounding change doesn't fail them.
+    """
+    if len(expected) != len(actual):
+        raise RenderError('Images differ in size')
+
+    expected_values = array('B', expected)
+    actual_values = array('B', actual)
+    largest = 0
+    failed_pixels = set()
+    for i, (a, b) in enumerate(zip(expected_values, actual_values)):
+        difference = abs(a - b)
+        if difference > largest:
+            largest = difference
+        if difference > tolerance:
+            failed_pixels.add(i // 3)
+
+    return largest, len(failed_pixels)
+
@@ -0,0 +1,83 @@
+from py3dengine.component import Component
+from py3dengine.math import RenderQueue
+from py3dengine.message import Message
+
+RENDER = 'render'
+
+
+class RenderBackend:
+    """RenderBackend: What RenderQueue.flush replays sorted batches on
+
+    A flush calls begin_layer when the layer or its translucency changes, bind_material and bind_mesh only when the
+    bound material or mesh changes, then draw_instanced once per batch with a float32 memoryview of the batch's world
+    matrices (16 floats each) and their count. Materials and meshes are whatever objects were submitted.
+    """
+
+    def begin_layer(self, layer, translucent):
+        pass
+
+    def bind_material(self, material):
+        pass
+
+    def bind_mesh(self, mesh):
+        pass
+
+    def draw_instanced(self, instances, count):
+        pass
+
+
+class RecordingBackend(RenderBackend):
+    """RecordingBackend: Records every backend call as a tuple, for tests and for inspecting a frame's draws"""
+
+    def __init__(self):
+        self.calls = []
+
+    def begin_layer(self, layer, translucent):
+        self.calls.append(('begin_layer', layer, translucent))
+
+    def bind_material(self, material):
+        self.calls.append(('bind_material', material))
+
+    def bind_mesh(self, mesh):
+        self.calls.append(('bind_mesh', mesh))
+
+    def draw_instanced(self, instances, count):
+        self.calls.append(('draw_instanced', count, tuple(instances)))
+
+    def get_draws(self):
+        return [call for call in self.calls if call[0] == 'draw_instanced']
+
+
+class MeshRenderer(Component):
+    """MeshRenderer: Submits its GameObject's mesh at the GameObject's world matrix when it receives a 'render' Message"""
+
+    def __init__(self, name, mesh, material, layer=0, translucent=False):
+        super().__init__(name)
+        self.mesh = mesh
+        self.material = material
+        self.layer = layer
+        self.translucent = translucent
+
+    def render(self, queue):
+        transform = None if self._owner is None else self._owner.get_transform
+        if transform is None:
+            return
+
+        queue.submit(self.material, self.mesh, transform.world_matrix, self.layer, self.translucent)
+
+
+def render_frame(scene, backend, queue=None, camera_position=None):
+    """Broadcast a 'render' Message with the queue through the scene, then flush the submitted draws on the backend
+
+    Returns the queue so the next frame can reuse its buffers and interned states.
+    """
+    if queue is None:
+        queue = RenderQueue()
+
+    if camera_position is not None:
+        queue.camera_position = camera_position
+
+    scene.receive_message(Message(RENDER, (queue,)))
+    queue.flush(backend)
+
+    return queue
@@ -137,12 +137,12 @@ class Parser:
             else:
                 self.statement_data.append(token.data)
             self._discard_token()
-
-            if self.num_parsed_tokens >= 7:
-                self.state = WFOToken.Types.LINE_BREAK
-            else:
-                self.state = WFOToken.Types.SEPERATOR
-        elif self._is_expected_token(token, WFOToken.Types.LINE_BREAK):
+            self.state = WFOToken.Types.SEPERATOR
+        elif (
+            self.state == WFOToken.Types.SEPERATOR and token.type == WFOToken.Types.LINE_BREAK and
+            self.statement_data is not None and len(self.statement_data) >= 3
+        ):
+            # Faces are polygons of 3 or more vertices
             self.statement_data = tuple(self.statement_data)
             self.statement_buffer.append(self._extract_statement_from_state())
         else:
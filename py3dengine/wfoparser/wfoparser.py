@@ -1,6 +1,6 @@
-from lexer import Lexer
-from parser import Parser
-from wfoprocessor import WfoProcessor
+from py3dengine.lexer import Lexer
+from py3dengine.parser import Parser
+from py3dengine.wfoprocessor import WfoProcessor
 
 
 class ParseError(Exception):
@@ -8,6 +8,7 @@ class ParseError(Exception):
 
 
 def import_from_file(file_name):
+    """Read an OBJ file and return the WfoProcessor holding its material files and packed vertex buffers"""
     try:
         wfo_file = open(file_name, mode='r', newline='')
     except OSError as err:
@@ -22,6 +23,6 @@ def import_from_file(file_name):
     statements = parser.parse_tokens(tokens)
 
     processor = WfoProcessor()
-    data = processor.process_statements(statements)
+    processor.process_statements(statements)
 
-    return data
+    return processor
@@ -1,10 +1,29 @@
+from array import array
 from typing import List
 from py3dengine.wfostatement import WfoStatement
 
 
+class ProcessorError(Exception):
+    pass
+
+
 class WfoProcessor:
+    """WfoProcessor: Turns parsed statements into packed float32 vertex buffers and a uint32 triangle index buffer
+
+    Every distinct position/tex coord/normal combination referenced by a face becomes one vertex, vertices without a
+    tex coord or normal get zeros. The buffers can be handed straight to the batch math APIs.
+    """
+
     def __init__(self):
         self._material_files = []
+        self._source_positions = []
+        self._source_normals = []
+        self._source_tex_coords = []
+        self._vertex_lookup = {}
+        self._positions = array('f')
+        self._normals = array('f')
+        self._tex_coords = array('f')
+        self._indices = array('I')
 
     def process_statements(self, statements: List[WfoStatement]):
         for statement in statements:
@@ -13,6 +32,65 @@ class WfoProcessor:
     def get_material_files(self):
         return tuple(self._material_files)
 
+    def get_vertex_count(self):
+        return len(self._vertex_lookup)
+
+    def get_positions(self):
+        return self._positions
+
+    def get_normals(self):
+        return self._normals
+
+    def get_tex_coords(self):
+        return self._tex_coords
+
+    def get_indices(self):
+        return self._indices
+
     def _process_statement(self, statement: WfoStatement):
         if statement.type == WfoStatement.Types.MATERIAL_LIB:
             self._material_files.append(statement.data)
+        elif statement.type == WfoStatement.Types.VERTEX:
+            self._source_positions.append(statement.data)
+        elif statement.type == WfoStatement.Types.NORMAL:
+            self._source_normals.append(statement.data)
+        elif statement.type == WfoStatement.Types.TEX_COORD:
+            self._source_tex_coords.append(statement.data)
+        elif statement.type == WfoStatement.Types.FACE:
+            face = [self._get_vertex_index(polygon, statement.line_num) for polygon in statement.data]
+
+            # Faces with more than 3 vertices are convex polygons in OBJ, a fan keeps the index buffer all triangles
+            for i in range(1, len(face) - 1):
+                self._indices.extend((face[0], face[i], face[i + 1]))
+
+    def _get_vertex_index(self, polygon, line_num):
+        polygon = (*polygon, None, None)
+        key = (
+            self._resolve(self._source_positions, polygon[0], line_num),
+            self._resolve(self._source_tex_coords, polygon[1], line_num),
+            self._resolve(self._source_normals, polygon[2], line_num),
+        )
+
+        index = self._vertex_lookup.get(key)
+        if index is None:
+            index = len(self._vertex_lookup)
+            self._vertex_lookup[key] = index
+
+            position, tex_coord, normal = key
+            self._positions.extend(self._source_positions[position])
+            self._tex_coords.extend((0.0, 0.0) if tex_coord is None else self._source_tex_coords[tex_coord])
+            self._normals.extend((0.0, 0.0, 0.0) if normal is None else self._source_normals[normal])
+
+        return index
+
+    @staticmethod
+    def _resolve(elements, obj_index, line_num):
+        """Turn a 1 based (or negative, relative to the end) OBJ index into a list index"""
+        if obj_index is None:
+            return None
+
+        index = obj_index - 1 if obj_index > 0 else len(elements) + obj_index
+        if obj_index == 0 or not 0 <= index < len(elements):
+            raise ProcessorError(f'Face on line: {line_num} references missing element: {obj_index}')
+
+        return index
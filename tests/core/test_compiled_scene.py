@@ -0,0 +1,106 @@
+import unittest
+from py3dengine.component import Component
+from py3dengine.gameobject import (
+    compile_scene, _do_import_game_object, _do_import_compiled_game_object, _COMPILED_HEADER
+)
+from py3dengine.resource_import import register_importer
+
+
+class CounterComponent(Component):
+    pass
+
+
+def import_counter_component(component_json):
+    return CounterComponent(component_json['name'])
+
+
+register_importer(import_counter_component, 'CounterComponent')
+
+
+def make_node(name, x, children=(), components=(), **extra):
+    node = {
+        'name': name,
+        'transform': {
+            'position': {'x': x, 'y': 2.0, 'z': 3.0},
+            'orientation': {'x': 0.0, 'y': 0.0, 'z': 0.0, 'w': 1.0},
+            'scale': {'x': 1.0, 'y': 1.0, 'z': 1.0},
+        },
+        'components': [{'type': 'CounterComponent', 'name': c} for c in components],
+        'children': list(children),
+    }
+    node.update(extra)
+    return node
+
+
+SCENE = make_node('root', 0.0, children=[
+    make_node('a', 1.0, children=[
+        make_node('a1', 11.0, components=['counter']),
+        make_node('a2', 12.0),
+    ], msg_white_list=['tick']),
+    make_node('b', 2.0, components=['first', 'second'], accept_msgs=False),
+])
+
+
+def describe(go):
+    return (
+        go.name,
+        go.get_transform.position.x,
+        tuple(go._message_type_white_list),
+        go._message_type_accept_by_default,
+        tuple(c.name for c in go._components),
+        tuple(describe(go.get_child_by_index(i)) for i in range(go.get_child_count())),
+    )
+
+
+class CompiledSceneTests(unittest.TestCase):
+    def test_compiled_scene_matches_json_import(self):
+        from_json = _do_import_game_object(SCENE)
+        from_compiled = _do_import_compiled_game_object(compile_scene(SCENE))
+
+        self.assertEqual(describe(from_json), describe(from_compiled))
+
+    def test_compiled_scene_links_parents_and_owners(self):
+        root = _do_import_compiled_game_object(compile_scene(SCENE))
+
+        a1 = root.get_child_by_name('a1')
+        self.assertIs(root.get_child_by_name('a'), a1.parent)
+        self.assertIs(a1, a1.get_component_by_index(0)._owner)
+        self.assertIsNone(root.parent)
+
+    def test_filter_lists_are_not_shared(self):
+        root = _do_import_compiled_game_object(compile_scene(SCENE))
+
+        root.add_message_filter('render', True)
+
+        self.assertEqual([], root.get_child_by_name('a2')._message_type_white_list)
+
+    def test_version_mismatch_is_rejected(self):
+        compiled = bytearray(compile_scene(SCENE))
+        compiled[4:8] = (99).to_bytes(4, 'little')
+
+        with self.assertRaises(ValueError):
+            _do_import_compiled_game_object(bytes(compiled))
+
+    def test_corrupt_compiled_scene_is_rejected(self):
+        compiled = compile_scene(SCENE)
+        header = _COMPILED_HEADER.unpack_from(compiled)
+        child_counts_offset, component_counts_offset, filter_ids_offset = header[8], header[14], header[12]
+
+        def corrupted(offset, value):
+            data = bytearray(compiled)
+            data[offset:offset + 4] = value.to_bytes(4, 'little')
+            return bytes(data)
+
+        for data in (
+            compiled[:len(compiled) // 2],
+            corrupted(child_counts_offset, 7),
+            corrupted(component_counts_offset, 3),
+            corrupted(filter_ids_offset, 40),
+            b'not a compiled scene at all' * 8,
+        ):
+            with self.assertRaises(ValueError):
+                _do_import_compiled_game_object(data)
+
+    def test_invalid_json_fails_at_compile_time(self):
+        with self.assertRaises(TypeError):
+            compile_scene(make_node(5, 0.0))
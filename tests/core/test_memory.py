@@ -0,0 +1,104 @@
+import unittest
+
+from py3dengine import memory, profiler
+from py3dengine.component import Component
+from py3dengine.gameobject import GameObject
+from py3dengine.math import MemoryTracker, Matrix4x4, Vector3
+from py3dengine.resource import Resource
+from py3dengine.resource_manager import ResourceManager
+from py3dengine.transform import Transform
+
+
+class SizedResource(Resource):
+    def __init__(self, name, size):
+        super().__init__(name)
+        self._size = size
+
+    @property
+    def size(self):
+        return self._size
+
+    def unload(self):
+        pass
+
+
+def build_scene(child_count):
+    scene = GameObject('scene')
+    for i in range(child_count):
+        child = GameObject(f'child{i}')
+        child._transform = Transform()
+        child.attach_component(Component('component'))
+        scene.attach_child(child)
+
+    return scene
+
+
+class MemoryTests(unittest.TestCase):
+    def test_math_types_count_live_and_peak_instances(self):
+        before = MemoryTracker.Stats()['Vector3']
+        vectors = [Vector3(i, 0, 0) for i in range(100)]
+        during = MemoryTracker.Stats()['Vector3']
+
+        self.assertEqual(before['live'] + 100, during['live'])
+        self.assertGreaterEqual(during['peak'], during['live'])
+        self.assertEqual(before['allocations'] + 100, during['allocations'])
+        self.assertGreater(during['live_bytes'], before['live_bytes'])
+
+        del vectors
+        after = MemoryTracker.Stats()['Vector3']
+        self.assertEqual(before['live'], after['live'])
+        self.assertEqual(during['peak'], after['peak'], 'The peak stays until it is reset')
+
+        MemoryTracker.ResetPeaks()
+        self.assertEqual(after['live'], MemoryTracker.Stats()['Vector3']['peak'])
+
+    def test_operator_results_are_counted(self):
+        before = MemoryTracker.Stats()['Matrix4x4']['allocations']
+        product = Matrix4x4() * Matrix4x4()
+
+        self.assertEqual(before + 3, MemoryTracker.Stats()['Matrix4x4']['allocations'])
+        del product
+
+    def test_scene_memory_grows_with_the_scene(self):
+        small = memory.scene_memory(build_scene(2))
+        large = memory.scene_memory(build_scene(20))
+
+        self.assertEqual(3, small['nodes'])
+        self.assertEqual(2, small['components'])
+        self.assertEqual(21, large['nodes'])
+        self.assertGreater(large['bytes'], small['bytes'] * 5)
+
+    def test_resource_report_splits_referenced_and_unreferenced_bytes(self):
+        manager = ResourceManager(memory_budget=1000)
+        manager.store_resource(SizedResource('mesh', 300))
+        texture = manager.store_resource(SizedResource('texture', 500))
+        manager.release_resource(texture)
+
+        report = manager.get_memory_report(largest_count=1)
+        self.assertEqual(2, report['resource_count'])
+        self.assertEqual(800, report['memory_used'])
+        self.assertEqual(1000, report['memory_budget'])
+        self.assertEqual(300, report['referenced_bytes'])
+        self.assertEqual(500, report['unreferenced_bytes'])
+        self.assertEqual([{'names': ['texture'], 'size': 500, 'ref_count': 0}], report['largest'])
+
+    def test_samples_are_recorded_as_profiler_counters(self):
+        scene = build_scene(3)
+        manager = ResourceManager()
+        sampler = memory.MemorySampler(interval=3600.0, scene=scene, resource_manager=manager)
+
+        self.assertIsNone(sampler.tick(), 'Nothing is sampled while the profiler is disabled')
+
+        profiler.collect_counters()
+        profiler.enable()
+        try:
+            report = sampler.tick()
+            self.assertIsNone(sampler.tick(), 'The interval has not passed yet')
+        finally:
+            profiler.disable()
+            profiler.collect()
+
+        self.assertEqual(4, report['scene']['nodes'])
+        names = [name for _, name, _ in profiler.collect_counters()]
+        self.assertEqual(['memory.Vector3', 'memory.Quaternion', 'memory.Matrix4x4', 'memory.scene',
+                          'memory.resources'], names)
@@ -0,0 +1,67 @@
+import io
+import unittest
+
+from py3dengine import message_stats
+from py3dengine.component import Component
+from py3dengine.gameobject import GameObject
+from py3dengine.message import Message
+
+
+class CountingComponent(Component):
+    def __init__(self, name):
+        super().__init__(name)
+        self.updates = 0
+
+    def update(self, delta):
+        self.updates += 1
+
+
+class MessageStatsTests(unittest.TestCase):
+    def setUp(self):
+        message_stats.reset()
+        message_stats.enable()
+
+        self.scene = GameObject('scene')
+        for i in range(4):
+            child = GameObject(f'child{i}')
+            child.attach_component(CountingComponent('counter'))
+            self.scene.attach_child(child)
+
+    def tearDown(self):
+        message_stats.disable()
+        message_stats.reset()
+
+    def test_broadcast_counts_deliveries_and_handlers(self):
+        self.scene.get_child_by_index(3).add_message_filter('update', False)
+        self.scene.receive_message(Message('update', (0.1,)))
+        self.scene.receive_message(Message('render'))
+
+        update = message_stats.get_message_stats('update')
+        self.assertEqual(5 + 3, update['deliveries'], 'The scene, 4 children and 3 components receive update')
+        self.assertEqual(1, update['filtered'])
+        self.assertEqual(3, update['handlers'])
+        self.assertGreater(update['handler_ns'], 0)
+
+        render = message_stats.get_message_stats('render')
+        self.assertEqual((9, 4, 0), (render['deliveries'], render['filtered'], render['handlers']),
+                         'Components without a render handler filter it out')
+
+    def test_disabled_statistics_record_nothing(self):
+        message_stats.disable()
+        self.scene.receive_message(Message('update', (0.1,)))
+
+        self.assertEqual({}, message_stats.get_message_stats())
+        self.assertEqual(0, message_stats.get_message_stats('update')['deliveries'])
+        self.assertEqual(4, sum(c.get_component_by_index(0).updates for c in self.scene._children))
+
+    def test_dump_lists_most_expensive_messages_first(self):
+        self.scene.receive_message(Message('render'))
+        self.scene.receive_message(Message('update', (0.1,)))
+
+        output = io.StringIO()
+        message_stats.dump(output)
+        lines = output.getvalue().splitlines()
+
+        self.assertEqual(3, len(lines))
+        self.assertTrue(lines[1].startswith('update'))
+        self.assertTrue(lines[2].startswith('render'))
@@ -0,0 +1,85 @@
+import unittest
+from py3dengine.component import Component
+from py3dengine.gameobject import GameObject
+from py3dengine.math import Vector3
+from py3dengine.overlap import OverlapTracker
+from py3dengine.transform import Transform
+
+
+class OverlapRecorder(Component):
+    def __init__(self, name):
+        super().__init__(name)
+        self.events = []
+
+    def overlap_began(self, others):
+        self.events.append(('began', sorted(o.name for o in others)))
+
+    def overlap_ended(self, others):
+        self.events.append(('ended', sorted(o.name for o in others)))
+
+
+def build_object(name, x):
+    go = GameObject(name)
+    go._transform = Transform(Vector3(x, 0, 0))
+    recorder = OverlapRecorder('recorder')
+    go.attach_component(recorder)
+
+    return go, recorder
+
+
+class OverlapTrackerTests(unittest.TestCase):
+    def setUp(self):
+        self.tracker = OverlapTracker()
+        self.objects = {}
+        self.recorders = {}
+        for name, x in (('left', 0.0), ('middle', 1.5), ('right', 3.0), ('far', 50.0)):
+            go, recorder = build_object(name, x)
+            self.objects[name] = go
+            self.recorders[name] = recorder
+            self.tracker.track(go, Vector3(-1, -1, -1), Vector3(1, 1, 1), dynamic=name != 'far')
+
+    def move(self, name, x):
+        self.objects[name]._transform = Transform(Vector3(x, 0, 0))
+
+    def test_overlaps_are_delivered_once_per_update(self):
+        self.assertEqual((2, 0), self.tracker.update())
+        self.assertEqual([('began', ['left', 'right'])], self.recorders['middle'].events)
+        self.assertEqual([('began', ['middle'])], self.recorders['left'].events)
+        self.assertEqual([], self.recorders['far'].events)
+
+        self.assertEqual((0, 0), self.tracker.update())
+        self.assertEqual(1, len(self.recorders['middle'].events))
+
+        self.move('middle', 49.0)
+        self.assertEqual((1, 2), self.tracker.update())
+        self.assertEqual(
+            [('began', ['left', 'right']), ('ended', ['left', 'right']), ('began', ['far'])],
+            self.recorders['middle'].events
+        )
+        self.assertEqual(1, len(self.tracker.get_overlaps()))
+
+    def test_untrack_ends_overlaps(self):
+        self.tracker.update()
+        self.tracker.untrack(self.objects['middle'])
+        self.tracker.update()
+
+        self.assertEqual([('began', ['middle']), ('ended', ['middle'])], self.recorders['left'].events)
+        self.assertFalse(self.tracker.is_tracked(self.objects['middle']))
+        self.assertEqual(3, self.tracker.get_tracked_count())
+
+        with self.assertRaises(ValueError):
+            self.tracker.untrack(self.objects['middle'])
+        with self.assertRaises(ValueError):
+            self.tracker.track(self.objects['left'], Vector3(), Vector3())
+
+    def test_static_bounds_follow_set_bounds_only(self):
+        self.tracker.update()
+        self.move('far', 0.0)
+        self.assertEqual((0, 0), self.tracker.update())
+
+        self.tracker.set_bounds(self.objects['far'], Vector3(-1, -1, -1), Vector3(1, 1, 1))
+        self.assertEqual((2, 0), self.tracker.update())
+
+
+if __name__ == '__main__':
+    unittest.main()
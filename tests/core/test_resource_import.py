@@ -0,0 +1,124 @@
+import json
+import os
+import tempfile
+import unittest
+from py3dengine import engine
+from py3dengine.component import Component
+from py3dengine.resource import Resource
+from py3dengine.resource_import import register_importer, import_shared_resource, import_resource, hash_content
+from py3dengine.resource_manager import ResourceManager
+
+
+class BlobResource(Resource):
+    import_count = 0
+
+    def __init__(self, name, data):
+        super().__init__(name)
+        self.data = data
+
+    @property
+    def size(self):
+        return len(self.data)
+
+
+def import_blob(path, data):
+    BlobResource.import_count += 1
+    return BlobResource(path, data)
+
+
+register_importer(import_blob, BlobResource)
+
+
+class MeshComponent(Component):
+    def __init__(self, name, mesh_handle):
+        super().__init__(name)
+        self.mesh_handle = mesh_handle
+
+
+def import_mesh_component(component_json):
+    return MeshComponent(component_json['name'], import_resource(component_json['mesh'], BlobResource))
+
+
+register_importer(import_mesh_component, 'MeshComponent')
+
+
+class ImportSharedResourceTests(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        BlobResource.import_count = 0
+
+    def tearDown(self):
+        self.dir.cleanup()
+
+    def _write(self, name, data):
+        path = os.path.join(self.dir.name, name)
+        with open(path, 'wb') as f:
+            f.write(data)
+        return path
+
+    def test_identical_content_is_shared(self):
+        manager = ResourceManager()
+        first_path = self._write('level1_rock.obj', b'v 1 2 3')
+        second_path = self._write('level2_rock.obj', b'v 1 2 3')
+
+        first = import_shared_resource(manager, first_path, BlobResource)
+        second = import_shared_resource(manager, second_path, BlobResource)
+
+        self.assertEqual(first, second)
+        self.assertEqual(1, BlobResource.import_count, 'Importer only runs for new content')
+        self.assertEqual(1, manager.get_resource_count())
+        self.assertEqual(2, manager.get_ref_count(first))
+        self.assertIs(manager.get_resource_by_name(first_path), manager.get_resource_by_name(second_path))
+        self.assertEqual(7, manager.memory_used, 'Shared content is only accounted once')
+
+    def test_different_content_is_not_shared(self):
+        manager = ResourceManager()
+
+        first = import_shared_resource(manager, self._write('a.obj', b'v 1 2 3'), BlobResource)
+        second = import_shared_resource(manager, self._write('b.obj', b'v 3 2 1'), BlobResource)
+
+        self.assertNotEqual(first, second)
+        self.assertEqual(2, BlobResource.import_count)
+
+    def test_evicting_shared_resource_drops_every_alias(self):
+        manager = ResourceManager(memory_budget=0)
+        first_path = self._write('a.obj', b'data')
+        second_path = self._write('b.obj', b'data')
+        first = import_shared_resource(manager, first_path, BlobResource)
+        second = import_shared_resource(manager, second_path, BlobResource)
+
+        manager.release_resource(first)
+        manager.release_resource(second)
+
+        self.assertIsNone(manager.get_handle_by_name(first_path))
+        self.assertIsNone(manager.get_handle_by_name(second_path))
+        self.assertIsNone(manager.get_handle_by_content_hash(hash_content(b'data')))
+
+    def test_scenes_loaded_by_the_engine_share_resources(self):
+        mesh_path = self._write('rock.obj', b'v 1 2 3')
+        scene_paths = []
+        for name in ('level1', 'level2'):
+            scene_path = self._write(f'{name}.json', json.dumps({
+                'name': name,
+                'transform': {
+                    'position': {'x': 0.0, 'y': 0.0, 'z': 0.0},
+                    'orientation': {'x': 0.0, 'y': 0.0, 'z': 0.0, 'w': 1.0},
+                    'scale': {'x': 1.0, 'y': 1.0, 'z': 1.0},
+                },
+                'components': [{'type': 'MeshComponent', 'name': 'mesh', 'mesh': mesh_path}],
+                'children': [],
+            }).encode('utf-8'))
+            scene_paths.append(self._write(f'{name}.scene', json.dumps({'file_path': scene_path}).encode('utf-8')))
+
+        manager = engine.get_resource_manager()
+        engine.load_scene(scene_paths[0])
+        engine.load_scene(scene_paths[1])
+        handle = manager.get_handle_by_name(mesh_path)
+
+        self.assertEqual(1, BlobResource.import_count)
+        self.assertEqual(2, manager.get_ref_count(handle), 'Each loaded scene holds a reference')
+
+        engine.unload_scene('level1')
+        engine.unload_scene('level2')
+
+        self.assertEqual(0, manager.get_ref_count(handle))
@@ -0,0 +1,112 @@
+import unittest
+from py3dengine.resource import Resource
+from py3dengine.resource_manager import ResourceManager
+
+
+class SizedResource(Resource):
+    def __init__(self, name, size):
+        super().__init__(name)
+        self._size = size
+        self.unloaded = False
+
+    @property
+    def size(self):
+        return self._size
+
+    def unload(self):
+        self.unloaded = True
+
+
+class ResourceManagerTests(unittest.TestCase):
+    def test_store_and_fetch_resource(self):
+        manager = ResourceManager()
+        resource = SizedResource('mesh', 10)
+
+        handle = manager.store_resource(resource)
+
+        self.assertIs(resource, manager.get_resource(handle))
+        self.assertIs(resource, manager.get_resource_by_name('mesh'))
+        self.assertEqual(handle, manager.get_handle_by_name('mesh'))
+        self.assertEqual(1, manager.get_ref_count(handle), 'Storing a resource hands one reference to the caller')
+        self.assertEqual(10, manager.memory_used)
+
+    def test_duplicate_names_are_rejected(self):
+        manager = ResourceManager()
+        manager.store_resource(SizedResource('mesh', 1))
+
+        with self.assertRaises(ValueError):
+            manager.store_resource(SizedResource('mesh', 1))
+
+    def test_duplicate_content_is_unloaded(self):
+        manager = ResourceManager()
+        stored = SizedResource('rock', 4)
+        duplicate = SizedResource('rock_copy', 4)
+
+        first = manager.store_resource(stored, 'hash')
+        second = manager.store_resource(duplicate, 'hash')
+
+        self.assertEqual(first, second)
+        self.assertIs(stored, manager.get_resource_by_name('rock_copy'))
+        self.assertTrue(duplicate.unloaded, 'The duplicate is never stored, so it is unloaded')
+        self.assertFalse(stored.unloaded)
+
+    def test_stale_handles_are_detected(self):
+        manager = ResourceManager()
+        old_handle = manager.store_resource(SizedResource('old', 1))
+        manager.remove_resource(old_handle)
+
+        new_handle = manager.store_resource(SizedResource('new', 1))
+
+        self.assertEqual(old_handle.index, new_handle.index, 'Vacated slots are reused')
+        self.assertFalse(manager.is_valid(old_handle))
+        with self.assertRaises(ValueError):
+            manager.get_resource(old_handle)
+
+    def test_referenced_resources_are_not_evicted(self):
+        manager = ResourceManager(memory_budget=10)
+        first = manager.store_resource(SizedResource('first', 8))
+        second = manager.store_resource(SizedResource('second', 8))
+
+        self.assertTrue(manager.is_valid(first))
+        self.assertTrue(manager.is_valid(second))
+        self.assertEqual(16, manager.memory_used)
+
+        manager.release_resource(first)
+
+        self.assertFalse(manager.is_valid(first), 'Releasing the last reference while over budget evicts')
+        self.assertEqual(8, manager.memory_used)
+
+    def test_least_recently_used_resource_is_evicted_first(self):
+        manager = ResourceManager(memory_budget=30)
+        resources = [SizedResource(name, 10) for name in ('a', 'b', 'c')]
+        handles = [manager.store_resource(r) for r in resources]
+        for handle in handles:
+            manager.release_resource(handle)
+
+        manager.get_resource(handles[0])
+        manager.store_resource(SizedResource('d', 10))
+
+        self.assertTrue(manager.is_valid(handles[0]))
+        self.assertFalse(manager.is_valid(handles[1]))
+        self.assertTrue(resources[1].unloaded)
+        self.assertTrue(manager.is_valid(handles[2]))
+        self.assertIsNone(manager.get_handle_by_name('b'))
+
+    def test_lowering_budget_evicts(self):
+        manager = ResourceManager()
+        handle = manager.store_resource(SizedResource('a', 10))
+        manager.release_resource(handle)
+
+        manager.memory_budget = 5
+
+        self.assertFalse(manager.is_valid(handle))
+        self.assertEqual(0, manager.memory_used)
+
+    def test_acquire_protects_from_eviction(self):
+        manager = ResourceManager(memory_budget=0)
+        handle = manager.store_resource(SizedResource('a', 10))
+        manager.acquire_resource(handle)
+        manager.release_resource(handle)
+
+        self.assertTrue(manager.is_valid(handle))
+        self.assertEqual(1, manager.get_ref_count(handle))
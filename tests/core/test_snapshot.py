@@ -0,0 +1,120 @@
+import os
+import tempfile
+import unittest
+from py3dengine.component import Component
+from py3dengine.gameobject import GameObject
+from py3dengine.math import Vector3, Quaternion
+from py3dengine.snapshot import save_snapshot, restore_snapshot, register_snapshot_component, SnapshotError, _HEADER
+from py3dengine.transform import Transform
+
+
+@register_snapshot_component('test_health')
+class HealthComponent(Component):
+    def __init__(self, name, health, target=None):
+        super().__init__(name)
+        self.health = health
+        self.target = target
+
+    def get_snapshot_state(self):
+        return {'health': self.health}
+
+    @classmethod
+    def from_snapshot_state(cls, name, state):
+        return cls(name, state['health'])
+
+
+class UnregisteredComponent(Component):
+    pass
+
+
+def build_scene():
+    root = GameObject('level')
+    root._transform = Transform()
+
+    player = GameObject('player')
+    player._transform = Transform(Vector3(1, 2, 3), Quaternion(0, 0, 0, 1), Vector3(2, 2, 2))
+    player.attach_component(HealthComponent('health', 75))
+    player.get_component_by_name('health').add_message_filter('hit', False)
+    player.add_message_filter('tick', True)
+    root.attach_child(player)
+
+    weapon = GameObject('wéapon')
+    weapon._transform = Transform(Vector3(4, 5, 6))
+    weapon.accept_messages_by_default = False
+    player.attach_child(weapon)
+
+    root.attach_child(GameObject('empty'))
+
+    return root
+
+
+class SnapshotTests(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.path = os.path.join(self.dir.name, 'quick.p3dsnap')
+
+    def tearDown(self):
+        self.dir.cleanup()
+
+    def test_round_trip_preserves_hierarchy_and_state(self):
+        save_snapshot(build_scene(), self.path)
+
+        root = restore_snapshot(self.path)
+
+        self.assertEqual('level', root.name)
+        self.assertEqual(['player', 'empty'], [c.name for c in root._children])
+
+        player = root.get_child_by_name('player')
+        self.assertEqual((1.0, 2.0, 3.0, 0.0, 0.0, 0.0, 1.0, 2.0, 2.0, 2.0), player.get_transform.to_floats())
+        self.assertEqual(['tick'], player._message_type_white_list)
+
+        health = player.get_component_by_name('health')
+        self.assertEqual(75, health.health)
+        self.assertIs(player, health._owner)
+        self.assertEqual(['hit'], health._message_type_black_list)
+
+        weapon = root.get_child_by_name('wéapon')
+        self.assertIs(player, weapon.parent)
+        self.assertFalse(weapon.accept_messages_by_default)
+        self.assertEqual(4.0, weapon.get_transform.position.x)
+
+    def test_corrupt_snapshot_is_rejected(self):
+        with open(self.path, 'wb') as f:
+            f.write(b'not a snapshot at all, just some bytes that are long enough' * 4)
+
+        with self.assertRaises(SnapshotError):
+            restore_snapshot(self.path)
+
+    def test_truncated_snapshot_is_rejected(self):
+        save_snapshot(build_scene(), self.path)
+        with open(self.path, 'rb') as f:
+            data = f.read()
+        with open(self.path, 'wb') as f:
+            f.write(data[:len(data) // 2])
+
+        with self.assertRaises(SnapshotError):
+            restore_snapshot(self.path)
+
+    def test_corrupt_component_block_is_rejected(self):
+        save_snapshot(build_scene(), self.path)
+        with open(self.path, 'rb') as f:
+            data = f.read()
+
+        # The component block is the last (offset, size) pair of the header
+        state_offset = _HEADER.unpack_from(data)[-2]
+        with open(self.path, 'wb') as f:
+            f.write(data[:state_offset] + b'\x80\x05garbage' + data[state_offset + 10:])
+
+        with self.assertRaises(SnapshotError):
+            restore_snapshot(self.path)
+
+    def test_only_registered_components_with_plain_state_are_saved(self):
+        root = build_scene()
+        root.attach_component(UnregisteredComponent('other'))
+        with self.assertRaises(SnapshotError):
+            save_snapshot(root, self.path)
+
+        root = build_scene()
+        root.attach_component(HealthComponent('health', 10, target=root))
+        save_snapshot(root, self.path)
+        self.assertIsNone(restore_snapshot(self.path).get_component_by_name('health').target)
@@ -0,0 +1,96 @@
+import tempfile
+import unittest
+from py3dengine import engine
+from py3dengine.component import Component
+from py3dengine.gameobject import GameObject
+from py3dengine.math import Vector3
+from py3dengine.snapshot import register_snapshot_component
+from py3dengine.streaming import partition_game_object, import_world_partition, StreamingController, WorldPartition
+from py3dengine.transform import Transform
+
+
+@register_snapshot_component('test_lifecycle')
+class LifecycleComponent(Component):
+    events = []
+
+    def loading(self):
+        LifecycleComponent.events.append(('loading', self._owner.name))
+
+    def unloading(self):
+        LifecycleComponent.events.append(('unloading', self._owner.name))
+
+
+def build_world():
+    world = GameObject('world')
+    world._transform = Transform()
+    for name, x in (('near', 5.0), ('middle', 25.0), ('far', 95.0)):
+        go = GameObject(name)
+        go._transform = Transform(Vector3(x, 1.0, 1.0))
+        go.attach_component(LifecycleComponent('lifecycle'))
+        world.attach_child(go)
+
+    return world
+
+
+class WorldPartitionTests(unittest.TestCase):
+    def test_chunks_in_range_uses_chunk_bounds(self):
+        partition = WorldPartition('w', 10.0)
+        partition._chunks = {(x, 0, 0): None for x in range(-3, 4)}
+
+        self.assertEqual({(0, 0, 0)}, partition.chunks_in_range(5.0, 5.0, 5.0, 4.0))
+        self.assertEqual({(-1, 0, 0), (0, 0, 0), (1, 0, 0)}, partition.chunks_in_range(5.0, 5.0, 5.0, 6.0))
+        self.assertEqual((-1, 0, 0), partition.chunk_coords_of(-0.5, 0.0, 9.9))
+
+
+class StreamingControllerTests(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        LifecycleComponent.events = []
+
+        self.descriptor_path = partition_game_object(build_world(), 20.0, self.dir.name)
+        with open(self.descriptor_path) as descriptor:
+            self.partition = import_world_partition(descriptor)
+
+        self.world_root = GameObject('world')
+        self.controller = StreamingController(self.world_root, self.partition, 16.0, 30.0)
+
+    def tearDown(self):
+        self.controller.shutdown()
+        self.dir.cleanup()
+
+    def test_partition_writes_one_chunk_per_occupied_cell(self):
+        self.assertEqual(3, self.partition.get_chunk_count())
+        self.assertEqual('snapshot', self.partition.get_chunk((4, 0, 0)).format)
+
+    def test_chunks_stream_in_and_out_around_focus(self):
+        self.controller.finish_pending(Vector3(5, 1, 1))
+
+        self.assertEqual({(0, 0, 0), (1, 0, 0)}, self.controller.get_resident_chunks())
+        self.assertEqual(2, self.world_root.get_child_count())
+        self.assertIsNotNone(self.world_root.get_child_by_name('middle'))
+        self.assertIn(('loading', 'near'), LifecycleComponent.events)
+
+        self.controller.finish_pending(Vector3(95, 1, 1))
+
+        self.assertEqual({(4, 0, 0)}, self.controller.get_resident_chunks())
+        self.assertIsNone(self.world_root.get_child_by_name('near'))
+        self.assertIn(('unloading', 'near'), LifecycleComponent.events)
+        self.assertIn(('loading', 'far'), LifecycleComponent.events)
+
+    def test_unload_radius_keeps_chunks_resident(self):
+        self.controller.finish_pending(Vector3(5, 1, 1))
+        self.controller.finish_pending(Vector3(45, 1, 1))
+
+        self.assertEqual({(0, 0, 0), (1, 0, 0)}, self.controller.get_resident_chunks())
+        self.assertNotIn(('unloading', 'near'), LifecycleComponent.events)
+
+    def test_unloading_a_streaming_scene_unloads_its_chunks(self):
+        controller = engine.load_streaming_scene(self.descriptor_path, 16.0, 30.0)
+        controller.finish_pending(Vector3(5, 1, 1))
+        self.assertEqual({(0, 0, 0), (1, 0, 0)}, controller.get_resident_chunks())
+
+        engine.unload_scene('world')
+
+        self.assertEqual(set(), controller.get_resident_chunks())
+        self.assertEqual(1, LifecycleComponent.events.count(('unloading', 'near')))
+        self.assertEqual(1, LifecycleComponent.events.count(('unloading', 'middle')))
@@ -0,0 +1,73 @@
+import tempfile
+import unittest
+from os import path
+
+from py3dengine.binary_log import BinaryLogError, decode_records, read_binary_log, render_records, save_binary_log
+from py3dengine.math import BinaryLog
+
+
+class BinaryLogTests(unittest.TestCase):
+    def test_records_round_trip_through_a_file(self):
+        log = BinaryLog()
+        moved = log.register('{} moved to ({:.1f}, {:.1f}) grounded={}', 'sffb')
+        tick = log.register('tick {}', 'i')
+
+        log.write(moved, 'crate', 1.5, -2.0, True)
+        log.write(tick, 42)
+        log.write(moved, 'café', 0.0, 0.25, False)
+
+        with tempfile.TemporaryDirectory() as work_dir:
+            log_path = path.join(work_dir, 'frame.p3dlog')
+            save_binary_log(log, log_path)
+            formats, records, overwritten = read_binary_log(log_path)
+
+        self.assertEqual(0, overwritten)
+        self.assertEqual([moved, tick, moved], [record[1] for record in records])
+        self.assertEqual(('crate', 1.5, -2.0, True), records[0][2])
+        self.assertLessEqual(records[0][0], records[1][0])
+
+        lines = [line.split('] ', 1)[1] for line in render_records(formats, records)]
+        self.assertEqual(
+            ['crate moved to (1.5, -2.0) grounded=True', 'tick 42', 'café moved to (0.0, 0.2) grounded=False'],
+            lines
+        )
+
+    def test_full_ring_keeps_the_newest_records_in_order(self):
+        log = BinaryLog(256)
+        tick = log.register('tick {} {}', 'is')
+
+        for i in range(100):
+            log.write(tick, i, 'x' * (i % 7))
+
+        self.assertGreater(log.overwritten_count, 0)
+        self.assertEqual(100, log.record_count + log.overwritten_count)
+
+        ticks = [args[0] for _, _, args in decode_records(log.snapshot(), log.formats)]
+        self.assertEqual(list(range(100 - len(ticks), 100)), ticks)
+
+        log.reset()
+        self.assertEqual(b'', log.snapshot())
+
+    def test_invalid_writes_raise(self):
+        log = BinaryLog(64)
+        tick = log.register('tick {}', 'i')
+
+        with self.assertRaises(KeyError):
+            log.write(tick + 1, 1)
+        with self.assertRaises(TypeError):
+            log.write(tick)
+        with self.assertRaises(TypeError):
+            log.write(tick, 'one')
+        with self.assertRaises(ValueError):
+            log.register('bad {}', 'x')
+        with self.assertRaises(ValueError):
+            log.write(log.register('{}', 's'), 'x' * 100)
+
+    def test_reading_a_text_file_raises(self):
+        with tempfile.TemporaryDirectory() as work_dir:
+            log_path = path.join(work_dir, 'text.log')
+            with open(log_path, 'w') as log_file:
+                log_file.write('[INFO]: not binary\n')
+
+            with self.assertRaises(BinaryLogError):
+                read_binary_log(log_path)
@@ -0,0 +1,116 @@
+import io
+import os
+import tempfile
+import unittest
+from os import path
+
+from py3dengine import logging
+
+
+class NotFormattable:
+    def __format__(self, format_spec):
+        raise AssertionError('Arguments below the level threshold must not be formatted')
+
+
+class LoggingTests(unittest.TestCase):
+    def setUp(self):
+        self.output = io.StringIO()
+        self.old_dsts = [
+            logging.set_trace_dst(self.output),
+            logging.set_debug_dst(self.output),
+            logging.set_info_dst(self.output),
+            logging.set_warning_dst(self.output),
+        ]
+
+    def tearDown(self):
+        logging.stop_async_logging()
+        logging.set_level('TRACE')
+        for setter, old_dst in zip(
+            (logging.set_trace_dst, logging.set_debug_dst, logging.set_info_dst, logging.set_warning_dst),
+            self.old_dsts
+        ):
+            setter(old_dst)
+
+    def test_messages_below_the_threshold_are_not_formatted(self):
+        logging.set_level('INFO')
+        logging.debug('position {}', NotFormattable())
+        logging.trace('position {}', NotFormattable())
+        logging.info('loaded {} objects in {:.1f} ms', 12, 3.25)
+
+        self.assertEqual('[INFO]: loaded 12 objects in 3.2 ms\n', self.output.getvalue())
+        self.assertFalse(logging.is_enabled_for('DEBUG'))
+        self.assertTrue(logging.is_enabled_for('WARNING'))
+
+        with self.assertRaises(ValueError):
+            logging.set_level('VERBOSE')
+
+    def test_messages_without_arguments_are_written_as_is(self):
+        logging.warning('braces {} stay when nothing is passed')
+        logging.warning('missing {} {}', 1)
+
+        lines = self.output.getvalue().splitlines()
+        self.assertEqual('[WARNING]: braces {} stay when nothing is passed', lines[0])
+        self.assertTrue(lines[1].startswith('[WARNING]: missing {} {} (1,)'))
+
+    def test_bad_arguments_do_not_raise_or_stop_the_async_writer(self):
+        logging.info('took {:.1f} ms', None)
+        self.assertIn('took {:.1f} ms (None,) (could not be formatted', self.output.getvalue())
+
+        with tempfile.TemporaryDirectory() as work_dir:
+            log_path = path.join(work_dir, 'game.log')
+            logging.start_async_logging(log_path)
+            logging.info('took {:.1f} ms', None)
+            logging.info('still {}', 'running')
+            logging.flush_async_logging()
+            logging.stop_async_logging()
+
+            with open(log_path) as log_file:
+                lines = log_file.read().splitlines()
+
+        self.assertEqual(2, len(lines))
+        self.assertIn('could not be formatted', lines[0])
+        self.assertEqual('[INFO]: still running', lines[1])
+
+    def test_async_writer_survives_a_deleted_log_file(self):
+        with tempfile.TemporaryDirectory() as work_dir:
+            log_path = path.join(work_dir, 'game.log')
+            logging.start_async_logging(log_path, max_bytes=1024, backup_count=2)
+            logging.info('before the file is deleted')
+            logging.flush_async_logging()
+            os.remove(log_path)
+
+            for frame in range(100):
+                logging.info('frame {} took {} ms', frame, 16)
+            logging.flush_async_logging()
+            logging.info('after rotation')
+            logging.flush_async_logging()
+            logging.stop_async_logging()
+
+            with open(log_path) as log_file:
+                self.assertIn('[INFO]: after rotation', log_file.read())
+
+    def test_async_logging_writes_batches_and_rotates(self):
+        with tempfile.TemporaryDirectory() as work_dir:
+            log_path = path.join(work_dir, 'game.log')
+            logging.start_async_logging(log_path, max_bytes=4096, backup_count=2)
+            with self.assertRaises(RuntimeError):
+                logging.start_async_logging(log_path)
+
+            for frame in range(300):
+                logging.info('frame {} took {} ms', frame, 16)
+                if frame % 50 == 49:
+                    logging.flush_async_logging()
+            logging.stop_async_logging()
+
+            self.assertEqual('', self.output.getvalue(), 'Nothing goes to the level destinations')
+            self.assertTrue(path.exists(log_path + '.1'))
+            self.assertTrue(path.exists(log_path + '.2'))
+            self.assertFalse(path.exists(log_path + '.3'))
+
+            lines = []
+            for file_path in (log_path + '.2', log_path + '.1', log_path):
+                with open(file_path) as log_file:
+                    lines.extend(log_file.read().splitlines())
+
+            frames = [int(line.split()[2]) for line in lines]
+            self.assertEqual(list(range(300 - len(frames), 300)), frames, 'The newest records are kept in order')
@@ -0,0 +1,90 @@
+import json
+import tempfile
+import threading
+import unittest
+from array import array
+from os import path
+
+from py3dengine import profiler
+from py3dengine.math import Matrix4x4
+from py3dengine.profiler import ProfileZone
+
+
+class ProfilerTests(unittest.TestCase):
+    def setUp(self):
+        profiler.collect()
+        profiler.enable()
+
+    def tearDown(self):
+        profiler.disable()
+        profiler.collect()
+
+    def test_zones_nest_on_their_thread(self):
+        with ProfileZone('frame'):
+            with ProfileZone('update'):
+                pass
+            with ProfileZone('render'):
+                pass
+
+        events = profiler.collect()
+        self.assertEqual(
+            [('B', 'frame'), ('B', 'update'), ('E', 'update'), ('B', 'render'), ('E', 'render'), ('E', 'frame')],
+            [(phase, name) for _, _, phase, name in events]
+        )
+        timestamps = [event[1] for event in events]
+        self.assertEqual(sorted(timestamps), timestamps)
+        self.assertEqual([], profiler.collect(), 'Collecting removes the events')
+
+        summary = profiler.summarize(events)
+        self.assertEqual(1, summary['frame'][0])
+        self.assertGreaterEqual(summary['frame'][1], summary['update'][1] + summary['render'][1])
+
+    def test_decorated_functions_and_math_kernels_record_zones(self):
+        worlds = array('f', [1.0] * 16 * 8)
+        out = array('f', bytes(len(worlds) * 4))
+
+        @ProfileZone()
+        def draw():
+            return Matrix4x4.MultBatch(worlds, Matrix4x4(), out)
+
+        self.assertEqual(8, draw())
+
+        names = [name for _, _, phase, name in profiler.collect() if phase == 'B']
+        self.assertEqual(['ProfilerTests.test_decorated_functions_and_math_kernels_record_zones.<locals>.draw',
+                          'Mat4MultBatch'], names)
+
+    def test_disabled_profiler_records_nothing(self):
+        profiler.disable()
+        with ProfileZone('frame'):
+            Matrix4x4.MultBatch(array('f', [1.0] * 16), Matrix4x4(), array('f', [0.0] * 16))
+
+        self.assertEqual([], profiler.collect())
+
+    def test_threads_record_separately_and_export_as_chrome_trace(self):
+        def work():
+            with ProfileZone('worker'):
+                pass
+
+        worker = threading.Thread(target=work, name='profiled worker')
+        with ProfileZone('main'):
+            worker.start()
+            worker.join()
+
+        with tempfile.TemporaryDirectory() as work_dir:
+            trace_path = path.join(work_dir, 'trace.json')
+            self.assertEqual(4, profiler.export_chrome_trace(trace_path))
+            with open(trace_path) as trace_file:
+                trace = json.load(trace_file)
+
+        zones = [e for e in trace['traceEvents'] if e['ph'] in ('B', 'E')]
+        tids = {e['name']: e['tid'] for e in zones}
+        self.assertNotEqual(tids['main'], tids['worker'])
+
+        thread_names = {e['tid']: e['args']['name'] for e in trace['traceEvents'] if e['ph'] == 'M'}
+        self.assertEqual('profiled worker', thread_names[tids['worker']])
+        self.assertEqual(0, trace['otherData']['dropped_events'])
+
+    def test_zone_names_must_be_strings(self):
+        with self.assertRaises(TypeError):
+            with ProfileZone(42):
+                pass
@@ -0,0 +1,149 @@
+import sys
+import threading
+import unittest
+from array import array
+from py3dengine.math import AnimationClip, Matrix4x4, Quaternion, Skeleton, Vector3
+
+
+def matrix_floats(m):
+    return list(memoryview(m))
+
+
+def palette_matrix(out, bone):
+    return out[bone * 16:bone * 16 + 16]
+
+
+def local_matrix(translation, rotation=Quaternion(0, 0, 0, 1), scale=Vector3(1, 1, 1)):
+    return Matrix4x4.Scaling(scale) * rotation.to_matrix() * Matrix4x4.Translation(translation)
+
+
+class AnimationTests(unittest.TestCase):
+    def setUp(self):
+        # A three bone chain: root <- upper <- lower, each child one unit along x from its parent
+        self.skeleton = Skeleton([-1, 0, 1])
+        self.quarter_turn = Quaternion.FromAxisAndDegrees(Vector3(0, 0, 1), 90)
+        self.walk = AnimationClip(2.0, [
+            (0, 'translation', [0.0, 2.0], [0, 0, 0, 4, 0, 0]),
+            (1, 'translation', [0.0], [1, 0, 0]),
+            (1, 'rotation', [0.0, 2.0], [0, 0, 0, 1, *self.quarter_turn_tuple()]),
+            (2, 'translation', [0.0], [1, 0, 0]),
+        ])
+        self.out = array('f', bytes(3 * 16 * 4))
+
+    def quarter_turn_tuple(self):
+        q = self.quarter_turn
+        return q.x, q.y, q.z, q.w
+
+    def assert_matrix(self, expected, actual, places=4):
+        for a, b in zip(matrix_floats(expected), actual):
+            self.assertAlmostEqual(a, b, places=places)
+
+    def test_clip_properties(self):
+        self.assertEqual(3, self.skeleton.bone_count)
+        self.assertEqual(2.0, self.walk.duration)
+        self.assertEqual(4, self.walk.track_count)
+
+    def test_palette_composes_the_hierarchy(self):
+        self.skeleton.evaluate([(self.walk, 1.0)], self.out)
+
+        half_turn = Quaternion.FromAxisAndDegrees(Vector3(0, 0, 1), 45)
+        root = local_matrix(Vector3(2, 0, 0))
+        upper = local_matrix(Vector3(1, 0, 0), half_turn) * root
+        lower = local_matrix(Vector3(1, 0, 0)) * upper
+
+        self.assert_matrix(root, palette_matrix(self.out, 0))
+        self.assert_matrix(upper, palette_matrix(self.out, 1))
+        self.assert_matrix(lower, palette_matrix(self.out, 2))
+
+    def test_inverse_bind_matrices(self):
+        inverse_bind = array('f')
+        for bone in range(3):
+            inverse_bind.extend(matrix_floats(Matrix4x4.Translation(Vector3(-bone, 0, 0))))
+        skeleton = Skeleton([-1, 0, 1], inverse_bind)
+
+        skeleton.evaluate([(self.walk, 0.0)], self.out)
+        for bone in range(3):
+            self.assert_matrix(Matrix4x4.Scaling(Vector3(1, 1, 1)), palette_matrix(self.out, bone))
+
+    def test_sampling_clamps_and_loops(self):
+        self.skeleton.evaluate([(self.walk, 3.0)], self.out, False)
+        self.assertAlmostEqual(4.0, self.out[12], places=5)
+
+        self.skeleton.evaluate([(self.walk, 2.5)], self.out)
+        self.assertAlmostEqual(1.0, self.out[12], places=5)
+
+    def test_untracked_bones_keep_the_rest_pose(self):
+        rest = array('f', [5, 0, 0, 0, 0, 0, 1, 2, 2, 2] * 2)
+        skeleton = Skeleton([-1, 0], rest_pose=rest)
+        clip = AnimationClip(1.0, [(1, 'scale', [0.0], [3, 3, 3])])
+        out = array('f', bytes(2 * 16 * 4))
+
+        skeleton.evaluate([(clip, 0.0)], out)
+        root = local_matrix(Vector3(5, 0, 0), scale=Vector3(2, 2, 2))
+        self.assert_matrix(root, palette_matrix(out, 0))
+        self.assert_matrix(local_matrix(Vector3(5, 0, 0), scale=Vector3(3, 3, 3)) * root, palette_matrix(out, 1))
+
+    def test_blending_two_clips(self):
+        still = AnimationClip(1.0, [(0, 'translation', [0.0], [10, 0, 0])])
+        self.skeleton.evaluate([(self.walk, 0.0, still, 0.0, 0.25)], self.out)
+        self.assertAlmostEqual(2.5, self.out[12], places=5)
+
+    def test_jobs_fill_consecutive_palettes(self):
+        jobs = [(self.walk, t * 0.1) for t in range(20)]
+        out = array('f', bytes(len(jobs) * 3 * 16 * 4))
+        self.skeleton.evaluate(jobs, out, threads=4)
+
+        single = array('f', bytes(3 * 16 * 4))
+        for j, job in enumerate(jobs):
+            self.skeleton.evaluate([job], single, threads=1)
+            self.assertEqual(list(single), list(out[j * 48:j * 48 + 48]))
+
+    def test_rejects_bad_input(self):
+        with self.assertRaises(ValueError):
+            Skeleton([-1, 2, 0])
+        with self.assertRaises(ValueError):
+            AnimationClip(1.0, [(0, 'position', [0.0], [0, 0, 0])])
+        with self.assertRaises(ValueError):
+            AnimationClip(1.0, [(0, 'rotation', [0.0], [0, 0, 0])])
+        with self.assertRaises(ValueError):
+            AnimationClip(1.0, [(0, 'scale', [1.0, 0.5], [1, 1, 1, 2, 2, 2])])
+        with self.assertRaises(ValueError):
+            self.skeleton.evaluate([(AnimationClip(1.0, [(3, 'scale', [0.0], [1, 1, 1])]), 0.0)], self.out)
+        with self.assertRaises(ValueError):
+            self.skeleton.evaluate([(self.walk, 0.0)] * 2, self.out)
+        with self.assertRaises(TypeError):
+            AnimationClip(1.0, [[0, 'scale', [0.0], [1, 1, 1]]])
+        with self.assertRaises(TypeError):
+            self.skeleton.evaluate([[self.walk, 0.0]], self.out)
+
+    def test_clips_and_skeleton_cannot_change_while_evaluating(self):
+        jobs = [(self.walk, t * 0.001) for t in range(200000)]
+        out = array('f', bytes(len(jobs) * 3 * 16 * 4))
+        tracks = [(0, 'translation', [0.0], [0, 0, 0])]
+
+        rejected = []
+        old_interval = sys.getswitchinterval()
+        # A long switch interval keeps this thread holding the GIL until evaluate releases it
+        sys.setswitchinterval(0.1)
+        try:
+            evaluator = threading.Thread(target=self.skeleton.evaluate, args=(jobs, out), kwargs={'threads': 1})
+            evaluator.start()
+            while evaluator.is_alive() and not rejected:
+                try:
+                    self.walk.__init__(2.0, tracks)
+                except RuntimeError:
+                    rejected.append('clip')
+                    with self.assertRaises(RuntimeError):
+                        self.skeleton.__init__([-1, 0, 1, 2, 3])
+            evaluator.join()
+        finally:
+            sys.setswitchinterval(old_interval)
+
+        self.assertEqual(['clip'], rejected)
+        self.assertEqual(3, self.skeleton.bone_count)
+        self.walk.__init__(2.0, tracks)
+        self.skeleton.__init__([-1, 0, 1, 2, 3])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,156 @@
+import random
+import sys
+import threading
+import unittest
+from array import array
+from py3dengine.math import Matrix4x4, SweepAndPrune, Vector3
+
+
+def overlaps(box_a, box_b):
+    return all(box_a[0][a] <= box_b[1][a] and box_b[0][a] <= box_a[1][a] for a in range(3))
+
+
+def brute_force(boxes):
+    names = sorted(boxes)
+    return {
+        (a, b) for i, a in enumerate(names) for b in names[i + 1:] if overlaps(boxes[a], boxes[b])
+    }
+
+
+def normalized(pairs):
+    return {tuple(sorted(pair)) for pair in pairs}
+
+
+class SweepAndPruneTests(unittest.TestCase):
+    def setUp(self):
+        self.rng = random.Random(11)
+        self.sap = SweepAndPrune()
+        self.boxes = {}
+        self.proxies = {}
+        for i in range(300):
+            self.add(i)
+
+    def random_box(self):
+        x, y, z = (self.rng.uniform(0, 40) for _ in range(3))
+        return (x, y, z), (x + self.rng.uniform(0.5, 4), y + self.rng.uniform(0.5, 4), z + self.rng.uniform(0.5, 4))
+
+    def add(self, name):
+        self.boxes[name] = self.random_box()
+        self.proxies[name] = self.sap.insert(name, Vector3(*self.boxes[name][0]), Vector3(*self.boxes[name][1]))
+
+    def test_events_track_brute_force_overlaps(self):
+        began, ended = self.sap.update_pairs()
+        self.assertEqual([], ended)
+        current = normalized(began)
+        self.assertEqual(brute_force(self.boxes), current)
+
+        next_name = len(self.boxes)
+        for frame in range(40):
+            for name in list(self.boxes):
+                roll = self.rng.random()
+                if roll < 0.02:
+                    self.sap.remove(self.proxies.pop(name))
+                    del self.boxes[name]
+                elif roll < 0.6:
+                    offset = [self.rng.uniform(-0.6, 0.6) for _ in range(3)]
+                    low, high = self.boxes[name]
+                    self.boxes[name] = tuple(v + o for v, o in zip(low, offset)), tuple(v + o for v, o in zip(high, offset))
+                    self.sap.update(self.proxies[name], Vector3(*self.boxes[name][0]), Vector3(*self.boxes[name][1]))
+
+            for _ in range(self.rng.randrange(4)):
+                self.add(next_name)
+                next_name += 1
+
+            began, ended = self.sap.update_pairs()
+            began, ended = normalized(began), normalized(ended)
+            self.assertFalse(began & ended, 'A pair is never reported as beginning and ending in one update')
+            self.assertTrue(ended <= current)
+            self.assertFalse(began & current)
+
+            current = (current - ended) | began
+            self.assertEqual(brute_force(self.boxes), current)
+            self.assertEqual(current, normalized(self.sap.get_pairs()))
+            self.assertEqual(len(current), self.sap.pair_count)
+            self.assertEqual(len(self.boxes), len(self.sap))
+
+    def test_no_events_without_movement(self):
+        self.sap.update_pairs()
+        self.assertEqual(([], []), self.sap.update_pairs())
+
+    def test_touching_and_removed_pairs(self):
+        sap = SweepAndPrune()
+        a = sap.insert('a', Vector3(0, 0, 0), Vector3(1, 1, 1))
+        b = sap.insert('b', Vector3(1, 0, 0), Vector3(2, 1, 1))
+        c = sap.insert('c', Vector3(0.5, 0, 0), Vector3(1.5, 1, 1))
+        self.assertEqual({('a', 'b'), ('a', 'c'), ('b', 'c')}, normalized(sap.update_pairs()[0]))
+
+        sap.remove(b)
+        sap.remove(c)
+        with self.assertRaises(KeyError):
+            sap.remove(b)
+        began, ended = sap.update_pairs()
+        self.assertEqual([], began)
+        self.assertEqual({('a', 'b'), ('a', 'c'), ('b', 'c')}, normalized(ended))
+
+        sap.update(a, Vector3(5, 5, 5), Vector3(6, 6, 6), Matrix4x4.Translation(Vector3(-5, -5, -5)))
+        d = sap.insert('d', Vector3(0.5, 0.5, 0.5), Vector3(0.7, 0.7, 0.7))
+        self.assertEqual([('a', 'd')], sap.update_pairs()[0])
+        self.assertEqual(2, len(sap))
+        self.assertNotEqual(a, d)
+
+    def test_update_batch(self):
+        self.sap.update_pairs()
+        names = sorted(self.proxies)
+        proxies = array('i', (self.proxies[name] for name in names))
+        bounds = array('f')
+        for i, name in enumerate(names):
+            low = (i % 10 * 2.0, i // 10 * 2.0, 0.0)
+            self.boxes[name] = low, (low[0] + 1, low[1] + 1, 1.0)
+            bounds.extend(self.boxes[name][0] + self.boxes[name][1])
+
+        self.assertEqual(len(names), self.sap.update_batch(proxies, bounds))
+        self.sap.update_pairs()
+        self.assertEqual(set(), normalized(self.sap.get_pairs()))
+
+        with self.assertRaises(ValueError):
+            self.sap.update_batch(proxies, bounds[:-1])
+        with self.assertRaises(KeyError):
+            self.sap.update_batch(array('i', [10000]), array('f', [0] * 6))
+
+    def test_proxies_cannot_change_while_updating_pairs(self):
+        sap = SweepAndPrune()
+        for i in range(50000):
+            low = self.random_box()[0]
+            sap.insert(i, Vector3(*low), Vector3(low[0] + 0.5, low[1] + 0.5, low[2] + 0.5))
+
+        observed = False
+        old_interval = sys.getswitchinterval()
+        # A long switch interval keeps this thread holding the GIL until update_pairs releases it to sweep
+        sys.setswitchinterval(0.1)
+        try:
+            updater = threading.Thread(target=sap.update_pairs)
+            updater.start()
+            while updater.is_alive() and not observed:
+                if sap.updating:
+                    observed = True
+                    with self.assertRaises(RuntimeError):
+                        sap.__init__()
+                    with self.assertRaises(RuntimeError):
+                        sap.insert('late', Vector3(0, 0, 0), Vector3(1, 1, 1))
+                    with self.assertRaises(RuntimeError):
+                        sap.update(0, Vector3(0, 0, 0), Vector3(1, 1, 1))
+                    with self.assertRaises(RuntimeError):
+                        sap.remove(0)
+                    with self.assertRaises(RuntimeError):
+                        sap.update_pairs()
+            updater.join()
+        finally:
+            sys.setswitchinterval(old_interval)
+
+        self.assertTrue(observed, 'update_pairs finished before the flag was seen')
+        self.assertFalse(sap.updating)
+        self.assertEqual(50000, len(sap))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,128 @@
+import math
+import random
+import unittest
+from py3dengine.math import BoundingVolumeHierarchy, Matrix4x4, Vector3
+
+
+def random_boxes(count, seed=7):
+    rng = random.Random(seed)
+    boxes = []
+    for i in range(count):
+        x, y, z = rng.uniform(-100, 100), rng.uniform(-100, 100), rng.uniform(-100, 100)
+        sx, sy, sz = rng.uniform(0.1, 4), rng.uniform(0.1, 4), rng.uniform(0.1, 4)
+        boxes.append((i, (x, y, z), (x + sx, y + sy, z + sz)))
+
+    return boxes
+
+
+def overlaps(box, low, high):
+    _, box_low, box_high = box
+    return all(box_low[a] <= high[a] and low[a] <= box_high[a] for a in range(3))
+
+
+def distance(box, point):
+    _, low, high = box
+    return math.sqrt(sum(max(low[a] - point[a], 0, point[a] - high[a]) ** 2 for a in range(3)))
+
+
+class BoundingVolumeHierarchyTests(unittest.TestCase):
+    def setUp(self):
+        self.boxes = random_boxes(500)
+        self.bvh = BoundingVolumeHierarchy(0.5)
+        self.proxies = {}
+        for box in self.boxes:
+            self.proxies[box[0]] = self.bvh.insert(box[0], Vector3(*box[1]), Vector3(*box[2]))
+
+    def assert_queries_match(self, boxes):
+        low, high = (-20, -30, -10), (40, 10, 25)
+        expected = sorted(b[0] for b in boxes if overlaps(b, low, high))
+        self.assertEqual(expected, sorted(self.bvh.query_aabb(Vector3(*low), Vector3(*high))))
+
+        center = (5, -5, 12)
+        expected = sorted(b[0] for b in boxes if distance(b, center) <= 30)
+        self.assertEqual(expected, sorted(self.bvh.query_sphere(Vector3(*center), 30)))
+
+        expected = sorted(distance(b, center) for b in boxes)[:8]
+        found = self.bvh.nearest(Vector3(*center), 8)
+        self.assertEqual(8, len(found))
+        for (_, dist), expected_dist in zip(found, expected):
+            self.assertAlmostEqual(expected_dist, dist, places=3)
+
+    def test_queries_match_brute_force(self):
+        self.assertEqual(500, len(self.bvh))
+        self.assert_queries_match(self.boxes)
+
+    def test_tree_stays_balanced(self):
+        self.assertLessEqual(self.bvh.height, 2 * math.ceil(math.log2(len(self.boxes))))
+
+    def test_ray_cast_returns_closest_hit(self):
+        bvh = BoundingVolumeHierarchy()
+        bvh.insert('far', Vector3(-1, -1, 9), Vector3(1, 1, 11))
+        bvh.insert('near', Vector3(-1, -1, 4), Vector3(1, 1, 6))
+        bvh.insert('aside', Vector3(5, 5, 0), Vector3(6, 6, 1))
+
+        obj, t = bvh.ray_cast(Vector3(0, 0, 0), Vector3(0, 0, 1))
+        self.assertEqual('near', obj)
+        self.assertAlmostEqual(4, t, places=5)
+
+        self.assertIsNone(bvh.ray_cast(Vector3(0, 0, 0), Vector3(0, 0, 1), 3))
+        self.assertIsNone(bvh.ray_cast(Vector3(0, 0, 0), Vector3(0, 0, -1)))
+
+    def test_update_and_remove(self):
+        moved = []
+        for box in self.boxes:
+            if box[0] % 3 == 0:
+                self.bvh.remove(self.proxies[box[0]])
+                continue
+
+            if box[0] % 3 == 1:
+                offset = 50 if box[0] % 2 == 0 else 0.1
+                box = (box[0], tuple(v + offset for v in box[1]), tuple(v + offset for v in box[2]))
+                self.bvh.update(self.proxies[box[0]], Vector3(*box[1]), Vector3(*box[2]))
+            moved.append(box)
+
+        self.assertEqual(len(moved), len(self.bvh))
+        self.assert_queries_match(moved)
+
+        with self.assertRaises(KeyError):
+            self.bvh.remove(self.proxies[0])
+
+    def test_set_bounds_refit_and_rebuild(self):
+        moved = []
+        for box in self.boxes:
+            box = (box[0], tuple(v * 0.5 for v in box[1]), tuple(v * 0.5 for v in box[2]))
+            self.bvh.set_bounds(self.proxies[box[0]], Vector3(*box[1]), Vector3(*box[2]))
+            moved.append(box)
+
+        self.bvh.refit()
+        self.assert_queries_match(moved)
+
+        self.bvh.rebuild()
+        self.assert_queries_match(moved)
+        for box in moved:
+            self.assertFalse(
+                self.bvh.update(self.proxies[box[0]], Vector3(*box[1]), Vector3(*box[2])),
+                'Proxies survive a rebuild'
+            )
+
+    def test_uninitialized_tree_raises(self):
+        bvh = BoundingVolumeHierarchy.__new__(BoundingVolumeHierarchy)
+
+        with self.assertRaises(RuntimeError):
+            bvh.refit()
+        with self.assertRaises(RuntimeError):
+            bvh.rebuild()
+        with self.assertRaises(RuntimeError):
+            bvh.height
+
+    def test_insert_with_world_matrix(self):
+        bvh = BoundingVolumeHierarchy()
+        world = Matrix4x4.RotationY(90) * Matrix4x4.Translation(Vector3(10, 0, 0))
+        bvh.insert('box', Vector3(0, 0, 0), Vector3(2, 1, 1), world)
+
+        self.assertEqual(['box'], bvh.query_aabb(Vector3(10.5, 0.5, -1.5), Vector3(10.5, 0.5, -1.5)))
+        self.assertEqual([], bvh.query_aabb(Vector3(11.5, 0.5, 1.5), Vector3(11.5, 0.5, 1.5)))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,104 @@
+import os
+import random
+import unittest
+from array import array
+
+from py3dengine.math import Dispatch, Frustum, Matrix4x4, Quaternion, Skeleton, Vector3
+from py3dengine.render import image_difference, render_mesh, rgba_to_rgb
+from py3dengine.wfoparser import import_from_file
+
+CUBE_OBJ = os.path.join(os.path.dirname(__file__), os.pardir, 'render', 'data', 'cube.obj')
+
+
+class DispatchTests(unittest.TestCase):
+    def setUp(self):
+        self.original_tier = Dispatch.Tier()
+
+        rng = random.Random(3)
+        self.count = 29
+        self.matrices = [
+            Matrix4x4.RotationY(rng.uniform(0, 360)) * Matrix4x4.Translation(Vector3(rng.uniform(-9, 9), 1, 2))
+            for _ in range(self.count)
+        ]
+        self.packed_matrices = array('f')
+        for m in self.matrices:
+            self.packed_matrices.frombytes(memoryview(m).tobytes())
+
+        self.packed_quats = array('f', (rng.uniform(-2, 2) for _ in range(self.count * 4)))
+        self.packed_quats[8:12] = array('f', (0, 0, 0, 0))
+        self.packed_vectors = array('f', (rng.uniform(-5, 5) for _ in range(self.count * 3)))
+        self.frustum = Frustum(Matrix4x4.OrthographicLH(8, 6, 0, 10))
+        self.centers = [array('f', (rng.uniform(-6, 6) for _ in range(self.count))) for _ in range(3)]
+        self.radii = array('f', (rng.uniform(0, 2) for _ in range(self.count)))
+        self.bone_indices = array('i', (rng.randrange(self.count) for _ in range(self.count * 4)))
+        self.bone_weights = array('f', (rng.uniform(0, 0.5) for _ in range(self.count * 4)))
+
+    def tearDown(self):
+        Dispatch.SetTier(self.original_tier)
+
+    def run_kernels(self):
+        results = []
+        for m in self.matrices[:4]:
+            results.append(memoryview(m * self.matrices[-1]).tolist())
+            results.append(memoryview(m.inverse()).tolist())
+
+        out = array('f', bytes(len(self.packed_matrices) * 4))
+        Matrix4x4.MultBatch(self.packed_matrices, self.matrices[0], out)
+        results.append(out.tolist())
+
+        out = array('f', self.packed_quats)
+        Quaternion.NormalizeBatch(self.packed_quats, out)
+        results.append(out.tolist())
+
+        out = array('f', self.packed_vectors)
+        Quaternion.RotateBatch(self.packed_vectors, Quaternion.FromAxisAndDegrees(Vector3(0, 1, 0), 40), out)
+        results.append(out.tolist())
+        Quaternion.RotateBatch(self.packed_vectors, self.packed_quats, out)
+        results.append(out.tolist())
+
+        results.append(self.frustum.cull_spheres(*self.centers, self.radii))
+        mins = [array('f', (c - r for c, r in zip(axis, self.radii))) for axis in self.centers]
+        maxs = [array('f', (c + r for c, r in zip(axis, self.radii))) for axis in self.centers]
+        results.append(self.frustum.cull_aabbs(*mins, *maxs))
+
+        positions = array('f', bytes(len(self.packed_vectors) * 4))
+        normals = array('f', positions)
+        Skeleton.SkinVertices(
+            self.packed_matrices, self.packed_vectors, self.bone_indices, self.bone_weights, positions,
+            self.packed_vectors, normals, threads=1
+        )
+        results.append(positions.tolist())
+        results.append(normals.tolist())
+
+        return results
+
+    def test_every_supported_tier_matches_scalar(self):
+        tiers = Dispatch.SupportedTiers()
+        self.assertEqual('scalar', tiers[0])
+        self.assertEqual(tiers[-1], Dispatch.DetectedTier())
+
+        Dispatch.SetTier('scalar')
+        expected = self.run_kernels()
+
+        for tier in tiers[1:]:
+            Dispatch.SetTier(tier)
+            self.assertEqual(tier, Dispatch.Tier())
+            for expected_values, actual_values in zip(expected, self.run_kernels()):
+                for e, a in zip(expected_values, actual_values):
+                    self.assertAlmostEqual(e, a, delta=1e-4 * max(1.0, abs(e)), msg=f'Tier {tier}')
+
+    def test_every_supported_tier_rasterizes_like_scalar(self):
+        mesh = import_from_file(CUBE_OBJ)
+        Dispatch.SetTier('scalar')
+        expected = rgba_to_rgb(render_mesh(mesh, 61, 47).color_bytes())
+
+        for tier in Dispatch.SupportedTiers()[1:]:
+            Dispatch.SetTier(tier)
+            _, failed = image_difference(expected, rgba_to_rgb(render_mesh(mesh, 61, 47).color_bytes()), tolerance=1)
+            self.assertEqual(0, failed, f'Tier {tier}')
+
+    def test_invalid_tiers_raise(self):
+        with self.assertRaises(ValueError):
+            Dispatch.SetTier('sse5')
+
+        self.assertEqual(self.original_tier, Dispatch.Tier())
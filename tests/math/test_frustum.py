@@ -0,0 +1,81 @@
+import random
+import unittest
+from array import array
+from py3dengine.math import Frustum, Matrix4x4, Vector3
+
+
+def orthographic_view_projection(width, height, near, far):
+    """Camera at the origin looking down +z, the box maps to x, y in [-1, 1] and z in [0, 1]"""
+    view = Matrix4x4.LookAtLH(Vector3(0, 0, 0), Vector3(0, 0, 1), Vector3(0, 1, 0))
+
+    return view * Matrix4x4.OrthographicLH(width, height, near, far)
+
+
+def plane_distance(plane, p):
+    return plane[0] * p[0] + plane[1] * p[1] + plane[2] * p[2] + plane[3]
+
+
+class FrustumTests(unittest.TestCase):
+    def setUp(self):
+        self.frustum = Frustum(orthographic_view_projection(20, 10, 1, 50))
+
+        rng = random.Random(3)
+        self.count = 1003
+        self.x = array('f', (rng.uniform(-30, 30) for _ in range(self.count)))
+        self.y = array('f', (rng.uniform(-20, 20) for _ in range(self.count)))
+        self.z = array('f', (rng.uniform(-10, 70) for _ in range(self.count)))
+        self.r = array('f', (rng.uniform(0, 3) for _ in range(self.count)))
+
+    def test_planes_bound_the_box(self):
+        expected = {(1, 0, 0, 10), (-1, 0, 0, 10), (0, 1, 0, 5), (0, -1, 0, 5), (0, 0, 1, -1), (0, 0, -1, 50)}
+        planes = {tuple(round(v, 4) + 0.0 for v in plane) for plane in self.frustum.planes}
+
+        self.assertEqual(expected, planes)
+
+    def test_single_volume_tests(self):
+        self.assertTrue(self.frustum.test_point(Vector3(0, 0, 10)))
+        self.assertFalse(self.frustum.test_point(Vector3(0, 0, 0.5)))
+        self.assertTrue(self.frustum.test_sphere(Vector3(11, 0, 10), 1.5))
+        self.assertFalse(self.frustum.test_sphere(Vector3(12, 0, 10), 1.5))
+        self.assertTrue(self.frustum.test_aabb(Vector3(-15, -15, 49), Vector3(-9, 15, 60)))
+        self.assertFalse(self.frustum.test_aabb(Vector3(-15, -15, 51), Vector3(-9, 15, 60)))
+
+    def test_cull_spheres_matches_brute_force(self):
+        planes = self.frustum.planes
+        expected = [
+            i for i in range(self.count)
+            if all(plane_distance(p, (self.x[i], self.y[i], self.z[i])) >= -self.r[i] for p in planes)
+        ]
+
+        self.assertTrue(0 < len(expected) < self.count)
+        self.assertEqual(expected, self.frustum.cull_spheres(self.x, self.y, self.z, self.r))
+
+        out = array('i', bytes(4 * self.count))
+        written = self.frustum.cull_spheres(self.x, self.y, self.z, self.r, out)
+        self.assertEqual(expected, list(out[:written]))
+
+    def test_cull_aabbs_matches_single_tests(self):
+        max_x = array('f', (v + r for v, r in zip(self.x, self.r)))
+        max_y = array('f', (v + r for v, r in zip(self.y, self.r)))
+        max_z = array('f', (v + r for v, r in zip(self.z, self.r)))
+        expected = [
+            i for i in range(self.count)
+            if self.frustum.test_aabb(
+                Vector3(self.x[i], self.y[i], self.z[i]), Vector3(max_x[i], max_y[i], max_z[i])
+            )
+        ]
+
+        self.assertTrue(0 < len(expected) < self.count)
+        self.assertEqual(expected, self.frustum.cull_aabbs(self.x, self.y, self.z, max_x, max_y, max_z))
+
+    def test_rejects_mismatched_buffers(self):
+        with self.assertRaises(ValueError):
+            self.frustum.cull_spheres(self.x, self.y, self.z, self.r[:-1])
+        with self.assertRaises(ValueError):
+            self.frustum.cull_spheres(self.x, self.y, self.z, array('d', self.r))
+        with self.assertRaises(ValueError):
+            self.frustum.cull_spheres(self.x, self.y, self.z, self.r, array('i', [0]))
+
+
+if __name__ == '__main__':
+    unittest.main()
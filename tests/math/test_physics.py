@@ -0,0 +1,190 @@
+import threading
+import unittest
+from array import array
+from py3dengine.math import PhysicsWorld, Quaternion, Vector3
+from py3dengine.transform import Transform
+
+
+def vector_tuple(v):
+    return v.x, v.y, v.z
+
+
+class PhysicsWorldTests(unittest.TestCase):
+    def setUp(self):
+        self.world = PhysicsWorld()
+        self.ground = Transform(Vector3(0, -1, 0))
+        self.world.add_body(self.ground, 'box', Vector3(50, 1, 50), 0)
+
+    def simulate(self, seconds, dt=1 / 60):
+        for _ in range(round(seconds / dt)):
+            self.world.step(dt)
+        self.world.write_transforms()
+
+    def test_free_fall_uses_semi_implicit_euler(self):
+        world = PhysicsWorld(Vector3(0, -10, 0))
+        transform = Transform(Vector3(0, 100, 0))
+        world.add_body(transform, 'sphere', Vector3(1, 0, 0), 2)
+
+        for _ in range(4):
+            world.step(0.5)
+        self.assertEqual(1, world.write_transforms())
+
+        # v_n = -5n, y_n = 100 - 0.5 * 5 * (1 + 2 + ... + n)
+        self.assertAlmostEqual(75, transform.position.y, places=4)
+        self.assertAlmostEqual(-20, world.get_velocity(0)[0].y, places=4)
+
+    def test_shapes_come_to_rest_on_the_ground(self):
+        sphere = Transform(Vector3(-4, 3, 0))
+        box = Transform(Vector3(0, 2, 0), Quaternion.FromAxisAndDegrees(Vector3(1, 0, 1).normalize(), 30))
+        capsule = Transform(Vector3(4, 2, 0), Quaternion.FromAxisAndDegrees(Vector3(0, 0, 1), 90))
+        self.world.add_body(sphere, 'sphere', Vector3(0.5, 0, 0))
+        self.world.add_body(box, 'box', Vector3(0.5, 0.5, 0.5))
+        self.world.add_body(capsule, 'capsule', Vector3(0.3, 0.5, 0))
+
+        self.simulate(5)
+
+        self.assertAlmostEqual(0.5, sphere.position.y, delta=0.02)
+        self.assertAlmostEqual(0.5, box.position.y, delta=0.02)
+        self.assertAlmostEqual(0.3, capsule.position.y, delta=0.02)
+        self.assertAlmostEqual(0, self.world.get_velocity(1)[0].y, delta=0.05)
+        self.assertGreater(self.world.contact_count, 0)
+
+    def test_box_stack_is_stable(self):
+        boxes = [Transform(Vector3(0, 0.5 + i, 0)) for i in range(5)]
+        for box in boxes:
+            self.world.add_body(box, 'box', Vector3(0.5, 0.5, 0.5))
+
+        self.simulate(5)
+
+        for i, box in enumerate(boxes):
+            self.assertAlmostEqual(0.5 + i, box.position.y, delta=0.03)
+            self.assertAlmostEqual(0, box.position.x, delta=0.03)
+
+    def test_restitution_bounces(self):
+        ball = Transform(Vector3(0, 5, 0))
+        body = self.world.add_body(ball, 'sphere', Vector3(0.5, 0, 0), restitution=1.0)
+
+        peak, falling = 0.0, True
+        for _ in range(240):
+            self.world.step(1 / 120)
+            velocity = self.world.get_velocity(body)[0].y
+            if falling and velocity > 0:
+                falling = False
+            if not falling:
+                self.world.write_transforms()
+                peak = max(peak, ball.position.y)
+
+        self.assertGreater(peak, 4)
+
+    def test_write_transforms_refreshes_world_matrix(self):
+        ball = Transform(Vector3(0, 5, 0))
+        self.world.add_body(ball, 'sphere', Vector3(0.5, 0, 0))
+        self.assertAlmostEqual(5, list(memoryview(ball.world_matrix))[13])
+
+        self.simulate(0.5)
+
+        self.assertAlmostEqual(ball.position.y, list(memoryview(ball.world_matrix))[13], places=5)
+        self.assertEqual((0, -1, 0), vector_tuple(self.ground.position), 'Static bodies are not written')
+
+    def test_read_transforms_sees_teleports_and_kinematic_moves(self):
+        ball = Transform(Vector3(0, 5, 0))
+        self.world.add_body(ball, 'sphere', Vector3(0.5, 0, 0))
+        self.simulate(2)
+        self.assertAlmostEqual(0.5, ball.position.y, places=1)
+
+        ball.position = Vector3(0, 10, 0)
+        self.ground.position = Vector3(0, -21, 0)
+        self.assertEqual(2, self.world.read_transforms())
+        self.simulate(1)
+
+        self.assertAlmostEqual(10 - 9.81 / 2, ball.position.y, delta=0.2, msg='The teleported ball falls from where it was moved to')
+        self.assertGreater(ball.position.y, -19.5, 'The moved ground still stops the ball')
+        self.simulate(2)
+        self.assertAlmostEqual(-19.5, ball.position.y, places=1)
+        self.assertAlmostEqual(ball.position.y, list(memoryview(ball.world_matrix))[13], places=5)
+
+    def test_velocity_and_state(self):
+        ball = Transform(Vector3(0, 5, 0))
+        body = self.world.add_body(ball, 'sphere', Vector3(0.5, 0, 0))
+        self.world.set_velocity(body, Vector3(1, 0, 0), Vector3(0, 1, 0))
+
+        state = array('f', bytes(2 * 7 * 4))
+        self.world.copy_state(state)
+        self.assertEqual([0, 5, 0], list(state[7:10]))
+
+        self.assertEqual((1, 0, 0), vector_tuple(self.world.get_velocity(body)[0]))
+        self.assertEqual((0, 1, 0), vector_tuple(self.world.get_velocity(body)[1]))
+
+    def test_same_scene_is_deterministic(self):
+        def run():
+            world = PhysicsWorld()
+            world.add_body(Transform(Vector3(0, -1, 0)), 'box', Vector3(20, 1, 20), 0)
+            shapes = (('sphere', Vector3(0.4, 0, 0)), ('box', Vector3(0.4, 0.3, 0.5)), ('capsule', Vector3(0.25, 0.3, 0)))
+            for i in range(60):
+                shape, size = shapes[i % 3]
+                orientation = Quaternion.FromAxisAndDegrees(Vector3(1, 1, 0).normalize(), i * 17)
+                world.add_body(Transform(Vector3(i % 4 * 0.9 - 1.5, 1 + i * 0.7, i % 5 * 0.8 - 2), orientation), shape, size)
+            for _ in range(240):
+                world.step(1 / 60)
+
+            state = array('f', bytes(world.body_count * 7 * 4))
+            world.copy_state(state)
+            return state.tobytes()
+
+        self.assertEqual(run(), run())
+
+    def test_remove_body_and_invalid_arguments(self):
+        ball = Transform(Vector3(0, 5, 0))
+        body = self.world.add_body(ball, 'sphere', Vector3(0.5, 0, 0))
+        self.assertEqual(2, self.world.body_count)
+
+        self.world.remove_body(body)
+        self.assertEqual(1, self.world.body_count)
+        with self.assertRaises(KeyError):
+            self.world.remove_body(body)
+        self.assertEqual(body, self.world.add_body(Transform(), 'sphere', Vector3(1, 0, 0)), 'Ids are reused')
+
+        with self.assertRaises(ValueError):
+            self.world.add_body(Transform(), 'cone', Vector3(1, 1, 1))
+        with self.assertRaises(ValueError):
+            self.world.add_body(Transform(), 'box', Vector3(1, 0, 1))
+        with self.assertRaises(TypeError):
+            self.world.add_body(object(), 'sphere', Vector3(1, 0, 0))
+        with self.assertRaises(ValueError):
+            self.world.step(0)
+
+    def test_bodies_cannot_change_while_stepping(self):
+        for i in range(400):
+            self.world.add_body(Transform(Vector3(i % 20 - 10, 1 + i // 20, 0)), 'box', Vector3(0.4, 0.4, 0.4))
+
+        stepper = threading.Thread(target=self.world.step, args=(1 / 60, 200))
+        stepper.start()
+        observed = False
+        while stepper.is_alive() and not observed:
+            if self.world.stepping:
+                observed = True
+                with self.assertRaises(RuntimeError):
+                    self.world.add_body(Transform(), 'sphere', Vector3(1, 0, 0))
+                with self.assertRaises(RuntimeError):
+                    self.world.remove_body(1)
+                with self.assertRaises(RuntimeError):
+                    self.world.step(1 / 60)
+                with self.assertRaises(RuntimeError):
+                    self.world.set_velocity(1, Vector3(1, 0, 0))
+                with self.assertRaises(RuntimeError):
+                    self.world.apply_impulse(1, Vector3(1, 0, 0))
+                with self.assertRaises(RuntimeError):
+                    self.world.read_transforms()
+                with self.assertRaises(RuntimeError):
+                    self.world.write_transforms()
+                with self.assertRaises(RuntimeError):
+                    self.world.copy_state(array('f', bytes(401 * 7 * 4)))
+        stepper.join()
+
+        self.assertTrue(observed, 'The step finished before the flag was seen')
+        self.assertFalse(self.world.stepping)
+        self.world.remove_body(1)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,125 @@
+import math
+import unittest
+from array import array
+from py3dengine.math import Matrix4x4, Vector3
+
+
+def project(m, x, y, z):
+    """Return the clip space (x, y, z, w) of a point transformed as a row vector"""
+    e = memoryview(m).tolist()
+    return tuple(x * e[j] + y * e[4 + j] + z * e[8 + j] + e[12 + j] for j in range(4))
+
+
+def ndc(m, x, y, z):
+    cx, cy, cz, w = project(m, x, y, z)
+    return cx / w, cy / w, cz / w
+
+
+class ProjectionTests(unittest.TestCase):
+    def assert_tuple_almost_equal(self, expected, actual, places=5):
+        self.assertEqual(len(expected), len(actual))
+        for e, a in zip(expected, actual):
+            self.assertAlmostEqual(e, a, places=places)
+
+    def test_perspective_lh_maps_near_and_far(self):
+        m = Matrix4x4.PerspectiveFovLH(90, 2, 1, 100)
+
+        self.assert_tuple_almost_equal((0, 0, 0), ndc(m, 0, 0, 1))
+        self.assert_tuple_almost_equal((0, 0, 1), ndc(m, 0, 0, 100))
+        self.assert_tuple_almost_equal((1, 1, 1), ndc(m, 200, 100, 100))
+
+    def test_perspective_rh_looks_down_negative_z(self):
+        m = Matrix4x4.PerspectiveFovRH(90, 1, 0.5, 10)
+
+        self.assert_tuple_almost_equal((0, 0, 0), ndc(m, 0, 0, -0.5))
+        self.assert_tuple_almost_equal((-1, 1, 1), ndc(m, -10, 10, -10))
+
+    def test_infinite_reverse_z(self):
+        lh = Matrix4x4.PerspectiveInfiniteReverseZLH(60, 1, 0.1)
+        rh = Matrix4x4.PerspectiveInfiniteReverseZRH(60, 1, 0.1)
+
+        self.assertAlmostEqual(1, ndc(lh, 0, 0, 0.1)[2])
+        self.assertAlmostEqual(1, ndc(rh, 0, 0, -0.1)[2])
+        self.assertAlmostEqual(0.1 / 1e6, ndc(lh, 0, 0, 1e6)[2])
+        self.assertGreater(ndc(lh, 0, 0, 10)[2], ndc(lh, 0, 0, 20)[2], 'Depth decreases with distance')
+
+    def test_orthographic(self):
+        lh = Matrix4x4.OrthographicLH(20, 10, 1, 11)
+        rh = Matrix4x4.OrthographicRH(20, 10, 1, 11)
+
+        self.assert_tuple_almost_equal((1, -1, 0, 1), project(lh, 10, -5, 1))
+        self.assert_tuple_almost_equal((1, -1, 1, 1), project(lh, 10, -5, 11))
+        self.assert_tuple_almost_equal((-1, 1, 0.5, 1), project(rh, -10, 5, -6))
+
+    def test_look_at_rh_puts_target_on_negative_z(self):
+        view = Matrix4x4.LookAtRH(Vector3(0, 0, 10), Vector3(0, 0, 0), Vector3(0, 1, 0))
+
+        self.assert_tuple_almost_equal((0, 0, -10, 1), project(view, 0, 0, 0))
+        self.assert_tuple_almost_equal((1, 0, -10, 1), project(view, 1, 0, 0), places=4)
+
+    def test_invalid_projection_arguments(self):
+        with self.assertRaises(ValueError):
+            Matrix4x4.PerspectiveFovLH(90, 0, 1, 100)
+        with self.assertRaises(ValueError):
+            Matrix4x4.OrthographicLH(10, 10, 5, 5)
+        with self.assertRaises(ValueError):
+            Matrix4x4.PerspectiveInfiniteReverseZLH(90, 1, 0)
+
+
+class MultBatchTests(unittest.TestCase):
+    def setUp(self):
+        view = Matrix4x4.LookAtLH(Vector3(3, 4, -10), Vector3(0, 0, 0), Vector3(0, 1, 0))
+        self.view_proj = view * Matrix4x4.PerspectiveFovLH(70, 16 / 9, 0.1, 500)
+
+        self.worlds = []
+        for i in range(37):
+            s = Matrix4x4.Scaling(Vector3(1 + i * 0.1, 1, 2))
+            r = Matrix4x4.RotationY(i * 10) * Matrix4x4.RotationX(i * 3)
+            t = Matrix4x4.Translation(Vector3(i, -i, i * 0.5))
+            self.worlds.append(s * r * t)
+
+        self.packed = array('f')
+        for world in self.worlds:
+            self.packed.frombytes(memoryview(world).tobytes())
+
+    def assert_matches_single_mults(self, out):
+        for i, world in enumerate(self.worlds):
+            expected = memoryview(world * self.view_proj).tolist()
+            for e, a in zip(expected, out[i * 16:(i + 1) * 16]):
+                self.assertAlmostEqual(e, a, delta=1e-4 * max(1.0, abs(e)))
+
+    def test_batch_matches_single_mults(self):
+        out = array('f', bytes(len(self.packed) * 4))
+
+        self.assertEqual(len(self.worlds), Matrix4x4.MultBatch(self.packed, self.view_proj, out))
+        self.assert_matches_single_mults(out)
+
+    def test_batch_in_place(self):
+        Matrix4x4.MultBatch(self.packed, self.view_proj, self.packed)
+
+        self.assert_matches_single_mults(self.packed)
+
+    def test_batch_rejects_bad_buffers(self):
+        with self.assertRaises(ValueError):
+            Matrix4x4.MultBatch(self.packed[:-1], self.view_proj, array('f', self.packed))
+        with self.assertRaises(ValueError):
+            Matrix4x4.MultBatch(self.packed, self.view_proj, array('f', self.packed[:-16]))
+        with self.assertRaises(ValueError):
+            Matrix4x4.MultBatch(array('d', self.packed), self.view_proj, array('f', self.packed))
+
+    def test_matrix_buffer_is_read_only(self):
+        m = Matrix4x4()
+        view = memoryview(m)
+        self.assertTrue(view.readonly)
+        with self.assertRaises(TypeError):
+            view[12:15] = array('f', (1, 2, 3))
+        view.release()
+
+        self.assertEqual([0, 0, 0], memoryview(m).tolist()[12:15])
+        self.assertEqual(math.prod(memoryview(m).shape), 16)
+        with self.assertRaises(BufferError):
+            Matrix4x4.MultBatch(self.packed[:16], self.view_proj, m)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,120 @@
+import math
+import random
+import unittest
+from array import array
+from py3dengine.math import Matrix4x4, Quaternion, Vector3
+
+
+def random_quaternion(rng):
+    axis = Vector3(rng.uniform(-1, 1), rng.uniform(-1, 1), rng.uniform(-1, 1) + 2).normalize()
+    return Quaternion.FromAxisAndDegrees(axis, rng.uniform(-180, 180))
+
+
+def quaternion_tuple(q):
+    return q.x, q.y, q.z, q.w
+
+
+class QuaternionTests(unittest.TestCase):
+    def assert_same_rotation(self, q1, q2, places=5):
+        sign = 1 if sum(a * b for a, b in zip(quaternion_tuple(q1), quaternion_tuple(q2))) >= 0 else -1
+        for a, b in zip(quaternion_tuple(q1), quaternion_tuple(q2)):
+            self.assertAlmostEqual(a, sign * b, places=places)
+
+    def test_normalize(self):
+        q = Quaternion(0, 3, 0, 4).normalize()
+        self.assertAlmostEqual(0.6, q.y, places=6)
+        self.assertAlmostEqual(0.8, q.w, places=6)
+
+        self.assertEqual((0, 0, 0, 1), quaternion_tuple(Quaternion(0, 0, 0, 0).normalize()))
+
+    def test_slerp_keeps_constant_angular_velocity(self):
+        up = Vector3(0, 1, 0)
+        start = Quaternion.FromAxisAndDegrees(up, 0)
+        end = Quaternion.FromAxisAndDegrees(up, 120)
+
+        self.assert_same_rotation(Quaternion.FromAxisAndDegrees(up, 30), start.slerp(end, 0.25))
+        self.assert_same_rotation(Quaternion.FromAxisAndDegrees(up, 90), start.slerp(end, 0.75))
+        self.assert_same_rotation(end, start.slerp(end, 1))
+
+    def test_interpolation_takes_the_shortest_path(self):
+        up = Vector3(0, 1, 0)
+        start = Quaternion.FromAxisAndDegrees(up, 170)
+        end = Quaternion.FromAxisAndDegrees(up, -170)
+
+        self.assert_same_rotation(Quaternion.FromAxisAndDegrees(up, 180), start.slerp(end, 0.5))
+        self.assert_same_rotation(Quaternion.FromAxisAndDegrees(up, 180), start.nlerp(end, 0.5))
+
+    def test_nlerp_is_normalized(self):
+        rng = random.Random(11)
+        q = random_quaternion(rng).nlerp(random_quaternion(rng), 0.3)
+
+        self.assertAlmostEqual(1, math.sqrt(sum(c * c for c in quaternion_tuple(q))), places=6)
+
+    def test_matrix_round_trip(self):
+        rng = random.Random(5)
+        for _ in range(100):
+            q = random_quaternion(rng)
+            self.assert_same_rotation(q, Quaternion.FromMatrix(q.to_matrix()))
+
+        q = random_quaternion(rng)
+        scaled = Matrix4x4.Scaling(Vector3(2, 3, 4)) * q.to_matrix() * Matrix4x4.Translation(Vector3(1, 2, 3))
+        self.assert_same_rotation(q, Quaternion.FromMatrix(scaled))
+
+    def test_matrix_and_quaternion_rotate_alike(self):
+        q = Quaternion.FromAxisAndDegrees(Vector3(1, 2, 3).normalize(), 77)
+        v = Vector3(4, -5, 6)
+
+        by_quaternion = v * q
+        by_matrix = v * q.to_matrix()
+        for a, b in zip((by_quaternion.x, by_quaternion.y, by_quaternion.z), (by_matrix.x, by_matrix.y, by_matrix.z)):
+            self.assertAlmostEqual(a, b, places=4)
+
+
+class QuaternionBatchTests(unittest.TestCase):
+    def setUp(self):
+        rng = random.Random(9)
+        self.count = 23
+        self.quats = [random_quaternion(rng) for _ in range(self.count)]
+        self.vectors = [Vector3(rng.uniform(-5, 5), rng.uniform(-5, 5), rng.uniform(-5, 5)) for _ in range(self.count)]
+        self.packed_vectors = array('f', (c for v in self.vectors for c in (v.x, v.y, v.z)))
+
+    def assert_vectors_equal(self, expected, packed):
+        for i, v in enumerate(expected):
+            for a, b in zip((v.x, v.y, v.z), packed[i * 3:i * 3 + 3]):
+                self.assertAlmostEqual(a, b, places=4)
+
+    def test_normalize_batch(self):
+        rng = random.Random(2)
+        raw = [Quaternion(*(rng.uniform(-3, 3) for _ in range(4))) for _ in range(self.count)]
+        raw[5] = Quaternion(0, 0, 0, 0)
+        packed = array('f', (c for q in raw for c in quaternion_tuple(q)))
+
+        self.assertEqual(self.count, Quaternion.NormalizeBatch(packed, packed))
+        for i, q in enumerate(raw):
+            for a, b in zip(quaternion_tuple(q.normalize()), packed[i * 4:i * 4 + 4]):
+                self.assertAlmostEqual(a, b, places=6)
+
+    def test_rotate_batch_by_one_quaternion(self):
+        out = array('f', bytes(len(self.packed_vectors) * 4))
+
+        self.assertEqual(self.count, Quaternion.RotateBatch(self.packed_vectors, self.quats[0], out))
+        self.assert_vectors_equal([v * self.quats[0] for v in self.vectors], out)
+
+    def test_rotate_batch_by_quaternion_per_vector(self):
+        packed_quats = array('f', (c for q in self.quats for c in quaternion_tuple(q)))
+
+        Quaternion.RotateBatch(self.packed_vectors, packed_quats, self.packed_vectors)
+        self.assert_vectors_equal([v * q for v, q in zip(self.vectors, self.quats)], self.packed_vectors)
+
+    def test_batch_rejects_bad_buffers(self):
+        out = array('f', self.packed_vectors)
+        with self.assertRaises(ValueError):
+            Quaternion.RotateBatch(self.packed_vectors[:-1], self.quats[0], out)
+        with self.assertRaises(ValueError):
+            Quaternion.RotateBatch(self.packed_vectors, array('f', [0, 0, 0, 1]), out)
+        with self.assertRaises(ValueError):
+            Quaternion.NormalizeBatch(array('f', [0, 0, 0, 1]), array('f', [0, 0]))
+
+
+if __name__ == '__main__':
+    unittest.main()
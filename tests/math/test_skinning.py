@@ -0,0 +1,99 @@
+import tempfile
+import unittest
+from array import array
+from os import path
+from py3dengine.math import Matrix4x4, Quaternion, Skeleton, Vector3
+from py3dengine.wfoparser import import_from_file
+
+QUAD_OBJ = '''v 0.0 0.0 0.0
+v 2.0 0.0 0.0
+v 0.0 2.0 0.0
+v 2.0 2.0 0.0
+vn 0.0 0.0 1.0
+f 1//1 2//1 3//1
+f 2//1 4//1 3//1
+'''
+
+
+def transform_point(m, x, y, z):
+    e = list(memoryview(m))
+    return tuple(x * e[c] + y * e[4 + c] + z * e[8 + c] + e[12 + c] for c in range(3))
+
+
+class SkinningTests(unittest.TestCase):
+    def setUp(self):
+        with tempfile.TemporaryDirectory() as work_dir:
+            obj_path = path.join(work_dir, 'quad.obj')
+            with open(obj_path, 'w') as obj_file:
+                obj_file.write(QUAD_OBJ)
+            self.mesh = import_from_file(obj_path)
+
+        self.bones = [
+            Matrix4x4.Translation(Vector3(0, 0, 5)),
+            Quaternion.FromAxisAndDegrees(Vector3(0, 1, 0), 90).to_matrix(),
+            Matrix4x4.Scaling(Vector3(2, 2, 2)) * Matrix4x4.Translation(Vector3(1, 0, 0)),
+        ]
+        self.palette = array('f', (f for m in self.bones for f in memoryview(m)))
+
+    def test_skins_imported_mesh(self):
+        count = self.mesh.get_vertex_count()
+        indices = array('i', [0, 1, 2, 0] * count)
+        weights = array('f', [0.5, 0.25, 0.25, 0.0] * count)
+        out_positions = array('f', bytes(count * 12))
+        out_normals = array('f', bytes(count * 12))
+
+        self.assertEqual(count, Skeleton.SkinVertices(
+            self.palette, self.mesh.get_positions(), indices, weights, out_positions,
+            self.mesh.get_normals(), out_normals
+        ))
+
+        positions, normals = self.mesh.get_positions(), self.mesh.get_normals()
+        for v in range(count):
+            p = positions[v * 3:v * 3 + 3]
+            expected = [0.0, 0.0, 0.0]
+            for bone, weight in zip((0, 1, 2), (0.5, 0.25, 0.25)):
+                skinned = transform_point(self.bones[bone], *p)
+                expected = [e + weight * s for e, s in zip(expected, skinned)]
+            for a, b in zip(expected, out_positions[v * 3:v * 3 + 3]):
+                self.assertAlmostEqual(a, b, places=5)
+
+            normal = [0.0, 0.0, 0.0]
+            for bone, weight in zip((0, 1, 2), (0.5, 0.25, 0.25)):
+                origin = transform_point(self.bones[bone], 0, 0, 0)
+                tip = transform_point(self.bones[bone], *normals[v * 3:v * 3 + 3])
+                normal = [n + weight * (t - o) for n, t, o in zip(normal, tip, origin)]
+            length = sum(n * n for n in normal) ** 0.5
+            for a, b in zip(normal, out_normals[v * 3:v * 3 + 3]):
+                self.assertAlmostEqual(a / length, b, places=5)
+
+    def test_multithreaded_matches_single_thread(self):
+        vertex_count = 10000
+        positions = array('f', (i * 0.001 for i in range(vertex_count * 3)))
+        indices = array('i', (i % 3 for i in range(vertex_count * 4)))
+        weights = array('f', [0.4, 0.3, 0.2, 0.1] * vertex_count)
+        single = array('f', bytes(len(positions) * 4))
+        threaded = array('f', bytes(len(positions) * 4))
+
+        Skeleton.SkinVertices(self.palette, positions, indices, weights, single, threads=1)
+        Skeleton.SkinVertices(self.palette, positions, indices, weights, threaded, threads=4)
+        self.assertEqual(list(single), list(threaded))
+
+        Skeleton.SkinVertices(self.palette, positions, indices, weights, positions)
+        self.assertEqual(list(single), list(positions), 'Skinning works in place')
+
+    def test_rejects_bad_buffers(self):
+        count = self.mesh.get_vertex_count()
+        positions = self.mesh.get_positions()
+        out = array('f', bytes(count * 12))
+        weights = array('f', [1, 0, 0, 0] * count)
+
+        with self.assertRaises(ValueError):
+            Skeleton.SkinVertices(self.palette, positions, array('i', [3, 0, 0, 0] * count), weights, out)
+        with self.assertRaises(ValueError):
+            Skeleton.SkinVertices(self.palette, positions, array('i', [0] * 4 * (count - 1)), weights, out)
+        with self.assertRaises(ValueError):
+            Skeleton.SkinVertices(self.palette, positions, array('i', [0] * 4 * count), weights, out, positions)
+
+
+if __name__ == '__main__':
+    unittest.main()
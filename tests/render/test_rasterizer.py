@@ -0,0 +1,133 @@
+import os
+import random
+import unittest
+from array import array
+from py3dengine.math import Matrix4x4, Rasterizer
+from py3dengine.render import image_difference, read_ppm, render_mesh, rgba_to_rgb, write_ppm
+from py3dengine.wfoparser import import_from_file
+
+DATA_DIR = os.path.join(os.path.dirname(__file__), 'data')
+CUBE_OBJ = os.path.join(DATA_DIR, 'cube.obj')
+CUBE_GOLDEN = os.path.join(DATA_DIR, 'cube_golden.ppm')
+
+# Set to rewrite the golden images from the current output after an intended rendering change
+UPDATE_GOLDEN = os.environ.get('PY3DENGINE_UPDATE_GOLDEN') is not None
+
+
+def jittered_grid(size, cells, seed):
+    """Triangulated grid over the whole clip space square with jittered inner vertices"""
+    rng = random.Random(seed)
+    positions = array('f')
+    for y in range(cells + 1):
+        for x in range(cells + 1):
+            px = -1.0 + 2.0 * x / cells
+            py = -1.0 + 2.0 * y / cells
+            if 0 < x < cells and 0 < y < cells:
+                px += rng.uniform(-0.4, 0.4) * 2.0 / cells
+                py += rng.uniform(-0.4, 0.4) * 2.0 / cells
+            positions.extend((px * size, py * size, 0.5))
+
+    indices = array('I')
+    for y in range(cells):
+        for x in range(cells):
+            a = y * (cells + 1) + x
+            b = a + 1
+            c = a + cells + 1
+            d = c + 1
+            indices.extend((a, b, d, a, d, c))
+
+    return positions, indices
+
+
+class RasterizerTests(unittest.TestCase):
+    def test_shared_edges_cover_every_pixel_exactly_once(self):
+        positions, indices = jittered_grid(1.0, 9, 3)
+        rasterizer = Rasterizer(67, 45, 1)
+
+        # Additive coverage isn't available, so every triangle is drawn alone and the pixels it touched are counted
+        coverage = [0] * (67 * 45)
+        for first in range(0, len(indices), 3):
+            rasterizer.clear((0.0, 0.0, 0.0, 0.0))
+            rasterizer.draw(Matrix4x4(), positions, indices[first:first + 3], color=(1.0, 1.0, 1.0), ambient=1.0)
+            color = rasterizer.color_bytes()
+            for pixel in range(67 * 45):
+                if color[pixel * 4] != 0:
+                    coverage[pixel] += 1
+
+        self.assertEqual({1}, set(coverage), 'A watertight mesh covers every pixel once')
+
+    def test_depth_test_keeps_the_nearest_triangle(self):
+        positions = array('f', [
+            -1.0, -1.0, 0.75, 1.0, -1.0, 0.75, 0.0, 1.0, 0.75,
+            -1.0, -1.0, 0.25, 1.0, -1.0, 0.25, 0.0, 1.0, 0.25,
+        ])
+        rasterizer = Rasterizer(8, 8)
+        rasterizer.draw(Matrix4x4(), positions, array('I', [3, 4, 5]), color=(1.0, 0.0, 0.0), ambient=1.0)
+        rasterizer.draw(Matrix4x4(), positions, array('I', [0, 1, 2]), color=(0.0, 1.0, 0.0), ambient=1.0)
+
+        color = rasterizer.color_bytes()
+        depth = array('f', [0.0]) * 64
+        rasterizer.read_depth(depth)
+        center = (4 * 8 + 4) * 4
+
+        self.assertEqual(255, color[center], 'The far triangle is rejected')
+        self.assertEqual(0, color[center + 1])
+        self.assertAlmostEqual(0.25, depth[4 * 8 + 4], 5)
+
+        rasterizer.clear(depth=0.0)
+        rasterizer.draw(
+            Matrix4x4(), positions, array('I', [3, 4, 5]), color=(1.0, 0.0, 0.0), ambient=1.0, reverse_z=True
+        )
+        rasterizer.draw(
+            Matrix4x4(), positions, array('I', [0, 1, 2]), color=(0.0, 1.0, 0.0), ambient=1.0, reverse_z=True
+        )
+        self.assertEqual(255, rasterizer.color_bytes()[center + 1], 'Reverse z keeps the greater depth')
+
+    def test_back_faces_are_culled(self):
+        positions = array('f', [-1.0, -1.0, 0.5, 1.0, -1.0, 0.5, 0.0, 1.0, 0.5])
+        rasterizer = Rasterizer(8, 8)
+        cleared = rasterizer.color_bytes()
+
+        self.assertEqual(0, rasterizer.draw(Matrix4x4(), positions, array('I', [0, 2, 1]), ambient=1.0))
+        self.assertEqual(cleared, rasterizer.color_bytes(), 'Clockwise triangles are back faces')
+
+        self.assertEqual(1, rasterizer.draw(Matrix4x4(), positions, array('I', [0, 2, 1]), ambient=1.0, cull=False))
+        self.assertNotEqual(0, rasterizer.color_bytes()[(4 * 8 + 4) * 4])
+
+    def test_output_does_not_depend_on_thread_count(self):
+        processor = import_from_file(CUBE_OBJ)
+        images = {render_mesh(processor, 150, 130, threads=threads).color_bytes() for threads in (1, 3, 0)}
+
+        self.assertEqual(1, len(images))
+
+    def test_invalid_draws_raise(self):
+        rasterizer = Rasterizer(4, 4)
+        positions = array('f', [0.0] * 9)
+
+        with self.assertRaises(ValueError):
+            rasterizer.draw(Matrix4x4(), positions, array('I', [0, 1, 3]))
+
+        with self.assertRaises(ValueError):
+            rasterizer.draw(Matrix4x4(), positions, array('I', [0, 1]))
+
+        with self.assertRaises(ValueError):
+            rasterizer.draw(Matrix4x4(), positions[:8], array('I', [0, 1, 2]))
+
+        with self.assertRaises(ValueError):
+            rasterizer.draw(Matrix4x4(), positions, array('I', [0, 1, 2]), normals=array('f', [0.0] * 6))
+
+        with self.assertRaises(ValueError):
+            Rasterizer(0, 4)
+
+    def test_cube_matches_golden_image(self):
+        rasterizer = render_mesh(import_from_file(CUBE_OBJ), 64, 64)
+        actual = rgba_to_rgb(rasterizer.color_bytes())
+
+        if UPDATE_GOLDEN:
+            write_ppm(CUBE_GOLDEN, 64, 64, rasterizer.color_bytes())
+
+        width, height, expected = read_ppm(CUBE_GOLDEN)
+        _, failed = image_difference(expected, actual, tolerance=2)
+
+        self.assertEqual((64, 64), (width, height))
+        self.assertLessEqual(failed, 8, 'At most a few edge pixels may change')
@@ -0,0 +1,143 @@
+import sys
+import threading
+import unittest
+from py3dengine.gameobject import GameObject
+from py3dengine.math import Matrix4x4, RenderQueue, Vector3
+from py3dengine.render_queue import MeshRenderer, RecordingBackend, render_frame
+from py3dengine.transform import Transform
+
+
+def at(x, y=0.0, z=0.0):
+    return Matrix4x4.Translation(Vector3(x, y, z))
+
+
+class RenderQueueTests(unittest.TestCase):
+    def setUp(self):
+        self.queue = RenderQueue()
+        self.backend = RecordingBackend()
+
+    def test_identical_states_are_instanced_in_one_draw(self):
+        materials = ['stone', 'wood', 'metal']
+        meshes = ['crate', 'barrel']
+        for i in range(600):
+            self.queue.submit(materials[i % 3], meshes[i % 2], at(i))
+
+        self.assertEqual(600, len(self.queue))
+        self.assertEqual(6, self.queue.flush(self.backend))
+        self.assertEqual(0, len(self.queue), 'Flushing empties the queue')
+
+        draws = self.backend.get_draws()
+        self.assertEqual([100] * 6, [draw[1] for draw in draws])
+        self.assertEqual((600, 6, 1 + 3 + 6), self.queue.last_flush, 'Materials bind 3 times, meshes 6 times')
+
+        binds = [call for call in self.backend.calls if call[0] == 'bind_material']
+        self.assertEqual(['stone', 'wood', 'metal'], [call[1] for call in binds], 'Materials keep first use order')
+
+    def test_opaque_draws_front_to_back_and_translucent_back_to_front(self):
+        self.queue.camera_position = Vector3(0.0, 0.0, 0.0)
+        for x in (5.0, 1.0, 3.0):
+            self.queue.submit('glass', 'pane', at(x), translucent=True)
+            self.queue.submit('stone', 'wall', at(x))
+
+        self.queue.flush(self.backend)
+        draws = self.backend.get_draws()
+
+        self.assertEqual(2, len(draws), 'Neighbouring draws of one state are a single batch')
+        self.assertEqual((1.0, 3.0, 5.0), draws[0][2][12::16], 'Opaque instances are sorted front to back')
+        self.assertEqual((5.0, 3.0, 1.0), draws[1][2][12::16], 'Translucent instances are sorted back to front')
+        self.assertEqual(('begin_layer', 0, True), [c for c in self.backend.calls if c[0] == 'begin_layer'][1])
+
+    def test_translucent_draws_only_merge_with_neighbours(self):
+        for x, material in ((4.0, 'glass'), (3.0, 'smoke'), (2.0, 'glass'), (1.0, 'glass')):
+            self.queue.submit(material, 'pane', at(x), translucent=True)
+
+        self.assertEqual(3, self.queue.flush(self.backend), 'Smoke between the glass panes splits their batch')
+        self.assertEqual([1, 1, 2], [draw[1] for draw in self.backend.get_draws()])
+
+    def test_layers_draw_in_order(self):
+        self.queue.submit('ui', 'quad', at(0), layer=2)
+        self.queue.submit('sky', 'dome', at(0), layer=0)
+        self.queue.submit('stone', 'wall', at(0), layer=1)
+
+        self.queue.flush(self.backend)
+        layers = [call[1] for call in self.backend.calls if call[0] == 'begin_layer']
+
+        self.assertEqual([0, 1, 2], layers)
+
+    def test_equal_keys_keep_submission_order(self):
+        for i in range(50):
+            self.queue.submit('stone', 'wall', at(i), depth=1.0)
+
+        self.queue.flush(self.backend)
+
+        self.assertEqual(tuple(float(i) for i in range(50)), self.backend.get_draws()[0][2][12::16])
+
+    def test_queue_cannot_change_while_flushing(self):
+        queue = self.queue
+
+        class SubmittingBackend(RecordingBackend):
+            def draw_instanced(self, instances, count):
+                queue.submit('stone', 'wall', at(0))
+
+        queue.submit('stone', 'wall', at(0))
+        with self.assertRaises(RuntimeError):
+            queue.flush(SubmittingBackend())
+
+        self.assertEqual(0, len(queue))
+
+    def test_queue_cannot_change_while_sorting_on_another_thread(self):
+        queue = self.queue
+        for i in range(100000):
+            queue.submit(i % 7, i % 5, at(float(i % 1000)))
+
+        rejected = []
+        old_interval = sys.getswitchinterval()
+        # A long switch interval keeps this thread holding the GIL until the flush releases it to sort
+        sys.setswitchinterval(0.1)
+        try:
+            flusher = threading.Thread(target=queue.flush, args=(RecordingBackend(),))
+            flusher.start()
+            while flusher.is_alive() and not rejected:
+                try:
+                    queue.submit('stone', 'wall', at(0))
+                except RuntimeError:
+                    rejected.append('submit')
+                    with self.assertRaises(RuntimeError):
+                        queue.__init__()
+            flusher.join()
+        finally:
+            sys.setswitchinterval(old_interval)
+
+        self.assertEqual(['submit'], rejected)
+        self.assertGreaterEqual(queue.last_flush[0], 100000)
+
+    def test_invalid_submissions_raise(self):
+        with self.assertRaises(ValueError):
+            self.queue.submit('stone', 'wall', at(0), layer=256)
+
+        with self.assertRaises(TypeError):
+            self.queue.submit(['unhashable'], 'wall', at(0))
+
+        self.queue.release_states()
+        self.assertEqual((0, 0), self.queue.state_count)
+
+
+class RenderFrameTests(unittest.TestCase):
+    def test_mesh_renderers_submit_on_render(self):
+        scene = GameObject('scene')
+        for i in range(10):
+            child = GameObject('crate{}'.format(i))
+            child._transform = Transform(Vector3(float(i), 0.0, 0.0))
+            child.attach_component(MeshRenderer('renderer', 'crate', 'wood'))
+            scene.attach_child(child)
+
+        backend = RecordingBackend()
+        queue = render_frame(scene, backend, camera_position=Vector3(-1.0, 0.0, 0.0))
+
+        draws = backend.get_draws()
+        self.assertEqual(1, len(draws))
+        self.assertEqual(10, draws[0][1])
+        self.assertEqual(tuple(float(i) for i in range(10)), draws[0][2][12::16])
+
+        render_frame(scene, backend, queue)
+        self.assertEqual((10, 1, 3), queue.last_flush)
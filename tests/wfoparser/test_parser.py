@@ -118,6 +118,24 @@ class ParserTests(unittest.TestCase):
                 ((1, 2, 3), (4, 5, 6), (7, 8, 9)),
             ),
 
+            # "f 1// 2// 3// 4//"
+            (
+                [
+                    WFOToken(WFOToken.Types.FACE, 1, 1),
+                    WFOToken(WFOToken.Types.SEPERATOR, 1, 2),
+                    WFOToken(WFOToken.Types.POLYGON, 1, 3, (1, None, None)),
+                    WFOToken(WFOToken.Types.SEPERATOR, 1, 6),
+                    WFOToken(WFOToken.Types.POLYGON, 1, 7, (2, None, None)),
+                    WFOToken(WFOToken.Types.SEPERATOR, 1, 10),
+                    WFOToken(WFOToken.Types.POLYGON, 1, 11, (3, None, None)),
+                    WFOToken(WFOToken.Types.SEPERATOR, 1, 14),
+                    WFOToken(WFOToken.Types.POLYGON, 1, 15, (4, None, None)),
+                    WFOToken(WFOToken.Types.LINE_BREAK, 1, 18, '\n'),
+                ],
+                WfoStatement.Types.FACE,
+                ((1, None, None), (2, None, None), (3, None, None), (4, None, None)),
+            ),
+
             # "s 1"
             (
                 [
@@ -1,5 +1,5 @@
 import unittest
-from py3dengine.wfoprocessor import WfoProcessor
+from py3dengine.wfoprocessor import WfoProcessor, ProcessorError
 from py3dengine.wfostatement import WfoStatement
 
 
@@ -19,3 +19,44 @@ class ProcessorTests(unittest.TestCase):
             'Material Lib statements add file names to material files collection'
         )
 
+    def test_faces_build_packed_vertex_buffers(self):
+        processor = WfoProcessor()
+
+        processor.process_statements([
+            WfoStatement(WfoStatement.Types.VERTEX, (0.0, 0.0, 0.0), 1, 1),
+            WfoStatement(WfoStatement.Types.VERTEX, (1.0, 0.0, 0.0), 2, 1),
+            WfoStatement(WfoStatement.Types.VERTEX, (0.0, 1.0, 0.0), 3, 1),
+            WfoStatement(WfoStatement.Types.VERTEX, (1.0, 1.0, 0.0), 4, 1),
+            WfoStatement(WfoStatement.Types.NORMAL, (0.0, 0.0, 1.0), 5, 1),
+            WfoStatement(WfoStatement.Types.FACE, ((1, None, 1), (2, None, 1), (3, None, 1)), 6, 1),
+            WfoStatement(WfoStatement.Types.FACE, ((-3, None, -1), (-1, None, -1), (-2, None, -1)), 7, 1),
+        ])
+
+        self.assertEqual(4, processor.get_vertex_count(), 'Shared position/normal pairs are one vertex')
+        self.assertEqual([0, 1, 2, 1, 3, 2], list(processor.get_indices()))
+        self.assertEqual([0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0], list(processor.get_positions()))
+        self.assertEqual([0, 0, 1] * 4, list(processor.get_normals()))
+        self.assertEqual([0, 0] * 4, list(processor.get_tex_coords()), 'Missing tex coords are zeros')
+
+    def test_polygon_faces_are_fanned_into_triangles(self):
+        processor = WfoProcessor()
+
+        processor.process_statements([
+            WfoStatement(WfoStatement.Types.VERTEX, (0.0, 0.0, 0.0), 1, 1),
+            WfoStatement(WfoStatement.Types.VERTEX, (1.0, 0.0, 0.0), 2, 1),
+            WfoStatement(WfoStatement.Types.VERTEX, (1.0, 1.0, 0.0), 3, 1),
+            WfoStatement(WfoStatement.Types.VERTEX, (0.0, 1.0, 0.0), 4, 1),
+            WfoStatement(WfoStatement.Types.FACE, ((1,), (2,), (3,), (4,)), 5, 1),
+        ])
+
+        self.assertEqual(4, processor.get_vertex_count())
+        self.assertEqual([0, 1, 2, 0, 2, 3], list(processor.get_indices()))
+
+    def test_face_with_missing_element_raises(self):
+        processor = WfoProcessor()
+
+        with self.assertRaises(ProcessorError):
+            processor.process_statements([
+                WfoStatement(WfoStatement.Types.VERTEX, (0.0, 0.0, 0.0), 1, 1),
+                WfoStatement(WfoStatement.Types.FACE, ((1, None, None), (2, None, None), (1, None, None)), 2, 1),
+            ])